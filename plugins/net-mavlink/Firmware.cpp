@@ -8,11 +8,15 @@
 #include <bmcl/MakeRc.h>
 #include <bmcl/Logging.h>
 #include <bmcl/Buffer.h>
+#include <bmcl/Endian.h>
+#include <bmcl/MemReader.h>
 #include <bmcl/StringView.h>
 #include <bmcl/OptionRc.h>
 
+#include <unordered_map>
+#include <unordered_set>
+
 #include <fmt/format.h>
-#include <rapidjson/writer.h>
 #include <rapidjson/document.h>
 
 namespace mccmav {
@@ -73,20 +77,23 @@ Firmware::~Firmware()
 {
 }
 
-void Firmware::loadXml(const std::vector<ParamValue>& params)
+using ParamMetaData = std::unordered_map<std::string, ParameterDescription>;
+
+static ParamMetaData parseMetaDataXml()
 {
+    ParamMetaData metaData;
     QFile file(":/net-mavlink/device/PX4ParameterFactMetaData.xml");
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
     {
         BMCL_WARNING() << "Can not open PX4ParameterFactMetaData.xml";
-        return;
+        return metaData;
     }
 
     QDomDocument doc;
     if (!doc.setContent(&file))
     {
         BMCL_WARNING() << "Can not read PX4ParameterFactMetaData.xml";
-        return;
+        return metaData;
     }
 
     QDomNodeList xmlGroups = doc.elementsByTagName("group");
@@ -127,13 +134,9 @@ void Firmware::loadXml(const std::vector<ParamValue>& params)
             QDomElement minElement = paramElement.firstChildElement("min");
             QDomElement maxElement = paramElement.firstChildElement("max");
 
-            auto paramIt = std::find_if(params.begin(), params.end(), [nameAttr](const ParamValue& p) { return p.name == nameAttr.toStdString(); });
-            if(paramIt == params.end())
-                continue;
-
             ParameterDescription description;
-            description.index = paramIt->index;
-            description.name = paramIt->name;
+            description.index = 0;
+            description.name = nameAttr.toStdString();
             description.defaultValue = defaultAttr.toDouble();
             description.type = typeAttr.toStdString();
             description.shortDesc = shortDescElement.text().toStdString();
@@ -155,17 +158,38 @@ void Firmware::loadXml(const std::vector<ParamValue>& params)
                 }
             }
 
-            _paramsDescription.emplace_back(std::move(description));
+            // first description wins, as with linear search before
+            metaData.emplace(description.name, std::move(description));
         }
     }
-    file.close();
+    return metaData;
+}
+
+// xml is embedded into resources and never changes, so it is parsed once for all devices
+static const ParamMetaData& px4MetaData()
+{
+    static const ParamMetaData metaData = parseMetaDataXml();
+    return metaData;
+}
+
+void Firmware::loadXml(const std::vector<ParamValue>& params)
+{
+    const ParamMetaData& metaData = px4MetaData();
+    std::unordered_set<std::string> added;
+    _paramsDescription.reserve(params.size());
 
     for (const auto& p : params)
     {
-        auto it = std::find_if(_paramsDescription.begin(), _paramsDescription.end(), [&p](const ParameterDescription& desc) { return desc.name == p.name; });
-        if (it != _paramsDescription.end())
+        if (!added.insert(p.name).second)
+            continue;
+
+        auto it = metaData.find(p.name);
+        if (it != metaData.end())
         {
-            it->type = toString(p.type);
+            ParameterDescription desc = it->second;
+            desc.index = p.index;
+            desc.type = toString(p.type);
+            _paramsDescription.emplace_back(std::move(desc));
             continue;
         }
 
@@ -188,69 +212,129 @@ void Firmware::loadXml(const std::vector<ParamValue>& params)
 
 }
 
+// binary form: magic, payload size, payload hash, payload
+constexpr uint32_t binaryMagic = 0x3157464d; // MFW1
+constexpr std::size_t binaryHeaderSize = 4 + 4 + 8;
+
+static uint64_t fnv1a(const uint8_t* data, std::size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (std::size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+static void writeString(bmcl::Buffer* dest, const std::string& str)
+{
+    dest->writeUint32Le(str.size());
+    dest->write(str.data(), str.size());
+}
+
+static bool readString(bmcl::MemReader* src, std::string* str)
+{
+    if (src->readableSize() < 4)
+        return false;
+    uint32_t size = src->readUint32Le();
+    if (src->readableSize() < size)
+        return false;
+    str->assign((const char*)src->current(), size);
+    src->skip(size);
+    return true;
+}
+
 bmcl::Buffer Firmware::encode() const
 {
-    rapidjson::StringBuffer buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-
-    writer.StartObject();
-    writer.Key("name");
-    writer.String(id().value());
-    writer.Key("autopilot");
-    writer.Int(_autopilotBoard);
-    writer.Key("params");
-    writer.StartArray();
+    bmcl::Buffer payload;
+    writeString(&payload, id().value());
+    payload.writeInt32Le(_autopilotBoard);
+    payload.writeUint32Le(_paramsDescription.size());
     for (const auto& p : _paramsDescription)
     {
-        writer.StartObject();
-        writer.Key("index");
-        writer.Int(p.index);
-        writer.Key("id");
-        writer.String(p.name);
-        writer.Key("defaultValue");
-        writer.Double(p.defaultValue);
-        writer.Key("shortInfo");
-        writer.String(p.shortDesc);
-        writer.Key("longInfo");
-        writer.String(p.longDesc);
-        writer.Key("unit");
-        writer.String(p.unit);
-        writer.Key("min");
-        writer.Double(p.min);
-        writer.Key("max");
-        writer.Double(p.max);
-        writer.Key("type");
-        writer.String(p.type);
-        writer.Key("category");
-        writer.String(p.category);
-
-        if (!p.values.empty())
+        payload.writeInt32Le(p.index);
+        writeString(&payload, p.name);
+        payload.writeFloat64Le(p.defaultValue);
+        writeString(&payload, p.shortDesc);
+        writeString(&payload, p.longDesc);
+        writeString(&payload, p.unit);
+        payload.writeFloat64Le(p.min);
+        payload.writeFloat64Le(p.max);
+        writeString(&payload, p.type);
+        writeString(&payload, p.category);
+        payload.writeUint32Le(p.values.size());
+        for (const auto& v : p.values)
         {
-            writer.Key("values");
-            writer.StartArray();
-            for (const auto& v : p.values)
-            {
-                writer.StartObject();
-                writer.Key("value");
-                writer.Int(v.first);
-                writer.Key("id");
-                writer.String(v.second);
-                writer.EndObject();
-            }
-            writer.EndArray();
+            payload.writeInt32Le(v.first);
+            writeString(&payload, v.second);
         }
-        writer.EndObject();
     }
-    writer.EndArray();
-    writer.EndObject();
 
-    assert(writer.IsComplete());
     bmcl::Buffer tmp;
-    tmp.write(buffer.GetString(), buffer.GetSize());
+    tmp.reserve(binaryHeaderSize + payload.size());
+    tmp.writeUint32Le(binaryMagic);
+    tmp.writeUint32Le(payload.size());
+    tmp.writeUint64Le(fnv1a(payload.data(), payload.size()));
+    tmp.write(payload.data(), payload.size());
     return tmp;
 }
 
-bmcl::OptionRc<const Firmware> Firmware::decode(const mccmsg::ProtocolValue& id, bmcl::Bytes bytes)
+static bmcl::OptionRc<const Firmware> decodeBinary(const mccmsg::ProtocolValue& id, bmcl::Bytes bytes)
+{
+    bmcl::MemReader reader(bytes);
+    reader.skip(4);
+    uint32_t size = reader.readUint32Le();
+    uint64_t hash = reader.readUint64Le();
+    if (reader.readableSize() != size || fnv1a(reader.current(), size) != hash)
+    {
+        BMCL_WARNING() << "Поврежденное описание прошивки " << id.value();
+        return bmcl::None;
+    }
+
+    std::string name;
+    if (!readString(&reader, &name) || reader.readableSize() < 8)
+        return bmcl::None;
+    MAV_AUTOPILOT ap = (MAV_AUTOPILOT)reader.readInt32Le();
+    uint32_t count = reader.readUint32Le();
+
+    std::vector<ParameterDescription> descriptions;
+    descriptions.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        ParameterDescription desc;
+        if (reader.readableSize() < 4)
+            return bmcl::None;
+        desc.index = reader.readInt32Le();
+        if (!readString(&reader, &desc.name) || reader.readableSize() < 8)
+            return bmcl::None;
+        desc.defaultValue = reader.readFloat64Le();
+        if (!readString(&reader, &desc.shortDesc) || !readString(&reader, &desc.longDesc) || !readString(&reader, &desc.unit))
+            return bmcl::None;
+        if (reader.readableSize() < 16)
+            return bmcl::None;
+        desc.min = reader.readFloat64Le();
+        desc.max = reader.readFloat64Le();
+        if (!readString(&reader, &desc.type) || !readString(&reader, &desc.category) || reader.readableSize() < 4)
+            return bmcl::None;
+        uint32_t valuesCount = reader.readUint32Le();
+        for (uint32_t j = 0; j < valuesCount; j++)
+        {
+            if (reader.readableSize() < 4)
+                return bmcl::None;
+            int value = reader.readInt32Le();
+            if (!readString(&reader, &desc.values[value]))
+                return bmcl::None;
+        }
+        descriptions.emplace_back(std::move(desc));
+    }
+    // firmware is stored under its name, other name means damaged row
+    if (id.value() != name)
+        return bmcl::None;
+    return bmcl::makeRc<const Firmware>(id, ap, descriptions, mccmsg::PropertyDescriptionPtrs(), mccmsg::PropertyDescriptionPtrs());
+}
+
+static bmcl::OptionRc<const Firmware> decodeJson(const mccmsg::ProtocolValue& id, bmcl::Bytes bytes)
 {
     rapidjson::Document d;
     if (d.Parse((const char*)bytes.data(), bytes.size()).HasParseError())
@@ -299,6 +383,14 @@ bmcl::OptionRc<const Firmware> Firmware::decode(const mccmsg::ProtocolValue& id,
     return bmcl::makeRc<const Firmware>(id, ap,  descriptions, mccmsg::PropertyDescriptionPtrs(), mccmsg::PropertyDescriptionPtrs());
 }
 
+bmcl::OptionRc<const Firmware> Firmware::decode(const mccmsg::ProtocolValue& id, bmcl::Bytes bytes)
+{
+    // firmwares registered before binary form was introduced are stored as json
+    if (bytes.size() >= binaryHeaderSize && le32dec(bytes.data()) == binaryMagic)
+        return decodeBinary(id, bytes);
+    return decodeJson(id, bytes);
+}
+
 bool Firmware::isPx4() const
 {
     return _autopilotBoard == MAV_AUTOPILOT_PX4;
@@ -8,6 +8,7 @@
 #include "mcc/net/Asio.h"
 #include "mcc/net/NetLoggerInf.h"
 #include "../broker/Broker.h"
+#include "../broker/ChannelActor.h"
 #include "../broker/Connections.h"
 #include "../device/Device.h"
 #include "../device/Mavlink.h"
@@ -18,6 +19,7 @@ CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::DevReqPtr)
 CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::CancelPtr)
 CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::NotificationPtr)
 CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::device::Activate_RequestPtr)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::channel::Activate_RequestPtr)
 
 namespace mccmav {
 
@@ -96,7 +98,11 @@ public:
 
     void visit(const mccmsg::channel::Activate_Request* msg) override
     {
-        _self->_conns->channelActivate(mccmsg::channel::Activate_RequestPtr(msg), _self->make_response_promise());
+        auto i = _self->_conns->getChannel(msg->data()._name);
+        if (i.isNone())
+            _self->response(mccmsg::make_error(mccmsg::Error::ChannelUnknown));
+        else
+            _self->delegate(i.unwrap(), mccmsg::channel::Activate_RequestPtr(msg));
     }
     void visit(const mccmsg::device::Activate_Request* msg) override
     {
@@ -178,47 +184,17 @@ caf::behavior Broker::make_behavior()
         {
             _conns->push(dev, Request(std::move(pkt)));
         }
-      , [this](mccnet::atom_rcvd, const mccmsg::Channel& channel, mccmsg::PacketPtr& pkt)
+      , [this](channel_state_atom, const mccmsg::Channel& channel, bool isEnabled)
         {
-            _conns->pull(channel, std::move(pkt));
+            _conns->channelActivated(channel, isEnabled);
         }
-      , [this](mccnet::atom_timeout, const mccmsg::Channel& channel)
+      , [this](channel_ready_atom, const mccmsg::Channel& channel)
         {
-            _conns->timeout(channel);
-        }
-      , [this](const mccmsg::Channel& c, const mccmsg::StatChannel& stats)
-        {
-            auto s = _conns->stats(c, stats);
-            send(_core, mccmsg::makeNote(new mccmsg::channel::State(s)));
-        }
-      , [this](mccnet::activated_atom, const mccmsg::Channel& channel)
-        {
-            _conns->channelActivated(channel);
-            auto s = _conns->getStats(channel);
-            if (s.isSome())
-                send(_core, mccmsg::makeNote(new mccmsg::channel::State(*s)));
-        }
-      , [this](mccnet::deactivated_atom, const caf::error& err, const mccmsg::Channel& channel)
-        {
-            _conns->channelDeactivated(channel, err);
-            auto s = _conns->getStats(channel);
-            if (s.isSome())
-                send(_core, mccmsg::makeNote(new mccmsg::channel::State(*s)));
+            _conns->channelReady(channel);
         }
       , [this](mccnet::activated_atom, const mccmsg::Device& device, bool state)
         {
             _conns->deviceActivated(device, state);
-            std::vector<std::size_t> ds;
-            for(const auto& i: _conns->devices())
-            {
-                if (i.second->isActive())
-                    ds.push_back(i.second->id().id());
-            }
-
-            for (const auto& i : _conns->devices())
-            {
-                send(i.second->actor(), mccnet::activated_list_atom::value, ds);
-            }
         }
 
     };
@@ -7,14 +7,13 @@
 #include "mcc/net/Asio.h"
 #include "mcc/net/NetLoggerInf.h"
 
-#include "../broker/Device.h"
 #include "../broker/Channel.h"
-#include "../device/Device.h"
 #include "../device/Mavlink.h"
 
 MSG_ALLOW_CAF(channel, Activate)
 CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::Channel)
 CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::NotificationPtr)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::PacketPtr)
 
 namespace mccmav {
 
@@ -25,83 +24,87 @@ IDevicePrioritizer::~IDevicePrioritizer()
 class DevicePrioritizer : public IDevicePrioritizer
 {
 public:
-    const std::vector<DItemPtr>& list() const override { return _devices; }
+    const std::vector<CDevicePtr>& list() const override { return _devices; }
     bool empty() const override { return _devices.empty(); }
-    void add(const DItemPtr& d) override
+    DevicePrioritizer()
     {
-        auto i = std::find_if(_devices.begin(), _devices.end(), [d](const DItemPtr& item) { return d->name() == item->name(); });
+        _slots.fill(noSlot);
+    }
+    void add(const CDevicePtr& d) override
+    {
+        auto i = std::find_if(_devices.begin(), _devices.end(), [d](const CDevicePtr& item) { return d->name() == item->name(); });
         if (i == _devices.end())
+        {
             _devices.emplace_back(d);
+            updateSlots();
+        }
     }
-    bmcl::OptionRc<DItem> remove(const mccmsg::Device& d) override
+    bmcl::OptionRc<CDevice> find(const mccmsg::Device& d) override
     {
-        auto i = std::find_if(_devices.begin(), _devices.end(), [d](const DItemPtr& item) { return d == item->name(); });
+        auto i = std::find_if(_devices.begin(), _devices.end(), [d](const CDevicePtr& item) { return d == item->name(); });
         if (i == _devices.end())
             return bmcl::None;
-        if (std::distance(_devices.begin(), i) <= _pos && _pos > 0)
-            --_pos;
-        DItemPtr dev = *i;
-        _devices.erase(i);
-        return dev;
+        return *i;
     }
-    bmcl::OptionRc<DItem> get(std::size_t id) override
+    bmcl::OptionRc<CDevice> remove(const mccmsg::Device& d) override
     {
-        auto i = std::find_if(_devices.begin(), _devices.end(), [id](const DItemPtr& item) { return item->isSameId(id); });
+        auto i = std::find_if(_devices.begin(), _devices.end(), [d](const CDevicePtr& item) { return d == item->name(); });
         if (i == _devices.end())
             return bmcl::None;
-        return *i;
+        CDevicePtr dev = *i;
+        _devices.erase(i);
+        updateSlots();
+        return dev;
     }
-    bmcl::OptionRc<DItem> next() override
+    bmcl::OptionRc<CDevice> get(std::size_t id) override
     {
-        if (_devices.empty())
+        if (id >= _slots.size() || _slots[id] == noSlot)
             return bmcl::None;
-        std::size_t size = _devices.size();
-        for (std::size_t i = 1; i <= size; ++i)
+        return _devices[_slots[id]];
+    }
+private:
+    static constexpr uint16_t noSlot = 0xffff;
+
+    // slot of attached device is its index in _devices, first device with same id wins as in linear search
+    void updateSlots()
+    {
+        _slots.fill(noSlot);
+        for (std::size_t i = _devices.size(); i > 0; --i)
         {
-            const DItemPtr& item = _devices[(_pos + i) % size];
-            if (item->hasRequests())
-            {
-                _pos = (_pos + i) % size;
-                return item;
-            }
+            std::size_t id = _devices[i - 1]->id().id();
+            if (id < _slots.size())
+                _slots[id] = static_cast<uint16_t>(i - 1);
         }
-        return bmcl::None;
     }
-private:
-    std::size_t _pos = 0;
-    std::vector<DItemPtr> _devices;
+
+    std::vector<CDevicePtr> _devices;
+    std::array<uint16_t, DeviceCounters::maxDevices> _slots;
 };
 
-CItem::CItem(mccnet::Asio& asio, std::unique_ptr<mccnet::IExchanger>&& exchanger, caf::event_based_actor* self, const mccmsg::ChannelDescription& d)
-    : _enabled(false), _asio(asio), _self(self), _dscr(d)
+CItem::CItem(caf::event_based_actor* self, const mccmsg::ChannelDescription& d)
+    : _enabled(false), _self(self), _dscr(d)
 {
     _devices = std::make_unique<DevicePrioritizer>();
-    _ptr = asio.add(_dscr, std::move(exchanger));
 }
 
 CItem::~CItem()
 {
-    _asio.remove(_ptr->id());
     BMCL_DEBUG() << "Канал удалён из брокера: " << _dscr->name().toStdString();
 }
 
-void CItem::add_device(const DItemPtr& device)
+void CItem::setChannel(const mccnet::ChannelPtr& ptr)
 {
-    _devices->add(device);
-    if (isEnabled())
-        device->addChannel(this);
+    _ptr = ptr;
 }
 
-void CItem::remove_device(const mccmsg::Device& device)
+void CItem::add_device(const mccmsg::ProtocolId& id, const caf::actor& a)
 {
-    auto d = _devices->remove(device);
-    if (d.isSome())
-        d.unwrap()->removeChannel(name());
+    _devices->add(CDevicePtr(new CDevice(id, a)));
 }
 
-inline bool CItem::isEnabled() const
+void CItem::remove_device(const mccmsg::Device& device)
 {
-    return _enabled;
+    _devices->remove(device);
 }
 
 void CItem::activated(bool state)
@@ -111,20 +114,11 @@ void CItem::activated(bool state)
     if (!state && _enabled)
         _ptr->disconnect([](caf::error&&) {});
 
-    auto ds = _devices->list();
-    for (const auto& j : ds)
-    {
-        if (isEnabled())
-            j->addChannel(this);
-        else
-            j->removeChannel(name());
-    }
-
-    if (isEnabled())
-        sendIfYouCan();
-
     if (!isEnabled())
+    {
         _stats.reset();
+        _counters.reset();
+    }
 }
 
 void CItem::connect(const mccmsg::channel::Activate_RequestPtr& req, caf::response_promise&& rp)
@@ -165,17 +159,14 @@ void CItem::update(const mccmsg::ChannelDescription& dscrNew)
 void CItem::timeout()
 {
     _pendingTimeout = false;
-    sendIfYouCan();
 }
 
-void CItem::sendIfYouCan()
+bool CItem::push(const mccmsg::Device& device, Request&& req)
 {
-    if (!isEnabled() || _pendingTimeout)
-        return;
-    auto d = _devices->next();
-    if (d.isNone())
-        return;
-    send((*d)->popRequest());
+    if (!_ptr || _devices->find(device).isNone())
+        return false;
+    send(std::move(req));
+    return true;
 }
 
 void CItem::pull(mccmsg::PacketPtr&& pkt)
@@ -183,11 +174,11 @@ void CItem::pull(mccmsg::PacketPtr&& pkt)
     if (pkt->size() <= 4)
         return;
     DeviceId id = MavlinkCoder::device_id(*pkt);
-    _stats._devices[id].add(pkt->size(), 1);
+    _counters.add(id, pkt->size());
     auto r = _devices->get(id);
     if (r.isNone())
         return;
-    r.unwrap()->pull(pkt);
+    _self->send(r.unwrap()->actor(), std::move(pkt));
 }
 
 void CItem::stats(const mccmsg::StatChannel& stats)
@@ -202,6 +193,7 @@ mccmsg::StatChannel CItem::getStats()
     mccmsg::StatChannel s = _stats;
     s._channel = _dscr->name();
     s._isActive = isEnabled();
+    _counters.snapshot(&s._devices);
     return s;
 }
 
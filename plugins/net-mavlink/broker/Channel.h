@@ -1,7 +1,9 @@
 #pragma once
 #include <ctime>
+#include <vector>
 #include <caf/send.hpp>
 #include <caf/atom.hpp>
+#include <caf/event_based_actor.hpp>
 #include <bmcl/Logging.h>
 #include <bmcl/OptionRc.h>
 #include "mcc/msg/ptr/Fwd.h"
@@ -9,38 +11,51 @@
 #include "mcc/net/Asio.h"
 #include "mcc/net/NetLoggerInf.h"
 
-#include "../broker/Broker.h"
-#include "../device/Device.h"
+#include "../broker/DeviceCounters.h"
+#include "../broker/Request.h"
 #include "../device/Mavlink.h"
 
 namespace mccmav {
 
-class DItem;
-using DItemPtr = mcc::Rc<DItem>;
-using DItems = std::map<mccmsg::Device, DItemPtr>;
+// device attached to channel, as seen by channel actor
+class CDevice : public mcc::RefCountable
+{
+public:
+    CDevice(const mccmsg::ProtocolId& id, const caf::actor& a) : _id(id), _a(a) {}
+    inline const mccmsg::ProtocolId& id() const { return _id; }
+    inline const mccmsg::Device& name() const { return _id.device(); }
+    inline const caf::actor& actor() const { return _a; }
+private:
+    mccmsg::ProtocolId _id;
+    caf::actor _a;
+};
+using CDevicePtr = mcc::Rc<CDevice>;
 
 class IDevicePrioritizer
 {
 public:
     virtual ~IDevicePrioritizer();
-    virtual const std::vector<DItemPtr>& list() const = 0;
+    virtual const std::vector<CDevicePtr>& list() const = 0;
     virtual bool empty() const = 0;
-    virtual void add(const DItemPtr& d) = 0;
-    virtual bmcl::OptionRc<DItem> get(std::size_t id) = 0;
-    virtual bmcl::OptionRc<DItem> remove(const mccmsg::Device& d) = 0;
-    virtual bmcl::OptionRc<DItem> next() = 0;
+    virtual void add(const CDevicePtr& d) = 0;
+    virtual bmcl::OptionRc<CDevice> get(std::size_t id) = 0;
+    virtual bmcl::OptionRc<CDevice> find(const mccmsg::Device& d) = 0;
+    virtual bmcl::OptionRc<CDevice> remove(const mccmsg::Device& d) = 0;
 };
 
-class CItem : public mcc::RefCountable
+// framing of one channel, owned by its ChannelActor. Broker gives channel next request
+// when channel is ready, so at most one request waits for answer or timeout
+class CItem
 {
 public:
-    CItem(mccnet::Asio& asio, std::unique_ptr<mccnet::IExchanger>&& exchanger, caf::event_based_actor* self, const mccmsg::ChannelDescription& d);
+    CItem(caf::event_based_actor* self, const mccmsg::ChannelDescription& d);
     ~CItem();
-    inline std::vector<DItemPtr> devices() const { return _devices->list(); }
     inline const mccmsg::Channel& name() const { return _dscr->name(); }
+    void setChannel(const mccnet::ChannelPtr& ptr);
     void stats(const mccmsg::StatChannel& stats);
-    bool isEnabled() const;
-    void add_device(const DItemPtr& device);
+    inline bool isEnabled() const { return _enabled; }
+    inline bool isReady() const { return _enabled && !_pendingTimeout && _ptr; }
+    void add_device(const mccmsg::ProtocolId& id, const caf::actor& a);
     void remove_device(const mccmsg::Device& device);
     void activated(bool state);
     void connect(const mccmsg::channel::Activate_RequestPtr& req, caf::response_promise&& rp);
@@ -48,21 +63,20 @@ public:
     void update(const mccmsg::ChannelDescription& dscrNew);
     mccmsg::StatChannel getStats();
 
+    // returns false if request is dropped because device is not attached
+    bool push(const mccmsg::Device& device, Request&& req);
     void pull(mccmsg::PacketPtr&& pkt);
-    void sendIfYouCan();
     void timeout();
 
 private:
     void send(Request&& r);
     bool _enabled;
     caf::event_based_actor* _self;
-    mccnet::Asio& _asio;
     bool _pendingTimeout = false;
     mccnet::ChannelPtr _ptr;
     std::unique_ptr<IDevicePrioritizer> _devices;
     mccmsg::ChannelDescription _dscr;
     mccmsg::StatChannel _stats;
+    DeviceCounters _counters;
 };
-using CItemPtr = mcc::Rc<CItem>;
-using CItems = std::map<mccmsg::Channel, CItemPtr>;
 }
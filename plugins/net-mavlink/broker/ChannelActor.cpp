@@ -0,0 +1,133 @@
+#include <fmt/format.h>
+#include <bmcl/Logging.h>
+#include "mcc/msg/ptr/Channel.h"
+#include "mcc/msg/Packet.h"
+#include "mcc/net/Asio.h"
+#include "mcc/net/NetLoggerInf.h"
+
+#include "../broker/ChannelActor.h"
+
+MSG_ALLOW_CAF(channel, Activate)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::Channel)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::ChannelDescription)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::Device)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::NotificationPtr)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::PacketPtr)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::ProtocolId)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::StatChannel)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccnet::ChannelPtr)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(std::shared_ptr<mccnet::Asio>)
+
+namespace mccmav {
+
+ChannelActor::ChannelActor(caf::actor_config& cfg, const caf::actor& core, const caf::actor& broker, const mccmsg::ChannelDescription& dscr)
+    : caf::event_based_actor(cfg), _core(core), _broker(broker), _channel(this, dscr)
+{
+    _name = fmt::format("net.mav.channel.{}", dscr->info());
+}
+
+ChannelActor::~ChannelActor()
+{
+}
+
+const char* ChannelActor::name() const
+{
+    return _name.c_str();
+}
+
+void ChannelActor::on_exit()
+{
+    _channel.setChannel(nullptr);
+    _asio.reset();
+    destroy(_core);
+    destroy(_broker);
+}
+
+void ChannelActor::activated(bool state)
+{
+    _channel.activated(state);
+    send(_broker, channel_state_atom::value, _channel.name(), state);
+    sendReady();
+    sendState();
+}
+
+// broker gets channel state first, so it takes ready only from enabled channel
+void ChannelActor::sendReady()
+{
+    if (_channel.isReady())
+        send(_broker, channel_ready_atom::value, _channel.name());
+}
+
+void ChannelActor::sendState()
+{
+    send(_core, mccmsg::makeNote(new mccmsg::channel::State(_channel.getStats())));
+}
+
+caf::behavior ChannelActor::make_behavior()
+{
+    return
+    {
+        [this](const mccnet::ChannelPtr& ptr, const std::shared_ptr<mccnet::Asio>& asio)
+        {
+            _asio = asio;
+            _channel.setChannel(ptr);
+        }
+      , [this](const mccmsg::ChannelDescription& dscr)
+        {
+            _channel.update(dscr);
+        }
+      , [this](const mccmsg::channel::Activate_RequestPtr& req)
+        {
+            auto rp = make_response_promise();
+            if (req->data()._state)
+                _channel.connect(req, std::move(rp));
+            else
+                _channel.disconnect(req, std::move(rp));
+            return caf::delegated<mccmsg::channel::Activate_ResponsePtr>();
+        }
+      , [this](channel_attach_atom, const mccmsg::ProtocolId& id, const caf::actor& device)
+        {
+            _channel.add_device(id, device);
+        }
+      , [this](channel_detach_atom, const mccmsg::Device& device)
+        {
+            _channel.remove_device(device);
+        }
+      , [this](mccnet::req_atom, const mccmsg::Device& device, mccmsg::PacketPtr& pkt)
+        {
+            // request routed before broker got disabled state of channel is queued again
+            if (!_channel.isEnabled())
+                send(_broker, mccnet::req_atom::value, device, std::move(pkt));
+            // request of device detached in the meantime is dropped
+            else if (!_channel.push(device, Request(std::move(pkt))))
+                sendReady();
+        }
+      , [this](mccnet::atom_rcvd, const mccmsg::Channel&, mccmsg::PacketPtr& pkt)
+        {
+            _channel.pull(std::move(pkt));
+        }
+      , [this](mccnet::atom_timeout, const mccmsg::Channel&)
+        {
+            _channel.timeout();
+            sendReady();
+        }
+      , [this](const mccmsg::Channel&, const mccmsg::StatChannel& stats)
+        {
+            _channel.stats(stats);
+            sendState();
+        }
+      , [this](mccnet::activated_atom, const mccmsg::Channel&)
+        {
+            activated(true);
+        }
+      , [this](mccnet::deactivated_atom, const caf::error& err, const mccmsg::Channel&)
+        {
+            if (err)
+            {
+                BMCL_WARNING() << "Ошибка соединения: " << system().render(err);
+            }
+            activated(false);
+        }
+    };
+}
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <memory>
+#include <caf/actor.hpp>
+#include <caf/atom.hpp>
+#include <caf/event_based_actor.hpp>
+#include "mcc/msg/ptr/Fwd.h"
+#include "mcc/net/Asio.h"
+
+#include "../broker/Channel.h"
+
+namespace mccmav {
+
+using channel_attach_atom = caf::atom_constant<caf::atom("chattach")>;
+using channel_detach_atom = caf::atom_constant<caf::atom("chdetach")>;
+using channel_state_atom = caf::atom_constant<caf::atom("chstate")>;
+using channel_ready_atom = caf::atom_constant<caf::atom("chready")>;
+
+// One actor per channel: receives packets straight from asio side of channel, counts and dispatches them
+// to device actors. Broker registers channels and devices and keeps request queues of devices, channel
+// reports its state with channel_state_atom and asks for next request with channel_ready_atom
+class ChannelActor : public caf::event_based_actor
+{
+public:
+    ChannelActor(caf::actor_config& cfg, const caf::actor& core, const caf::actor& broker, const mccmsg::ChannelDescription& dscr);
+    ~ChannelActor();
+    caf::behavior make_behavior() override;
+    const char* name() const override;
+    void on_exit() override;
+
+private:
+    void activated(bool state);
+    void sendReady();
+    void sendState();
+
+    std::string _name;
+    caf::actor _core;
+    caf::actor _broker;
+    // channels keep reference to io context, so asio lives while any of channel actors is alive
+    std::shared_ptr<mccnet::Asio> _asio;
+    CItem _channel;
+};
+}
@@ -9,24 +9,32 @@
 #include "mcc/net/NetLoggerInf.h"
 
 #include "../broker/Broker.h"
+#include "../broker/ChannelActor.h"
 #include "../broker/Connections.h"
 #include "../broker/Exchanger.h"
 #include "../device/Device.h"
 #include "../device/Mavlink.h"
 
 CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::Channel)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::ChannelDescription)
 CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::Device)
 CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::NotificationPtr)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::PacketPtr)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::ProtocolId)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccnet::ChannelPtr)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(std::shared_ptr<mccnet::Asio>)
 
 namespace mccmav {
 
 Connections::Connections(Broker* self, const caf::actor& core, const caf::actor& logger, const caf::actor& group)
-    : _self(self), _core(core), _logger(logger), _group(group)
+    : _asio(std::make_shared<mccnet::Asio>()), _self(self), _core(core), _logger(logger), _group(group)
 {
 }
 
 Connections::~Connections()
 {
+    for (const auto& i : _channels)
+        _self->send_exit(i.second.actor, caf::exit_reason::user_shutdown);
 }
 
 bmcl::Option<caf::actor&> Connections::getDevice(const mccmsg::Device& name)
@@ -50,7 +58,17 @@ const DItemPtr& Connections::addDevice(const mccmsg::ProtocolId& id)
     {
         auto a = _self->spawn<Device, caf::monitored>(_core, _self, _group, id, _self->getDeviceName(id));
         auto j = _devices.emplace(name, new DItem(id, a, _self));
+        _deviceAddrs.emplace(a.address(), name);
         _self->send(_core, caf::atom("device"), id.device());
+
+        std::vector<std::size_t> ds;
+        for (const auto& k : _devices)
+        {
+            if (k.second->isActive())
+                ds.push_back(k.second->id().id());
+        }
+        if (!ds.empty())
+            _self->send(a, mccnet::activated_list_atom::value, ds);
         i = j.first;
     }
     return i->second;
@@ -58,18 +76,30 @@ const DItemPtr& Connections::addDevice(const mccmsg::ProtocolId& id)
 
 void Connections::deviceDown(const caf::down_msg& dm)
 {
-    caf::actor_addr addr = dm.source;
-    auto i = std::find_if(_devices.begin(), _devices.end(), [addr](const DItems::value_type& i) { return i.second->isSame(addr); });
+    auto addr = _deviceAddrs.find(dm.source);
+    if (addr == _deviceAddrs.end())
+        return;
+    auto i = _devices.find(addr->second);
+    _deviceAddrs.erase(addr);
     if (i == _devices.end())
+    {
+        assert(false);
         return;
-    assert(i != _devices.end());
+    }
     if (dm.reason == caf::sec::runtime_error)
         _self->log(i->second->name(), "актор устройства остановлен из-за ошибки");
     else
         _self->log(i->second->name(), "актор устройства остановлен по причине: {}", _self->system().render(dm.reason));
-    for (const auto& j : _channels)
-        j.second->remove_device(i->second->name());
+    for (const mccmsg::Channel& c : i->second->attachedChannels())
+    {
+        auto j = _channels.find(c);
+        if (j != _channels.end() && j->second.devices.erase(i->second->name()) != 0)
+            _self->send(j->second.actor, channel_detach_atom::value, i->second->name());
+    }
+    DItemPtr d = i->second;
     _devices.erase(i);
+    if (d->isActive())
+        sendActivatedChange(d->id().id(), false);
 }
 
 void Connections::removeDevice(const mccmsg::Device& d, const caf::error& reason)
@@ -89,9 +119,16 @@ void Connections::removeAllDevices(const caf::error& reason)
 void Connections::deviceActivated(const mccmsg::Device& device, bool isActive)
 {
     auto i = _devices.find(device);
-    if (i == _devices.end())
+    if (i == _devices.end() || i->second->isActive() == isActive)
         return;
     i->second->activated(isActive);
+    sendActivatedChange(i->second->id().id(), isActive);
+}
+
+void Connections::sendActivatedChange(std::size_t id, bool isActive)
+{
+    for (const auto& i : _devices)
+        _self->send(i.second->actor(), mccnet::activated_change_atom::value, id, isActive);
 }
 
 const DItems& Connections::devices() const
@@ -112,45 +149,64 @@ void Connections::syncChannel(const mccmsg::ChannelDescription& dscr)
         assert(false);
         return;
     }
-    auto& c = i->second;
-    const auto& current = c->devices();
-    for (const DItemPtr& d : current)
+    std::set<mccmsg::Device> connected;
+    for (const auto& id : dscr->connectedDevices())
+        connected.emplace(id.device());
+    const auto current = i->second.devices;
+    for (const mccmsg::Device& d : current)
     {
-        auto j = std::find_if(dscr->connectedDevices().begin(), dscr->connectedDevices().end(), [d](const mccmsg::ProtocolId& id) { return id.device() == d->name(); });
-        if (j == dscr->connectedDevices().end())
-            disconnect(dscr->name(), d->name());
+        if (connected.find(d) == connected.end())
+            disconnect(dscr->name(), d);
     }
-    c->update(dscr);
+    _self->send(i->second.actor, dscr);
 }
 
-const CItemPtr& Connections::addChannel(const mccmsg::ChannelDescription& dscr)
+void Connections::addChannel(const mccmsg::ChannelDescription& dscr)
 {
     auto i = _channels.find(dscr->name());
     if (i == _channels.end())
     {
-        auto j = _channels.emplace(dscr->name(), new CItem(_asio, std::make_unique<Exchanger>(dscr->name(), _self, _logger), _self, dscr));
+        // asio side of channel sends packets, stats and state straight to channel actor
+        auto a = _self->spawn<ChannelActor>(_core, _self, dscr);
+        auto ptr = _asio->add(dscr, std::make_unique<Exchanger>(dscr->name(), a, _logger));
+        _self->send(a, ptr, _asio);
+        auto j = _channels.emplace(dscr->name(), CRoute{a, ptr->id(), false, false, std::set<mccmsg::Device>(), bmcl::None});
         i = j.first;
     }
 
     syncChannel(dscr);
     send_as(_self, _core, caf::atom("channel"), dscr->name());
-    i->second->sendIfYouCan();
-    return i->second;
 }
 
-bmcl::Option<CItemPtr&> Connections::getChannel(const mccmsg::Channel& name)
+bmcl::Option<caf::actor&> Connections::getChannel(const mccmsg::Channel& name)
 {
     auto i = _channels.find(name);
     if (i == _channels.end())
         return bmcl::None;
-    return i->second;
+    return i->second.actor;
+}
+
+void Connections::eraseChannel(CRoutes::iterator i)
+{
+    _self->send_exit(i->second.actor, caf::exit_reason::user_shutdown);
+    _asio->remove(i->second.id);
+    for (const mccmsg::Device& d : i->second.devices)
+    {
+        auto j = _devices.find(d);
+        if (j == _devices.end())
+            continue;
+        j->second->detach(i->first);
+        j->second->removeChannel(i->first);
+    }
+    _channels.erase(i);
 }
 
 void Connections::removeChannel(const mccmsg::Channel& name)
 {
-    _channels.erase(name);
-    for (const auto& i : _devices)
-        i.second->removeChannel(name);
+    auto i = _channels.find(name);
+    if (i == _channels.end())
+        return;
+    eraseChannel(i);
 }
 
 void Connections::sync(const mccmsg::ChannelDescriptions& ds)
@@ -169,44 +225,59 @@ void Connections::sync(const mccmsg::ChannelDescriptions& ds)
             ++i;
         else
         {
-            _channels.erase(i++);
+            eraseChannel(i++);
         }
     }
 }
 
-void Connections::channelActivate(const mccmsg::channel::Activate_RequestPtr& req, caf::response_promise&& rp)
+void Connections::channelActivated(const mccmsg::Channel& channel, bool isEnabled)
 {
-    const auto i = _channels.find(req->data()._name);
+    auto i = _channels.find(channel);
     if (i == _channels.end())
-    {
-        rp.deliver(mccmsg::make_error(mccmsg::Error::ChannelUnknown));
         return;
+    auto& c = i->second;
+    c.isEnabled = isEnabled;
+    // enabled channel reports that it is ready after request sent before disabling times out
+    c.isReady = false;
+    for (const mccmsg::Device& d : c.devices)
+    {
+        auto j = _devices.find(d);
+        if (j == _devices.end())
+            continue;
+        if (isEnabled)
+            j->second->addChannel(channel, c.actor);
+        else
+            j->second->removeChannel(channel);
     }
-
-    if (req->data()._state)
-        i->second->connect(req, std::move(rp));
-    else
-        i->second->disconnect(req, std::move(rp));
 }
 
-void Connections::channelActivated(const mccmsg::Channel& channel)
+void Connections::channelReady(const mccmsg::Channel& channel)
 {
-    const auto i = _channels.find(channel);
-    if (i == _channels.end())
+    auto i = _channels.find(channel);
+    if (i == _channels.end() || !i->second.isEnabled)
         return;
-    i->second->activated(true);
+    i->second.isReady = true;
+    sendIfYouCan(i->second);
 }
 
-void Connections::channelDeactivated(const mccmsg::Channel& channel, const caf::error& err)
+// devices of channel are served in turn, request of device is taken by whichever of its channels is ready first
+void Connections::sendIfYouCan(CRoute& c)
 {
-    const auto i = _channels.find(channel);
-    if (i == _channels.end())
+    if (!c.isEnabled || !c.isReady || c.devices.empty())
         return;
-    if (err)
+    auto i = c.lastDevice.isSome() ? c.devices.upper_bound(c.lastDevice.unwrap()) : c.devices.begin();
+    for (std::size_t n = 0; n < c.devices.size(); ++n, ++i)
     {
-        BMCL_WARNING() << "Ошибка соединения: " << _self->system().render(err);
+        if (i == c.devices.end())
+            i = c.devices.begin();
+        auto j = _devices.find(*i);
+        if (j == _devices.end() || !j->second->hasRequests())
+            continue;
+        c.lastDevice = *i;
+        c.isReady = false;
+        _self->send(c.actor, mccnet::req_atom::value, *i, std::move(j->second->popRequest().pkt));
+        return;
     }
-    i->second->activated(false);
 }
 
 void Connections::connect(const mccmsg::Channel& channel, const mccmsg::ProtocolId& id)
@@ -218,7 +289,13 @@ void Connections::connect(const mccmsg::Channel& channel, const mccmsg::Protocol
         return;
     }
     auto& c = i->second;
-    c->add_device(addDevice(id));
+    const DItemPtr& d = addDevice(id);
+    if (!c.devices.emplace(d->name()).second)
+        return;
+    d->attach(channel);
+    _self->send(c.actor, channel_attach_atom::value, id, d->actor());
+    if (c.isEnabled)
+        d->addChannel(channel, c.actor);
 }
 
 void Connections::disconnect(const mccmsg::Channel& channel, const mccmsg::Device& device)
@@ -226,7 +303,9 @@ void Connections::disconnect(const mccmsg::Channel& channel, const mccmsg::Devic
     auto i = _channels.find(channel);
     if (i == _channels.end())
         return;
-    i->second->remove_device(device);
+    if (i->second.devices.erase(device) == 0)
+        return;
+    _self->send(i->second.actor, channel_detach_atom::value, device);
 
     auto j = _devices.find(device);
     if (j == _devices.end())
@@ -234,6 +313,7 @@ void Connections::disconnect(const mccmsg::Channel& channel, const mccmsg::Devic
         assert(false);
         return;
     }
+    j->second->detach(channel);
     j->second->removeChannel(channel);
 }
 
@@ -245,39 +325,13 @@ void Connections::push(const mccmsg::Device& dev, Request&& req)
         BMCL_WARNING() << fmt::format("устройство {} преждевременно удалено из обменки!", dev.toStdString());
         return;
     }
-    i->second->pushRequest(std::move(req));
-}
-
-void Connections::pull(const mccmsg::Channel& c, mccmsg::PacketPtr&& pkt)
-{
-    auto i = _channels.find(c);
-    if (i == _channels.end())
-        return;
-    i->second->pull(std::move(pkt));
-}
-
-void Connections::timeout(const mccmsg::Channel& c)
-{
-    auto i = _channels.find(c);
-    if (i == _channels.end())
+    if (!i->second->pushRequest(std::move(req)))
         return;
-    i->second->timeout();
-}
-
-mccmsg::StatChannel Connections::stats(const mccmsg::Channel& c, const mccmsg::StatChannel& stats)
-{
-    auto i = _channels.find(c);
-    if (i == _channels.end())
-        return stats;
-    i->second->stats(stats);
-    return i->second->getStats();
-}
-
-bmcl::Option<mccmsg::StatChannel> Connections::getStats(const mccmsg::Channel& c)
-{
-    auto i = _channels.find(c);
-    if (i == _channels.end())
-        return bmcl::None;
-    return i->second->getStats();
-}
+    for (const auto& c : i->second->channels())
+    {
+        auto j = _channels.find(c.first);
+        if (j != _channels.end())
+            sendIfYouCan(j->second);
+    }
 }
+}
\ No newline at end of file
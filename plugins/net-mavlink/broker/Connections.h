@@ -1,4 +1,6 @@
 #pragma once
+#include <unordered_map>
+#include <bmcl/Option.h>
 #include "mcc/msg/ptr/Fwd.h"
 #include "mcc/msg/Packet.h"
 #include "mcc/net/Asio.h"
@@ -6,10 +8,22 @@
 
 #include "../broker/Broker.h"
 #include "../broker/Device.h"
-#include "../broker/Channel.h"
 
 namespace mccmav {
 
+// broker side of channel, framing happens in channel actor. Requests wait in queues of devices,
+// channel actor reports when it is ready to send next one
+struct CRoute
+{
+    caf::actor actor;
+    mccnet::ChannelId id;
+    bool isEnabled;
+    bool isReady;
+    std::set<mccmsg::Device> devices;
+    bmcl::Option<mccmsg::Device> lastDevice;
+};
+using CRoutes = std::map<mccmsg::Channel, CRoute>;
+
 class Connections
 {
 public:
@@ -21,34 +35,35 @@ public:
     void deviceDown(const caf::down_msg& dm);
     void removeDevice(const mccmsg::Device& d, const caf::error& reason);
     void removeAllDevices(const caf::error& reason);
+    // device actors are told only about change of active list
     void deviceActivated(const mccmsg::Device& device, bool isActive);
     const DItems& devices() const;
 
     void sync(const mccmsg::ChannelDescriptions& ds);
     void syncChannel(const mccmsg::ChannelDescription& dscr);
-    const CItemPtr& addChannel(const mccmsg::ChannelDescription& dscr);
-    bmcl::Option<CItemPtr&> getChannel(const mccmsg::Channel& name);
+    void addChannel(const mccmsg::ChannelDescription& dscr);
+    bmcl::Option<caf::actor&> getChannel(const mccmsg::Channel& name);
     void removeChannel(const mccmsg::Channel& name);
-    void channelActivate(const mccmsg::channel::Activate_RequestPtr& req, caf::response_promise&& rp);
-    void channelActivated(const mccmsg::Channel& channel);
-    void channelDeactivated(const mccmsg::Channel& channel, const caf::error& err);
+    void channelActivated(const mccmsg::Channel& channel, bool isEnabled);
+    void channelReady(const mccmsg::Channel& channel);
 
     void connect(const mccmsg::Channel& channel, const mccmsg::ProtocolId& id);
     void disconnect(const mccmsg::Channel& channel, const mccmsg::Device& device);
 
     void push(const mccmsg::Device& dev, Request&& req);
-    void pull(const mccmsg::Channel& c, mccmsg::PacketPtr&& pkt);
-    void timeout(const mccmsg::Channel& c);
-    mccmsg::StatChannel stats(const mccmsg::Channel& c, const mccmsg::StatChannel& stats);
-    bmcl::Option<mccmsg::StatChannel> getStats(const mccmsg::Channel& c);
 
 private:
-    mccnet::Asio _asio;
+    void eraseChannel(CRoutes::iterator i);
+    void sendIfYouCan(CRoute& c);
+    void sendActivatedChange(std::size_t id, bool isActive);
+
+    std::shared_ptr<mccnet::Asio> _asio;
     caf::actor  _core;
     caf::actor  _logger;
     caf::actor  _group;
     Broker*     _self;
     DItems _devices;
-    CItems _channels;
+    std::unordered_map<caf::actor_addr, mccmsg::Device> _deviceAddrs;
+    CRoutes _channels;
 };
 }
\ No newline at end of file
@@ -2,8 +2,8 @@
 #include "mcc/net/NetLoggerInf.h"
 
 #include "../broker/Device.h"
-#include "../broker/Channel.h"
 
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::Device);
 CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::PacketPtr);
 
 namespace mccmav {
@@ -17,11 +17,11 @@ DItem::~DItem()
     BMCL_DEBUG() << "Устройство удалёно из брокера: " << _id.device().toStdString();
 }
 
-void DItem::addChannel(const CItemPtr& c)
+void DItem::addChannel(const mccmsg::Channel& name, const caf::actor& c)
 {
     if (!hasChannels())
         _self->send(_a, mccnet::connected_atom::value);
-    cs.emplace(c->name(), c);
+    cs.emplace(name, c);
 }
 
 void DItem::removeChannel(const mccmsg::Channel& c)
@@ -31,17 +31,13 @@ void DItem::removeChannel(const mccmsg::Channel& c)
         _self->send(_a, mccnet::disconnected_atom::value);
 }
 
-void DItem::pushRequest(Request&& r)
+bool DItem::pushRequest(Request&& r)
 {
     if (!hasChannels())
-        return;
+        return false;
 
     queue.push_back(std::move(r));
-    if (queue.size() > 1)
-        return;
-
-    for (const auto& i : cs)
-        i.second->sendIfYouCan();
+    return queue.size() == 1;
 }
 
 Request DItem::popRequest()
@@ -52,11 +48,6 @@ Request DItem::popRequest()
     return r;
 }
 
-void DItem::pull(const mccmsg::PacketPtr& pkt)
-{
-    _self->send(_a, pkt);
-}
-
 void DItem::activated(bool isActive)
 {
     _isActive = isActive;
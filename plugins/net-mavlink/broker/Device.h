@@ -1,4 +1,6 @@
 #pragma once
+#include <map>
+#include <set>
 #include "mcc/msg/ptr/Fwd.h"
 #include "mcc/msg/ptr/Protocol.h"
 #include "mcc/msg/ptr/Tm.h"
@@ -8,10 +10,6 @@
 
 namespace mccmav {
 
-class CItem;
-using CItemPtr = mcc::Rc<CItem>;
-using CItems = std::map<mccmsg::Channel, CItemPtr>;
-
 class DItem : public mcc::RefCountable
 {
 public:
@@ -26,17 +24,23 @@ public:
     inline bool hasChannels() const { return !cs.empty(); }
     inline bool hasRequests() const { return !queue.empty(); }
     inline bool isActive() const { return _isActive; }
+    // channels device is attached to, enabled or not
+    inline const std::set<mccmsg::Channel>& attachedChannels() const { return _attached; }
+    inline bool attach(const mccmsg::Channel& c) { return _attached.emplace(c).second; }
+    inline bool detach(const mccmsg::Channel& c) { return _attached.erase(c) != 0; }
 
     void activated(bool isActive);
-    void addChannel(const CItemPtr& c);
+    void addChannel(const mccmsg::Channel& name, const caf::actor& c);
     void removeChannel(const mccmsg::Channel& c);
-    void pushRequest(Request&& r);
+    inline const std::map<mccmsg::Channel, caf::actor>& channels() const { return cs; }
+    // returns true if queue was empty, so free channels of device have to be asked to send it
+    bool pushRequest(Request&& r);
     Request popRequest();
-    void pull(const mccmsg::PacketPtr& pkt);
 private:
     bool _isActive;
     Queue queue;
-    CItems cs;
+    std::map<mccmsg::Channel, caf::actor> cs;
+    std::set<mccmsg::Channel> _attached;
     caf::actor _a;
     mccmsg::ProtocolId _id;
     caf::event_based_actor* _self;
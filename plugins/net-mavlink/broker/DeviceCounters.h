@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <bmcl/TimeUtils.h>
+#include "mcc/msg/Stats.h"
+
+#include "../device/Mavlink.h"
+
+namespace mccmav {
+
+// Received packets of every mavlink system id seen on channel, attached or not.
+// Counters are kept in flat array indexed by DeviceId, so counting packet never allocates
+class DeviceCounters
+{
+public:
+    static constexpr std::size_t maxDevices = 256;
+
+    DeviceCounters()
+    {
+        _seen.reserve(maxDevices);
+    }
+
+    inline void add(DeviceId id, std::size_t bytes)
+    {
+        Counter& c = _counters[id];
+        if (!c.isSeen)
+        {
+            c.isSeen = true;
+            _seen.push_back(id);
+        }
+        c.bytes += bytes;
+        c.packets++;
+    }
+
+    // time of stat is time of first snapshot after counter has changed
+    void snapshot(std::map<mccmsg::DeviceId, mccmsg::Stat>* devices)
+    {
+        bmcl::SystemTime now = bmcl::SystemClock::now();
+        for (DeviceId id : _seen)
+        {
+            Counter& c = _counters[id];
+            if (c.packets != c.snapshotPackets)
+            {
+                c.snapshotPackets = c.packets;
+                c.time = now;
+            }
+            mccmsg::Stat& s = (*devices)[id];
+            s._packets = c.packets;
+            s._bytes = c.bytes;
+            s._time = c.time;
+        }
+    }
+
+    void reset()
+    {
+        for (DeviceId id : _seen)
+            _counters[id] = Counter();
+        _seen.clear();
+    }
+
+private:
+    struct Counter
+    {
+        bool isSeen = false;
+        std::size_t packets = 0;
+        std::size_t bytes = 0;
+        std::size_t snapshotPackets = 0;
+        bmcl::SystemTime time;
+    };
+
+    std::array<Counter, maxDevices> _counters;
+    std::vector<DeviceId> _seen;
+};
+}
@@ -317,6 +317,15 @@ caf::behavior Device::make_behavior()
             _activeDevices = devs;
             std::sort(_activeDevices.begin(), _activeDevices.end());
         }
+      , [this](mccnet::activated_change_atom, std::size_t dev, bool isActive)
+        {
+            auto i = std::lower_bound(_activeDevices.begin(), _activeDevices.end(), dev);
+            bool isListed = i != _activeDevices.end() && *i == dev;
+            if (isActive && !isListed)
+                _activeDevices.insert(i, dev);
+            else if (!isActive && isListed)
+                _activeDevices.erase(i);
+        }
       , [this](mccnet::group_cmd_new, const mccmsg::Group& group, const std::vector<std::size_t>& devs)
         {
             return mccmsg::make_error(mccmsg::Error::NotImplemented);
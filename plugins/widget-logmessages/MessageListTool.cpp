@@ -1,5 +1,6 @@
 #include "MessageListTool.h"
 
+#include "mcc/ide/models/LogMessagesFilterModel.h"
 #include "mcc/ide/models/LogMessagesModel.h"
 #include "mcc/msg/ptr/Tm.h"
 #include "mcc/uav/UavController.h"
@@ -14,49 +15,12 @@
 #include <QLineEdit>
 #include <QMenu>
 #include <QMenu>
-#include <QSortFilterProxyModel>
 #include <QStyle>
 #include <QTreeWidget>
 #include <QVBoxLayout>
 #include <QWidget>
 #include <QtGlobal>
 
-class MySortModel : public QSortFilterProxyModel
-{
-public:
-    explicit MySortModel(QObject *parent = 0)
-        : QSortFilterProxyModel(parent)
-    {
-        setLogLevel(bmcl::LogLevel::Debug);
-    }
-
-    void setLogLevel(bmcl::LogLevel logLevel)
-    {
-        beginResetModel();
-        _logLevel = logLevel;
-        endResetModel();
-    }
-protected:
-    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
-    {
-        QModelIndex index0 = sourceModel()->index(sourceRow, 0, sourceParent);
-        QModelIndex index1 = sourceModel()->index(sourceRow, 1, sourceParent);
-        QModelIndex index2 = sourceModel()->index(sourceRow, 2, sourceParent);
-        QModelIndex index3 = sourceModel()->index(sourceRow, 3, sourceParent);
-
-        int logLevel = sourceModel()->data(index0, mccide::LogMessagesModel::LogLevel).toInt();
-        if (logLevel > (int)_logLevel)
-            return false;
-
-        return (sourceModel()->data(index0).toString().contains(filterRegExp())
-            || sourceModel()->data(index1).toString().contains(filterRegExp())
-            || sourceModel()->data(index2).toString().contains(filterRegExp())
-            || sourceModel()->data(index3).toString().contains(filterRegExp()));
-    }
-private:
-    bmcl::LogLevel _logLevel;
-};
-
 MessageListTool::MessageListTool(mccuav::UavController* uavController, QWidget* parent)
     : QWidget(parent)
     , _uavController(uavController)
@@ -75,8 +39,7 @@ MessageListTool::MessageListTool(mccuav::UavController* uavController, QWidget*
     _filterLine = new QLineEdit(this);
     _filterLine->setPlaceholderText("Введите строку поиска...");
 
-    _proxyModel = new MySortModel(this);
-    _proxyModel->setSourceModel(_logModel);
+    _proxyModel = new mccide::LogMessagesFilterModel(_logModel, this);
 
     _messagesTree->setModel(_proxyModel);
 
@@ -15,8 +15,8 @@ class QComboBox;
 
 namespace mccide {
 class LogMessagesModel;
+class LogMessagesFilterModel;
 }
-class MySortModel;
 
 class MessageListTool : public QWidget
 {
@@ -35,5 +35,5 @@ private:
     QTreeView*                          _messagesTree;
     QLineEdit*                          _filterLine;
     mccide::LogMessagesModel*           _logModel;
-    MySortModel*                        _proxyModel;
+    mccide::LogMessagesFilterModel*     _proxyModel;
 };
@@ -6,17 +6,21 @@
 #include <QString>
 #include <QFont>
 
+#include <algorithm>
+
 using mccui::CoordinateSystemController;
 
 MissionPlanModel::MissionPlanModel(const mccui::CoordinateSystemController* csController)
     : _route(nullptr)
     , _enabled(false)
     , _activePoint(-1)
+    , _isMovingRow(false)
     , _csController(csController)
 {
     connect(_csController.get(), &CoordinateSystemController::changed, this, [this](){
-        beginResetModel();
-        endResetModel();
+        emit headerDataChanged(Qt::Horizontal, 0, columnCount() - 1);
+        if (rowCount() > 0)
+            emitRowsChanged(0, rowCount() - 1);
     });
 }
 
@@ -233,42 +237,58 @@ void MissionPlanModel::setRoute(mccuav::Route* route)
         [this](const mccmsg::Waypoint& waypoint, int index)
     {
         Q_UNUSED(waypoint);
-        dataChanged(this->index(index, 0), this->index(index, columnCount()));
-    })
-        ;
+        emitRowsChanged(index, index);
+    });
 
     connect(_route, &Route::waypointOnlyAltChanged, this,
             [this](const mccmsg::Waypoint& waypoint, int index)
     {
-        dataChanged(this->index(index, 0), this->index(index, columnCount()));
-    }
-    );
+        Q_UNUSED(waypoint);
+        emitRowsChanged(index, index);
+    });
+
+    // rows after changed one are renumbered, so index column is updated too
+    connect(_route, &Route::waypointAboutToBeInserted, this,
+        [this](int index)
+    {
+        beginInsertRows(QModelIndex(), index, index);
+    });
 
     connect(_route, &Route::waypointInserted, this,
         [this](const mccmsg::Waypoint& waypoint, int index)
     {
         Q_UNUSED(waypoint);
-        Q_UNUSED(index);
-        beginResetModel();
-        endResetModel();
-    })
-        ;
+        endInsertRows();
+        emitIndexesChanged(index + 1);
+    });
+
+    connect(_route, &Route::waypointAboutToBeRemoved, this,
+        [this](int index)
+    {
+        beginRemoveRows(QModelIndex(), index, index);
+    });
 
     connect(_route, &Route::waypointRemoved, this,
         [this](int index)
     {
-        Q_UNUSED(index);
-        beginResetModel();
-        endResetModel();
+        endRemoveRows();
+        emitIndexesChanged(index);
+    });
+
+    connect(_route, &Route::waypointAboutToBeMoved, this,
+        [this](int oldIndex, int newIndex)
+    {
+        int destination = newIndex > oldIndex ? newIndex + 1 : newIndex;
+        _isMovingRow = beginMoveRows(QModelIndex(), oldIndex, oldIndex, QModelIndex(), destination);
     });
 
     connect(_route, &Route::waypointMoved, this,
         [this](int oldIndex, int newIndex)
     {
-        Q_UNUSED(oldIndex);
-        Q_UNUSED(newIndex);
-        beginResetModel();
-        endResetModel();
+        if (_isMovingRow)
+            endMoveRows();
+        _isMovingRow = false;
+        emitRowsChanged(std::min(oldIndex, newIndex), std::max(oldIndex, newIndex));
     });
 
     connect(_route, &Route::allWaypointsChanged, this, [this]()
@@ -280,50 +300,64 @@ void MissionPlanModel::setRoute(mccuav::Route* route)
     connect(_route, &Route::activeWaypointChanged, this,
         [this](bmcl::Option<std::size_t> index)
         {
+            int oldPoint = _activePoint;
             if (index.isSome())
                 _activePoint = (int)index.unwrap();
             else
                 _activePoint = -1;
 
-            beginResetModel();
-            endResetModel();
+            if (oldPoint >= 0 && oldPoint < rowCount())
+                emitRowsChanged(oldPoint, oldPoint, QVector<int>() << Qt::FontRole);
+            if (_activePoint >= 0 && _activePoint < rowCount())
+                emitRowsChanged(_activePoint, _activePoint, QVector<int>() << Qt::FontRole);
         }
     );
 
-    connect(_route, &Route::selectedWaypointsChanged, this,
-            [this]()
+    connect(_route, &Route::waypointsSelectionChanged, this,
+            [this](std::size_t first, std::size_t last, bool selected)
             {
-                emit dataChanged(index(0, 0), index(rowCount(), columnCount()), QVector<int>() << Qt::BackgroundRole);
+                Q_UNUSED(selected);
+                int lastRow = std::min<int>(last, rowCount() - 1);
+                if ((int)first <= lastRow)
+                    emitRowsChanged(first, lastRow, QVector<int>() << Qt::BackgroundRole);
             }
     );
 }
 
+void MissionPlanModel::emitRowsChanged(int first, int last, const QVector<int>& roles)
+{
+    emit dataChanged(index(first, 0), index(last, columnCount() - 1), roles);
+}
+
+void MissionPlanModel::emitIndexesChanged(int first)
+{
+    if (first < rowCount())
+        emit dataChanged(index(first, (int)Columns::Index), index(rowCount() - 1, (int)Columns::Index));
+}
+
 void MissionPlanModel::moveWaypointUp(int index)
 {
-    beginResetModel();
     _route->moveWaypointUp(index);
-    endResetModel();
 }
 
 void MissionPlanModel::moveWaypointDown(int index)
 {
-    beginResetModel();
     _route->moveWaypointDown(index);
-    endResetModel();
 }
 
 void MissionPlanModel::removeWaypoint(int index)
 {
-    beginResetModel();
     _route->removeWaypoint(index);
-    endResetModel();
 }
 
 void MissionPlanModel::setEnabled(bool mode)
 {
+    if (_enabled == mode)
+        return;
     _enabled = mode;
-    beginResetModel();
-    endResetModel();
+    // only item flags depend on this
+    if (rowCount() > 0)
+        emitRowsChanged(0, rowCount() - 1);
 }
 
 void MissionPlanModel::setEmptyRoute()
@@ -49,8 +49,12 @@ public slots:
     void removeWaypoint(int index);
 
 private:
+    void emitRowsChanged(int first, int last, const QVector<int>& roles = QVector<int>());
+    void emitIndexesChanged(int first);
+
     mccuav::Route* _route;
     bool _enabled;
     int _activePoint;
+    bool _isMovingRow;
     mccuav::Rc<const mccui::CoordinateSystemController> _csController;
 };
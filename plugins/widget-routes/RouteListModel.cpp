@@ -29,14 +29,10 @@ void RouteListModel::setDevice(mccuav::Uav* dev)
     connect(_device, &mccuav::Uav::activeRouteChanged, this, &RouteListModel::activeRouteChanged);
 
     for (auto route : _device->routes())
-    {
-        connect(route, &mccuav::Route::userVisibilityFlagChanged,     this, &RouteListModel::routeVisibilityChanged);
-        connect(route, &mccuav::Route::readOnlyFlagChanged,       this, &RouteListModel::routeVisibilityChanged);
-        connect(route, &mccuav::Route::enabledFlagChanged,        this, &RouteListModel::routeEnabledChanged);
-        connect(route, &mccuav::Route::hiddenFlagChanged, this, &RouteListModel::routeHiddenChanged);
-    }
+        connectRoute(route);
 
     beginResetModel();
+    _routes = _device->routes();
     endResetModel();
 }
 
@@ -48,20 +44,40 @@ void RouteListModel::setEmptyDevice()
         disconnect(_device, &mccuav::Uav::routeRemoved, this, &RouteListModel::routeRemoved);
         disconnect(_device, &mccuav::Uav::activeRouteChanged, this, &RouteListModel::activeRouteChanged);
 
-        for (auto route : _device->routes())
-        {
-            disconnect(route, &mccuav::Route::userVisibilityFlagChanged, this, &RouteListModel::routeVisibilityChanged);
-            disconnect(route, &mccuav::Route::readOnlyFlagChanged, this, &RouteListModel::routeVisibilityChanged);
-            disconnect(route, &mccuav::Route::enabledFlagChanged, this, &RouteListModel::routeEnabledChanged);
-            disconnect(route, &mccuav::Route::hiddenFlagChanged, this, &RouteListModel::routeHiddenChanged);
-        }
+        for (auto route : _routes)
+            disconnectRoute(route);
     }
 
     _device = nullptr;
     beginResetModel();
+    _routes.clear();
     endResetModel();
 }
 
+void RouteListModel::connectRoute(mccuav::Route* route)
+{
+    connect(route, &mccuav::Route::userVisibilityFlagChanged, this, &RouteListModel::routeVisibilityChanged);
+    connect(route, &mccuav::Route::readOnlyFlagChanged, this, &RouteListModel::routeVisibilityChanged);
+    connect(route, &mccuav::Route::enabledFlagChanged, this, &RouteListModel::routeEnabledChanged);
+    connect(route, &mccuav::Route::hiddenFlagChanged, this, &RouteListModel::routeHiddenChanged);
+}
+
+void RouteListModel::disconnectRoute(mccuav::Route* route)
+{
+    disconnect(route, &mccuav::Route::userVisibilityFlagChanged, this, &RouteListModel::routeVisibilityChanged);
+    disconnect(route, &mccuav::Route::readOnlyFlagChanged, this, &RouteListModel::routeVisibilityChanged);
+    disconnect(route, &mccuav::Route::enabledFlagChanged, this, &RouteListModel::routeEnabledChanged);
+    disconnect(route, &mccuav::Route::hiddenFlagChanged, this, &RouteListModel::routeHiddenChanged);
+}
+
+void RouteListModel::emitRouteChanged(mccuav::Route* route)
+{
+    int row = _routes.indexOf(route);
+    if (row < 0)
+        return;
+    emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+}
+
 QVariant RouteListModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
     if (role != Qt::DisplayRole)
@@ -102,10 +118,7 @@ Qt::ItemFlags RouteListModel::flags(const QModelIndex& index) const
 int RouteListModel::rowCount(const QModelIndex& parent) const
 {
     Q_UNUSED(parent);
-    if (_device == nullptr)
-        return 0;
-
-    return _device->routes().count();
+    return _routes.count();
 }
 
 int RouteListModel::columnCount(const QModelIndex& parent) const
@@ -119,17 +132,15 @@ QVariant RouteListModel::data(const QModelIndex& index, int role) const
     if (!index.isValid())
         return QVariant();
 
-    const auto& routes = _device->routes();
-
     int routeIndex = index.row();
 
-    if (routeIndex >= routes.count())
+    if (routeIndex >= _routes.count())
     {
         Q_ASSERT(false);
         return QVariant();
     }
 
-    auto route = routes[routeIndex];
+    auto route = _routes[routeIndex];
 
     bool isActiveRoute = (_device->activeRoute() == route);
     bool isSelectedRoute = (_device->selectedRoute() != nullptr && route->id() == _device->selectedRoute()->id());
@@ -207,16 +218,15 @@ bool RouteListModel::setData(const QModelIndex& index, const QVariant& value, in
     qDebug() << value;
     if (role == Qt::CheckStateRole && index.column() == 2)
     {
-        const auto& routes = _device->routes();
         int routeIndex = index.row();
 
-        if (routeIndex >= routes.count())
+        if (routeIndex >= _routes.count())
         {
             Q_ASSERT(false);
             return false;
         }
 
-        auto route = routes[routeIndex];
+        auto route = _routes[routeIndex];
         bool isVisible = data(index, RouteVisibility).toBool();
 
         route->setUserVisibility(!isVisible);
@@ -228,49 +238,50 @@ bool RouteListModel::setData(const QModelIndex& index, const QVariant& value, in
 
 void RouteListModel::routeAdded(mccuav::Route* route)
 {
-    connect(route, &mccuav::Route::userVisibilityFlagChanged, this, &RouteListModel::routeVisibilityChanged);
-    connect(route, &mccuav::Route::readOnlyFlagChanged, this, &RouteListModel::routeVisibilityChanged);
-    connect(route, &mccuav::Route::enabledFlagChanged, this, &RouteListModel::routeEnabledChanged);
-    connect(route, &mccuav::Route::hiddenFlagChanged, this, &RouteListModel::routeHiddenChanged);
-    beginResetModel();
-    endResetModel();
+    connectRoute(route);
+
+    int row = _device->routes().indexOf(route);
+    if (row < 0 || row > _routes.count())
+        row = _routes.count();
+    beginInsertRows(QModelIndex(), row, row);
+    _routes.insert(row, route);
+    endInsertRows();
 }
 
 void RouteListModel::routeRemoved(mccuav::Route* route)
 {
-    disconnect(route, &mccuav::Route::userVisibilityFlagChanged, this, &RouteListModel::routeVisibilityChanged);
-    disconnect(route, &mccuav::Route::readOnlyFlagChanged, this, &RouteListModel::routeVisibilityChanged);
-    disconnect(route, &mccuav::Route::enabledFlagChanged, this, &RouteListModel::routeEnabledChanged);
-    disconnect(route, &mccuav::Route::hiddenFlagChanged, this, &RouteListModel::routeHiddenChanged);
-
-    beginResetModel();
-    endResetModel();
+    disconnectRoute(route);
+
+    int row = _routes.indexOf(route);
+    if (row < 0)
+        return;
+    beginRemoveRows(QModelIndex(), row, row);
+    _routes.remove(row);
+    endRemoveRows();
 }
 
 void RouteListModel::activeRouteChanged(mccuav::Route* route)
 {
     Q_UNUSED(route);
-    beginResetModel();
-    endResetModel();
+    if (_routes.isEmpty())
+        return;
+    emit dataChanged(index(0, 0), index(_routes.count() - 1, columnCount() - 1), {Qt::DecorationRole, Qt::FontRole});
 }
 
 void RouteListModel::routeVisibilityChanged(bool visible)
 {
     Q_UNUSED(visible);
-    beginResetModel();
-    endResetModel();
+    emitRouteChanged(qobject_cast<mccuav::Route*>(sender()));
 }
 
 void RouteListModel::routeEnabledChanged(bool enabled)
 {
     Q_UNUSED(enabled);
-    beginResetModel();
-    endResetModel();
+    emitRouteChanged(qobject_cast<mccuav::Route*>(sender()));
 }
 
 void RouteListModel::routeHiddenChanged(bool enabled)
 {
     Q_UNUSED(enabled);
-    beginResetModel();
-    endResetModel();
+    emitRouteChanged(qobject_cast<mccuav::Route*>(sender()));
 }
@@ -6,6 +6,7 @@
 #include <QAbstractTableModel>
 #include <QIcon>
 #include <QFont>
+#include <QVector>
 
 class RouteListModel : public QAbstractTableModel
 {
@@ -41,7 +42,13 @@ private slots:
     void routeHiddenChanged(bool enabled);
 
 private:
+    void connectRoute(mccuav::Route* route);
+    void disconnectRoute(mccuav::Route* route);
+    void emitRouteChanged(mccuav::Route* route);
+
     mccuav::Uav* _device;
+    // routes as currently shown, Uav emits signals after its list is already changed
+    QVector<mccuav::Route*> _routes;
 
     QFont _boldFont;
     QIcon _activeRouteIcon;
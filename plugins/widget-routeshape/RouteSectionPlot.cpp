@@ -9,11 +9,15 @@
 #include "mcc/ui/HeightmapController.h"
 #include "mcc/uav/Uav.h"
 #include "mcc/vis/RadarGroup.h"
+#include "mcc/vis/RadarTerrainCache.h"
 #include "mcc/geo/Constants.h"
+#include "mcc/msg/TmView.h"
+#include "mcc/msg/exts/Position.h"
 
 #include <bmcl/Logging.h>
 #include <bmcl/DoubleEq.h>
 
+#include <algorithm>
 #include <cfloat>
 #include <limits>
 
@@ -151,6 +155,7 @@ RouteSectionPlot::RouteSectionPlot(mccui::Settings* settings,
     , _geod(mccgeo::wgs84a<double>(), mccgeo::wgs84f<double>())
 {
     _hmReader = new mcchm::EmptyHmReader;
+    _radarTerrain.reset(new mccvis::RadarTerrainCache(_hmReader.get(), _geod));
 
     _track->setSamples(new PointVectorRefData(&_trackPoints));
     setObjectName("Профиль маршрута");
@@ -230,8 +235,10 @@ void RouteSectionPlot::setHeightmapController(bmcl::OptionPtr<const mccui::Heigh
     if (hmController.isSome()) {
         _hmController = hmController;
         _hmReader = _hmController->cloneHeightmapReader();
+        _radarTerrain->setReader(_hmReader.get());
         connect(_hmController.unwrap().get(), &mccui::HeightmapController::heightmapReaderChanged, this, [this](const bmcl::Rc<const mcchm::HmReader>& reader) {
             _hmReader = reader;
+            _radarTerrain->setReader(_hmReader.get());
             recalcData();
         });
     }
@@ -265,6 +272,7 @@ void RouteSectionPlot::recalcData()
     _srtmDistance.clear();
     _srtmAlt.clear();
     _frenelVisZs.clear();
+    _totalProfile.clear();
     _trackPoints.clear();
 
     if (!_route || _route->waypointsCount() == 0) {
@@ -321,6 +329,7 @@ void RouteSectionPlot::recalcData()
     }
 
     drawRoute(routeProfiles);
+    rebuildTrack();
 }
 
 void RouteSectionPlot::recalcDataOnlyAlt()
@@ -376,66 +385,10 @@ void RouteSectionPlot::recalcDataOnlyAlt()
 }
 
 
-static std::vector<mccvis::Point> visionArea(const mccvis::RadarPtr& radar,
-                                             const mcchm::HmReader* handler,
-                                             const mccgeo::Geod& geod,
-                                             const std::vector<mccgeo::PositionAndDistance>& profile)
-{
-    std::vector<mccvis::Point> top;
-    top.reserve(profile.size()); //worst case
-    std::vector<mccvis::Point> bot;
-    bot.reserve(profile.size()); //worst case
-
-    const auto& _params = radar->viewParams();
-    const auto& _position = radar->position();
-
-    for (const mccgeo::PositionAndDistance& pAd : profile) {
-        const mccgeo::Position& point = pAd.position();
-        double d = 0;
-        double a1 = 0;
-        double a2 = 0;
-        geod.inverse(_position, point.latLon(), &d, &a1, &a2);
-        if (d > _params.maxBeamDistance || d < _params.minBeamDistance) {
-            continue;
-        }
-        double a1norm = a1;
-        while (a1norm < _params.minAzimuth) {
-            a1norm += 360;
-        }
-        if (!(a1norm >= _params.minAzimuth && a1norm <= _params.maxAzimuth)) {
-            continue;
-        }
-        mccgeo::LatLon newEnd;
-        geod.direct(_position, a1, d, &newEnd, &a2);
-
-        std::vector<mccvis::Point> slice;
-        if (_params.useCalcStep) {
-            double step = std::max(90.0, _params.calcStep);
-            slice = handler->relativePointProfile(_position, newEnd, step);
-        } else {
-            slice = handler->relativePointProfileAutostep(_position, newEnd);
-        }
-
-        slice.push_back(mccvis::Point(d, point.altitude()));
-        mccvis::Profile vI(a1norm, slice, _params);
-        bmcl::Option<std::pair<double, double>> interval = vI.verticalVisionIntervalAt(d);
-
-        if (interval.isSome()) {
-            double botP = interval->first;
-            double topP = interval->second;
-            bot.emplace_back(pAd.distance() / 1000, botP);
-            top.emplace_back(pAd.distance() / 1000, topP);
-        }
-    }
-    bot.insert(bot.end(), top.rbegin(), top.rend());
-    return bot;
-}
-
-
 void RouteSectionPlot::drawRoute(const std::vector<std::vector<mccgeo::PositionAndDistance>>& routeProfiles)
 {
     double totalDistance = 0;
-    std::vector<mccgeo::PositionAndDistance> totalProfile;
+    std::vector<mccgeo::PositionAndDistance>& totalProfile = _totalProfile;
     totalProfile.reserve(routeProfiles.size());
     for (const auto& profile : routeProfiles) {
         for (const mccgeo::PositionAndDistance& pAd : profile) {
@@ -457,7 +410,7 @@ void RouteSectionPlot::drawRoute(const std::vector<std::vector<mccgeo::PositionA
     if (_radarGroup.isSome()) {
         for (auto& rad : _radarGroup.unwrap()->radars()) {
             QColor color = QColor::fromRgba(rad->viewParams().viewZonesColorArgb);
-            _frenelVisZs.emplace_back(visionArea(rad, _hmReader.get(), _geod, totalProfile), std::move(color));
+            _frenelVisZs.emplace_back(rad.get(), _radarTerrain->visionArea(rad.get(), totalProfile), std::move(color));
         }
     }
 
@@ -465,6 +418,19 @@ void RouteSectionPlot::drawRoute(const std::vector<std::vector<mccgeo::PositionA
     resetPlotData();
 }
 
+void RouteSectionPlot::updateRadar(const mccvis::Radar* radar)
+{
+    auto it = std::find_if(_frenelVisZs.begin(), _frenelVisZs.end(), [radar](const VisCurve& z) { return z.radar == radar; });
+    if (it == _frenelVisZs.end()) {
+        recalcData();
+        return;
+    }
+    // only changed radar is recomputed, terrain under its rays is reused if position is the same
+    it->points = _radarTerrain->visionArea(radar, _totalProfile);
+    it->color = QColor::fromRgba(radar->viewParams().viewZonesColorArgb);
+    resetPlotData();
+}
+
 void RouteSectionPlot::resetPlotData()
 {
     auto size = _distances.size();
@@ -577,9 +543,37 @@ void RouteSectionPlot::rescale()
     setAxisScale(QwtPlot::yLeft, yMin, yMax);
 }
 
-void RouteSectionPlot::clearTrack()
+// track is relative to route, so it is projected again from position history of vehicle
+// when route or vehicle changes. Newest _trackLen distinct positions are taken as drawDevice() would add them
+void RouteSectionPlot::rebuildTrack()
 {
     _trackPoints.clear();
+    if (!_currentUav || !_route || _currentUav->tmStorage().isNull())
+        return;
+    auto ext = _currentUav->tmStorage()->getExtension<mccmsg::TmPosition>();
+    if (ext.isNone())
+        return;
+    auto history = ext->history();
+    if (history.isNone())
+        return;
+
+    std::vector<mccgeo::Position> positions;
+    for (std::size_t i = history->size(); i > 0 && positions.size() < std::size_t(_trackLen); i--)
+    {
+        mccgeo::Position p(history->valueAt(i - 1, 0), history->valueAt(i - 1, 1), history->valueAt(i - 1, 2));
+        if (positions.empty() || positions.back() != p)
+            positions.push_back(p);
+    }
+    _trackPoints.reserve(positions.size());
+    for (auto i = positions.rbegin(); i != positions.rend(); ++i)
+    {
+        double fromRouteDist = -1;
+        double onRouteDist = -1;
+        relativeProfileDistanses(*i, *_route, &onRouteDist, &fromRouteDist);
+        _trackPoints.emplace_back(onRouteDist, i->altitude());
+    }
+    _track->setPen(Qt::red, 1);
+    _track->attach(this);
 }
 
 void RouteSectionPlot::updateSelectedWaypoints()
@@ -604,11 +598,11 @@ void RouteSectionPlot::connectAll()
     if (!_route) {
         return;
     }
-    connect(_route, &Route::waypointChanged, this, [this](const mccmsg::Waypoint&, int) { recalcData(); clearTrack(); });
-    connect(_route, &Route::waypointMoved, this, [this](int, int) { recalcData(); clearTrack(); });
-    connect(_route, &Route::waypointRemoved, this, [this](int) { recalcData(); clearTrack(); });
-    connect(_route, &Route::waypointInserted, this, [this](const mccmsg::Waypoint&, int) { recalcData(); clearTrack(); });
-    connect(_route, &Route::allWaypointsChanged, this, [this]() { recalcData(); clearTrack(); });
+    connect(_route, &Route::waypointChanged, this, [this](const mccmsg::Waypoint&, int) { recalcData(); });
+    connect(_route, &Route::waypointMoved, this, [this](int, int) { recalcData(); });
+    connect(_route, &Route::waypointRemoved, this, [this](int) { recalcData(); });
+    connect(_route, &Route::waypointInserted, this, [this](const mccmsg::Waypoint&, int) { recalcData(); });
+    connect(_route, &Route::allWaypointsChanged, this, [this]() { recalcData(); });
     connect(_route, &Route::closedPathFlagChanged, this, [this](bool) { recalcData(); });
     connect(_route, &Route::waypointOnlyAltChanged, this, [this](void) { recalcDataOnlyAlt(); });
     connect(_route, &Route::activeWaypointChanged, this, [this](void) { recalcDataOnlyAlt(); });
@@ -621,9 +615,9 @@ void RouteSectionPlot::connectAll()
     if (_radarGroup.isSome()) {
         auto r = _radarGroup->get();
         connect(r, &mccvis::RadarGroup::radarAdded, this, [this]() { recalcData(); });
-        connect(r, &mccvis::RadarGroup::radarRemoved, this, [this]() { recalcData(); });
-        connect(r, &mccvis::RadarGroup::radarsReset, this, [this]() { recalcData(); });
-        connect(r, &mccvis::RadarGroup::radarUpdated, this, [this]() { recalcData(); });
+        connect(r, &mccvis::RadarGroup::radarRemoved, this, [this](const mccvis::RadarPtr& radar) { _radarTerrain->remove(radar.get()); recalcData(); });
+        connect(r, &mccvis::RadarGroup::radarsReset, this, [this]() { _radarTerrain->clear(); recalcData(); });
+        connect(r, &mccvis::RadarGroup::radarUpdated, this, [this](const mccvis::RadarPtr& radar) { updateRadar(radar.get()); });
     }
 
     _settings->onChange("map/heightMapCachePath", this, [this](const QVariant& value) {
@@ -640,6 +634,9 @@ void RouteSectionPlot::reconnectDevice()
     if (_currentUav)
         disconnect(_currentUav, 0, this, 0);
     _currentUav = curDevice;
+    _lastPosition = bmcl::None;
+    rebuildTrack();
+    replot();
 }
 
 void RouteSectionPlot::drawDevice()
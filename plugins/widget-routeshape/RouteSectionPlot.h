@@ -61,10 +61,11 @@ private:
     void recalcDataOnlyAlt();
     void resetPlotData();
     void rescale();
-    void clearTrack();
+    void rebuildTrack();
     void updateSelectedWaypoints();
 
     void drawRoute(const std::vector<std::vector<mccgeo::PositionAndDistance>>& routeProfiles);
+    void updateRadar(const mccvis::Radar* radar);
 
     QSize sizeHint() const override;
     QSize minimumSizeHint() const override;
@@ -81,17 +82,21 @@ private:
     std::vector<double> _srtmDistance;
 
     struct VisCurve {
-        VisCurve(std::vector<mccvis::Point>&& points, QColor&& color)
-            : points(std::move(points))
+        VisCurve(const mccvis::Radar* radar, std::vector<mccvis::Point>&& points, QColor&& color)
+            : radar(radar)
+            , points(std::move(points))
             , color(std::move(color))
         {
         }
 
+        const mccvis::Radar* radar;
         std::vector<mccvis::Point> points;
         QColor color;
     };
 
     std::vector<VisCurve> _frenelVisZs;
+    std::vector<mccgeo::PositionAndDistance> _totalProfile;
+    std::unique_ptr<mccvis::RadarTerrainCache> _radarTerrain;
     std::vector<mccvis::Point> _trackPoints;
     std::vector<std::unique_ptr<QwtPlotMarker>> _inclines;
     bmcl::Option<QPointF> _waypointHint;
@@ -0,0 +1,182 @@
+#include "mcc/ide/models/LogMessagesFilterModel.h"
+#include "mcc/ide/models/LogMessagesModel.h"
+
+#include <algorithm>
+
+namespace mccide {
+
+LogMessagesFilterModel::LogMessagesFilterModel(LogMessagesModel* source, QObject* parent)
+    : QAbstractProxyModel(parent)
+    , _source(source)
+    , _logLevel(bmcl::LogLevel::Debug)
+{
+    QAbstractProxyModel::setSourceModel(source);
+    connect(source, &QAbstractItemModel::rowsInserted, this, &LogMessagesFilterModel::onRowsInserted);
+    connect(source, &QAbstractItemModel::rowsAboutToBeRemoved, this, &LogMessagesFilterModel::onRowsAboutToBeRemoved);
+    connect(source, &QAbstractItemModel::modelReset, this, &LogMessagesFilterModel::rebuild);
+    rebuild();
+}
+
+LogMessagesFilterModel::~LogMessagesFilterModel()
+{
+}
+
+void LogMessagesFilterModel::setLogLevel(bmcl::LogLevel logLevel)
+{
+    _logLevel = logLevel;
+    rebuild();
+}
+
+void LogMessagesFilterModel::setDevice(const bmcl::Option<mccmsg::Device>& device)
+{
+    _device = device;
+    rebuild();
+}
+
+void LogMessagesFilterModel::setFilterRegExp(const QRegExp& regExp)
+{
+    _regExp = regExp;
+    rebuild();
+}
+
+bool LogMessagesFilterModel::acceptsLevel(const AbstractLogMessage* msg) const
+{
+    return (int)msg->logLevel() <= (int)_logLevel;
+}
+
+bool LogMessagesFilterModel::acceptsText(const AbstractLogMessage* msg) const
+{
+    if (_regExp.isEmpty())
+        return true;
+    const QString& text = msg->message();
+    return msg->time().contains(_regExp)
+        || msg->component().contains(_regExp)
+        || msg->deviceName().contains(_regExp)
+        || text.left(text.indexOf('\n')).contains(_regExp);
+}
+
+void LogMessagesFilterModel::rebuild()
+{
+    beginResetModel();
+    _sequences.clear();
+    uint64_t first = _source->firstSequence();
+    if (_device.isSome())
+    {
+        const LogMessagesModel::Sequences* deviceSequences = _source->deviceSequences(_device.unwrap());
+        if (deviceSequences)
+        {
+            for (uint64_t sequence : *deviceSequences)
+            {
+                const AbstractLogMessage* msg = _source->message(static_cast<int>(sequence - first));
+                if (acceptsLevel(msg) && acceptsText(msg))
+                    _sequences.push_back(sequence);
+            }
+        }
+    }
+    else
+    {
+        std::vector<uint64_t> candidates;
+        for (int level = 0; level <= (int)_logLevel; level++)
+        {
+            const LogMessagesModel::Sequences& levelSequences = _source->levelSequences((bmcl::LogLevel)level);
+            std::size_t middle = candidates.size();
+            candidates.insert(candidates.end(), levelSequences.begin(), levelSequences.end());
+            std::inplace_merge(candidates.begin(), candidates.begin() + middle, candidates.end());
+        }
+        if (_regExp.isEmpty())
+        {
+            _sequences = std::move(candidates);
+        }
+        else
+        {
+            for (uint64_t sequence : candidates)
+            {
+                if (acceptsText(_source->message(static_cast<int>(sequence - first))))
+                    _sequences.push_back(sequence);
+            }
+        }
+    }
+    endResetModel();
+}
+
+void LogMessagesFilterModel::onRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+    uint64_t firstSequence = _source->firstSequence();
+    std::vector<uint64_t> accepted;
+    for (int row = first; row <= last; row++)
+    {
+        const AbstractLogMessage* msg = _source->message(row);
+        if (_device.isSome() && (msg->device().isNone() || msg->device().unwrap() != _device.unwrap()))
+            continue;
+        if (acceptsLevel(msg) && acceptsText(msg))
+            accepted.push_back(firstSequence + row);
+    }
+    if (accepted.empty())
+        return;
+    int startRow = static_cast<int>(_sequences.size());
+    beginInsertRows(QModelIndex(), startRow, startRow + static_cast<int>(accepted.size()) - 1);
+    _sequences.insert(_sequences.end(), accepted.begin(), accepted.end());
+    endInsertRows();
+}
+
+void LogMessagesFilterModel::onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+    uint64_t firstSequence = _source->firstSequence();
+    auto from = std::lower_bound(_sequences.begin(), _sequences.end(), firstSequence + first);
+    auto to = std::upper_bound(from, _sequences.end(), firstSequence + last);
+    if (from == to)
+        return;
+    beginRemoveRows(QModelIndex(), static_cast<int>(from - _sequences.begin()), static_cast<int>(to - _sequences.begin()) - 1);
+    _sequences.erase(from, to);
+    endRemoveRows();
+}
+
+QModelIndex LogMessagesFilterModel::mapToSource(const QModelIndex& proxyIndex) const
+{
+    if (!proxyIndex.isValid() || proxyIndex.row() >= rowCount())
+        return QModelIndex();
+    int row = static_cast<int>(_sequences[static_cast<size_t>(proxyIndex.row())] - _source->firstSequence());
+    return _source->index(row, proxyIndex.column());
+}
+
+QModelIndex LogMessagesFilterModel::mapFromSource(const QModelIndex& sourceIndex) const
+{
+    if (!sourceIndex.isValid())
+        return QModelIndex();
+    uint64_t sequence = _source->firstSequence() + sourceIndex.row();
+    auto it = std::lower_bound(_sequences.begin(), _sequences.end(), sequence);
+    if (it == _sequences.end() || *it != sequence)
+        return QModelIndex();
+    return createIndex(static_cast<int>(it - _sequences.begin()), sourceIndex.column());
+}
+
+QModelIndex LogMessagesFilterModel::index(int row, int column, const QModelIndex& parent) const
+{
+    if (parent.isValid() || row < 0 || row >= rowCount() || column < 0 || column >= columnCount())
+        return QModelIndex();
+    return createIndex(row, column);
+}
+
+QModelIndex LogMessagesFilterModel::parent(const QModelIndex&) const
+{
+    return QModelIndex();
+}
+
+int LogMessagesFilterModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return static_cast<int>(_sequences.size());
+}
+
+int LogMessagesFilterModel::columnCount(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return _source->columnCount();
+}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <QAbstractProxyModel>
+#include <QRegExp>
+
+#include "mcc/Config.h"
+
+#include <bmcl/Logging.h>
+#include <bmcl/Option.h>
+
+#include "mcc/msg/Fwd.h"
+#include "mcc/msg/Objects.h"
+
+namespace mccide {
+
+class AbstractLogMessage;
+class LogMessagesModel;
+
+// Filters LogMessagesModel rows by log level, device and text.
+// Candidate rows are taken from model level and device indexes, so only text filter checks messages one by one
+class MCC_IDE_DECLSPEC LogMessagesFilterModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+public:
+    LogMessagesFilterModel(LogMessagesModel* source, QObject* parent = nullptr);
+    ~LogMessagesFilterModel() override;
+
+    void setLogLevel(bmcl::LogLevel logLevel);
+    void setDevice(const bmcl::Option<mccmsg::Device>& device);
+    void setFilterRegExp(const QRegExp& regExp);
+
+    QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex& sourceIndex) const override;
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+private slots:
+    void onRowsInserted(const QModelIndex& parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
+
+private:
+    bool acceptsLevel(const AbstractLogMessage* msg) const;
+    bool acceptsText(const AbstractLogMessage* msg) const;
+    void rebuild();
+
+    LogMessagesModel* _source;
+    std::vector<uint64_t> _sequences;
+    bmcl::LogLevel _logLevel;
+    bmcl::Option<mccmsg::Device> _device;
+    QRegExp _regExp;
+};
+}
@@ -1,6 +1,7 @@
 #include "mcc/ide/models/LogMessagesModel.h"
 #include "mcc/msg/Error.h"
 
+#include <algorithm>
 #include <memory>
 
 #include <QColor>
@@ -169,6 +170,8 @@ mccmsg::RequestId CmdLogMessage::cmdId() const
 LogMessagesModel::LogMessagesModel(QObject* parent)
     : QAbstractItemModel(parent)
     , _context(nullptr)
+    , _firstSequence(0)
+    , _maxMessages(100000)
 {
     startTimer(100);
 }
@@ -186,6 +189,41 @@ void LogMessagesModel::setContext(mccuav::UavController* context)
 
 }
 
+void LogMessagesModel::setMaxMessages(std::size_t count)
+{
+    _maxMessages = std::max<std::size_t>(1, count);
+    if (_messages.size() > _maxMessages)
+        removeOldest(_messages.size() - _maxMessages);
+}
+
+std::size_t LogMessagesModel::maxMessages() const
+{
+    return _maxMessages;
+}
+
+const AbstractLogMessage* LogMessagesModel::message(int row) const
+{
+    return _messages[static_cast<size_t>(row)].get();
+}
+
+uint64_t LogMessagesModel::firstSequence() const
+{
+    return _firstSequence;
+}
+
+const LogMessagesModel::Sequences& LogMessagesModel::levelSequences(bmcl::LogLevel level) const
+{
+    return _levelIndex[static_cast<size_t>(level)];
+}
+
+const LogMessagesModel::Sequences* LogMessagesModel::deviceSequences(const mccmsg::Device& device) const
+{
+    auto it = _deviceIndex.find(device);
+    if (it == _deviceIndex.end())
+        return nullptr;
+    return &it->second;
+}
+
 QModelIndex LogMessagesModel::index(int row, int column, const QModelIndex& parent) const
 {
     return createIndex(row, column);
@@ -307,16 +345,62 @@ QModelIndex LogMessagesModel::parent(const QModelIndex&) const
     return QModelIndex();
 }
 
+void LogMessagesModel::indexMessage(const AbstractLogMessage* msg, uint64_t sequence)
+{
+    _levelIndex[static_cast<size_t>(msg->logLevel())].push_back(sequence);
+    if (msg->device().isSome())
+        _deviceIndex[msg->device().unwrap()].push_back(sequence);
+}
+
+void LogMessagesModel::removeOldest(std::size_t count)
+{
+    beginRemoveRows(QModelIndex(), 0, static_cast<int>(count) - 1);
+    _messages.erase(_messages.begin(), _messages.begin() + count);
+    _firstSequence += count;
+    for (Sequences& sequences : _levelIndex)
+    {
+        while (!sequences.empty() && sequences.front() < _firstSequence)
+            sequences.pop_front();
+    }
+    for (auto it = _deviceIndex.begin(); it != _deviceIndex.end();)
+    {
+        while (!it->second.empty() && it->second.front() < _firstSequence)
+            it->second.pop_front();
+        if (it->second.empty())
+            it = _deviceIndex.erase(it);
+        else
+            ++it;
+    }
+    endRemoveRows();
+}
+
 void LogMessagesModel::timerEvent(QTimerEvent*)
 {
     if (_queue.empty())
         return;
 
+    // messages that would be removed right away are not shown at all
+    if (_queue.size() > _maxMessages)
+    {
+        std::size_t skipped = _queue.size() - _maxMessages;
+        _queue.erase(_queue.begin(), _queue.begin() + skipped);
+        if (!_messages.empty())
+            removeOldest(_messages.size());
+        _firstSequence += skipped;
+    }
+    else if (_messages.size() + _queue.size() > _maxMessages)
+    {
+        removeOldest(_messages.size() + _queue.size() - _maxMessages);
+    }
+
     int startRow = static_cast<int>(_messages.size());
     int endRow = startRow + static_cast<int>(_queue.size()) - 1;
     beginInsertRows(QModelIndex(), startRow, endRow);
+    uint64_t sequence = _firstSequence + _messages.size();
     while (!_queue.empty())
     {
+        indexMessage(_queue.front().get(), sequence);
+        sequence++;
         _messages.push_back(std::move(_queue.front()));
         _queue.pop_front();
     }
@@ -1,6 +1,9 @@
 #pragma once
-#include <memory>
+#include <array>
+#include <cstdint>
 #include <deque>
+#include <map>
+#include <memory>
 
 #include <QAbstractTableModel>
 #include <QColor>
@@ -12,6 +15,7 @@
 
 #include "mcc/msg/ptr/Fwd.h"
 #include "mcc/msg/Fwd.h"
+#include "mcc/msg/Objects.h"
 #include "mcc/uav/Fwd.h"
 
 namespace mccide {
@@ -64,11 +68,24 @@ public:
         MessageColorRole,
     };
 
+    using Sequences = std::deque<uint64_t>;
+
     LogMessagesModel(QObject* parent);
     ~LogMessagesModel() override;
 
     void setContext(mccuav::UavController* context);
 
+    // oldest messages are removed when count exceeds limit
+    void setMaxMessages(std::size_t count);
+    std::size_t maxMessages() const;
+
+    const AbstractLogMessage* message(int row) const;
+
+    // every message gets increasing sequence number, row = sequence - firstSequence()
+    uint64_t firstSequence() const;
+    const Sequences& levelSequences(bmcl::LogLevel level) const;
+    const Sequences* deviceSequences(const mccmsg::Device& device) const;
+
     QModelIndex index(int row, int column,
                       const QModelIndex &parent = QModelIndex()) const override;
     using QObject::parent;
@@ -90,9 +107,16 @@ private:
     QModelIndex parent(const QModelIndex &child) const override;
 
     void addMessage(LogMessagePtr&& msgPtr);
+    void removeOldest(std::size_t count);
+    void indexMessage(const AbstractLogMessage* msg, uint64_t sequence);
+
     mccuav::UavController* _context;
-    std::vector<LogMessagePtr> _messages;
+    std::deque<LogMessagePtr> _messages;
     std::deque<LogMessagePtr> _queue;
+    std::array<Sequences, 6> _levelIndex;
+    std::map<mccmsg::Device, Sequences> _deviceIndex;
+    uint64_t _firstSequence;
+    std::size_t _maxMessages;
 };
 }
 
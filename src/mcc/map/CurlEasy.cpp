@@ -26,6 +26,17 @@ CurlEasy::CurlEasy(CurlMulti* parent)
     set(CURLOPT_XFERINFOFUNCTION, staticCurlXferInfoFunction);
     set(CURLOPT_XFERINFODATA, this);
     set(CURLOPT_NOPROGRESS, long(0));
+
+    // empty string enables every encoding supported by libcurl
+    set(CURLOPT_ACCEPT_ENCODING, "");
+    set(CURLOPT_TCP_KEEPALIVE, 1L);
+#if LIBCURL_VERSION_NUM >= 0x072f00
+    set(CURLOPT_HTTP_VERSION, long(CURL_HTTP_VERSION_2TLS));
+#endif
+#if LIBCURL_VERSION_NUM >= 0x072b00
+    // wait for multiplexed connection instead of opening new one
+    set(CURLOPT_PIPEWAIT, 1L);
+#endif
 }
 
 CurlEasy::~CurlEasy()
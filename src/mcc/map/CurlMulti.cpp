@@ -43,6 +43,9 @@ CurlMulti::CurlMulti(QObject* parent)
     curl_multi_setopt(_handle, CURLMOPT_SOCKETDATA, this);
     curl_multi_setopt(_handle, CURLMOPT_TIMERFUNCTION, staticCurlTimerFunction);
     curl_multi_setopt(_handle, CURLMOPT_TIMERDATA, this);
+#if LIBCURL_VERSION_NUM >= 0x072b00
+    curl_multi_setopt(_handle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
 
     _timer->setSingleShot(true);
     connect(_timer, &QTimer::timeout, this, &CurlMulti::curlMultiTimeout);
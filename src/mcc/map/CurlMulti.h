@@ -27,6 +27,9 @@ public:
     //NOTE: CurlMulti ownes easy handles
     CurlEasy* addTransfer();
 
+    template<typename T>
+    bool set(CURLMoption option, T parameter);
+
 private slots:
     void curlMultiTimeout();
     void socketReadyRead(int socketDescriptor);
@@ -51,4 +54,10 @@ private:
 
     std::vector<CurlEasy*> _transfers;
 };
+
+template<typename T>
+bool CurlMulti::set(CURLMoption option, T parameter)
+{
+    return curl_multi_setopt(_handle, option, parameter) == CURLM_OK;
+}
 }
@@ -42,6 +42,11 @@ bmcl::Option<QString> DiskCache::generateTileSavePath(const mccmap::TilePosition
     return _cachePath + createPath(pos);
 }
 
+bmcl::Option<QString> DiskCache::generateTileIndexPath()
+{
+    return _cachePath + "tiles.idx";
+}
+
 DiskCache::~DiskCache()
 {
 }
@@ -16,6 +16,7 @@ public:
     ~DiskCache();
 
     bmcl::Option<QString> generateTileSavePath(const mccmap::TilePosition & pos) override;
+    bmcl::Option<QString> generateTileIndexPath() override;
     QImage readImage(const TilePosition& pos, const QRect& rect) const override;
     bool tileExists(const TilePosition& pos) const override;
 
@@ -160,6 +160,11 @@ bmcl::Option<QString> FileCache::generateTileSavePath(const TilePosition& pos)
     return bmcl::None;
 }
 
+bmcl::Option<QString> FileCache::generateTileIndexPath()
+{
+    return bmcl::None;
+}
+
 bool FileCache::hasOnlineTiles() const
 {
     return false;
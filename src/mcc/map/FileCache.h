@@ -46,6 +46,8 @@ public:
     virtual int maxTileZoom() const;
     virtual bmcl::Option<std::string> generateTileUrl(const TilePosition& pos);
     virtual bmcl::Option<QString> generateTileSavePath(const TilePosition& pos);
+    // sidecar file with http validators of saved tiles
+    virtual bmcl::Option<QString> generateTileIndexPath();
     virtual bool hasOnlineTiles() const;
     virtual const mccgeo::MercatorProjection& projection() const = 0;
     virtual const QString& description() const = 0;
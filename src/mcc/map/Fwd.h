@@ -10,8 +10,11 @@ class FileCache;
 class MapRect;
 class MapWidget;
 class OmcfCache;
+class OmcfWriter;
 class OnlineCache;
 class StackCache;
+class TilePixmapCache;
+class TilePrefetcher;
 
 class Layer;
 class LayerGroup;
@@ -66,6 +66,11 @@ const char* Layer::name() const
     return "NO NAME";
 }
 
+bool Layer::isStatic() const
+{
+    return false;
+}
+
 void Layer::setActive(bool isActive)
 {
     _isActive = isActive;
@@ -8,6 +8,7 @@
 #include "mcc/ui/QObjectRefCountable.h"
 
 #include <QObject>
+#include <QRect>
 
 class QPainter;
 class QPoint;
@@ -37,6 +38,8 @@ public:
     virtual bool viewportResetEvent(int oldZoom, int newZoom, const QRect& oldViewport, const QRect& newViewport);
     virtual void createMenues(const QPoint& pos, bool isSubmenu, QMenu* dest);
     virtual const char* name() const;
+    // static layer changes only on its own scene updates and viewport events, it is drawn from cached image
+    virtual bool isStatic() const;
 
     void drawCoordinatesAt(QPainter* p, const mccui::CoordinateSystemController* csController, const QPointF& coord,
                            const QPointF& point, const QString& arg = "%1, %2", double scale = 1) const;
@@ -57,6 +60,8 @@ signals:
     void visibilityChanged(bool isVisible);
     void editabilityChanged(bool isEditable);
     void sceneUpdated();
+    // only rect of viewport in widget coordinates is changed
+    void sceneRectUpdated(const QRect& rect);
 
 protected:
     QMenu* createSubmenu(const QString& name, bool isSubmenu, QMenu* dest);
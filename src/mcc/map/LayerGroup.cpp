@@ -10,6 +10,7 @@
 #include <bmcl/Logging.h>
 
 #include <QPainter>
+#include <QPaintDevice>
 #include <QMenu>
 
 namespace mccmap {
@@ -46,7 +47,18 @@ void LayerGroup::insertLayer(Layer* l, std::size_t pos)
             _activatedLayer.unwrap()++;
         }
     }
-    connect(layer.get(), &Layer::sceneUpdated, this, &LayerGroup::sceneUpdated);
+    Layer* ptr = layer.get();
+    connect(ptr, &Layer::sceneUpdated, this, [this, ptr]() {
+        invalidateCache(ptr);
+        emit sceneUpdated();
+    });
+    connect(ptr, &Layer::sceneRectUpdated, this, [this, ptr](const QRect& rect) {
+        QRegion region = tiledRegion(rect);
+        invalidateCache(ptr, region);
+        for (const QRect& r : region.rects()) {
+            emit sceneRectUpdated(r);
+        }
+    });
     connect(layer.get(), &Layer::activated, this, [this, layer]() {
         if (!_catchUpdates) {
             return;
@@ -88,6 +100,7 @@ void LayerGroup::removeAt(std::size_t pos)
 
     Layer* layer = _layers[pos].get();
     disconnect(layer, 0, this, 0);
+    _staticCaches.erase(layer);
     _layers.erase(_layers.begin() + pos);
     adjustRemovedIndex(pos, &_activeLayer);
     adjustRemovedIndex(pos, &_activatedLayer);
@@ -183,25 +196,110 @@ void LayerGroup::draw(QPainter* p) const
 }
 
 void LayerGroup::drawTiled(QPainter* p) const
+{
+    for (const Rc<Layer>& layer : _layers) {
+        if (layer->isVisible()) {
+            drawLayerTiled(layer.get(), p);
+        }
+    }
+}
+
+void LayerGroup::drawLayerTiled(const Layer* layer, QPainter* p) const
 {
     int maxMapSize = mapRect()->maxMapSize();
     int width = mapRect()->size().width();
     int x = mapRect()->mapOffsetRaw().x();
 
-    for (const Rc<Layer>& layer : _layers) {
-        if (layer->isVisible()) {
-            for (int i = 0; i < width; i += maxMapSize) {
-                layer->draw(p);
-                p->translate(maxMapSize, 0);
-            }
+    QTransform t = p->transform();
+    for (int i = 0; i < width; i += maxMapSize) {
+        layer->draw(p);
+        p->translate(maxMapSize, 0);
+    }
+
+    if ((x + width) > maxMapSize) {
+        layer->draw(p);
+    }
+
+    p->setTransform(t);
+}
 
-            if ((x + width) > maxMapSize) {
-                layer->draw(p);
-            }
+void LayerGroup::drawCached(QPainter* p, const QRegion& region)
+{
+    qreal ratio = p->device()->devicePixelRatioF();
+    QRect viewport(QPoint(0, 0), mapRect()->size());
+
+    p->save();
+    p->setClipRegion(region);
+    for (const Rc<Layer>& layer : _layers) {
+        if (!layer->isVisible()) {
+            continue;
+        }
+        if (!layer->isStatic()) {
+            drawLayerTiled(layer.get(), p);
+            continue;
+        }
 
-            p->resetTransform();
+        StaticCache& cache = _staticCaches[layer.get()];
+        QSize imageSize = viewport.size() * ratio;
+        if (cache.image.size() != imageSize || cache.image.devicePixelRatioF() != ratio) {
+            cache.image = QImage(imageSize, QImage::Format_ARGB32_Premultiplied);
+            cache.image.setDevicePixelRatio(ratio);
+            cache.stale = viewport;
         }
+        if (!cache.stale.isEmpty()) {
+            QPainter cp(&cache.image);
+            cp.setRenderHints(p->renderHints());
+            cp.setClipRegion(cache.stale);
+            cp.setCompositionMode(QPainter::CompositionMode_Source);
+            cp.fillRect(viewport, Qt::transparent);
+            cp.setCompositionMode(QPainter::CompositionMode_SourceOver);
+            drawLayerTiled(layer.get(), &cp);
+            cache.stale = QRegion();
+        }
+        p->drawImage(QPoint(0, 0), cache.image);
+    }
+    p->restore();
+}
+
+QRegion LayerGroup::tiledRegion(const QRect& rect) const
+{
+    // layer is drawn once for every map width in viewport
+    int maxMapSize = mapRect()->maxMapSize();
+    int width = mapRect()->size().width();
+    QRegion region;
+    for (int dx = 0; rect.left() + dx < width; dx += maxMapSize) {
+        region += rect.translated(dx, 0);
+    }
+    return region;
+}
+
+void LayerGroup::invalidateCache(const Layer* layer, const QRegion& region)
+{
+    auto it = _staticCaches.find(layer);
+    if (it != _staticCaches.end()) {
+        it->second.stale += region;
+    }
+}
+
+void LayerGroup::invalidateCache(const Layer* layer)
+{
+    invalidateCache(layer, QRect(QPoint(0, 0), mapRect()->size()));
+}
+
+void LayerGroup::invalidateCaches()
+{
+    for (auto& it : _staticCaches) {
+        it.second.stale = QRect(QPoint(0, 0), mapRect()->size());
+    }
+}
+
+bool LayerGroup::invalidateActivatedIf(bool isHandled)
+{
+    // mouse events may change static layer, e.g. selection
+    if (isHandled && _activatedLayer.isSome()) {
+        invalidateCache(_layers[_activatedLayer.unwrap()].get());
     }
+    return isHandled;
 }
 
 template <typename F, typename... A>
@@ -249,6 +347,7 @@ inline bool LayerGroup::visitFirstAvailableAfterActivated(F&& func, L&& layerFun
 void LayerGroup::changeProjection(const mccgeo::MercatorProjection& from, const mccgeo::MercatorProjection& to)
 {
     visitLayers(&Layer::changeProjection, from, to);
+    invalidateCaches();
 }
 
 void LayerGroup::createMenues(const QPoint& pos, bool isSubmenu, QMenu* dest)
@@ -277,51 +376,56 @@ void LayerGroup::createMenues(const QPoint& pos, bool isSubmenu, QMenu* dest)
 
 bool LayerGroup::mouseMoveEvent(const QPoint& oldPos, const QPoint& newPos)
 {
-    return visitFirstAvailableAfterActivated(&Layer::mouseMoveEvent, &Layer::isVisibleAndEditable, oldPos, newPos);
+    return invalidateActivatedIf(visitFirstAvailableAfterActivated(&Layer::mouseMoveEvent, &Layer::isVisibleAndEditable, oldPos, newPos));
 }
 
 bool LayerGroup::mousePressEvent(const QPoint& pos)
 {
-    return visitFirstAvailableAfterActivated(&Layer::mousePressEvent, &Layer::isVisibleAndEditable, pos);
+    return invalidateActivatedIf(visitFirstAvailableAfterActivated(&Layer::mousePressEvent, &Layer::isVisibleAndEditable, pos));
 }
 
 bool LayerGroup::mouseDoubleClickEvent(const QPoint& pos)
 {
-    return visitFirstAvailableAfterActivated(&Layer::mouseDoubleClickEvent, &Layer::isVisibleAndEditable, pos);
+    return invalidateActivatedIf(visitFirstAvailableAfterActivated(&Layer::mouseDoubleClickEvent, &Layer::isVisibleAndEditable, pos));
 }
 
 bool LayerGroup::mouseReleaseEvent(const QPoint& pos)
 {
     //HACK
-    return visitFirstAvailableAfterActivated(&Layer::mouseReleaseEvent, &Layer::isVisibleAndEditable, pos);
+    return invalidateActivatedIf(visitFirstAvailableAfterActivated(&Layer::mouseReleaseEvent, &Layer::isVisibleAndEditable, pos));
 }
 
 void LayerGroup::mouseLeaveEvent()
 {
     visitLayers(&Layer::mouseLeaveEvent);
+    invalidateCaches();
 }
 
 bool LayerGroup::viewportResetEvent(int oldZoom, int newZoom, const QRect& oldViewpiort, const QRect& newViewport)
 {
     visitLayers(&Layer::viewportResetEvent, oldZoom, newZoom, oldViewpiort, newViewport);
+    invalidateCaches();
     return true;
 }
 
 bool LayerGroup::viewportResizeEvent(const QSize& oldSize, const QSize& newSize)
 {
     visitLayers(&Layer::viewportResizeEvent, oldSize, newSize);
+    invalidateCaches();
     return true;
 }
 
 bool LayerGroup::viewportScrollEvent(const QPoint& oldPos, const QPoint& newPos)
 {
     visitLayers(&Layer::viewportScrollEvent, oldPos, newPos);
+    invalidateCaches();
     return true;
 }
 
 bool LayerGroup::zoomEvent(const QPoint& pos, int fromZoom, int toZoom)
 {
     visitLayers(&Layer::zoomEvent, pos, fromZoom, toZoom);
+    invalidateCaches();
     return true;
 }
 
@@ -7,6 +7,10 @@
 
 #include <bmcl/Option.h>
 
+#include <QImage>
+#include <QRegion>
+
+#include <map>
 #include <vector>
 
 namespace mccmap {
@@ -20,6 +24,8 @@ public:
     ~LayerGroup() override;
     void draw(QPainter* p) const override;
     void drawTiled(QPainter* p) const;
+    // static layers are redrawn into their cached images only where stale, everything is composited in region
+    void drawCached(QPainter* p, const QRegion& region);
     void mouseLeaveEvent() override;
     bool mouseMoveEvent(const QPoint& oldPos, const QPoint& newPos) override;
     bool mousePressEvent(const QPoint& pos) override;
@@ -67,6 +73,18 @@ protected:
     const std::vector<Rc<Layer>>& layers();
 
 private:
+    struct StaticCache {
+        QImage image;
+        QRegion stale;
+    };
+
+    void drawLayerTiled(const Layer* layer, QPainter* p) const;
+    QRegion tiledRegion(const QRect& rect) const;
+    void invalidateCache(const Layer* layer, const QRegion& region);
+    void invalidateCache(const Layer* layer);
+    void invalidateCaches();
+    bool invalidateActivatedIf(bool isHandled);
+
     template <typename F, typename... A>
     void visitLayers(F&& func, A&&... args);
     template <typename F, typename L, typename... A>
@@ -76,6 +94,7 @@ private:
     bmcl::Option<std::size_t> _activatedLayer;
     bmcl::Option<std::size_t> _activeLayer;
     std::vector<Rc<Layer>> _layers;
+    std::map<const Layer*, StaticCache> _staticCaches;
     bool _catchUpdates;
 };
 
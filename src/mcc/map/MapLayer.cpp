@@ -144,6 +144,7 @@ void MapLayer::enableTileDownloading(bool flag)
     if (_downloadEnabled) {
         auto queue = _cache.reloadCache();
         sendTiles(queue);
+        emit sceneUpdated();
     } else {
         _manager->clear();
     }
@@ -151,13 +152,19 @@ void MapLayer::enableTileDownloading(bool flag)
 
 void MapLayer::connectManager()
 {
-    connect(_manager, &TileLoader::pixmapReady, this, [this](const TilePosition& pos, const QPixmap& pixmap) {
-        if (pos.zoomLevel == _cache.zoomLevel()) {
-            _cache.updatePixmap(pos, pixmap);
-            emit sceneUpdated();
+    connect(_manager, &TileLoader::pixmapReady, this, [this](const TilePosition& pos, const QPixmap& pixmap, qint64 expires) {
+        // late tiles of previous zoom level are kept in pixmap cache
+        _cache.updatePixmap(pos, pixmap, expires);
+        QRect rect = _cache.tileRect(pos);
+        if (!rect.isNull()) {
+            emit sceneRectUpdated(rect.translated(-_paintOffset));
         }
     }, Qt::QueuedConnection);
 
+    connect(_manager, &TileLoader::pixmapRevalidated, this, [this](const TilePosition& pos, qint64 expires) {
+        _cache.updateExpires(pos, expires);
+    }, Qt::QueuedConnection);
+
     connect(_manager, &TileLoader::cacheReloaded, this, &MapLayer::reload, Qt::QueuedConnection);
 
     //connect(_manager, &TileLoader::pixmapFailed, this, [this](const TilePosition& pos) {
@@ -195,6 +202,7 @@ void MapLayer::setMapInfo(FileCache* mapInfo, bool downloadEnabled)
 
     auto imgs = _cache.reloadCache();
     sendTiles(imgs);
+    emit sceneUpdated();
 }
 
 void MapLayer::reload()
@@ -202,6 +210,7 @@ void MapLayer::reload()
     _manager->clear();
     auto imgs = _cache.reloadCache();
     sendTiles(imgs);
+    emit sceneUpdated();
 }
 
 void MapLayer::clear()
@@ -309,4 +318,9 @@ const char* MapLayer::name() const
 {
     return "Карта";
 }
+
+bool MapLayer::isStatic() const
+{
+    return true;
+}
 }
@@ -39,6 +39,7 @@ public:
     bool viewportResetEvent(int oldZoom, int newZoom, const QRect& oldViewpiort, const QRect& newViewport) override;
     void changeProjection(const mccgeo::MercatorProjection& from, const mccgeo::MercatorProjection& to) override;
     const char* name() const override;
+    bool isStatic() const override;
     void createMenues(const QPoint& pos, bool isSubmenu, QMenu* dest) override;
 
     void setMapInfo(FileCache* mapInfo, bool downloadEnabled);
@@ -124,6 +124,7 @@ MapWidget::MapWidget(MapRect* mapRect,
     _layers->insertLayer(_mapLayer.get(), 0);
 
     connect(_layers.get(), &Layer::sceneUpdated, this, &MapWidget::updateMap);
+    connect(_layers.get(), &Layer::sceneRectUpdated, this, &MapWidget::updateMapRect);
 
     createMapWidgets();
 
@@ -131,9 +132,9 @@ MapWidget::MapWidget(MapRect* mapRect,
     connect(this, &MapWidget::mapNeedsUpdate, this, [this]() { update(); }, Qt::QueuedConnection);
 #else
     connect(_frameLimitTimer, &QTimer::timeout, this, [this]() {
-        if (_needsUpdate) {
-            _needsUpdate = false;
-            update();
+        if (!_dirtyRegion.isEmpty()) {
+            update(_dirtyRegion);
+            _dirtyRegion = QRegion();
             _frameLimitTimer->start();
         }
     });
@@ -196,7 +197,17 @@ void MapWidget::updateMap()
 #if MCC_USE_OPENGL
     emit mapNeedsUpdate();
 #else
-    _needsUpdate = true;
+    updateMapRect(rect());
+#endif
+}
+
+void MapWidget::updateMapRect(const QRect& rect)
+{
+#if MCC_USE_OPENGL
+    (void)rect;
+    emit mapNeedsUpdate();
+#else
+    _dirtyRegion += rect;
     if (!_frameLimitTimer->isActive()) {
         _frameLimitTimer->start();
     }
@@ -473,7 +484,11 @@ void MapWidget::renderNoResize(QPaintDevice* dev)
 void MapWidget::paintEvent(QPaintEvent* event)
 {
     event->accept();
-    renderNoResize(this);
+
+    QPainter p(this);
+    p.setRenderHint(QPainter::Antialiasing);
+
+    _layers->drawCached(&p, event->region());
 }
 
 void MapWidget::resizeLayersNoEmit(const QSize& oldSize, const QSize& newSize)
@@ -10,6 +10,8 @@
 
 #include <bmcl/Fwd.h>
 
+#include <QRegion>
+
 #ifdef MCC_USE_OPENGL
 #define MCC_MAP_WIDGET_BASE QOpenGLWidget
 #include <QOpenGLWidget>
@@ -119,6 +121,7 @@ public slots:
 
 private slots:
     void updateMap();
+    void updateMapRect(const QRect& rect);
 
 private:
     void setUpdateRate(int rate);
@@ -171,7 +174,7 @@ private:
     bool                                _isCursorOverWidget;
     bool                                _positionLoaded;
     std::string                         _staticMapType;
-    bool                                _needsUpdate;
+    QRegion                             _dirtyRegion;
     std::unique_ptr<mccui::Trackable>   _trackable;
     Rc<MapLayer>                        _mapLayer;
 
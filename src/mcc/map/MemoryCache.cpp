@@ -3,6 +3,7 @@
 
 #include <bmcl/Logging.h>
 #include <bmcl/Assert.h>
+#include <bmcl/OptionPtr.h>
 
 #include <QPainter>
 
@@ -10,8 +11,16 @@
 
 namespace mccmap {
 
+constexpr const int tileSize = 256;
+// max zoom difference of parent tile used while tile is loading
+constexpr const int maxPlaceholderDepth = 4;
+
 MemoryCache::MemoryCache()
-    : _zoomLevel(0)
+    : _originX(0)
+    , _originY(0)
+    , _requestedTileCount(0)
+    , _cachedTileCount(0)
+    , _zoomLevel(0)
     , _width(0)
     , _height(0)
     , _maxWidth(1)
@@ -41,17 +50,24 @@ void MemoryCache::drawNonTiled(QPainter* p) const
 {
     int pixmapOffsetX = 0;
     int pixmapOffsetY = 0;
-    for (const std::deque<QPixmap>& row : _cache) {
+    for (int tileY = 0; tileY < _height; tileY++) {
         pixmapOffsetX = 0;
-        for (const QPixmap& pixmap : row) {
-            p->drawPixmap(pixmapOffsetX, pixmapOffsetY, pixmap);
+        for (int tileX = 0; tileX < _width; tileX++) {
+            p->drawPixmap(pixmapOffsetX, pixmapOffsetY, slotPixmap(slotAt(tileX, tileY)));
             pixmapOffsetX += 256;
         }
         pixmapOffsetY += 256;
     }
 }
 
-void MemoryCache::updatePixmap(const mccmap::TilePosition& pos, const QPixmap& image)
+void MemoryCache::updatePixmap(const mccmap::TilePosition& pos, const QPixmap& image, std::time_t expires)
+{
+    // tiles of other zoom levels are kept for later zooming
+    _pixmaps.add(pos, image, expires);
+    setPixmap(pos, image);
+}
+
+void MemoryCache::setPixmap(const mccmap::TilePosition& pos, const QPixmap& image)
 {
     if (pos.zoomLevel != _zoomLevel) {
         return;
@@ -60,74 +76,79 @@ void MemoryCache::updatePixmap(const mccmap::TilePosition& pos, const QPixmap& i
     int y = absOffset(pos.globalOffsetY - _globalOffsetY);
     int x = absOffset(pos.globalOffsetX - _globalOffsetX);
 
+    SlotState state = image.isNull() ? SlotState::Empty : SlotState::Loaded;
     for (int j = y; j < _height; j += _maxSize) {
-        std::deque<QPixmap>& pixmapsRow = _cache[j];
-        if ((int)pixmapsRow.size() < _width)
-        {
-            BMCL_CRITICAL() << "MemoryCache::updatePixmap(): pixmapsRow.size() < _width";
-            BMCL_ASSERT((int)pixmapsRow.size() < _width);
-            continue;
-        }
         for (int i = x; i < _width; i += _maxSize) {
-            pixmapsRow[i] = image;
+            setSlot(&slotAt(i, j), image, state);
         }
     }
 }
 
-const QPixmap& MemoryCache::pixmapAt(int x, int y) const
+void MemoryCache::setSlot(Slot* slot, const QPixmap& pixmap, SlotState state)
 {
-    if (y > _height - 1) {
-        return _emptyPixmap;
+    slot->state = state;
+    if (state == SlotState::Empty) {
+        // default pixmap is not copied into every empty slot
+        slot->pixmap = QPixmap();
+        return;
     }
-    const std::deque<QPixmap>& pixmapsRow = _cache[y];
-    if (x > _width - 1) {
+    slot->pixmap = pixmap;
+}
+
+QRect MemoryCache::tileRect(const mccmap::TilePosition& pos) const
+{
+    if (pos.zoomLevel != _zoomLevel) {
+        return QRect();
+    }
+    int y = absOffset(pos.globalOffsetY - _globalOffsetY);
+    int x = absOffset(pos.globalOffsetX - _globalOffsetX);
+    if (x >= _width || y >= _height) {
+        return QRect();
+    }
+    return QRect(x * 256, y * 256, 256, 256);
+}
+
+const QPixmap& MemoryCache::pixmapAt(int x, int y) const
+{
+    if (y > _height - 1 || x > _width - 1) {
         return _emptyPixmap;
     }
-    return pixmapsRow[x];
+    return slotPixmap(slotAt(x, y));
 }
 
 std::vector<TilePosition> MemoryCache::setSize(int tileCountX, int tileCountY)
 {
     tileCountY = std::min(tileCountY, _maxSize);
     tileCountX = std::min(tileCountX, _maxSize);
-    int dx = tileCountX - _width;
-    int dy = tileCountY - _height;
     std::vector<TilePosition> queue;
-
-    if (dy > 0) {
-        queue.reserve(dy * _width);
-        for (int i = 0; i < dy; i++) {
-            _cache.emplace_back();
-            populateEmptyRow(_cache.back());
-            loadRow((int)_cache.size() - 1, &queue);
-        }
-    } else if (dy < 0) {
-        dy = -dy;
-        for (int i = 0; i < dy; i++) {
-            _cache.pop_back();
-        }
+    if (tileCountX == _width && tileCountY == _height) {
+        return queue;
     }
 
-    if (dx > 0) {
-        queue.reserve(queue.size() + dx * _height);
-        for (int i = 0; i < dx; i++) {
-            for (auto& row : _cache) {
-                row.push_back(_emptyPixmap);
-            }
-            loadColumn((int)_cache[0].size() - 1, &queue);
-        }
-    } else if (dx < 0) {
-        dx = -dx;
-        for (auto& row : _cache) {
-            for (int i = 0; i < dx; i++) {
-                row.pop_back();
-            }
+    // kept tiles are moved to new grid with origin at first slot
+    std::vector<Slot> slots(tileCountX * tileCountY);
+    int keptWidth = std::min(tileCountX, _width);
+    int keptHeight = std::min(tileCountY, _height);
+    for (int row = 0; row < keptHeight; row++) {
+        for (int column = 0; column < keptWidth; column++) {
+            slots[row * tileCountX + column] = std::move(slotAt(column, row));
         }
     }
-
-    _height = tileCountY;
+    _slots.swap(slots);
+    _originX = 0;
+    _originY = 0;
     _width = tileCountX;
+    _height = tileCountY;
 
+    queue.reserve(_width * _height - keptWidth * keptHeight);
+    for (int row = keptHeight; row < _height; row++) {
+        loadRow(row, &queue);
+    }
+    for (int row = 0; row < keptHeight; row++) {
+        for (int column = keptWidth; column < _width; column++) {
+            loadTile(column, row, &queue);
+        }
+    }
     return queue;
 }
 
@@ -142,14 +163,12 @@ std::vector<TilePosition> MemoryCache::scrollUp()
 {
     std::vector<TilePosition> queue;
     _globalOffsetY = absOffset(_globalOffsetY - 1);
-    if (_maxHeight == _maxSize) {
-        std::deque<QPixmap> last = std::move(_cache.back());
-        _cache.pop_back();
-        _cache.push_front(std::move(last));
-    } else {
-        _cache.pop_back();
-        _cache.emplace_front();
-        populateEmptyRow(_cache.front());
+    if (_height == 0) {
+        return queue;
+    }
+    // last row becomes first one
+    _originY = (_originY + _height - 1) % _height;
+    if (_maxHeight != _maxSize) {
         queue.reserve(_width);
         loadRow(0, &queue);
     }
@@ -160,14 +179,11 @@ std::vector<TilePosition> MemoryCache::scrollDown()
 {
     std::vector<TilePosition> queue;
     _globalOffsetY = absOffset(_globalOffsetY + 1);
-    if (_maxHeight == _maxSize) {
-        std::deque<QPixmap> first = std::move(_cache.front());
-        _cache.pop_front();
-        _cache.push_back(std::move(first));
-    } else {
-        _cache.pop_front();
-        _cache.emplace_back();
-        populateEmptyRow(_cache.back());
+    if (_height == 0) {
+        return queue;
+    }
+    _originY = (_originY + 1) % _height;
+    if (_maxHeight != _maxSize) {
         queue.reserve(_width);
         loadRow(_height - 1, &queue);
     }
@@ -178,18 +194,12 @@ std::vector<TilePosition> MemoryCache::scrollLeft()
 {
     std::vector<TilePosition> queue;
     _globalOffsetX = absOffset(_globalOffsetX - 1);
-    if (_width >= _maxSize) {
-        for (std::deque<QPixmap>& row : _cache) {
-            QPixmap last = std::move(row.back());
-            row.pop_back();
-            row.push_front(std::move(last));
-        }
-    } else {
+    if (_width == 0) {
+        return queue;
+    }
+    _originX = (_originX + _width - 1) % _width;
+    if (_width < _maxSize) {
         queue.reserve(_height);
-        for (std::deque<QPixmap>& row : _cache) {
-            row.pop_back();
-            row.push_front(_emptyPixmap);
-        }
         loadColumn(0, &queue);
     }
     return queue;
@@ -199,18 +209,12 @@ std::vector<TilePosition> MemoryCache::scrollRight()
 {
     std::vector<TilePosition> queue;
     _globalOffsetX = absOffset(_globalOffsetX + 1);
-    if (_width >= _maxSize) {
-        for (std::deque<QPixmap>& row : _cache) {
-            QPixmap first = std::move(row.front());
-            row.pop_front();
-            row.push_back(std::move(first));
-        }
-    } else {
+    if (_width == 0) {
+        return queue;
+    }
+    _originX = (_originX + 1) % _width;
+    if (_width < _maxSize) {
         queue.reserve(_height);
-        for (std::deque<QPixmap>& row : _cache) {
-            row.pop_front();
-            row.push_back(_emptyPixmap);
-        }
         loadColumn(_width - 1, &queue);
     }
     return queue;
@@ -226,14 +230,14 @@ std::vector<TilePosition> MemoryCache::setPosition(int zoomLevel, int globalOffs
     setSize(std::min(_maxWidth, _maxSize), std::min(_maxHeight, _maxSize));
     _globalOffsetX = absOffset(globalOffsetX);
     _globalOffsetY = absOffset(globalOffsetY);
-    return reloadCache();
+    return loadCache();
 }
 
 std::vector<TilePosition> MemoryCache::setOffset(int globalOffsetX, int globalOffsetY)
 {
     _globalOffsetX = absOffset(globalOffsetX);
     _globalOffsetY = absOffset(globalOffsetY);
-    return reloadCache();
+    return loadCache();
 }
 
 int MemoryCache::absOffset(int globalOffset) const
@@ -248,44 +252,119 @@ int MemoryCache::absOffset(int globalOffset) const
 }
 
 std::vector<TilePosition> MemoryCache::reloadCache()
+{
+    _pixmaps.clear();
+    return loadCache();
+}
+
+std::vector<TilePosition> MemoryCache::loadCache()
 {
     std::vector<TilePosition> queue;
     queue.reserve(_height * _width);
     for (int i = 0; i < _height; i++) {
         loadRow(i, &queue);
     }
-    for (auto& cont : _cache) {
-        for (QPixmap& p : cont) {
-            p = _emptyPixmap;
-        }
-    }
     return queue;
 }
 
+void MemoryCache::loadTile(int column, int row, std::vector<TilePosition>* queue)
+{
+    TilePosition pos(_zoomLevel, absOffset(_globalOffsetX + column), absOffset(_globalOffsetY + row));
+    bmcl::OptionPtr<const QPixmap> pixmap = _pixmaps.get(pos);
+    Slot& slot = slotAt(column, row);
+    if (pixmap.isSome() && !_pixmaps.isExpired(pos, std::time(nullptr))) {
+        setSlot(&slot, *pixmap.unwrap(), SlotState::Loaded);
+        _cachedTileCount++;
+        return;
+    }
+    if (pixmap.isSome()) {
+        // expired tile is shown until loader reads it again and revalidates it
+        setSlot(&slot, *pixmap.unwrap(), SlotState::Placeholder);
+    } else if (placeholder(pos, &slot.pixmap)) {
+        slot.state = SlotState::Placeholder;
+    } else {
+        setSlot(&slot, QPixmap(), SlotState::Empty);
+    }
+    queue->push_back(pos);
+    _requestedTileCount++;
+}
+
 void MemoryCache::loadRow(int row, std::vector<TilePosition>* queue)
 {
-    int y = absOffset(_globalOffsetY + row);
-    for (int i = 0; i < (int)_cache[0].size(); i++) {
-        int x = absOffset(_globalOffsetX + i);
-        queue->emplace_back(_zoomLevel, x, y);
+    for (int i = 0; i < _width; i++) {
+        loadTile(i, row, queue);
     }
 }
 
 void MemoryCache::loadColumn(int column, std::vector<TilePosition>* queue)
 {
-    int x = absOffset(_globalOffsetX + column);
-    for (int i = 0; i < (int)_cache.size(); i++) {
-        int y = absOffset(_globalOffsetY + i);
-        queue->emplace_back(_zoomLevel, x, y);
+    for (int i = 0; i < _height; i++) {
+        loadTile(column, i, queue);
+    }
+}
+
+bool MemoryCache::parentPlaceholder(const TilePosition& pos, int depth, QPixmap* dest) const
+{
+    if (depth > pos.zoomLevel) {
+        return false;
+    }
+    TilePosition parent(pos.zoomLevel - depth, pos.globalOffsetX >> depth, pos.globalOffsetY >> depth);
+    bmcl::OptionPtr<const QPixmap> pixmap = _pixmaps.find(parent);
+    if (pixmap.isNone()) {
+        return false;
+    }
+    int size = pixmap.unwrap()->width() >> depth;
+    if (size == 0) {
+        return false;
+    }
+    int mask = (1 << depth) - 1;
+    QRect rect((pos.globalOffsetX & mask) * size, (pos.globalOffsetY & mask) * size, size, size);
+    *dest = pixmap.unwrap()->copy(rect).scaled(tileSize, tileSize);
+    return true;
+}
+
+bool MemoryCache::childrenPlaceholder(const TilePosition& pos, QPixmap* dest) const
+{
+    QPainter p;
+    for (int dy = 0; dy < 2; dy++) {
+        for (int dx = 0; dx < 2; dx++) {
+            TilePosition child(pos.zoomLevel + 1, pos.globalOffsetX * 2 + dx, pos.globalOffsetY * 2 + dy);
+            bmcl::OptionPtr<const QPixmap> pixmap = _pixmaps.find(child);
+            if (pixmap.isNone()) {
+                continue;
+            }
+            if (!p.isActive()) {
+                if (_emptyPixmap.isNull()) {
+                    // quarters of missing children must not show uninitialized memory
+                    *dest = QPixmap(tileSize, tileSize);
+                    dest->fill(Qt::transparent);
+                } else {
+                    *dest = _emptyPixmap.copy();
+                }
+                p.begin(dest);
+            }
+            p.drawPixmap(QRect(dx * tileSize / 2, dy * tileSize / 2, tileSize / 2, tileSize / 2), *pixmap.unwrap());
+        }
+    }
+    if (!p.isActive()) {
+        return false;
     }
+    p.end();
+    return true;
 }
 
-void MemoryCache::populateEmptyRow(std::deque<QPixmap>& row)
+bool MemoryCache::placeholder(const TilePosition& pos, QPixmap* dest) const
 {
-    std::size_t size = _width;
-    for (std::size_t i = 0; i < size; i++) {
-        row.push_back(_emptyPixmap);
+    // scaled tiles of nearby zoom levels are shown until tile is loaded
+    if (parentPlaceholder(pos, 1, dest) || childrenPlaceholder(pos, dest)) {
+        return true;
+    }
+    for (int depth = 2; depth <= maxPlaceholderDepth; depth++) {
+        if (parentPlaceholder(pos, depth, dest)) {
+            return true;
+        }
     }
+    return false;
 }
 
 MemoryCache::~MemoryCache()
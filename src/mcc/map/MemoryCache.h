@@ -1,10 +1,12 @@
 #pragma once
 
 #include "mcc/Config.h"
+#include "mcc/map/TilePixmapCache.h"
 
-#include <deque>
 #include <vector>
 #include <cmath>
+#include <cstdint>
+#include <ctime>
 
 #include <QPixmap>
 
@@ -31,10 +33,18 @@ public:
     inline bool isAtBottom() const;
 
     inline void setDefaultPixmap(const QPixmap& p);
+    inline void setMaxCacheBytes(std::size_t bytes);
+    inline const TilePixmapCache& pixmapCache() const;
+    inline std::size_t requestedTileCount() const;
+    inline std::size_t cachedTileCount() const;
 
     void draw(QPainter* p) const;
     void drawNonTiled(QPainter* p) const;
-    void updatePixmap(const mccmap::TilePosition& pos, const QPixmap& image);
+    // expires is unix time, expired tiles are requested again when viewport reaches them
+    void updatePixmap(const mccmap::TilePosition& pos, const QPixmap& image, std::time_t expires = TilePixmapCache::neverExpires);
+    inline void updateExpires(const mccmap::TilePosition& pos, std::time_t expires);
+    // rect of tile as drawn by drawNonTiled(), null if tile is not in cache
+    QRect tileRect(const mccmap::TilePosition& pos) const;
     inline void resetPixmap(const mccmap::TilePosition& pos);
 
     std::vector<TilePosition> setPosition(int zoomLevel, int globalOffsetX, int globalOffsetY);
@@ -44,18 +54,53 @@ public:
     std::vector<TilePosition> scrollDown();
     std::vector<TilePosition> scrollLeft();
     std::vector<TilePosition> scrollRight();
+    // drops decoded tiles of all zoom levels and requests whole viewport again
     std::vector<TilePosition> reloadCache();
 
 private:
     std::vector<TilePosition> setSize(int tileCountX, int tileCountY);
+    std::vector<TilePosition> loadCache();
     int absOffset(int globalOffset) const;
+    void setPixmap(const TilePosition& pos, const QPixmap& image);
+    void loadTile(int column, int row, std::vector<TilePosition>* queue);
     void loadRow(int row, std::vector<TilePosition>* queue);
     void loadColumn(int column, std::vector<TilePosition>* queue);
-    void populateEmptyRow(std::deque<QPixmap>& row);
+    bool placeholder(const TilePosition& pos, QPixmap* dest) const;
+    bool parentPlaceholder(const TilePosition& pos, int depth, QPixmap* dest) const;
+    bool childrenPlaceholder(const TilePosition& pos, QPixmap* dest) const;
     inline void updateMaxSize();
 
+    enum class SlotState : uint8_t {
+        Empty,       // default pixmap is drawn, slot pixmap is null
+        Placeholder, // scaled tile of nearby zoom level or expired tile, tile is requested
+        Loaded,
+    };
+
+    struct Slot {
+        Slot()
+            : state(SlotState::Empty)
+        {
+        }
+
+        QPixmap pixmap;
+        SlotState state;
+    };
+
+    // column and row are relative to viewport
+    inline Slot& slotAt(int column, int row);
+    inline const Slot& slotAt(int column, int row) const;
+    inline const QPixmap& slotPixmap(const Slot& slot) const;
+    void setSlot(Slot* slot, const QPixmap& pixmap, SlotState state);
+
     QPixmap _emptyPixmap;
-    std::deque<std::deque<QPixmap>> _cache;
+    // _width * _height slots, row major; viewport origin is at (_originX, _originY),
+    // scrolling moves origin and reloads only wrapped row or column
+    std::vector<Slot> _slots;
+    int _originX;
+    int _originY;
+    TilePixmapCache _pixmaps;
+    std::size_t _requestedTileCount;
+    std::size_t _cachedTileCount;
     int _zoomLevel;
     int _width;
     int _height;
@@ -76,14 +121,40 @@ inline void MemoryCache::setDefaultPixmap(const QPixmap& p)
     _emptyPixmap = p;
 }
 
+inline void MemoryCache::setMaxCacheBytes(std::size_t bytes)
+{
+    _pixmaps.setMaxBytes(bytes);
+}
+
+inline const TilePixmapCache& MemoryCache::pixmapCache() const
+{
+    return _pixmaps;
+}
+
+inline std::size_t MemoryCache::requestedTileCount() const
+{
+    return _requestedTileCount;
+}
+
+inline std::size_t MemoryCache::cachedTileCount() const
+{
+    return _cachedTileCount;
+}
+
 inline int MemoryCache::maxSize() const
 {
     return _maxSize;
 }
 
+inline void MemoryCache::updateExpires(const TilePosition& pos, std::time_t expires)
+{
+    _pixmaps.setExpires(pos, expires);
+}
+
 inline void MemoryCache::resetPixmap(const TilePosition& pos)
 {
-    updatePixmap(pos, _emptyPixmap);
+    _pixmaps.remove(pos);
+    setPixmap(pos, QPixmap());
 }
 
 inline bool MemoryCache::isAtBottom() const
@@ -121,6 +192,24 @@ inline QPoint MemoryCache::globalOffset() const
     return QPoint(_globalOffsetX, _globalOffsetY);
 }
 
+inline MemoryCache::Slot& MemoryCache::slotAt(int column, int row)
+{
+    return _slots[((_originY + row) % _height) * _width + (_originX + column) % _width];
+}
+
+inline const MemoryCache::Slot& MemoryCache::slotAt(int column, int row) const
+{
+    return _slots[((_originY + row) % _height) * _width + (_originX + column) % _width];
+}
+
+inline const QPixmap& MemoryCache::slotPixmap(const Slot& slot) const
+{
+    if (slot.state == SlotState::Empty) {
+        return _emptyPixmap;
+    }
+    return slot.pixmap;
+}
+
 inline void MemoryCache::updateMaxSize()
 {
     _maxSize = std::exp2(_zoomLevel);
@@ -2,6 +2,7 @@
 #include "mcc/map/TilePosition.h"
 
 #include <bmcl/Assert.h>
+#include <bmcl/Endian.h>
 #include <bmcl/Logging.h>
 #include <bmcl/MemReader.h>
 #include <bmcl/Result.h>
@@ -14,9 +15,8 @@
 #include <QRect>
 #include <QString>
 
+#include <algorithm>
 #include <cstddef>
-#include <unordered_map>
-
 #include <cstdint>
 
 namespace mccmap {
@@ -193,6 +193,36 @@ uint32_t OmcfCache::crc32(const void* data, std::size_t len)
     return ~crc;
 }
 
+// u16 zoom + 1, u32 x, u32 y, u64 offset, u64 size
+constexpr std::size_t recordSize = 2 + 4 + 4 + 8 + 8;
+constexpr int maxKeyZoom = 29;
+constexpr uint64_t invalidKey = UINT64_MAX;
+constexpr uint32_t noRecord = UINT32_MAX;
+// zoom gets grid if its bounding box has no more cells than this number per tile
+constexpr uint64_t maxCellsPerTile = 4;
+
+// packs position so that keys are ordered by zoom, x, y
+static inline uint64_t packKey(int zoom, uint32_t x, uint32_t y)
+{
+    if (zoom < 0 || zoom > maxKeyZoom || (x >> zoom) != 0 || (y >> zoom) != 0) {
+        return invalidKey;
+    }
+    return (uint64_t(zoom) << (2 * maxKeyZoom)) | (uint64_t(x) << maxKeyZoom) | y;
+}
+
+static inline uint64_t recordKey(const uint8_t* record)
+{
+    return packKey(int(le16dec(record)) - 1, le32dec(record + 2), le32dec(record + 6)); //backwards compatible zoom
+}
+
+OmcfCache::OmcfCache()
+    : _records(nullptr)
+    , _recordsNum(0)
+    , _tilesNum(0)
+    , _mapped(nullptr)
+{
+}
+
 bmcl::Result<Rc<OmcfCache>, OmcfCache::Result> OmcfCache::create(const QString& path)
 {
     Rc<OmcfCache> cache = new OmcfCache();
@@ -243,22 +273,149 @@ OmcfCache::Result OmcfCache::open(const QString& path)
     _description = QString((QChar*)header.current(), descriptionSize);
     header.skip(descriptionSize * sizeof(QChar));
     uint32_t tilesNum = header.readUint32Le();
-    for (uint32_t i = 0; i < tilesNum; i++) {
-        TilePosition pos;
-        pos.zoomLevel = header.readUint16Le() - 1; //backwards compatible zoom
-        pos.globalOffsetX = header.readUint32Le();
-        pos.globalOffsetY = header.readUint32Le();
-        TileFileInfo info;
-        info.offset = header.readUint64Le();
-        info.size = header.readUint64Le();
-        _cache.addValue(pos, info);
+    if (header.readableSize() < std::size_t(tilesNum) * recordSize) {
+        BMCL_CRITICAL() << "invalid omcf index size";
+        return NoFilesFound;
+    }
+
+    _records = header.current();
+    _recordsNum = tilesNum;
+
+    struct Bounds {
+        std::size_t count = 0;
+        uint32_t minX = UINT32_MAX;
+        uint32_t minY = UINT32_MAX;
+        uint32_t maxX = 0;
+        uint32_t maxY = 0;
+    };
+    Bounds bounds[maxKeyZoom + 1];
+    int maxZoom = -1;
+    for (std::size_t i = 0; i < _recordsNum; i++) {
+        const uint8_t* record = _records + i * recordSize;
+        if (recordKey(record) == invalidKey) {
+            continue;
+        }
+        int zoom = int(le16dec(record)) - 1;
+        uint32_t x = le32dec(record + 2);
+        uint32_t y = le32dec(record + 6);
+        Bounds& b = bounds[zoom];
+        b.count++;
+        b.minX = std::min(b.minX, x);
+        b.minY = std::min(b.minY, y);
+        b.maxX = std::max(b.maxX, x);
+        b.maxY = std::max(b.maxY, y);
+        maxZoom = std::max(maxZoom, zoom);
+    }
+
+    _zooms.resize(maxZoom + 1);
+    std::size_t cellsNum = 0;
+    for (int zoom = 0; zoom <= maxZoom; zoom++) {
+        const Bounds& b = bounds[zoom];
+        ZoomIndex& index = _zooms[zoom];
+        index.minX = 0;
+        index.minY = 0;
+        index.width = 0;
+        index.height = 0;
+        index.cellsStart = 0;
+        index.keysStart = 0;
+        index.keysNum = 0;
+        if (b.count == 0) {
+            continue;
+        }
+        uint64_t width = uint64_t(b.maxX - b.minX) + 1;
+        uint64_t height = uint64_t(b.maxY - b.minY) + 1;
+        if (width * height <= maxCellsPerTile * b.count + 64) {
+            index.minX = b.minX;
+            index.minY = b.minY;
+            index.width = uint32_t(width);
+            index.height = uint32_t(height);
+            index.cellsStart = cellsNum;
+            cellsNum += width * height;
+        }
+    }
+
+    // for duplicate positions last record wins
+    _cells.assign(cellsNum, noRecord);
+    for (std::size_t i = 0; i < _recordsNum; i++) {
+        const uint8_t* record = _records + i * recordSize;
+        uint64_t key = recordKey(record);
+        if (key == invalidKey) {
+            continue;
+        }
+        const ZoomIndex& index = _zooms[int(le16dec(record)) - 1];
+        if (index.width == 0) {
+            _keys.push_back(KeyEntry{key, uint32_t(i)});
+            continue;
+        }
+        uint32_t& cell = _cells[index.cellsStart + std::size_t(le32dec(record + 6) - index.minY) * index.width + (le32dec(record + 2) - index.minX)];
+        if (cell == noRecord) {
+            _tilesNum++;
+        }
+        cell = uint32_t(i);
+    }
+
+    std::stable_sort(_keys.begin(), _keys.end(), [](const KeyEntry& left, const KeyEntry& right) {
+        return left.key < right.key;
+    });
+    auto last = std::unique(_keys.rbegin(), _keys.rend(), [](const KeyEntry& left, const KeyEntry& right) {
+        return left.key == right.key;
+    });
+    _keys.erase(_keys.begin(), last.base());
+    _keys.shrink_to_fit();
+    _tilesNum += _keys.size();
+    for (std::size_t i = 0; i < _keys.size(); i++) {
+        ZoomIndex& index = _zooms[_keys[i].key >> (2 * maxKeyZoom)];
+        if (index.keysNum == 0) {
+            index.keysStart = i;
+        }
+        index.keysNum++;
     }
     return Ok;
 }
 
+uint32_t OmcfCache::findRecord(const TilePosition& pos) const
+{
+    if (pos.zoomLevel < 0 || pos.zoomLevel >= int(_zooms.size())) {
+        return noRecord;
+    }
+    const ZoomIndex& index = _zooms[pos.zoomLevel];
+    if (index.width != 0) {
+        // negative offsets wrap around and fall outside of grid
+        uint32_t x = uint32_t(pos.globalOffsetX) - index.minX;
+        uint32_t y = uint32_t(pos.globalOffsetY) - index.minY;
+        if (x >= index.width || y >= index.height) {
+            return noRecord;
+        }
+        return _cells[index.cellsStart + std::size_t(y) * index.width + x];
+    }
+    uint64_t key = packKey(pos.zoomLevel, pos.globalOffsetX, pos.globalOffsetY);
+    auto first = _keys.begin() + index.keysStart;
+    auto end = first + index.keysNum;
+    auto it = std::lower_bound(first, end, key, [](const KeyEntry& entry, uint64_t key) {
+        return entry.key < key;
+    });
+    if (it == end || it->key != key) {
+        return noRecord;
+    }
+    return it->record;
+}
+
+bmcl::Option<OmcfCache::TileFileInfo> OmcfCache::findTile(const TilePosition& pos) const
+{
+    uint32_t i = findRecord(pos);
+    if (i == noRecord) {
+        return bmcl::None;
+    }
+    const uint8_t* record = _records + std::size_t(i) * recordSize;
+    TileFileInfo info;
+    info.offset = le64dec(record + 10);
+    info.size = le64dec(record + 18);
+    return info;
+}
+
 QImage OmcfCache::readImage(const TilePosition& pos, const QRect& rect) const
 {
-    auto info = _cache.get(pos);
+    auto info = findTile(pos);
     if (info.isNone()) {
         return QImage();
     }
@@ -271,7 +428,7 @@ QImage OmcfCache::readImage(const TilePosition& pos, const QRect& rect) const
 
 bool OmcfCache::tileExists(const TilePosition& pos) const
 {
-    return _cache.get(pos).isSome();
+    return findTile(pos).isSome();
 }
 
 const mccgeo::MercatorProjection& OmcfCache::projection() const
@@ -284,6 +441,33 @@ const QString& OmcfCache::path() const
     return _path;
 }
 
+std::vector<TilePosition> OmcfCache::tiles() const
+{
+    std::vector<TilePosition> tiles;
+    tiles.reserve(size());
+    for (std::size_t i = 0; i < _recordsNum; i++) {
+        const uint8_t* record = _records + i * recordSize;
+        if (recordKey(record) == invalidKey) {
+            continue;
+        }
+        TilePosition pos(int(le16dec(record)) - 1, le32dec(record + 2), le32dec(record + 6));
+        // skip records overridden by later duplicates
+        if (findRecord(pos) == i) {
+            tiles.push_back(pos);
+        }
+    }
+    return tiles;
+}
+
+bmcl::Bytes OmcfCache::tileData(const TilePosition& pos) const
+{
+    auto info = findTile(pos);
+    if (info.isNone()) {
+        return bmcl::Bytes();
+    }
+    return bmcl::Bytes(_mapped + info.unwrap().offset, info.unwrap().size);
+}
+
 OmcfCache::~OmcfCache()
 {
 }
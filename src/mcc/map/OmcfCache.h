@@ -2,15 +2,17 @@
 
 #include "mcc/map/FileCache.h"
 #include "mcc/geo/MercatorProjection.h"
-#include "mcc/map/TilePosCache.h"
 #include "mcc/map/Rc.h"
 
 #include <bmcl/Fwd.h>
+#include <bmcl/Bytes.h>
+#include <bmcl/Option.h>
 
 #include <QString>
 #include <QFile>
 
 #include <cstdint>
+#include <vector>
 
 class QImage;
 
@@ -23,6 +25,7 @@ public:
     static constexpr uint32_t headerMagic = 0x5a5a5a5a;
 
     enum Result { Ok, NoFilesFound, WriteError };
+    OmcfCache();
     ~OmcfCache();
 
     static uint32_t crc32(const void* data, std::size_t len);
@@ -40,6 +43,8 @@ public:
     bool tileExists(const TilePosition& pos) const override;
 
     const QString& path() const;
+    std::vector<TilePosition> tiles() const;
+    bmcl::Bytes tileData(const TilePosition& pos) const;
 
 private:
     struct TileFileInfo {
@@ -47,7 +52,33 @@ private:
         int64_t size;
     };
 
-    FastTilePosCache<TileFileInfo> _cache;
+    // tiles of one zoom, indexed by dense grid of record numbers over their bounding box
+    // or by sorted keys if tiles are too sparse for grid
+    struct ZoomIndex {
+        uint32_t minX;
+        uint32_t minY;
+        uint32_t width;
+        uint32_t height;
+        std::size_t cellsStart;
+        std::size_t keysStart;
+        std::size_t keysNum;
+    };
+
+    struct KeyEntry {
+        uint64_t key;
+        uint32_t record;
+    };
+
+    uint32_t findRecord(const TilePosition& pos) const;
+    bmcl::Option<TileFileInfo> findTile(const TilePosition& pos) const;
+
+    // index records inside mapped header
+    const uchar* _records;
+    std::size_t _recordsNum;
+    std::size_t _tilesNum;
+    std::vector<ZoomIndex> _zooms;
+    std::vector<uint32_t> _cells;
+    std::vector<KeyEntry> _keys;
     mccgeo::MercatorProjection _proj;
     QFile _file;
     QString _name;
@@ -58,6 +89,6 @@ private:
 
 inline int OmcfCache::size() const
 {
-    return (int)_cache.count();
+    return (int)_tilesNum;
 }
 }
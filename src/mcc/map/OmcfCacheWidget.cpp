@@ -1,9 +1,8 @@
 #include "mcc/map/OmcfCacheWidget.h"
 #include "mcc/geo/MercatorProjection.h"
 #include "mcc/map/OmcfCache.h"
+#include "mcc/map/OmcfWriter.h"
 
-#include <bmcl/Assert.h>
-#include <bmcl/MemWriter.h>
 
 #include <QComboBox>
 #include <QDir>
@@ -13,6 +12,7 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
+#include <QMessageBox>
 #include <QProgressBar>
 #include <QPushButton>
 #include <QSettings>
@@ -65,57 +65,47 @@ void OmcfCacheWidget::createCache(const QString& dirPath, const QString& outputP
     getFiles(inputDir.absolutePath().length() + 1, format.constData(), &inputDir, &tiles);
     int count = (int)tiles.count();
 
-    QFile output(outputPath);
-    if (!output.open(QIODevice::WriteOnly)) {
+    OmcfWriter output;
+    if (output.open(outputPath, inputDir.absolutePath(), name, description, proj, count) != OmcfWriter::Ok) {
+        emit failed(QString("Не удалось открыть файл %1").arg(outputPath));
+        emit finished();
         return;
     }
 
-    uint32_t headerSize = 4 + 4 + 2 * sizeof(double) + 4 + name.size() * sizeof(QChar) + 4
-        + description.size() * sizeof(QChar) + 4 + count * (2 + 4 + 4 + 8 + 8) + 4;
-    int64_t currentOffset = headerSize;
-    double a = proj.majorAxis();
-    double b = proj.minorAxis();
-    output.seek(currentOffset);
-    std::unique_ptr<uint8_t[]> data(new uint8_t[headerSize]);
-    bmcl::MemWriter header(data.get(), headerSize);
-    header.writeUint32Le(OmcfCache::headerMagic);
-    header.writeUint32Le(headerSize);
-    header.write(&a, sizeof(double));
-    header.write(&b, sizeof(double));
-    header.writeUint32Le(name.size());
-    header.write(name.constData(), name.size() * sizeof(QChar));
-    header.writeUint32Le(description.size());
-    header.write(description.constData(), description.size() * sizeof(QChar));
-    header.writeUint32Le(count);
-    auto writer = [this, &header, &inputDir, &output, &currentOffset, &count](const TilePosition& pos,
-                                                                              const QString& path, std::size_t index) {
-        QFile input(inputDir.absoluteFilePath(path));
-        if (!input.open(QIODevice::ReadOnly)) {
+    // first error stops writing, unfinished pack is resumed by next run with same parameters
+    QString error;
+    auto writer = [this, &inputDir, &output, &count, &error](const TilePosition& pos, const QString& path, std::size_t index) {
+        if (!error.isEmpty()) {
             return;
         }
-
-        QByteArray data = input.readAll();
-        if (data.isNull()) {
-            return;
+        // tiles written before interruption are already in journal
+        if (!output.hasTile(pos)) {
+            QFile input(inputDir.absoluteFilePath(path));
+            if (!input.open(QIODevice::ReadOnly)) {
+                error = QString("Не удалось открыть файл %1").arg(input.fileName());
+                return;
+            }
+
+            QByteArray data = input.readAll();
+            if (data.isNull()) {
+                error = QString("Не удалось прочитать файл %1").arg(input.fileName());
+                return;
+            }
+
+            if (output.addTile(pos, data.constData(), data.size()) != OmcfWriter::Ok) {
+                error = QString("Не удалось записать тайл в файл %1").arg(outputPath);
+                return;
+            }
         }
-        int64_t fileSize = data.size();
-
-        header.writeUint16Le(pos.zoomLevel + 1);  //backwards compatible zoom
-        header.writeUint32Le(pos.globalOffsetX);
-        header.writeUint32Le(pos.globalOffsetY);
-        header.writeUint64Le(currentOffset);
-        header.writeUint64Le(fileSize);
-        currentOffset += fileSize;
-
-        output.write(data);
         emit progressChanged(double(index + 1) / double(count) * 100);
     };
     tiles.map(writer);
-    uint32_t crc = OmcfCache::crc32(header.start(), header.sizeUsed());
-    header.writeUint32Le(crc);
-    BMCL_ASSERT(header.writableSize() == 0);
-    output.seek(0);
-    output.write((char*)header.start(), header.sizeUsed());
+    if (error.isEmpty() && output.finish() != OmcfWriter::Ok) {
+        error = QString("Не удалось записать файл %1").arg(outputPath);
+    }
+    if (!error.isEmpty()) {
+        emit failed(error);
+    }
     emit finished();
 }
 
@@ -229,6 +219,9 @@ OmcfCacheWidget::OmcfCacheWidget(QWidget* parent)
 
     connect(this, &OmcfCacheWidget::progressChanged, _progressBar, &QProgressBar::setValue, Qt::QueuedConnection);
     connect(this, &OmcfCacheWidget::finished, _progressBar, &QProgressBar::hide, Qt::QueuedConnection);
+    connect(this, &OmcfCacheWidget::failed, this, [this](const QString& message) {
+        QMessageBox::warning(this, "Создание кеша карт", message);
+    }, Qt::QueuedConnection);
 
     connect(createButton, &QPushButton::clicked, this,
             [this, openDirEdit, saveFileEdit, imageFormatBox, projectionBox, nameEdit, descriptionEdit]() {
@@ -19,6 +19,7 @@ public:
 
 signals:
     void progressChanged(int value);
+    void failed(const QString& message);
     void finished();
 
 private:
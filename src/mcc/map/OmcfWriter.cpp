@@ -0,0 +1,320 @@
+#include "mcc/map/OmcfWriter.h"
+#include "mcc/map/OmcfCache.h"
+
+#include <bmcl/Buffer.h>
+#include <bmcl/Logging.h>
+#include <bmcl/MemReader.h>
+#include <bmcl/MemWriter.h>
+
+#include <QFileInfo>
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+
+namespace mccmap {
+
+constexpr uint32_t journalMagic = 0x324a434d;
+constexpr std::size_t entrySize = 2 + 4 + 4 + 8 + 8;
+
+static void writeString(bmcl::Buffer* dest, const QString& str)
+{
+    dest->writeUint32Le(str.size());
+    dest->write(str.constData(), str.size() * sizeof(QChar));
+}
+
+OmcfWriter::OmcfWriter()
+    : _dataStart(0)
+    , _dataEnd(0)
+{
+}
+
+OmcfWriter::~OmcfWriter()
+{
+    close();
+}
+
+uint32_t OmcfWriter::headerSize(const QString& name, const QString& description, std::size_t tileCount)
+{
+    return 4 + 4 + 2 * sizeof(double) + 4 + name.size() * sizeof(QChar) + 4
+        + description.size() * sizeof(QChar) + 4 + tileCount * entrySize + 4;
+}
+
+bool OmcfWriter::isOpen() const
+{
+    return _data.isOpen();
+}
+
+std::size_t OmcfWriter::count() const
+{
+    return _entries.size();
+}
+
+bool OmcfWriter::hasTile(const TilePosition& pos) const
+{
+    return _index.get(pos).isSome();
+}
+
+void OmcfWriter::close()
+{
+    if (isOpen()) {
+        flush();
+    }
+    _data.close();
+    _journal.close();
+    _pendingJournal.clear();
+}
+
+// pack parameters and start of tile data, header is the same only for write with same parameters
+QByteArray OmcfWriter::journalHeader(std::size_t expectedTileCount) const
+{
+    bmcl::Buffer header;
+    header.writeUint32Le(journalMagic);
+    header.writeUint64Le(_dataStart);
+    header.writeUint64Le(expectedTileCount);
+    header.writeFloat64Le(_proj.majorAxis());
+    header.writeFloat64Le(_proj.minorAxis());
+    writeString(&header, _source);
+    writeString(&header, _name);
+    writeString(&header, _description);
+    return QByteArray((const char*)header.data(), (int)header.size());
+}
+
+OmcfWriter::Result OmcfWriter::open(const QString& path, const QString& source, const QString& name, const QString& description,
+                                    const mccgeo::MercatorProjection& proj, std::size_t expectedTileCount)
+{
+    close();
+    _path = path;
+    _source = source;
+    _name = name;
+    _description = description;
+    _proj = proj;
+    _entries.clear();
+    _index = FastTilePosCache<std::size_t>();
+    _dataStart = headerSize(name, description, expectedTileCount);
+    _dataEnd = _dataStart;
+    QByteArray header = journalHeader(expectedTileCount);
+
+    _data.setFileName(path + ".part");
+    _journal.setFileName(path + ".part.journal");
+    if (_journal.exists() && _data.exists()) {
+        Result rv = readJournal(header);
+        if (rv == Ok) {
+            return Ok;
+        }
+        close();
+        _entries.clear();
+        _index = FastTilePosCache<std::size_t>();
+        _dataEnd = _dataStart;
+        BMCL_INFO() << "discarding unfinished omcf write with other parameters: " << _data.fileName().toStdString();
+    }
+
+    if (!_data.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        BMCL_WARNING() << "failed to open omcf data file: " << _data.fileName().toStdString();
+        return OpenError;
+    }
+    if (!_journal.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        BMCL_WARNING() << "failed to open omcf journal: " << _journal.fileName().toStdString();
+        return OpenError;
+    }
+
+    if (_journal.write(header) != header.size() || !_journal.flush()) {
+        return WriteError;
+    }
+    return Ok;
+}
+
+OmcfWriter::Result OmcfWriter::readJournal(const QByteArray& expectedHeader)
+{
+    if (!_data.open(QIODevice::ReadWrite) || !_journal.open(QIODevice::ReadWrite)) {
+        return OpenError;
+    }
+    QByteArray journal = _journal.readAll();
+    if (!journal.startsWith(expectedHeader)) {
+        return ReadError;
+    }
+    std::size_t journalHeaderSize = expectedHeader.size();
+    bmcl::MemReader reader((const uint8_t*)journal.constData(), journal.size());
+    reader.skip(journalHeaderSize);
+    int64_t dataSize = _data.size();
+
+    while (reader.readableSize() >= entrySize) {
+        Entry entry;
+        entry.pos.zoomLevel = reader.readUint16Le() - 1;
+        entry.pos.globalOffsetX = reader.readUint32Le();
+        entry.pos.globalOffsetY = reader.readUint32Le();
+        entry.offset = reader.readUint64Le();
+        entry.size = reader.readUint64Le();
+        if (entry.offset != _dataEnd || (entry.offset + entry.size) > dataSize) {
+            break;
+        }
+        _dataEnd += entry.size;
+        if (hasTile(entry.pos)) {
+            continue;
+        }
+        _index.addValue(entry.pos, _entries.size());
+        _entries.push_back(entry);
+    }
+
+    // drop data and journal records written after last complete tile
+    std::size_t validJournalSize = journalHeaderSize + (journal.size() - journalHeaderSize - reader.readableSize()) / entrySize * entrySize;
+    if (!_journal.resize(validJournalSize) || !_data.resize(_dataEnd)) {
+        return WriteError;
+    }
+    _journal.seek(validJournalSize);
+    BMCL_INFO() << "resuming omcf write with " << _entries.size() << " tiles";
+    return Ok;
+}
+
+OmcfWriter::Result OmcfWriter::importPack(const OmcfCache* cache)
+{
+    for (const TilePosition& pos : cache->tiles()) {
+        if (hasTile(pos)) {
+            continue;
+        }
+        bmcl::Bytes data = cache->tileData(pos);
+        Result rv = addTile(pos, data.data(), data.size());
+        if (rv != Ok) {
+            return rv;
+        }
+    }
+    return Ok;
+}
+
+OmcfWriter::Result OmcfWriter::addTile(const TilePosition& pos, const void* data, std::size_t size)
+{
+    if (!isOpen()) {
+        return OpenError;
+    }
+    if (hasTile(pos)) {
+        return Ok;
+    }
+    if (!_data.seek(_dataEnd) || _data.write((const char*)data, size) != int64_t(size)) {
+        return WriteError;
+    }
+
+    Entry entry;
+    entry.pos = pos;
+    entry.offset = _dataEnd;
+    entry.size = size;
+
+    uint8_t record[entrySize];
+    bmcl::MemWriter writer(record, sizeof(record));
+    writer.writeUint16Le(pos.zoomLevel + 1); //backwards compatible zoom
+    writer.writeUint32Le(pos.globalOffsetX);
+    writer.writeUint32Le(pos.globalOffsetY);
+    writer.writeUint64Le(entry.offset);
+    writer.writeUint64Le(entry.size);
+    _pendingJournal.append((const char*)record, sizeof(record));
+
+    _dataEnd += size;
+    _index.addValue(pos, _entries.size());
+    _entries.push_back(entry);
+    if (_pendingJournal.size() >= int(flushInterval * entrySize)) {
+        return flush();
+    }
+    return Ok;
+}
+
+// journal records are written only after data they point to, so journal never refers to lost data
+OmcfWriter::Result OmcfWriter::flush()
+{
+    if (!isOpen()) {
+        return OpenError;
+    }
+    if (_pendingJournal.isEmpty()) {
+        return Ok;
+    }
+    if (!_data.flush()) {
+        return WriteError;
+    }
+    if (_journal.write(_pendingJournal) != _pendingJournal.size() || !_journal.flush()) {
+        return WriteError;
+    }
+    _pendingJournal.clear();
+    return Ok;
+}
+
+OmcfWriter::Result OmcfWriter::shiftData(uint32_t newDataStart)
+{
+    int64_t delta = int64_t(newDataStart) - _dataStart;
+    constexpr int64_t chunkSize = 1024 * 1024;
+    std::unique_ptr<char[]> chunk(new char[chunkSize]);
+    int64_t end = _dataEnd;
+    while (end > _dataStart) {
+        int64_t size = std::min(chunkSize, end - _dataStart);
+        int64_t from = end - size;
+        if (!_data.seek(from) || _data.read(chunk.get(), size) != size) {
+            return ReadError;
+        }
+        if (!_data.seek(from + delta) || _data.write(chunk.get(), size) != size) {
+            return WriteError;
+        }
+        end = from;
+    }
+    for (Entry& entry : _entries) {
+        entry.offset += delta;
+    }
+    _dataStart += delta;
+    _dataEnd += delta;
+    return Ok;
+}
+
+OmcfWriter::Result OmcfWriter::finish()
+{
+    Result rv = flush();
+    if (rv != Ok) {
+        return rv;
+    }
+
+    uint32_t size = headerSize(_name, _description, _entries.size());
+    if (size > _dataStart) {
+        rv = shiftData(size);
+        if (rv != Ok) {
+            return rv;
+        }
+    }
+
+    // sorted index keeps tiles of one zoom together and pack contents listed in stable order
+    std::sort(_entries.begin(), _entries.end(), [](const Entry& left, const Entry& right) {
+        return std::tie(left.pos.zoomLevel, left.pos.globalOffsetX, left.pos.globalOffsetY)
+             < std::tie(right.pos.zoomLevel, right.pos.globalOffsetX, right.pos.globalOffsetY);
+    });
+
+    double a = _proj.majorAxis();
+    double b = _proj.minorAxis();
+    std::unique_ptr<uint8_t[]> data(new uint8_t[size]);
+    bmcl::MemWriter header(data.get(), size);
+    header.writeUint32Le(OmcfCache::headerMagic);
+    header.writeUint32Le(size);
+    header.write(&a, sizeof(double));
+    header.write(&b, sizeof(double));
+    header.writeUint32Le(_name.size());
+    header.write(_name.constData(), _name.size() * sizeof(QChar));
+    header.writeUint32Le(_description.size());
+    header.write(_description.constData(), _description.size() * sizeof(QChar));
+    header.writeUint32Le(_entries.size());
+    for (const Entry& entry : _entries) {
+        header.writeUint16Le(entry.pos.zoomLevel + 1); //backwards compatible zoom
+        header.writeUint32Le(entry.pos.globalOffsetX);
+        header.writeUint32Le(entry.pos.globalOffsetY);
+        header.writeUint64Le(entry.offset);
+        header.writeUint64Le(entry.size);
+    }
+    uint32_t crc = OmcfCache::crc32(header.start(), header.sizeUsed());
+    header.writeUint32Le(crc);
+
+    if (!_data.seek(0) || _data.write((const char*)header.start(), header.sizeUsed()) != size || !_data.flush()) {
+        return WriteError;
+    }
+    close();
+
+    QFile::remove(_path);
+    if (!QFile::rename(_data.fileName(), _path)) {
+        BMCL_WARNING() << "failed to rename omcf file: " << _path.toStdString();
+        return WriteError;
+    }
+    _journal.remove();
+    return Ok;
+}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "mcc/Config.h"
+#include "mcc/map/TilePosition.h"
+#include "mcc/map/TilePosCache.h"
+#include "mcc/geo/MercatorProjection.h"
+
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+namespace mccmap {
+
+class OmcfCache;
+
+// Writes omcf pack tile by tile. Tiles go to <path>.part right after space reserved for header,
+// written tiles are recorded in <path>.part.journal after their data is flushed, so interrupted write
+// can be resumed. Journal header keeps pack parameters, leftover of write with other parameters is discarded.
+// finish() writes header with index and renames .part file to path, close() leaves .part file for resume.
+class MCC_MAP_DECLSPEC OmcfWriter {
+public:
+    enum Result { Ok, OpenError, WriteError, ReadError };
+
+    OmcfWriter();
+    ~OmcfWriter();
+
+    // tiles written between flushes of data and journal
+    static constexpr std::size_t flushInterval = 64;
+
+    static uint32_t headerSize(const QString& name, const QString& description, std::size_t tileCount);
+
+    // source identifies where tiles come from, e.g. directory or url, write is resumed only from same source
+    Result open(const QString& path, const QString& source, const QString& name, const QString& description,
+                const mccgeo::MercatorProjection& proj, std::size_t expectedTileCount);
+    Result importPack(const OmcfCache* cache);
+    Result addTile(const TilePosition& pos, const void* data, std::size_t size);
+    Result flush();
+    Result finish();
+    void close();
+
+    bool hasTile(const TilePosition& pos) const;
+    std::size_t count() const;
+    bool isOpen() const;
+
+private:
+    struct Entry {
+        TilePosition pos;
+        int64_t offset;
+        int64_t size;
+    };
+
+    QByteArray journalHeader(std::size_t expectedTileCount) const;
+    Result readJournal(const QByteArray& expectedHeader);
+    Result shiftData(uint32_t newDataStart);
+
+    FastTilePosCache<std::size_t> _index;
+    std::vector<Entry> _entries;
+    mccgeo::MercatorProjection _proj;
+    QFile _data;
+    QFile _journal;
+    QByteArray _pendingJournal;
+    QString _path;
+    QString _source;
+    QString _name;
+    QString _description;
+    int64_t _dataStart;
+    int64_t _dataEnd;
+};
+}
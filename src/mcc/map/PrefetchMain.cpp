@@ -0,0 +1,113 @@
+#include "mcc/map/TilePrefetcher.h"
+#include "mcc/geo/LatLon.h"
+#include "mcc/geo/MercatorProjection.h"
+
+#include <tclap/CmdLine.h>
+
+#include <QCoreApplication>
+#include <QString>
+#include <QStringList>
+
+#include <iostream>
+
+using namespace mccmap;
+
+static bool parsePolygon(const std::string& str, std::vector<mccgeo::LatLon>* polygon)
+{
+    for (const QString& point : QString::fromStdString(str).split(';', QString::SkipEmptyParts)) {
+        QStringList coords = point.split(',');
+        if (coords.size() != 2) {
+            return false;
+        }
+        bool latOk;
+        bool lonOk;
+        double lat = coords[0].trimmed().toDouble(&latOk);
+        double lon = coords[1].trimmed().toDouble(&lonOk);
+        if (!latOk || !lonOk) {
+            return false;
+        }
+        polygon->emplace_back(lat, lon);
+    }
+    return polygon->size() >= 3;
+}
+
+static void replaceAll(std::string* str, const std::string& from, const std::string& to)
+{
+    std::size_t pos = 0;
+    while ((pos = str->find(from, pos)) != std::string::npos) {
+        str->replace(pos, from.size(), to);
+        pos += to.size();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    TCLAP::CmdLine cmdLine("omcf prefetch");
+    TCLAP::ValueArg<std::string> urlArg("u", "url", "Tile url template with {z}, {x} and {y} placeholders", true, "", "url");
+    TCLAP::ValueArg<std::string> polygonArg("p", "polygon", "Region polygon as lat,lon;lat,lon;...", true, "", "polygon");
+    TCLAP::ValueArg<int> minZoomArg("", "min-zoom", "Min zoom level", false, 1, "zoom");
+    TCLAP::ValueArg<int> maxZoomArg("", "max-zoom", "Max zoom level", true, 1, "zoom");
+    TCLAP::ValueArg<std::string> outputArg("o", "output", "Output omcf file", true, "", "path");
+    TCLAP::ValueArg<std::string> nameArg("n", "name", "Pack name", false, "", "name");
+    TCLAP::ValueArg<std::string> descriptionArg("d", "description", "Pack description", false, "", "text");
+    TCLAP::ValueArg<unsigned> connectionsArg("c", "connections", "Max parallel connections", false, 16, "count");
+    TCLAP::SwitchArg ellipticalArg("", "elliptical", "Use elliptical mercator projection");
+
+    cmdLine.add(&urlArg);
+    cmdLine.add(&polygonArg);
+    cmdLine.add(&minZoomArg);
+    cmdLine.add(&maxZoomArg);
+    cmdLine.add(&outputArg);
+    cmdLine.add(&nameArg);
+    cmdLine.add(&descriptionArg);
+    cmdLine.add(&connectionsArg);
+    cmdLine.add(&ellipticalArg);
+    cmdLine.parse(argc, argv);
+
+    std::vector<mccgeo::LatLon> polygon;
+    if (!parsePolygon(polygonArg.getValue(), &polygon)) {
+        std::cerr << "invalid polygon" << std::endl;
+        return -1;
+    }
+    if (minZoomArg.getValue() < 1 || maxZoomArg.getValue() < minZoomArg.getValue() || maxZoomArg.getValue() > 20) {
+        std::cerr << "invalid zoom range" << std::endl;
+        return -1;
+    }
+
+    mccgeo::MercatorProjection proj(ellipticalArg.getValue() ? mccgeo::MercatorProjection::EllipticalMercator
+                                                             : mccgeo::MercatorProjection::SphericalMercator);
+    std::string urlTemplate = urlArg.getValue();
+
+    TilePrefetcher prefetcher;
+    prefetcher.setProjection(proj);
+    prefetcher.setMaxConnections(connectionsArg.getValue());
+    prefetcher.setGenerator([urlTemplate](const TilePosition& pos) {
+        std::string url = urlTemplate;
+        replaceAll(&url, "{z}", std::to_string(pos.zoomLevel));
+        replaceAll(&url, "{x}", std::to_string(pos.globalOffsetX));
+        replaceAll(&url, "{y}", std::to_string(pos.globalOffsetY));
+        return url;
+    });
+
+    QObject::connect(&prefetcher, &TilePrefetcher::progressChanged, [](std::size_t processed, std::size_t total) {
+        std::cout << "\r" << processed << "/" << total << std::flush;
+    });
+    QObject::connect(&prefetcher, &TilePrefetcher::finished, [&prefetcher](bool isOk) {
+        std::cout << std::endl << "downloaded: " << prefetcher.downloadedCount()
+                  << ", skipped: " << prefetcher.skippedCount()
+                  << ", failed: " << prefetcher.failedCount() << std::endl;
+        QCoreApplication::exit(isOk ? 0 : 1);
+    });
+
+    std::vector<TilePosition> tiles = TilePrefetcher::tilesInPolygon(proj, polygon, minZoomArg.getValue(), maxZoomArg.getValue());
+    std::cout << "tiles in region: " << tiles.size() << std::endl;
+    QString output = QString::fromStdString(outputArg.getValue());
+    if (!prefetcher.start(output, QString::fromStdString(nameArg.getValue()),
+                          QString::fromStdString(descriptionArg.getValue()), std::move(tiles))) {
+        std::cerr << "failed to open " << outputArg.getValue() << std::endl;
+        return -1;
+    }
+    return app.exec();
+}
@@ -9,6 +9,9 @@
 #include <QDir>
 #include <QPixmap>
 
+#include <ctime>
+#include <limits>
+
 namespace mccmap {
 
 TileLoader::TileLoader(FileCache* cache, QObject* parent)
@@ -22,11 +25,16 @@ TileLoader::TileLoader(FileCache* cache, QObject* parent)
     for (std::size_t i = 0; i < numDownloaders; i++) {
         auto& handle = _handles[i];
         handle.easy = _multi.addTransfer();
+        handle.isRevalidation = false;
 
         handle.easy->setWriteFunction([&handle](const void* buf, std::size_t size) -> std::size_t {
             handle.imgBuf.write(buf, size);
             return size;
         });
+        handle.easy->setHeaderFunction([&handle](const void* buf, std::size_t size) -> std::size_t {
+            handle.response.addHeader((const char*)buf, size);
+            return size;
+        });
 
         const char* userAgent = "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_10; rv:33.0) Gecko/20100101 Firefox/33.0";
         handle.easy->set(CURLOPT_USERAGENT, userAgent);
@@ -35,41 +43,7 @@ TileLoader::TileLoader(FileCache* cache, QObject* parent)
         handle.easy->set(CURLOPT_SSL_VERIFYPEER, 0L);
 
         connect(handle.easy, &CurlEasy::done, this, [this, &handle](CURLcode code) {
-            if (code == CURLE_OK) {
-                QPixmap pixmap;
-                if (pixmap.loadFromData(handle.imgBuf.data(), handle.imgBuf.size())) {
-                    emit pixmapReady(handle.pos, pixmap);
-                    saveImg(handle.pos, handle.imgBuf);
-                } else {
-                    emit pixmapFailed(handle.pos);
-                    BMCL_DEBUG() << "failed to load downloaded pixmap " << handle.url;
-                }
-            } else {
-                emit pixmapFailed(handle.pos);
-                BMCL_DEBUG() << "failed to download pixmap " << handle.url + " " + curl_easy_strerror(code);
-            }
-            assert(_numUsedHandles != 0);
-
-            handle.imgBuf.resize(0);
-
-            if (!_downloadQueue.empty()) {
-                handle.pos = _downloadQueue.back();
-                auto url = _mapInfo->generateTileUrl(handle.pos);
-                _downloadQueue.pop_back();
-                if (url.isNone()) {
-                    _numUsedHandles--;
-                    return;
-                }
-
-                handle.url = url.take();
-                assert(!handle.easy->isRunning());
-                handle.easy->set(CURLOPT_URL, handle.url.data());
-                handle.easy->perform();
-            } else {
-                assert(_numUsedHandles != 0);
-                _numUsedHandles--;
-            }
-
+            onDownloadDone(handle, code);
         });
     }
     _numUsedHandles = 0;
@@ -80,6 +54,139 @@ TileLoader::~TileLoader()
     disconnect(_mapInfo.get(), &FileCache::cacheReloaded, this, 0);
 }
 
+void TileLoader::onDownloadDone(EasyPosAndUrl& handle, CURLcode code)
+{
+    long httpCode = 0;
+    handle.easy->get(CURLINFO_RESPONSE_CODE, &httpCode);
+    if (code == CURLE_OK && httpCode == 304 && handle.isRevalidation) {
+        // tile on disk is still valid, only its freshness is updated
+        updateValidators(handle, true);
+        emit pixmapRevalidated(handle.pos, expires(handle.pos, true));
+    } else if (code == CURLE_OK) {
+        QPixmap pixmap;
+        if (pixmap.loadFromData(handle.imgBuf.data(), handle.imgBuf.size())) {
+            if (httpCode == 200) {
+                updateValidators(handle, false);
+            }
+            emit pixmapReady(handle.pos, pixmap, expires(handle.pos, true));
+            saveImg(handle.pos, handle.imgBuf);
+        } else {
+            if (!handle.isRevalidation) {
+                emit pixmapFailed(handle.pos);
+            }
+            BMCL_DEBUG() << "failed to load downloaded pixmap " << handle.url;
+        }
+    } else {
+        if (!handle.isRevalidation) {
+            emit pixmapFailed(handle.pos);
+        }
+        BMCL_DEBUG() << "failed to download pixmap " << handle.url + " " + curl_easy_strerror(code);
+    }
+    assert(_numUsedHandles != 0);
+
+    handle.imgBuf.resize(0);
+
+    while (!_downloadQueue.empty()) {
+        handle.pos = _downloadQueue.back();
+        _downloadQueue.pop_back();
+        if (startDownload(handle)) {
+            return;
+        }
+    }
+    _numUsedHandles--;
+}
+
+bool TileLoader::startDownload(EasyPosAndUrl& handle)
+{
+    auto url = _mapInfo->generateTileUrl(handle.pos);
+    if (url.isNone()) {
+        return false;
+    }
+
+    handle.url = url.take();
+    handle.imgBuf.resize(0);
+    handle.response.reset();
+    handle.isRevalidation = false;
+    handle.easy->removeHttpHeader("If-None-Match");
+    handle.easy->removeHttpHeader("If-Modified-Since");
+
+    auto index = validators();
+    if (index.isSome()) {
+        auto entry = index->find(handle.pos);
+        // entry is left after tile file is removed from cache
+        if (entry.isSome() && _mapInfo->tileExists(handle.pos)) {
+            handle.isRevalidation = true;
+            if (!entry->etag.empty()) {
+                handle.easy->setHttpHeaderRaw("If-None-Match", QByteArray(entry->etag.data(), (int)entry->etag.size()));
+            }
+            if (!entry->lastModified.empty()) {
+                handle.easy->setHttpHeaderRaw("If-Modified-Since", QByteArray(entry->lastModified.data(), (int)entry->lastModified.size()));
+            }
+        }
+    }
+
+    assert(!handle.easy->isRunning());
+    handle.easy->set(CURLOPT_URL, handle.url.data());
+    handle.easy->perform();
+    return true;
+}
+
+bmcl::OptionPtr<TileValidators> TileLoader::validators()
+{
+    auto path = _mapInfo->generateTileIndexPath();
+    if (path.isNone()) {
+        return bmcl::None;
+    }
+    _validators.open(path.unwrap());
+    return &_validators;
+}
+
+void TileLoader::updateValidators(const EasyPosAndUrl& handle, bool isNotModified)
+{
+    auto index = validators();
+    if (index.isNone()) {
+        return;
+    }
+    // validators of cached entry belong to old tile body, new body keeps only its own
+    if (isNotModified) {
+        index->update(handle.pos, handle.response.makeEntry(std::time(nullptr), index->find(handle.pos)));
+    } else {
+        index->update(handle.pos, handle.response.makeEntry(std::time(nullptr)));
+    }
+}
+
+bool TileLoader::isExpired(const TilePosition& pos)
+{
+    auto index = validators();
+    if (index.isNone()) {
+        return false;
+    }
+    // tiles saved before index was introduced are kept as is
+    auto entry = index->find(pos);
+    return entry.isSome() && entry->expires <= std::time(nullptr);
+}
+
+// memory cache of map layer keeps tile until this time
+qint64 TileLoader::expires(const TilePosition& pos, bool isOriginal)
+{
+    // nothing newer can be loaded, cache is reloaded when download is enabled
+    if (!_downloadEnabled) {
+        return std::numeric_limits<qint64>::max();
+    }
+    if (!isOriginal) {
+        return 0;
+    }
+    auto index = validators();
+    if (index.isNone()) {
+        return std::numeric_limits<qint64>::max();
+    }
+    auto entry = index->find(pos);
+    if (entry.isNone()) {
+        return std::numeric_limits<qint64>::max();
+    }
+    return entry->expires;
+}
+
 void TileLoader::saveImg(const TilePosition& pos, const bmcl::Buffer& img)
 {
     auto path = _mapInfo->generateTileSavePath(pos);
@@ -119,15 +226,15 @@ void TileLoader::addRequest(const TilePosition& pos)
         if (pixmap.isNull()) {
             emit pixmapFailed(pos);
         } else {
-            emit pixmapReady(pos, pixmap);
+            emit pixmapReady(pos, pixmap, expires(pos, pair.second == FileCache::TileType::Original));
         }
     }
 
-    if (pair.second == FileCache::TileType::Original) {
+    if (!_downloadEnabled) {
         return;
     }
 
-    if (!_downloadEnabled) {
+    if (pair.second == FileCache::TileType::Original && !isExpired(pos)) {
         return;
     }
 
@@ -144,17 +251,9 @@ void TileLoader::addRequest(const TilePosition& pos)
     EasyPosAndUrl& handle = *it;
 
     handle.pos = pos;
-    auto url = _mapInfo->generateTileUrl(handle.pos);
-    if (url.isNone()) {
-        return;
+    if (startDownload(handle)) {
+        _numUsedHandles++;
     }
-    _numUsedHandles++;
-
-    handle.imgBuf.resize(0);
-    handle.url = url.take();
-    assert(!handle.easy->isRunning());
-    handle.easy->set(CURLOPT_URL, handle.url.data());
-    handle.easy->perform();
 }
 
 void TileLoader::cancelRequest(const TilePosition& pos)
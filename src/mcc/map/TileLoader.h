@@ -5,8 +5,10 @@
 #include "mcc/map/TilePosition.h"
 #include "mcc/map/CurlMulti.h"
 #include "mcc/map/Rc.h"
+#include "mcc/map/TileValidators.h"
 
 #include <bmcl/Buffer.h>
+#include <bmcl/OptionPtr.h>
 
 class QPixmap;
 
@@ -24,7 +26,10 @@ public:
     ~TileLoader();
 
 signals:
-    void pixmapReady(const TilePosition& pos, const QPixmap& pixmap);
+    // expires is unix time when tile must be requested again
+    void pixmapReady(const TilePosition& pos, const QPixmap& pixmap, qint64 expires);
+    // tile on disk is still valid, 304 response
+    void pixmapRevalidated(const TilePosition& pos, qint64 expires);
     void pixmapFailed(const TilePosition& pos);
     void cacheReloaded();
 
@@ -36,20 +41,31 @@ public slots:
     void setDownloadEnabled(bool flag);
 
 private:
-    void saveImg(const TilePosition& pos, const bmcl::Buffer& img);
-
     struct EasyPosAndUrl {
         CurlEasy* easy;
         TilePosition pos;
         std::string url;
         bmcl::Buffer imgBuf;
+        TileValidators::Response response;
+        // conditional request for expired tile which is already shown from disk cache
+        bool isRevalidation;
     };
 
+    void saveImg(const TilePosition& pos, const bmcl::Buffer& img);
+    bool startDownload(EasyPosAndUrl& handle);
+    void onDownloadDone(EasyPosAndUrl& handle, CURLcode code);
+    void updateValidators(const EasyPosAndUrl& handle, bool isNotModified);
+    bool isExpired(const TilePosition& pos);
+    // scaled tiles are replaced by downloaded ones
+    qint64 expires(const TilePosition& pos, bool isOriginal);
+    bmcl::OptionPtr<TileValidators> validators();
+
     std::array<EasyPosAndUrl, numDownloaders> _handles;
     std::size_t _numUsedHandles;
     std::vector<TilePosition> _downloadQueue;
     CurlMulti _multi;
     Rc<FileCache> _mapInfo;
+    TileValidators _validators;
     int _zoomLevel;
     bool _downloadEnabled;
 };
@@ -0,0 +1,128 @@
+#include "mcc/map/TilePixmapCache.h"
+
+namespace mccmap {
+
+constexpr std::time_t TilePixmapCache::neverExpires;
+
+TilePixmapCache::TilePixmapCache(std::size_t maxBytes)
+    : _maxBytes(maxBytes)
+    , _bytes(0)
+{
+}
+
+TilePixmapCache::~TilePixmapCache()
+{
+}
+
+uint64_t TilePixmapCache::key(const TilePosition& pos)
+{
+    return (uint64_t(pos.zoomLevel) << 58) | (uint64_t(uint32_t(pos.globalOffsetX)) << 29) | uint64_t(uint32_t(pos.globalOffsetY));
+}
+
+std::size_t TilePixmapCache::pixmapBytes(const QPixmap& pixmap)
+{
+    return std::size_t(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+
+void TilePixmapCache::setMaxBytes(std::size_t maxBytes)
+{
+    _maxBytes = maxBytes;
+    while (_bytes > _maxBytes && !_tiles.empty()) {
+        removeOldest();
+    }
+}
+
+std::size_t TilePixmapCache::maxBytes() const
+{
+    return _maxBytes;
+}
+
+std::size_t TilePixmapCache::bytes() const
+{
+    return _bytes;
+}
+
+std::size_t TilePixmapCache::size() const
+{
+    return _tiles.size();
+}
+
+bmcl::OptionPtr<const QPixmap> TilePixmapCache::get(const TilePosition& pos)
+{
+    auto it = _index.find(key(pos));
+    if (it == _index.end()) {
+        return bmcl::None;
+    }
+    _tiles.splice(_tiles.begin(), _tiles, it->second);
+    return &it->second->pixmap;
+}
+
+bmcl::OptionPtr<const QPixmap> TilePixmapCache::find(const TilePosition& pos) const
+{
+    auto it = _index.find(key(pos));
+    if (it == _index.end()) {
+        return bmcl::None;
+    }
+    return &it->second->pixmap;
+}
+
+void TilePixmapCache::add(const TilePosition& pos, const QPixmap& pixmap, std::time_t expires)
+{
+    uint64_t k = key(pos);
+    auto it = _index.find(k);
+    if (it != _index.end()) {
+        _bytes -= pixmapBytes(it->second->pixmap);
+        it->second->pixmap = pixmap;
+        it->second->expires = expires;
+        _tiles.splice(_tiles.begin(), _tiles, it->second);
+    } else {
+        _tiles.emplace_front(k, pixmap, expires);
+        _index.emplace(k, _tiles.begin());
+    }
+    _bytes += pixmapBytes(pixmap);
+    // most recent tile is kept even if it alone exceeds budget
+    while (_bytes > _maxBytes && _tiles.size() > 1) {
+        removeOldest();
+    }
+}
+
+void TilePixmapCache::setExpires(const TilePosition& pos, std::time_t expires)
+{
+    auto it = _index.find(key(pos));
+    if (it != _index.end()) {
+        it->second->expires = expires;
+    }
+}
+
+bool TilePixmapCache::isExpired(const TilePosition& pos, std::time_t now) const
+{
+    auto it = _index.find(key(pos));
+    return it != _index.end() && it->second->expires <= now;
+}
+
+void TilePixmapCache::remove(const TilePosition& pos)
+{
+    auto it = _index.find(key(pos));
+    if (it == _index.end()) {
+        return;
+    }
+    _bytes -= pixmapBytes(it->second->pixmap);
+    _tiles.erase(it->second);
+    _index.erase(it);
+}
+
+void TilePixmapCache::clear()
+{
+    _tiles.clear();
+    _index.clear();
+    _bytes = 0;
+}
+
+void TilePixmapCache::removeOldest()
+{
+    const Entry& last = _tiles.back();
+    _bytes -= pixmapBytes(last.pixmap);
+    _index.erase(last.key);
+    _tiles.pop_back();
+}
+}
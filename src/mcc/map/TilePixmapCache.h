@@ -0,0 +1,70 @@
+#pragma once
+
+#include "mcc/Config.h"
+#include "mcc/map/TilePosition.h"
+
+#include <bmcl/OptionPtr.h>
+
+#include <QPixmap>
+
+#include <cstdint>
+#include <ctime>
+#include <limits>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace mccmap {
+
+// Decoded tiles of all zoom levels, least recently used tiles are removed when byte budget is exceeded.
+// Expired tiles are kept, they are shown until loader reads and revalidates them again
+class MCC_MAP_DECLSPEC TilePixmapCache {
+public:
+    static constexpr std::time_t neverExpires = std::numeric_limits<std::time_t>::max();
+
+    explicit TilePixmapCache(std::size_t maxBytes = 128 * 1024 * 1024);
+    ~TilePixmapCache();
+
+    void setMaxBytes(std::size_t maxBytes);
+    std::size_t maxBytes() const;
+    std::size_t bytes() const;
+    std::size_t size() const;
+
+    // marks tile as recently used
+    bmcl::OptionPtr<const QPixmap> get(const TilePosition& pos);
+    // does not change tile order
+    bmcl::OptionPtr<const QPixmap> find(const TilePosition& pos) const;
+
+    // expires is unix time
+    void add(const TilePosition& pos, const QPixmap& pixmap, std::time_t expires = neverExpires);
+    void setExpires(const TilePosition& pos, std::time_t expires);
+    // false if tile is not in cache
+    bool isExpired(const TilePosition& pos, std::time_t now) const;
+    void remove(const TilePosition& pos);
+    void clear();
+
+private:
+    struct Entry {
+        Entry(uint64_t key, const QPixmap& pixmap, std::time_t expires)
+            : key(key)
+            , pixmap(pixmap)
+            , expires(expires)
+        {
+        }
+
+        uint64_t key;
+        QPixmap pixmap;
+        std::time_t expires;
+    };
+    using List = std::list<Entry>;
+
+    static uint64_t key(const TilePosition& pos);
+    static std::size_t pixmapBytes(const QPixmap& pixmap);
+    void removeOldest();
+
+    List _tiles;
+    std::unordered_map<uint64_t, List::iterator> _index;
+    std::size_t _maxBytes;
+    std::size_t _bytes;
+};
+}
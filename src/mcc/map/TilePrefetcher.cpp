@@ -0,0 +1,322 @@
+#include "mcc/map/TilePrefetcher.h"
+#include "mcc/map/CurlEasy.h"
+#include "mcc/map/OmcfCache.h"
+
+#include <bmcl/Logging.h>
+#include <bmcl/Result.h>
+
+#include <QFileInfo>
+#include <QTimer>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mccmap {
+
+TilePrefetcher::TilePrefetcher(QObject* parent)
+    : QObject(parent)
+    , _multi(this)
+    , _userAgent("Mozilla/5.0 (Macintosh; Intel Mac OS X 10_10; rv:33.0) Gecko/20100101 Firefox/33.0")
+    , _maxConnections(16)
+    , _maxRetries(3)
+    , _total(0)
+    , _downloaded(0)
+    , _skipped(0)
+    , _failed(0)
+    , _running(0)
+    , _hasWriteErrors(false)
+    , _isStopped(false)
+    , _isActive(false)
+{
+}
+
+TilePrefetcher::~TilePrefetcher()
+{
+}
+
+void TilePrefetcher::setGenerator(const Generator& generator)
+{
+    _generator = generator;
+}
+
+void TilePrefetcher::setProjection(const mccgeo::MercatorProjection& proj)
+{
+    _proj = proj;
+}
+
+void TilePrefetcher::setMaxConnections(std::size_t num)
+{
+    _maxConnections = std::max<std::size_t>(1, num);
+}
+
+void TilePrefetcher::setMaxRetries(std::size_t num)
+{
+    _maxRetries = num;
+}
+
+void TilePrefetcher::setUserAgent(const std::string& userAgent)
+{
+    _userAgent = userAgent;
+}
+
+std::size_t TilePrefetcher::downloadedCount() const
+{
+    return _downloaded;
+}
+
+std::size_t TilePrefetcher::skippedCount() const
+{
+    return _skipped;
+}
+
+std::size_t TilePrefetcher::failedCount() const
+{
+    return _failed;
+}
+
+static void addColumns(double from, double to, int tileCount, std::vector<bool>* columns)
+{
+    int first = std::max(0, (int)std::floor(std::min(from, to)));
+    int last = std::min(tileCount - 1, (int)std::floor(std::max(from, to)));
+    for (int x = first; x <= last; x++) {
+        (*columns)[x] = true;
+    }
+}
+
+std::vector<TilePosition> TilePrefetcher::tilesInPolygon(const mccgeo::MercatorProjection& proj,
+                                                         const std::vector<mccgeo::LatLon>& polygon,
+                                                         int minZoom, int maxZoom)
+{
+    std::vector<TilePosition> tiles;
+    if (polygon.size() < 3) {
+        return tiles;
+    }
+
+    for (int zoom = minZoom; zoom <= maxZoom; zoom++) {
+        int tileCount = 1 << zoom;
+        // polygon in tile units
+        std::vector<std::pair<double, double>> points;
+        points.reserve(polygon.size());
+        double minY = tileCount;
+        double maxY = 0;
+        for (const mccgeo::LatLon& latLon : polygon) {
+            double x = (1 + proj.longitudeToRelativeOffset(latLon.longitude())) / 2 * tileCount;
+            double y = (0.5 - proj.latitudeToRelativeOffset(latLon.latitude())) * tileCount;
+            points.emplace_back(x, y);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+        }
+
+        int firstRow = std::max(0, (int)std::floor(minY));
+        int lastRow = std::min(tileCount - 1, (int)std::floor(maxY));
+        std::vector<bool> columns(tileCount);
+        std::vector<double> crossings;
+        for (int row = firstRow; row <= lastRow; row++) {
+            std::fill(columns.begin(), columns.end(), false);
+            crossings.clear();
+            double top = row;
+            double bottom = row + 1;
+            double middle = row + 0.5;
+            for (std::size_t i = 0; i < points.size(); i++) {
+                const auto& p1 = points[i];
+                const auto& p2 = points[(i + 1) % points.size()];
+                double y1 = p1.second;
+                double y2 = p2.second;
+                // edge part inside row covers every column between its ends
+                double clipTop = std::max(top, std::min(y1, y2));
+                double clipBottom = std::min(bottom, std::max(y1, y2));
+                if (clipTop <= clipBottom) {
+                    if (y1 == y2) {
+                        addColumns(p1.first, p2.first, tileCount, &columns);
+                    } else {
+                        double k = (p2.first - p1.first) / (y2 - y1);
+                        addColumns(p1.first + k * (clipTop - y1), p1.first + k * (clipBottom - y1), tileCount, &columns);
+                    }
+                }
+                if ((y1 <= middle) != (y2 <= middle)) {
+                    crossings.push_back(p1.first + (middle - y1) * (p2.first - p1.first) / (y2 - y1));
+                }
+            }
+            // tiles fully inside polygon
+            std::sort(crossings.begin(), crossings.end());
+            for (std::size_t i = 0; i + 1 < crossings.size(); i += 2) {
+                addColumns(crossings[i], crossings[i + 1], tileCount, &columns);
+            }
+            for (int x = 0; x < tileCount; x++) {
+                if (columns[x]) {
+                    tiles.emplace_back(zoom, x, row);
+                }
+            }
+        }
+    }
+    return tiles;
+}
+
+bool TilePrefetcher::start(const QString& path, const QString& name, const QString& description, std::vector<TilePosition>&& tiles)
+{
+    if (_isActive || !_generator) {
+        return false;
+    }
+
+    _total = tiles.size();
+    _downloaded = 0;
+    _skipped = 0;
+    _failed = 0;
+    _hasWriteErrors = false;
+    _isStopped = false;
+
+    // url of first tile of world identifies tile source of unfinished pack
+    QString source = QString::fromStdString(_generator(TilePosition()));
+    if (_writer.open(path, source, name, description, _proj, tiles.size()) != OmcfWriter::Ok) {
+        return false;
+    }
+    if (QFileInfo(path).exists()) {
+        auto cache = OmcfCache::create(path);
+        if (cache.isOk() && _writer.importPack(cache.unwrap().get()) != OmcfWriter::Ok) {
+            return false;
+        }
+    }
+
+    _queue.clear();
+    _queue.reserve(tiles.size());
+    // download from the end of queue, so tiles are requested in original order
+    for (auto it = tiles.rbegin(); it != tiles.rend(); it++) {
+        if (_writer.hasTile(*it)) {
+            _skipped++;
+        } else {
+            _queue.push_back(*it);
+        }
+    }
+    tiles.clear();
+    _isActive = true;
+    BMCL_INFO() << "prefetching " << _queue.size() << " tiles, " << _skipped << " already present";
+
+    std::size_t numTransfers = std::min(_maxConnections, _queue.size());
+    _multi.set(CURLMOPT_MAX_HOST_CONNECTIONS, long(_maxConnections));
+    _transfers.resize(numTransfers);
+    _running = 0;
+    for (Transfer& transfer : _transfers) {
+        Transfer* t = &transfer;
+        t->easy = _multi.addTransfer();
+        t->retries = 0;
+        t->easy->setWriteFunction([t](const void* buf, std::size_t size) -> std::size_t {
+            t->buf.write(buf, size);
+            return size;
+        });
+        t->easy->set(CURLOPT_USERAGENT, _userAgent.c_str());
+        t->easy->set(CURLOPT_NOSIGNAL, 1L);
+        t->easy->set(CURLOPT_TIMEOUT, 30L);
+        t->easy->set(CURLOPT_SSL_VERIFYPEER, 0L);
+        t->easy->set(CURLOPT_FOLLOWLOCATION, 1L);
+        connect(t->easy, &CurlEasy::done, this, [this, t](CURLcode code) {
+            onTransferDone(t, code);
+        });
+    }
+    for (Transfer& transfer : _transfers) {
+        startNext(&transfer);
+    }
+    // every tile may be already present, report that from event loop
+    QTimer::singleShot(0, this, [this]() {
+        checkFinished();
+    });
+    return true;
+}
+
+void TilePrefetcher::stop()
+{
+    if (!_isActive) {
+        return;
+    }
+    _isStopped = true;
+    _queue.clear();
+    for (Transfer& transfer : _transfers) {
+        if (transfer.easy->abort()) {
+            _running--;
+        }
+    }
+    checkFinished();
+}
+
+void TilePrefetcher::startNext(Transfer* transfer)
+{
+    while (!_queue.empty()) {
+        transfer->pos = _queue.back();
+        _queue.pop_back();
+        transfer->retries = 0;
+        std::string url = _generator(transfer->pos);
+        if (url.empty()) {
+            _failed++;
+            emit tileFailed(transfer->pos);
+            continue;
+        }
+        transfer->url = std::move(url);
+        startTransfer(transfer);
+        return;
+    }
+}
+
+void TilePrefetcher::startTransfer(Transfer* transfer)
+{
+    transfer->buf.resize(0);
+    transfer->easy->set(CURLOPT_URL, transfer->url.c_str());
+    transfer->easy->perform();
+    _running++;
+}
+
+// server errors and throttling may pass, missing tiles and other client errors are final
+static bool isTransient(int code, long httpCode)
+{
+    return code != CURLE_OK || httpCode >= 500 || httpCode == 429;
+}
+
+void TilePrefetcher::onTransferDone(Transfer* transfer, int code)
+{
+    _running--;
+    long httpCode = 0;
+    transfer->easy->get(CURLINFO_RESPONSE_CODE, &httpCode);
+    if (code == CURLE_OK && httpCode == 200 && !transfer->buf.isEmpty()) {
+        if (_writer.addTile(transfer->pos, transfer->buf.data(), transfer->buf.size()) == OmcfWriter::Ok) {
+            _downloaded++;
+        } else {
+            BMCL_CRITICAL() << "failed to write tile to omcf file";
+            _hasWriteErrors = true;
+            _queue.clear();
+        }
+    } else if (isTransient(code, httpCode) && transfer->retries < _maxRetries) {
+        transfer->retries++;
+        startTransfer(transfer);
+        return;
+    } else {
+        _failed++;
+        BMCL_DEBUG() << "failed to download tile " << transfer->url << " " << httpCode << " " << curl_easy_strerror((CURLcode)code);
+        emit tileFailed(transfer->pos);
+    }
+    emit progressChanged(_downloaded + _skipped + _failed, _total);
+    startNext(transfer);
+    checkFinished();
+}
+
+void TilePrefetcher::checkFinished()
+{
+    if (!_isActive || _running != 0 || !_queue.empty()) {
+        return;
+    }
+    for (Transfer& transfer : _transfers) {
+        transfer.easy->deleteLater();
+    }
+    _transfers.clear();
+    _isActive = false;
+    // stopped pack is left unfinished and resumed on next run with same parameters
+    if (_isStopped) {
+        _writer.close();
+        emit finished(false);
+        return;
+    }
+    // tiles that failed to download are not in pack and are requested again on next run
+    bool isOk = !_hasWriteErrors && _failed == 0;
+    if (!_hasWriteErrors) {
+        isOk &= _writer.finish() == OmcfWriter::Ok;
+    }
+    emit finished(isOk);
+}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "mcc/Config.h"
+#include "mcc/map/TilePosition.h"
+#include "mcc/map/CurlMulti.h"
+#include "mcc/map/OmcfWriter.h"
+#include "mcc/geo/MercatorProjection.h"
+#include "mcc/geo/LatLon.h"
+
+#include <bmcl/Buffer.h>
+
+#include <QObject>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mccmap {
+
+class CurlEasy;
+
+// Downloads tiles of region directly into omcf pack without disk cache
+class MCC_MAP_DECLSPEC TilePrefetcher : public QObject {
+    Q_OBJECT
+public:
+    using Generator = std::function<std::string(const TilePosition&)>;
+
+    explicit TilePrefetcher(QObject* parent = nullptr);
+    ~TilePrefetcher();
+
+    static std::vector<TilePosition> tilesInPolygon(const mccgeo::MercatorProjection& proj,
+                                                    const std::vector<mccgeo::LatLon>& polygon,
+                                                    int minZoom, int maxZoom);
+
+    void setGenerator(const Generator& generator);
+    void setProjection(const mccgeo::MercatorProjection& proj);
+    void setMaxConnections(std::size_t num);
+    void setMaxRetries(std::size_t num);
+    void setUserAgent(const std::string& userAgent);
+
+    bool start(const QString& path, const QString& name, const QString& description, std::vector<TilePosition>&& tiles);
+    // downloaded tiles stay in unfinished pack, next start with same parameters resumes it
+    void stop();
+
+    std::size_t downloadedCount() const;
+    std::size_t skippedCount() const;
+    std::size_t failedCount() const;
+
+signals:
+    void progressChanged(std::size_t processed, std::size_t total);
+    void tileFailed(const TilePosition& pos);
+    void finished(bool isOk);
+
+private:
+    struct Transfer {
+        CurlEasy* easy;
+        TilePosition pos;
+        std::string url;
+        bmcl::Buffer buf;
+        std::size_t retries;
+    };
+
+    void onTransferDone(Transfer* transfer, int code);
+    void startNext(Transfer* transfer);
+    void startTransfer(Transfer* transfer);
+    void checkFinished();
+
+    CurlMulti _multi;
+    OmcfWriter _writer;
+    Generator _generator;
+    mccgeo::MercatorProjection _proj;
+    std::vector<Transfer> _transfers;
+    std::vector<TilePosition> _queue;
+    std::string _userAgent;
+    std::size_t _maxConnections;
+    std::size_t _maxRetries;
+    std::size_t _total;
+    std::size_t _downloaded;
+    std::size_t _skipped;
+    std::size_t _failed;
+    std::size_t _running;
+    bool _hasWriteErrors;
+    bool _isStopped;
+    bool _isActive;
+};
+}
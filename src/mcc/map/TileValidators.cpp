@@ -0,0 +1,252 @@
+#include "mcc/map/TileValidators.h"
+
+#include <bmcl/Logging.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace mccmap {
+
+static bool startsWithNoCase(const char* data, std::size_t size, const char* prefix)
+{
+    std::size_t prefixSize = std::strlen(prefix);
+    if (size < prefixSize) {
+        return false;
+    }
+    for (std::size_t i = 0; i < prefixSize; i++) {
+        if (std::tolower((unsigned char)data[i]) != prefix[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::string trimmed(const char* begin, const char* end)
+{
+    while (begin != end && std::isspace((unsigned char)*begin)) {
+        begin++;
+    }
+    while (end != begin && std::isspace((unsigned char)end[-1])) {
+        end--;
+    }
+    return std::string(begin, end);
+}
+
+void TileValidators::Response::reset()
+{
+    etag.clear();
+    lastModified.clear();
+    maxAge.clear();
+    expires.clear();
+}
+
+void TileValidators::Response::addHeader(const char* data, std::size_t size)
+{
+    // every response of redirect chain starts with status line
+    if (startsWithNoCase(data, size, "http/")) {
+        reset();
+        return;
+    }
+    const char* end = data + size;
+    const char* colon = std::find(data, end, ':');
+    if (colon == end) {
+        return;
+    }
+    std::string value = trimmed(colon + 1, end);
+    // tab and newline separate index fields
+    if (value.find_first_of("\t\r\n") != std::string::npos) {
+        return;
+    }
+
+    if (startsWithNoCase(data, size, "etag:")) {
+        etag = std::move(value);
+    } else if (startsWithNoCase(data, size, "last-modified:")) {
+        lastModified = std::move(value);
+    } else if (startsWithNoCase(data, size, "expires:")) {
+        std::time_t t = curl_getdate(value.c_str(), nullptr);
+        expires = t < 0 ? 0 : t;
+    } else if (startsWithNoCase(data, size, "cache-control:")) {
+        for (char& c : value) {
+            c = std::tolower((unsigned char)c);
+        }
+        if (value.find("no-cache") != std::string::npos || value.find("no-store") != std::string::npos) {
+            maxAge = std::time_t(0);
+            return;
+        }
+        std::size_t pos = value.find("max-age=");
+        if (pos != std::string::npos) {
+            maxAge = std::max<std::time_t>(0, std::strtoll(value.c_str() + pos + 8, nullptr, 10));
+        }
+    }
+}
+
+TileValidators::Entry TileValidators::Response::makeEntry(std::time_t now, bmcl::OptionPtr<const Entry> cached) const
+{
+    Entry entry;
+    entry.etag = etag;
+    entry.lastModified = lastModified;
+    if (cached.isSome()) {
+        if (entry.etag.empty()) {
+            entry.etag = cached->etag;
+        }
+        if (entry.lastModified.empty()) {
+            entry.lastModified = cached->lastModified;
+        }
+    }
+    if (maxAge.isSome()) {
+        entry.expires = now + maxAge.unwrap();
+    } else if (expires.isSome()) {
+        entry.expires = expires.unwrap();
+    } else {
+        entry.expires = now + defaultFreshness;
+    }
+    return entry;
+}
+
+TileValidators::TileValidators()
+{
+}
+
+TileValidators::~TileValidators()
+{
+}
+
+static QByteArray formatLine(uint64_t key, const TileValidators::Entry& entry)
+{
+    QByteArray line = QByteArray::number((qulonglong)key, 16);
+    line += '\t';
+    line += QByteArray::number((qlonglong)entry.expires);
+    line += '\t';
+    line.append(entry.etag.data(), (int)entry.etag.size());
+    line += '\t';
+    line.append(entry.lastModified.data(), (int)entry.lastModified.size());
+    line += '\n';
+    return line;
+}
+
+uint64_t TileValidators::key(const TilePosition& pos)
+{
+    return (uint64_t(pos.zoomLevel) << 58) | (uint64_t(uint32_t(pos.globalOffsetX)) << 29) | uint64_t(uint32_t(pos.globalOffsetY));
+}
+
+void TileValidators::open(const QString& path)
+{
+    if (path == _path) {
+        return;
+    }
+    close();
+    _path = path;
+    if (_path.isEmpty()) {
+        return;
+    }
+    load();
+}
+
+void TileValidators::close()
+{
+    _file.close();
+    _entries.clear();
+    _path.clear();
+}
+
+const QString& TileValidators::path() const
+{
+    return _path;
+}
+
+std::size_t TileValidators::size() const
+{
+    return _entries.size();
+}
+
+bmcl::OptionPtr<const TileValidators::Entry> TileValidators::find(const TilePosition& pos) const
+{
+    auto it = _entries.find(key(pos));
+    if (it == _entries.end()) {
+        return bmcl::None;
+    }
+    return &it->second;
+}
+
+void TileValidators::update(const TilePosition& pos, const Entry& entry)
+{
+    uint64_t k = key(pos);
+    _entries[k] = entry;
+    append(k, entry);
+}
+
+void TileValidators::load()
+{
+    std::size_t lines = 0;
+    QFile file(_path);
+    if (file.open(QIODevice::ReadOnly)) {
+        while (!file.atEnd()) {
+            QByteArray line = file.readLine();
+            lines++;
+            if (line.endsWith('\n')) {
+                line.chop(1);
+            }
+            QList<QByteArray> fields = line.split('\t');
+            if (fields.size() != 4) {
+                continue;
+            }
+            bool isKeyOk;
+            bool isTimeOk;
+            uint64_t k = fields[0].toULongLong(&isKeyOk, 16);
+            qint64 expires = fields[1].toLongLong(&isTimeOk);
+            if (!isKeyOk || !isTimeOk) {
+                continue;
+            }
+            Entry& entry = _entries[k];
+            entry.expires = expires;
+            entry.etag.assign(fields[2].constData(), fields[2].size());
+            entry.lastModified.assign(fields[3].constData(), fields[3].size());
+        }
+        file.close();
+    }
+
+    // every update appends line, so most lines of old index are stale
+    if (lines > _entries.size() * 2 + 256) {
+        compact();
+    }
+
+    QDir().mkpath(QFileInfo(_path).absolutePath());
+    _file.setFileName(_path);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        BMCL_DEBUG() << "failed to open tile index for write: " << _path.toStdString();
+    }
+}
+
+void TileValidators::compact()
+{
+    QSaveFile file(_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    QByteArray data;
+    for (const auto& it : _entries) {
+        data += formatLine(it.first, it.second);
+    }
+    file.write(data);
+    if (!file.commit()) {
+        BMCL_DEBUG() << "failed to compact tile index: " << _path.toStdString();
+    }
+}
+
+void TileValidators::append(uint64_t key, const Entry& entry)
+{
+    if (!_file.isOpen()) {
+        return;
+    }
+    _file.write(formatLine(key, entry));
+    _file.flush();
+}
+}
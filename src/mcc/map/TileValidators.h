@@ -0,0 +1,68 @@
+#pragma once
+
+#include "mcc/Config.h"
+#include "mcc/map/TilePosition.h"
+
+#include <bmcl/Option.h>
+#include <bmcl/OptionPtr.h>
+
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+
+namespace mccmap {
+
+// ETag and Last-Modified of downloaded tiles, expired tiles are revalidated with conditional requests.
+// Index is kept in sidecar file of disk cache, updates are appended and file is compacted on load
+class MCC_MAP_DECLSPEC TileValidators {
+public:
+    struct Entry {
+        std::string etag;
+        std::string lastModified;
+        std::time_t expires = 0;
+    };
+
+    // validators and freshness collected from response headers
+    struct Response {
+        void reset();
+        void addHeader(const char* data, std::size_t size);
+        // headers of 304 response may omit validators, those are taken from cached entry;
+        // cached entry must not be passed for 200 response, its validators belong to old body
+        Entry makeEntry(std::time_t now, bmcl::OptionPtr<const Entry> cached = bmcl::None) const;
+
+        std::string etag;
+        std::string lastModified;
+        bmcl::Option<std::time_t> maxAge;
+        bmcl::Option<std::time_t> expires;
+    };
+
+    // freshness of tiles without Cache-Control and Expires headers
+    static constexpr std::time_t defaultFreshness = 7 * 24 * 3600;
+
+    TileValidators();
+    ~TileValidators();
+
+    // does nothing if index is already loaded from this path
+    void open(const QString& path);
+    void close();
+    const QString& path() const;
+
+    bmcl::OptionPtr<const Entry> find(const TilePosition& pos) const;
+    void update(const TilePosition& pos, const Entry& entry);
+    std::size_t size() const;
+
+private:
+    static uint64_t key(const TilePosition& pos);
+    void load();
+    void compact();
+    void append(uint64_t key, const Entry& entry);
+
+    QString _path;
+    QFile _file;
+    std::unordered_map<uint64_t, Entry> _entries;
+};
+}
@@ -2,6 +2,7 @@
 
 #include "mcc/map/drawables/Interfaces.h"
 #include "mcc/map/drawables/Wrappers.h"
+#include "mcc/map/drawables/PolyLineIndex.h"
 #include "mcc/map/MapRect.h"
 #include "mcc/map/Rc.h"
 #include "mcc/map/LineAndPos.h"
@@ -94,10 +95,19 @@ public:
     QPainterPath createArrowheads(bool isConnected = false, bool backwards = false) const;
 
 private:
+    // shorter polylines are searched linearly
+    static constexpr const std::size_t minIndexedCount = 64;
+
     void recalcDistancesAround(std::size_t index);
     void recalcDistancesFor(std::size_t current, std::size_t next);
+    void invalidateIndex();
+    void invalidateIndex(std::size_t index);
+    void updatePointIndex() const;
+    void updateSegmentIndex() const;
 
     std::deque<W> _points;
+    mutable PolyLineIndex _pointIndex;
+    mutable PolyLineIndex _segmentIndex;
     Rc<const MapRect> _rect;
     double _totalDistance;
     QPen _pen;
@@ -123,6 +133,13 @@ template <typename T, typename W>
 template <typename C>
 bmcl::Option<std::size_t> PolyLineBase<T, W>::nearest(const QPointF& position, C&& checker) const
 {
+    if (_points.size() >= minIndexedCount) {
+        updatePointIndex();
+        return _pointIndex.find(position, 1, true, [&](std::size_t i) {
+            const W& point = _points[i];
+            return point.hasInRect(position) && checker(point);
+        });
+    }
     std::size_t i = _points.size();
     for (auto it = _points.rbegin(); it < _points.rend(); ++it, --i) {
         if (it->hasInRect(position)) {
@@ -138,6 +155,12 @@ bmcl::Option<std::size_t> PolyLineBase<T, W>::nearest(const QPointF& position, C
 template <typename T, typename W>
 bmcl::Option<std::size_t> PolyLineBase<T, W>::nearest(const QPointF& position) const
 {
+    if (_points.size() >= minIndexedCount) {
+        updatePointIndex();
+        return _pointIndex.find(position, 1, true, [&](std::size_t i) {
+            return _points[i].hasInRect(position);
+        });
+    }
     std::size_t i = _points.size();
     for (auto it = _points.rbegin(); it < _points.rend(); ++it, --i) {
         if (it->hasInRect(position)) {
@@ -150,7 +173,13 @@ bmcl::Option<std::size_t> PolyLineBase<T, W>::nearest(const QPointF& position) c
 template <typename T, typename W>
 bmcl::Option<std::size_t> PolyLineBase<T, W>::nearestFromBegining(const QPointF& position) const
 {
-    std::size_t i = 0;;
+    if (_points.size() >= minIndexedCount) {
+        updatePointIndex();
+        return _pointIndex.find(position, 1, false, [&](std::size_t i) {
+            return _points[i].hasInRect(position);
+        });
+    }
+    std::size_t i = 0;
     for (auto it = _points.begin(); it < _points.end(); it++) {
         if (it->hasInRect(position)) {
             return i;
@@ -202,25 +231,36 @@ bmcl::Option<LineIndexAndPos> PolyLineBase<T, W>::nearestLine(const QPointF& pos
         return projectPointOnLine(p1.x(), p1.y(), p2.x(), p2.y(), p3.x(), p3.y());
     };
 
-    auto it = _points.begin();
-    auto nextIt = it + 1;
-    while (nextIt < _points.end()) {
-        const QPointF& p1 = it->position();
-        const QPointF& p2 = nextIt->position();
+    QPointF projected;
+    auto isOnSegment = [&](std::size_t i) {
+        const QPointF& p1 = _points[i].position();
+        const QPointF& p2 = _points[i + 1].position();
         QRectF rect(p1, p2);
         rect.adjust(-width, -width, width, width);
         if (rect.contains(position)) {
-            QPointF projected = projectPointOnLine2(p1, p2, position);
-            if (std::hypot(position.x() - projected.x(), position.y() - projected.y()) < width) {
-                return bmcl::Option<LineIndexAndPos>(bmcl::InPlace, it - _points.begin(), projected);
+            projected = projectPointOnLine2(p1, p2, position);
+            return std::hypot(position.x() - projected.x(), position.y() - projected.y()) < width;
+        }
+        return false;
+    };
+
+    if (_points.size() >= minIndexedCount) {
+        updateSegmentIndex();
+        // boxes are expanded by width here, extra pixel covers rounding of adjusted rect
+        bmcl::Option<std::size_t> index = _segmentIndex.find(position, width + 1, false, isOnSegment);
+        if (index.isSome()) {
+            return bmcl::Option<LineIndexAndPos>(bmcl::InPlace, index.unwrap(), projected);
+        }
+    } else {
+        for (std::size_t i = 0; i < _points.size() - 1; i++) {
+            if (isOnSegment(i)) {
+                return bmcl::Option<LineIndexAndPos>(bmcl::InPlace, i, projected);
             }
         }
-        it = nextIt;
-        nextIt++;
     }
     if (isConnected) {
-        it = _points.end() - 1;
-        nextIt = _points.begin();
+        auto it = _points.end() - 1;
+        auto nextIt = _points.begin();
         const QPointF& p1 = it->position();
         const QPointF& p2 = nextIt->position();
         QRectF rect(p1, p2);
@@ -302,11 +342,45 @@ void PolyLineBase<T, W>::recalcDistancesAround(std::size_t index)
     }
 }
 
+template <typename T, typename W>
+inline void PolyLineBase<T, W>::invalidateIndex()
+{
+    _pointIndex.invalidate();
+    _segmentIndex.invalidate();
+}
+
+template <typename T, typename W>
+inline void PolyLineBase<T, W>::invalidateIndex(std::size_t index)
+{
+    _pointIndex.invalidate(index);
+    if (index > 0) {
+        _segmentIndex.invalidate(index - 1);
+    }
+    _segmentIndex.invalidate(index);
+}
+
+template <typename T, typename W>
+void PolyLineBase<T, W>::updatePointIndex() const
+{
+    _pointIndex.update(_points.size(), [this](std::size_t i) {
+        return _points[i].rect();
+    });
+}
+
+template <typename T, typename W>
+void PolyLineBase<T, W>::updateSegmentIndex() const
+{
+    _segmentIndex.update(_points.size() - 1, [this](std::size_t i) {
+        return QRectF(_points[i].position(), _points[i + 1].position());
+    });
+}
+
 template <typename T, typename W>
 inline void PolyLineBase<T, W>::clear()
 {
     _totalDistance = 0;
     _points.clear();
+    invalidateIndex();
 }
 
 template <typename T, typename W>
@@ -314,6 +388,7 @@ void PolyLineBase<T, W>::remove(std::size_t index)
 {
     double distance = _points[index].distance();
     _points.erase(_points.begin() + index);
+    invalidateIndex();
     if (_points.empty()) {
         _totalDistance = 0;
     } else if (_points.size() == 1) {
@@ -330,6 +405,7 @@ void PolyLineBase<T, W>::removeFront()
 {
     double distance = _points[0].distance();
     _points.pop_front();
+    invalidateIndex();
     if (_points.empty()) {
         _totalDistance = 0;
     } else if (_points.size() == 1) {
@@ -347,6 +423,7 @@ void PolyLineBase<T, W>::removeFront(std::size_t count)
     if (count == 0) {
         return;
     }
+    invalidateIndex();
     if (count >= _points.size()) {
         _points.clear();
         _totalDistance = 0;
@@ -370,6 +447,7 @@ template <typename T, typename W>
 inline void PolyLineBase<T, W>::set(std::size_t index, T&& point)
 {
     _points[index].reset(std::forward<T>(point));
+    invalidateIndex(index);
     recalcDistancesAround(index);
 }
 
@@ -377,6 +455,7 @@ template <typename T, typename W>
 inline void PolyLineBase<T, W>::setLatLon(std::size_t index, const mccgeo::LatLon& latLon)
 {
     _points[index].setLatLon(latLon, _rect.get());
+    invalidateIndex(index);
     recalcDistancesAround(index);
 }
 
@@ -384,6 +463,7 @@ template <typename T, typename W>
 inline void PolyLineBase<T, W>::moveBy(std::size_t index, const QPointF& delta)
 {
     _points[index].moveBy(delta, mapRect());
+    invalidateIndex(index);
     recalcDistancesAround(index);
 }
 
@@ -393,6 +473,7 @@ inline void PolyLineBase<T, W>::moveAll(const QPointF& delta)
     for (W& point : _points) {
         point.moveBy(delta, mapRect());
     }
+    invalidateIndex();
     // TODO: recalcDistances
 }
 
@@ -400,6 +481,7 @@ template <typename T, typename W>
 inline void PolyLineBase<T, W>::setPosition(std::size_t index, const QPointF& pos)
 {
     _points[index].setPosition(pos);
+    invalidateIndex(index);
     recalcDistancesAround(index);
 }
 
@@ -407,6 +489,7 @@ template <typename T, typename W>
 void PolyLineBase<T, W>::append(T&& point)
 {
     _points.emplace_back(bmcl::InPlace, std::forward<T>(point));
+    invalidateIndex();
     recalcDistancesAround(_points.size() - 1);
 }
 
@@ -414,6 +497,7 @@ template <typename T, typename W>
 inline void PolyLineBase<T, W>::insert(std::size_t index, T&& point)
 {
 	_points.emplace(_points.begin() + index, bmcl::InPlace, std::forward<T>(point));
+    invalidateIndex();
     recalcDistancesAround(index);
 }
 
@@ -423,6 +507,8 @@ inline void PolyLineBase<T, W>::swap(std::size_t first, std::size_t second)
     auto it1 = _points.begin() + first;
     auto it2 = _points.begin() + second;
     std::swap(*it1, *it2);
+    invalidateIndex(first);
+    invalidateIndex(second);
     recalcDistancesAround(first);
     recalcDistancesAround(second);
 }
@@ -442,6 +528,8 @@ inline bool PolyLineBase<T, W>::empty() const
 template <typename T, typename W>
 inline W& PolyLineBase<T, W>::at(std::size_t index)
 {
+    // point can be changed through returned reference
+    invalidateIndex();
     return _points[index];
 }
 
@@ -471,6 +559,7 @@ template <typename... A>
 inline void PolyLineBase<T, W>::emplace(std::size_t index, A&&... args)
 {
 	_points.emplace(_points.begin() + index, bmcl::InPlace, std::forward<A>(args)...);
+    invalidateIndex();
     recalcDistancesAround(index);
 }
 
@@ -479,6 +568,7 @@ template <typename... A>
 inline void PolyLineBase<T, W>::emplaceBack(A&&... args)
 {
 	_points.emplace_back(bmcl::InPlace, std::forward<A>(args)...);
+    invalidateIndex();
     recalcDistancesAround(_points.size() - 1);
 }
 
@@ -488,6 +578,7 @@ inline void PolyLineBase<T, W>::changeProjection(const mccgeo::MercatorProjectio
     for (W& point : _points) {
         point.changeProjection(_rect.get(), from, to);
     }
+    invalidateIndex();
 }
 
 template <typename T, typename W>
@@ -496,6 +587,8 @@ inline void PolyLineBase<T, W>::changeZoomLevel(int from, int to)
     for (W& point : _points) {
         point.changeZoomLevel(from, to);
     }
+    // rebuilt on next query
+    invalidateIndex();
 }
 
 template <typename T, typename W>
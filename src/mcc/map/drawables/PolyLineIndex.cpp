@@ -0,0 +1,95 @@
+#include "mcc/map/drawables/PolyLineIndex.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace mccmap {
+
+PolyLineIndex::Box::Box()
+    : left(std::numeric_limits<double>::infinity())
+    , top(std::numeric_limits<double>::infinity())
+    , right(-std::numeric_limits<double>::infinity())
+    , bottom(-std::numeric_limits<double>::infinity())
+{
+}
+
+PolyLineIndex::Box::Box(const QRectF& rect)
+{
+    QRectF r = rect.normalized();
+    left = r.left();
+    top = r.top();
+    right = r.right();
+    bottom = r.bottom();
+}
+
+void PolyLineIndex::Box::unite(const Box& other)
+{
+    left = std::min(left, other.left);
+    top = std::min(top, other.top);
+    right = std::max(right, other.right);
+    bottom = std::max(bottom, other.bottom);
+}
+
+PolyLineIndex::PolyLineIndex()
+    : _leafOffset(1)
+    , _isValid(false)
+{
+}
+
+PolyLineIndex::~PolyLineIndex()
+{
+}
+
+void PolyLineIndex::invalidate()
+{
+    _isValid = false;
+    _pending.clear();
+}
+
+void PolyLineIndex::invalidate(std::size_t item)
+{
+    if (!_isValid) {
+        return;
+    }
+    // many single updates cost more than rebuild
+    if (_pending.size() > _items.size() / 16) {
+        invalidate();
+        return;
+    }
+    _pending.push_back(item);
+}
+
+void PolyLineIndex::rebuild()
+{
+    std::size_t leafCount = (_items.size() + leafSize - 1) / leafSize;
+    _leafOffset = 1;
+    while (_leafOffset < leafCount) {
+        _leafOffset *= 2;
+    }
+    _nodes.assign(2 * _leafOffset, Box());
+    for (std::size_t i = 0; i < _items.size(); i++) {
+        _nodes[_leafOffset + i / leafSize].unite(_items[i]);
+    }
+    for (std::size_t node = _leafOffset - 1; node > 0; node--) {
+        _nodes[node] = _nodes[2 * node];
+        _nodes[node].unite(_nodes[2 * node + 1]);
+    }
+    _pending.clear();
+    _isValid = true;
+}
+
+void PolyLineIndex::updateLeaf(std::size_t leaf)
+{
+    std::size_t begin = leaf * leafSize;
+    std::size_t end = std::min(begin + leafSize, _items.size());
+    std::size_t node = _leafOffset + leaf;
+    _nodes[node] = Box();
+    for (std::size_t i = begin; i < end; i++) {
+        _nodes[node].unite(_items[i]);
+    }
+    for (node /= 2; node > 0; node /= 2) {
+        _nodes[node] = _nodes[2 * node];
+        _nodes[node].unite(_nodes[2 * node + 1]);
+    }
+}
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "mcc/Config.h"
+
+#include <bmcl/Option.h>
+
+#include <QPointF>
+#include <QRectF>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace mccmap {
+
+// Bounding box tree over consecutive items of polyline (points or segments) in map pixel space.
+// Leaves hold fixed count of items in index order, so neighbouring points end up in same leaf.
+// Moved items are updated in O(log n) on next query, other changes cause full rebuild.
+class MCC_MAP_DECLSPEC PolyLineIndex {
+public:
+    PolyLineIndex();
+    ~PolyLineIndex();
+
+    // all items have to be recalculated
+    void invalidate();
+    // box of one item changed
+    void invalidate(std::size_t item);
+
+    // boxAt(i) returns QRectF of i-th item
+    template <typename B>
+    void update(std::size_t count, B&& boxAt);
+
+    // first item (last if isReversed) which box expanded by margin contains pos and for which check(i) returns true
+    template <typename F>
+    bmcl::Option<std::size_t> find(const QPointF& pos, double margin, bool isReversed, F&& check) const;
+
+private:
+    struct Box {
+        Box();
+        Box(const QRectF& rect);
+
+        void unite(const Box& other);
+        inline bool contains(const QPointF& pos, double margin) const;
+
+        double left;
+        double top;
+        double right;
+        double bottom;
+    };
+
+    static constexpr const std::size_t leafSize = 8;
+
+    void rebuild();
+    void updateLeaf(std::size_t leaf);
+
+    std::vector<Box> _items;
+    // implicit binary tree, root is 1, children of n are 2n and 2n + 1, leaves start at _leafOffset
+    std::vector<Box> _nodes;
+    std::vector<std::size_t> _pending;
+    std::size_t _leafOffset;
+    bool _isValid;
+};
+
+inline bool PolyLineIndex::Box::contains(const QPointF& pos, double margin) const
+{
+    return pos.x() >= left - margin && pos.x() <= right + margin && pos.y() >= top - margin && pos.y() <= bottom + margin;
+}
+
+template <typename B>
+void PolyLineIndex::update(std::size_t count, B&& boxAt)
+{
+    if (!_isValid || count != _items.size()) {
+        _items.resize(count);
+        for (std::size_t i = 0; i < count; i++) {
+            _items[i] = Box(boxAt(i));
+        }
+        rebuild();
+        return;
+    }
+    for (std::size_t item : _pending) {
+        if (item < count) {
+            _items[item] = Box(boxAt(item));
+            updateLeaf(item / leafSize);
+        }
+    }
+    _pending.clear();
+}
+
+template <typename F>
+bmcl::Option<std::size_t> PolyLineIndex::find(const QPointF& pos, double margin, bool isReversed, F&& check) const
+{
+    if (_items.empty()) {
+        return bmcl::None;
+    }
+    std::size_t stack[64];
+    std::size_t size = 0;
+    stack[size++] = 1;
+    while (size != 0) {
+        std::size_t node = stack[--size];
+        if (!_nodes[node].contains(pos, margin)) {
+            continue;
+        }
+        if (node < _leafOffset) {
+            // first visited child is pushed last
+            if (isReversed) {
+                stack[size++] = 2 * node;
+                stack[size++] = 2 * node + 1;
+            } else {
+                stack[size++] = 2 * node + 1;
+                stack[size++] = 2 * node;
+            }
+            continue;
+        }
+        std::size_t begin = (node - _leafOffset) * leafSize;
+        std::size_t end = std::min(begin + leafSize, _items.size());
+        for (std::size_t j = begin; j < end; j++) {
+            std::size_t i = isReversed ? (begin + end - 1 - j) : j;
+            if (_items[i].contains(pos, margin) && check(i)) {
+                return i;
+            }
+        }
+    }
+    return bmcl::None;
+}
+}
@@ -11,7 +11,7 @@ ITmView::~ITmView(){}
 ITmViewUpdate::ITmViewUpdate(const Device& device) : TmAny(device) {}
 ITmViewUpdate::~ITmViewUpdate() {}
 
-ITmStorage::ITmStorage() : _counter(new TmExtensionCounter) {}
+ITmStorage::ITmStorage() : _counter(new TmExtensionCounter), _historyBudget(0) {}
 ITmStorage::~ITmStorage() { removeAllHandlers(); }
 TmExtensionCounterPtr& ITmStorage::counter() { return _counter; }
 bmcl::Option<Group> ITmStorage::group() const { return bmcl::None; }
@@ -22,6 +22,7 @@ void ITmStorage::removeAllHandlers()
         i.second->removeAllHandlers();
     }
     _exts.clear();
+    _slots.clear();
 }
 void ITmStorage::removeHandler(const bmcl::Option<HandlerId>& id)
 {
@@ -33,6 +34,26 @@ void ITmStorage::removeHandler(const bmcl::Option<HandlerId>& id)
     }
 }
 
+std::size_t ITmStorage::historyBudget() const { return _historyBudget; }
+
+void ITmStorage::setHistoryBudget(std::size_t bytes)
+{
+    _historyBudget = bytes;
+    std::vector<ITmSimpleExtension*> exts;
+    std::size_t sampleBytes = 0;
+    for (auto& i : _exts)
+    {
+        auto ext = dynamic_cast<ITmSimpleExtension*>(i.second.get());
+        if (!ext || ext->historyFields() == 0)
+            continue;
+        exts.push_back(ext);
+        sampleBytes += TmHistory::sampleBytes(ext->historyFields());
+    }
+    std::size_t samples = sampleBytes == 0 ? 0 : bytes / sampleBytes;
+    for (auto ext : exts)
+        ext->setHistoryCapacity(samples);
+}
+
 bmcl::OptionRc<ITmExtension> ITmStorage::getExtension(const TmExtension& name) const
 {
     const auto i = _exts.find(name);
@@ -45,6 +66,12 @@ void ITmStorage::addExtension(const ITmExtensionPtr& ext)
 {
     assert(_exts.find(ext->name()) == _exts.end());
     _exts.emplace(ext->name(), ext);
+    const TmExtensionSlot slot = TmExtensionSlots::slot(ext->name());
+    if (slot >= _slots.size())
+        _slots.resize(slot + 1);
+    _slots[slot] = ext;
+    if (_historyBudget != 0)
+        setHistoryBudget(_historyBudget);
 }
 
 void ITmStorage::removeAllExtensions()
@@ -60,6 +87,9 @@ void ITmStorage::removeExtension(const TmExtension& name)
         return;
     i->second->removeAllHandlers();
     _exts.erase(i);
+    const TmExtensionSlot slot = TmExtensionSlots::slot(name);
+    if (slot < _slots.size())
+        _slots[slot].reset();
 }
 
 
@@ -6,6 +6,7 @@
 #include "mcc/msg/exts/ITmExtension.h"
 #include <bmcl/OptionRc.h>
 #include <map>
+#include <vector>
 
 namespace mccmsg {
 
@@ -40,14 +41,20 @@ public:
     void removeHandler(const bmcl::Option<HandlerId>&);
     void removeAllHandlers();
 
+    // splits memory budget between histories of all extensions which support it,
+    // every history gets the same number of samples, 0 disables histories
+    void setHistoryBudget(std::size_t bytes);
+    std::size_t historyBudget() const;
+
     bmcl::OptionRc<ITmExtension> getExtension(const TmExtension& name) const;
     template<typename T>
     bmcl::OptionRc<T> getExtension() const
     {
-        auto r = getExtension(T::id());
-        if (r.isNone())
+        // extension stored under T::id() is always T
+        const TmExtensionSlot slot = TmExtensionSlots::slot<T>();
+        if (slot >= _slots.size())
             return bmcl::None;
-        return bmcl::dynamic_pointer_cast<T>(r.unwrap());
+        return bmcl::Rc<T>(static_cast<T*>(_slots[slot].get()));
     }
 
 protected:
@@ -63,6 +70,8 @@ protected:
 private:
     TmExtensionCounterPtr _counter;
     std::map<TmExtension, ITmExtensionPtr> _exts;
+    std::vector<ITmExtensionPtr> _slots;
+    std::size_t _historyBudget;
 };
 using ITmStoragePtr = bmcl::Rc<ITmStorage>;
 
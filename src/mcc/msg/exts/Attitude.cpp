@@ -7,11 +7,17 @@ TmAttitude::TmAttitude(const TmExtensionCounterPtr& counter) : ITmSimpleExtensio
 TmAttitude::~TmAttitude() {}
 const TmExtension& TmAttitude::id() { static auto i = TmExtension::createOrNil("{1c82028e-1f0e-4a85-b967-2d0641bcc9ea}"); return i; }
 const char* TmAttitude::info() { return "attitude"; }
+std::size_t TmAttitude::historyFields() const { return 3; } // heading, pitch, roll
 const bmcl::Option<mccgeo::Attitude>& TmAttitude::attitude() const { return _attitude; }
 void TmAttitude::set(bmcl::SystemTime t, const bmcl::Option<mccgeo::Attitude>& v)
 {
     bool changed = (_attitude != v);
     _attitude = v;
+    if (v.isSome())
+    {
+        const double values[3] = {v->heading(), v->pitch(), v->roll()};
+        appendHistory(t, values);
+    }
     updated_(t, changed);
 }
 
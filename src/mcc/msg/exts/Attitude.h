@@ -14,6 +14,7 @@ public:
     ~TmAttitude() override;
     static const TmExtension& id();
     static const char* info();
+    std::size_t historyFields() const override;
     const bmcl::Option<mccgeo::Attitude>& attitude() const;
     void set(bmcl::SystemTime t, const bmcl::Option<mccgeo::Attitude>& v);
 private:
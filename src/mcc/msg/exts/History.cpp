@@ -0,0 +1,184 @@
+#include "mcc/msg/exts/History.h"
+#include <algorithm>
+
+namespace mccmsg {
+
+TmHistory::TmHistory(std::size_t fields, std::size_t capacity)
+    : _fields(fields)
+    , _capacity(capacity)
+    , _head(0)
+    , _size(0)
+    , _times(capacity)
+    , _values(capacity * fields)
+{
+}
+
+TmHistory::~TmHistory() {}
+std::size_t TmHistory::sampleBytes(std::size_t fields) { return sizeof(bmcl::SystemTime) + fields * sizeof(double); }
+std::size_t TmHistory::fields() const { return _fields; }
+std::size_t TmHistory::capacity() const { return _capacity; }
+std::size_t TmHistory::size() const { return _size; }
+std::size_t TmHistory::bytes() const { return _capacity * sampleBytes(_fields); }
+bool TmHistory::isEmpty() const { return _size == 0; }
+
+void TmHistory::setCapacity(std::size_t capacity)
+{
+    if (capacity == _capacity)
+        return;
+    std::size_t size = std::min(_size, capacity);
+    std::size_t skip = _size - size;
+    std::vector<bmcl::SystemTime> times(capacity);
+    std::vector<double> values(capacity * _fields);
+    for (std::size_t i = 0; i < size; i++)
+    {
+        std::size_t p = physical(skip + i);
+        times[i] = _times[p];
+        for (std::size_t f = 0; f < _fields; f++)
+            values[f * capacity + i] = _values[f * _capacity + p];
+    }
+    _times = std::move(times);
+    _values = std::move(values);
+    _capacity = capacity;
+    _size = size;
+    _head = 0;
+}
+
+void TmHistory::clear()
+{
+    _head = 0;
+    _size = 0;
+}
+
+void TmHistory::append(bmcl::SystemTime t, const double* values)
+{
+    if (_capacity == 0)
+        return;
+    std::size_t p;
+    if (_size < _capacity)
+    {
+        p = physical(_size);
+        _size++;
+    }
+    else
+    {
+        p = _head;
+        _head = (_head + 1) % _capacity;
+    }
+    _times[p] = t;
+    for (std::size_t f = 0; f < _fields; f++)
+        _values[f * _capacity + p] = values[f];
+}
+
+std::size_t TmHistory::physical(std::size_t index) const
+{
+    std::size_t p = _head + index;
+    return p >= _capacity ? p - _capacity : p;
+}
+
+bmcl::SystemTime TmHistory::timeAt(std::size_t index) const { return _times[physical(index)]; }
+double TmHistory::valueAt(std::size_t index, std::size_t field) const { return _values[field * _capacity + physical(index)]; }
+
+std::size_t TmHistory::lowerBound(bmcl::SystemTime t) const
+{
+    std::size_t first = 0;
+    std::size_t count = _size;
+    while (count > 0)
+    {
+        std::size_t step = count / 2;
+        if (timeAt(first + step) < t)
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+    return first;
+}
+
+std::size_t TmHistory::upperBound(bmcl::SystemTime t) const
+{
+    std::size_t first = 0;
+    std::size_t count = _size;
+    while (count > 0)
+    {
+        std::size_t step = count / 2;
+        if (!(t < timeAt(first + step)))
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+    return first;
+}
+
+std::pair<std::size_t, std::size_t> TmHistory::range(bmcl::SystemTime from, bmcl::SystemTime to) const
+{
+    if (to < from)
+        return std::make_pair(std::size_t(0), std::size_t(0));
+    return std::make_pair(lowerBound(from), upperBound(to));
+}
+
+TmHistorySlice TmHistory::makeSlice(std::size_t count) const
+{
+    TmHistorySlice slice;
+    slice.times.reserve(count);
+    slice.columns.resize(_fields);
+    for (auto& column : slice.columns)
+        column.reserve(count);
+    return slice;
+}
+
+void TmHistory::copySample(std::size_t index, TmHistorySlice* slice) const
+{
+    std::size_t p = physical(index);
+    slice->times.push_back(_times[p]);
+    for (std::size_t f = 0; f < _fields; f++)
+        slice->columns[f].push_back(_values[f * _capacity + p]);
+}
+
+TmHistorySlice TmHistory::read(bmcl::SystemTime from, bmcl::SystemTime to) const
+{
+    auto r = range(from, to);
+    std::size_t count = r.second - r.first;
+    TmHistorySlice slice = makeSlice(count);
+    // copy contiguous parts of ring column by column
+    std::size_t first = physical(r.first);
+    std::size_t firstPart = std::min(count, _capacity - first);
+    slice.times.insert(slice.times.end(), _times.begin() + first, _times.begin() + first + firstPart);
+    slice.times.insert(slice.times.end(), _times.begin(), _times.begin() + (count - firstPart));
+    for (std::size_t f = 0; f < _fields; f++)
+    {
+        auto column = _values.begin() + f * _capacity;
+        slice.columns[f].insert(slice.columns[f].end(), column + first, column + first + firstPart);
+        slice.columns[f].insert(slice.columns[f].end(), column, column + (count - firstPart));
+    }
+    return slice;
+}
+
+TmHistorySlice TmHistory::readDownsampled(bmcl::SystemTime from, bmcl::SystemTime to, std::size_t maxPoints) const
+{
+    auto r = range(from, to);
+    std::size_t count = r.second - r.first;
+    if (count <= maxPoints)
+        return read(from, to);
+    TmHistorySlice slice = makeSlice(maxPoints);
+    if (maxPoints == 0)
+        return slice;
+    if (maxPoints == 1)
+    {
+        copySample(r.second - 1, &slice);
+        return slice;
+    }
+    for (std::size_t i = 0; i < maxPoints; i++)
+        copySample(r.first + i * (count - 1) / (maxPoints - 1), &slice);
+    return slice;
+}
+
+}
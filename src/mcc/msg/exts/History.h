@@ -0,0 +1,65 @@
+#pragma once
+#include "mcc/Config.h"
+#include "mcc/Rc.h"
+#include <bmcl/TimeUtils.h>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace mccmsg {
+
+// Samples of history in columnar form, times[i] corresponds to columns[field][i]
+struct MCC_MSG_DECLSPEC TmHistorySlice
+{
+    std::vector<bmcl::SystemTime> times;
+    std::vector<std::vector<double>> columns;
+};
+
+// Fixed capacity ring of (time, fields) samples shared by all readers of an extension.
+// Samples are expected in non decreasing time order, oldest samples are overwritten when full.
+class MCC_MSG_DECLSPEC TmHistory : public mcc::RefCountable
+{
+public:
+    TmHistory(std::size_t fields, std::size_t capacity);
+    ~TmHistory() override;
+
+    static std::size_t sampleBytes(std::size_t fields);
+
+    std::size_t fields() const;
+    std::size_t capacity() const;
+    std::size_t size() const;
+    std::size_t bytes() const;
+    bool isEmpty() const;
+
+    // keeps newest samples that fit
+    void setCapacity(std::size_t capacity);
+    void clear();
+    void append(bmcl::SystemTime t, const double* values);
+
+    // index 0 is the oldest sample
+    bmcl::SystemTime timeAt(std::size_t index) const;
+    double valueAt(std::size_t index, std::size_t field) const;
+
+    // [first, last) indexes of samples with from <= time <= to
+    std::pair<std::size_t, std::size_t> range(bmcl::SystemTime from, bmcl::SystemTime to) const;
+    TmHistorySlice read(bmcl::SystemTime from, bmcl::SystemTime to) const;
+    // at most maxPoints samples evenly taken from range, last sample of range is always included
+    TmHistorySlice readDownsampled(bmcl::SystemTime from, bmcl::SystemTime to, std::size_t maxPoints) const;
+
+private:
+    std::size_t physical(std::size_t index) const;
+    std::size_t lowerBound(bmcl::SystemTime t) const;
+    std::size_t upperBound(bmcl::SystemTime t) const;
+    TmHistorySlice makeSlice(std::size_t count) const;
+    void copySample(std::size_t index, TmHistorySlice* slice) const;
+
+    std::size_t _fields;
+    std::size_t _capacity;
+    std::size_t _head;
+    std::size_t _size;
+    std::vector<bmcl::SystemTime> _times;
+    std::vector<double> _values; // _fields columns of _capacity values each
+};
+using TmHistoryPtr = bmcl::Rc<TmHistory>;
+
+}
@@ -1,8 +1,14 @@
 ﻿#include "mcc/msg/SubHolder.h"
 #include "mcc/msg/exts/ITmExtension.h"
+#include "mcc/msg/exts/Position.h"
+#include "mcc/msg/exts/Attitude.h"
+#include "mcc/msg/exts/Velocity.h"
+#include "mcc/msg/exts/Gps.h"
 #include <bmcl/Option.h>
 #include <bmcl/Rc.h>
 #include <algorithm>
+#include <map>
+#include <mutex>
 
 namespace mccmsg {
 
@@ -10,6 +16,49 @@ TmExtensionCounter::TmExtensionCounter() : _counter(0) {}
 TmExtensionCounter::~TmExtensionCounter() {}
 HandlerId TmExtensionCounter::next() { return ++_counter; }
 
+namespace {
+
+struct SlotRegistry
+{
+    SlotRegistry()
+    {
+        // most used extensions get first slots so storages stay small
+        add(TmPosition::id());
+        add(TmAttitude::id());
+        add(TmVelocity::id());
+        add(TmGps::id());
+    }
+
+    TmExtensionSlot add(const TmExtension& name)
+    {
+        auto it = slots.find(name);
+        if (it != slots.end())
+            return it->second;
+        TmExtensionSlot s = slots.size();
+        slots.emplace(name, s);
+        return s;
+    }
+
+    std::mutex mutex;
+    std::map<TmExtension, TmExtensionSlot> slots;
+};
+
+SlotRegistry& slotRegistry()
+{
+    static SlotRegistry registry;
+    return registry;
+}
+
+const bool builtinSlotsRegistered = (slotRegistry(), true);
+}
+
+TmExtensionSlot TmExtensionSlots::slot(const TmExtension& name)
+{
+    SlotRegistry& registry = slotRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.add(name);
+}
+
 
 ITmExtension::ITmExtension(const TmExtension& name, const char* info, const TmExtensionCounterPtr& counter) : _name(name), _info(info), _counter(counter) {}
 ITmExtension::~ITmExtension() {}
@@ -22,6 +71,28 @@ ITmSimpleExtension::~ITmSimpleExtension() {}
 const bmcl::SystemTime& ITmSimpleExtension::updated() const { return _updated; }
 const bmcl::SystemTime& ITmSimpleExtension::changed() const { return _changed; }
 void ITmSimpleExtension::updated(bmcl::SystemTime t) { updated_(t, false); }
+std::size_t ITmSimpleExtension::historyFields() const { return 0; }
+bmcl::OptionRc<const TmHistory> ITmSimpleExtension::history() const { return bmcl::Rc<const TmHistory>(_history.get()); }
+
+void ITmSimpleExtension::setHistoryCapacity(std::size_t samples)
+{
+    if (samples == 0 || historyFields() == 0)
+    {
+        _history.reset();
+        return;
+    }
+    if (_history.isNull())
+        _history = new TmHistory(historyFields(), samples);
+    else
+        _history->setCapacity(samples);
+}
+
+void ITmSimpleExtension::appendHistory(bmcl::SystemTime t, const double* values)
+{
+    if (_history.isNull())
+        return;
+    _history->append(t, values);
+}
 
 ITmSimpleExtension::Item::Item(HandlerId i, Handler&& h) : i(i), h(std::move(h)) {}
 ITmSimpleExtension::Item::~Item() {}
@@ -2,6 +2,8 @@
 #include "mcc/Config.h"
 #include "mcc/Rc.h"
 #include "mcc/msg/Objects.h"
+#include "mcc/msg/exts/History.h"
+#include <bmcl/OptionRc.h>
 #include <bmcl/Rc.h>
 #include <bmcl/TimeUtils.h>
 #include <functional>
@@ -11,6 +13,22 @@ namespace mccmsg {
 
 using HandlerId = std::size_t;
 using Handler = std::function<void()>;
+using TmExtensionSlot = std::size_t;
+
+// Process-wide small integer slots of extension types, used for typed lookup in storages
+class MCC_MSG_DECLSPEC TmExtensionSlots
+{
+public:
+    // assigns next free slot on first call for given extension
+    static TmExtensionSlot slot(const TmExtension& name);
+
+    template<typename T>
+    static TmExtensionSlot slot()
+    {
+        static const TmExtensionSlot s = slot(T::id());
+        return s;
+    }
+};
 
 class MCC_MSG_DECLSPEC TmExtensionCounter : public mcc::RefCountable
 {
@@ -55,8 +73,15 @@ public:
     const bmcl::SystemTime& changed() const;
     void updated(bmcl::SystemTime);
     SubHolder addHandler(Handler&&, bool onChangeOnly);
+
+    // values recorded per history sample, 0 if extension keeps no history
+    virtual std::size_t historyFields() const;
+    // 0 disables history
+    void setHistoryCapacity(std::size_t samples);
+    bmcl::OptionRc<const TmHistory> history() const;
 protected:
     void updated_(bmcl::SystemTime, bool changed);
+    void appendHistory(bmcl::SystemTime, const double* values);
 
 private:
     bmcl::SystemTime _updated;
@@ -71,6 +96,7 @@ private:
     using Items = std::vector<Item>;
     Items _updateHandler;
     Items _changeHandler;
+    TmHistoryPtr _history;
 };
 
 
@@ -1,5 +1,6 @@
 #include "mcc/msg/exts/Position.h"
 #include <bmcl/Option.h>
+#include <cmath>
 
 namespace mccmsg {
 
@@ -7,6 +8,7 @@ TmPosition::TmPosition(const TmExtensionCounterPtr& counter) : ITmSimpleExtensio
 TmPosition::~TmPosition() {}
 const TmExtension& TmPosition::id() { static auto i = TmExtension::createOrNil("{8bd11374-8c08-4ed7-9e36-bce641d9a188}"); return i; }
 const char* TmPosition::info() { return "position"; }
+std::size_t TmPosition::historyFields() const { return 4; } // latitude, longitude, altitude, accuracy
 const bmcl::Option<mccgeo::Position>& TmPosition::position() const { return _position; }
 const bmcl::Option<double>& TmPosition::positionAccuracy() const { return _positionAccuracy; }
 void TmPosition::set(bmcl::SystemTime t, const bmcl::Option<mccgeo::Position>& v, bmcl::Option<double> acc)
@@ -14,6 +16,11 @@ void TmPosition::set(bmcl::SystemTime t, const bmcl::Option<mccgeo::Position>& v
     bool changed = (_position != v || acc != _positionAccuracy);
     _position = v;
     _positionAccuracy = acc;
+    if (v.isSome())
+    {
+        const double values[4] = {v->latitude(), v->longitude(), v->altitude(), acc.unwrapOr(std::nan(""))};
+        appendHistory(t, values);
+    }
     updated_(t, changed);
 }
 
@@ -14,6 +14,7 @@ public:
     ~TmPosition() override;
     static const TmExtension& id();
     static const char* info();
+    std::size_t historyFields() const override;
     const bmcl::Option<mccgeo::Position>& position() const;
     const bmcl::Option<double>& positionAccuracy() const;
     void set(bmcl::SystemTime t, const bmcl::Option<mccgeo::Position>& v, bmcl::Option<double> acc = bmcl::None);
@@ -7,6 +7,7 @@ TmVelocity::TmVelocity(const TmExtensionCounterPtr& counter) : ITmSimpleExtensio
 TmVelocity::~TmVelocity() {}
 const TmExtension& TmVelocity::id() { static auto i = TmExtension::createOrNil("{26bc2979-fd81-4dae-a14e-10e07347c0de}"); return i; }
 const char* TmVelocity::info() { return "velocity"; }
+std::size_t TmVelocity::historyFields() const { return 3; } // velocity components
 const bmcl::Option<mccgeo::Position>& TmVelocity::velocity() const { return _velocity; }
 const bmcl::Option<double>& TmVelocity::speed() const { return _speed; }
 void TmVelocity::set(bmcl::SystemTime t, const bmcl::Option<mccgeo::Position>& v)
@@ -18,6 +19,11 @@ void TmVelocity::set(bmcl::SystemTime t, const bmcl::Option<mccgeo::Position>& v
 
     if (changed)
         _speed = std::hypot(std::hypot(v->latitude(), v->longitude()), v->altitude());
+    if (v.isSome())
+    {
+        const double values[3] = {v->latitude(), v->longitude(), v->altitude()};
+        appendHistory(t, values);
+    }
     updated_(t, changed);
 }
 
@@ -14,6 +14,7 @@ public:
     ~TmVelocity() override;
     static const TmExtension& id();
     static const char* info();
+    std::size_t historyFields() const override;
     const bmcl::Option<mccgeo::Position>& velocity() const;
     const bmcl::Option<double>& speed() const;
     void set(bmcl::SystemTime t, const bmcl::Option<double>& speed);
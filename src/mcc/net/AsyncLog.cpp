@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include <fmt/format.h>
+#include <bmcl/ColorStream.h>
+#include "mcc/net/AsyncLog.h"
+
+#ifdef BMCL_HAVE_QT
+#include <QString>
+#endif
+
+namespace mccnet {
+
+// writer wakes up at least this often, or as soon as quarter of ring is filled
+static constexpr std::chrono::milliseconds writeInterval(20);
+
+static const char* levelPrefix(bmcl::LogLevel level)
+{
+    switch (level)
+    {
+    case bmcl::LogLevel::Debug:    return "DEBUG:   ";
+    case bmcl::LogLevel::Info:     return "INFO:    ";
+    case bmcl::LogLevel::Warning:  return "WARNING: ";
+    case bmcl::LogLevel::Critical: return "CRITICAL:";
+    case bmcl::LogLevel::Panic:    return "PANIC:   ";
+    default:                       return "????:    ";
+    }
+}
+
+static bmcl::ColorAttr levelColor(bmcl::LogLevel level)
+{
+    switch (level)
+    {
+    case bmcl::LogLevel::Debug:    return bmcl::ColorAttr::FgBlack;
+    case bmcl::LogLevel::Info:     return bmcl::ColorAttr::FgCyan;
+    case bmcl::LogLevel::Warning:  return bmcl::ColorAttr::FgYellow;
+    case bmcl::LogLevel::Critical: return bmcl::ColorAttr::FgRed;
+    case bmcl::LogLevel::Panic:    return bmcl::ColorAttr::FgRed;
+    default:                       return bmcl::ColorAttr::Reset;
+    }
+}
+
+AsyncLog::AsyncLog(std::FILE* out, bool isConsole, std::size_t capacity, std::size_t lowPriorityRate)
+    : _out(out)
+    , _isConsole(isConsole)
+    , _ring(std::max<std::size_t>(capacity, 4))
+    , _head(0)
+    , _size(0)
+    , _lowPriorityRate(lowPriorityRate)
+    , _lowPriorityCount(0)
+    , _rateSecond(0)
+    , _droppedReported(0)
+    , _flushRequests(0)
+    , _isRunning(true)
+    , _written(0)
+    , _droppedTotal(0)
+    , _cachedSecond(0)
+{
+    _dropped.fill(0);
+    _cachedTime[0] = '\0';
+    _thread = std::thread([this]() { run(); });
+}
+
+AsyncLog::~AsyncLog()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isRunning = false;
+    }
+    _hasRecords.notify_one();
+    _hasSpace.notify_all();
+    _thread.join();
+}
+
+bool AsyncLog::accept(bmcl::LogLevel level, std::time_t now)
+{
+    if ((int)level <= (int)bmcl::LogLevel::Critical)
+        return true;
+    if (_size == _ring.size())
+        return false;
+    if ((int)level < (int)bmcl::LogLevel::Info || _size < _ring.size() / 4 * 3)
+        return true;
+    if (now != _rateSecond)
+    {
+        _rateSecond = now;
+        _lowPriorityCount = 0;
+    }
+    if (_lowPriorityCount >= _lowPriorityRate)
+        return false;
+    _lowPriorityCount++;
+    return true;
+}
+
+void AsyncLog::push(bmcl::LogLevel level, std::size_t id, const char* msg, std::size_t size)
+{
+    if ((int)level > (int)bmcl::logLevel())
+        return;
+    while (size != 0 && (msg[size - 1] == '\n' || msg[size - 1] == '\r'))
+        size--;
+
+    std::time_t now = std::time(nullptr);
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!accept(level, now))
+    {
+        _dropped[(std::size_t)level]++;
+        _droppedTotal++;
+        return;
+    }
+    _hasSpace.wait(lock, [this]() { return _size < _ring.size() || !_isRunning; });
+    if (!_isRunning)
+        return;
+
+    Record& r = _ring[(_head + _size) % _ring.size()];
+    r.level = level;
+    r.id = id;
+    r.time = now;
+    if (size > maxTextSize)
+    {
+        std::memcpy(r.text, msg, maxTextSize - 3);
+        std::memcpy(r.text + maxTextSize - 3, "...", 3);
+        r.size = maxTextSize;
+    }
+    else
+    {
+        std::memcpy(r.text, msg, size);
+        r.size = size;
+    }
+    _size++;
+    bool isUrgent = _size == _ring.size() / 4 || (int)level <= (int)bmcl::LogLevel::Critical;
+    lock.unlock();
+
+    if (isUrgent)
+        _hasRecords.notify_one();
+    if (level == bmcl::LogLevel::Panic)
+    {
+        flush();
+        std::abort();
+    }
+}
+
+void AsyncLog::flush()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _flushRequests++;
+    _hasRecords.notify_one();
+    _hasSpace.wait(lock, [this]() { return _size == 0 || !_isRunning; });
+    _flushRequests--;
+}
+
+AsyncLog::Stats AsyncLog::stats() const
+{
+    Stats s;
+    s.written = _written;
+    s.dropped = _droppedTotal;
+    return s;
+}
+
+void AsyncLog::format(const Record& r, std::string* dest)
+{
+    if (r.time != _cachedSecond)
+    {
+        _cachedSecond = r.time;
+        std::strftime(_cachedTime, sizeof(_cachedTime), "%T", std::localtime(&r.time));
+    }
+#ifdef BMCL_HAVE_QT
+    QByteArray local;
+    const char* text = r.text;
+    std::size_t size = r.size;
+    if (_isConsole)
+    {
+        local = QString::fromUtf8(r.text, (int)r.size).toLocal8Bit();
+        text = local.constData();
+        size = local.size();
+    }
+#else
+    const char* text = r.text;
+    std::size_t size = r.size;
+#endif
+
+#ifdef _WIN32
+    // console colors are set with console api, so records with colors are written one by one
+    (void)dest;
+    bmcl::ColorStdError out;
+    out << bmcl::ColorAttr::Bright << _cachedTime << " [" << fmt::format("{:>2}", r.id) << "] ";
+    out << levelColor(r.level) << levelPrefix(r.level) << bmcl::ColorAttr::Reset << ' ';
+    out << std::string(text, size) << '\n';
+#else
+    fmt::memory_buffer prefix;
+    fmt::format_to(prefix, "\x1b[1m{} [{:>2}] \x1b[{}m{}\x1b[0m ", _cachedTime, r.id, (int)levelColor(r.level), levelPrefix(r.level));
+    dest->append(prefix.data(), prefix.size());
+    dest->append(text, size);
+    dest->push_back('\n');
+#endif
+}
+
+void AsyncLog::write(const std::string& batch)
+{
+    if (batch.empty())
+        return;
+    std::fwrite(batch.data(), 1, batch.size(), _out);
+    std::fflush(_out);
+}
+
+void AsyncLog::run()
+{
+    std::string batch;
+    batch.reserve(64 * 1024);
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        _hasRecords.wait_for(lock, writeInterval, [this]() { return _size >= _ring.size() / 4 || _flushRequests != 0 || !_isRunning; });
+
+        std::size_t head = _head;
+        std::size_t count = _size;
+        std::time_t now = std::time(nullptr);
+        std::array<std::size_t, 6> dropped = {};
+        if (now != _droppedReported || !_isRunning)
+        {
+            _droppedReported = now;
+            dropped = _dropped;
+            _dropped.fill(0);
+        }
+        bool isRunning = _isRunning;
+        lock.unlock();
+
+        batch.clear();
+        for (std::size_t i = 0; i < count; i++)
+            format(_ring[(head + i) % _ring.size()], &batch);
+
+        std::size_t droppedCount = 0;
+        for (std::size_t n : dropped)
+            droppedCount += n;
+        if (droppedCount != 0)
+        {
+            Record r;
+            r.level = bmcl::LogLevel::Warning;
+            r.id = 0;
+            r.time = now;
+            std::string text = fmt::format("log overloaded, dropped {} messages (debug: {}, info: {}, warning: {})", droppedCount
+                                           , dropped[(std::size_t)bmcl::LogLevel::Debug]
+                                           , dropped[(std::size_t)bmcl::LogLevel::Info]
+                                           , dropped[(std::size_t)bmcl::LogLevel::Warning]);
+            r.size = std::min(text.size(), maxTextSize);
+            std::memcpy(r.text, text.data(), r.size);
+            format(r, &batch);
+        }
+        write(batch);
+
+        lock.lock();
+        _head = (_head + count) % _ring.size();
+        _size -= count;
+        _written += count;
+        _hasSpace.notify_all();
+        if (!isRunning && _size == 0)
+            break;
+    }
+}
+}
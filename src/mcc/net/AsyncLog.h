@@ -0,0 +1,83 @@
+#pragma once
+#include "mcc/Config.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <bmcl/Logging.h>
+
+namespace mccnet {
+
+// Console text log written by dedicated thread. Producers copy message into preallocated ring of records
+// and return, writer formats records in batches and writes every batch with one call.
+// Under overload debug and info messages are rate limited, when ring is full messages below critical
+// are dropped. Dropped messages are counted and reported once per second
+class MCC_NET_DECLSPEC AsyncLog
+{
+public:
+    struct Stats
+    {
+        std::size_t written = 0;
+        std::size_t dropped = 0;
+    };
+
+    static constexpr std::size_t maxTextSize = 1000;
+
+    // lowPriorityRate is number of debug and info messages accepted per second while ring is more than 3/4 full
+    AsyncLog(std::FILE* out, bool isConsole, std::size_t capacity = 2048, std::size_t lowPriorityRate = 1000);
+    ~AsyncLog();
+
+    // messages above bmcl::logLevel() are ignored, critical messages wait for free record,
+    // panic message is written before process is aborted
+    void push(bmcl::LogLevel level, std::size_t id, const char* msg, std::size_t size);
+    inline void push(bmcl::LogLevel level, std::size_t id, const std::string& msg) { push(level, id, msg.data(), msg.size()); }
+    // waits until all accepted messages are written
+    void flush();
+    Stats stats() const;
+
+private:
+    struct Record
+    {
+        bmcl::LogLevel level;
+        std::size_t id;
+        std::time_t time;
+        std::size_t size;
+        char text[maxTextSize];
+    };
+
+    bool accept(bmcl::LogLevel level, std::time_t now);
+    void run();
+    void format(const Record& r, std::string* dest);
+    void write(const std::string& batch);
+
+    std::FILE* _out;
+    bool _isConsole;
+    std::vector<Record> _ring;
+    std::size_t _head;
+    // records in ring, including records being written
+    std::size_t _size;
+    std::size_t _lowPriorityRate;
+    std::size_t _lowPriorityCount;
+    std::time_t _rateSecond;
+    std::array<std::size_t, 6> _dropped;
+    std::time_t _droppedReported;
+    std::size_t _flushRequests;
+    bool _isRunning;
+    mutable std::mutex _mutex;
+    std::condition_variable _hasRecords;
+    std::condition_variable _hasSpace;
+    std::atomic<std::size_t> _written;
+    std::atomic<std::size_t> _droppedTotal;
+
+    // used only by writer thread
+    std::time_t _cachedSecond;
+    char _cachedTime[16];
+
+    std::thread _thread;
+};
+}
@@ -1,19 +1,14 @@
-#include <ctime>
-#include <fstream>
-#include <iomanip>
-
-#include <fmt/ostream.h>
-#include <fmt/time.h>
+#include <cerrno>
+#include <cstdlib>
 #include <caf/send.hpp>
 #include <caf/allowed_unsafe_message_type.hpp>
 #include <bmcl/Logging.h>
 #include <bmcl/Utils.h>
 #include <bmcl/TimeUtils.h>
-#include <bmcl/Logging.h>
-#include <bmcl/ColorStream.h>
 #include "mcc/msg/ptr/Fwd.h"
 #include "mcc/msg/ptr/Tm.h"
 #include "mcc/msg/Packet.h"
+#include "mcc/net/AsyncLog.h"
 #include "mcc/net/NetLogger.h"
 #include "mcc/net/NetLoggerInf.h"
 #include "mcc/path/Paths.h"
@@ -26,7 +21,7 @@ CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccnet::LogWriteCreator);
 
 namespace mccnet {
 
-Logger::Logger(caf::actor_config& cfg, bool isConsole) : caf::event_based_actor(cfg), _isConsole(isConsole)
+Logger::Logger(caf::actor_config& cfg, const std::shared_ptr<AsyncLog>& log) : caf::event_based_actor(cfg), _log(log)
 {
     join(system().groups().get_local("notes"));
     join(system().groups().get_local(":log"));
@@ -35,64 +30,11 @@ Logger::Logger(caf::actor_config& cfg, bool isConsole) : caf::event_based_actor(
 void Logger::on_exit()
 {
     _files.clear();
+    _log.reset();
 }
 
 const char* Logger::name() const { return "net.logger"; }
 
-void Logger::handle(caf::actor_id id, bmcl::LogLevel level, const char* msg, bool hasEndl)
-{
-    if ((int)level > (int)bmcl::logLevel())
-    {
-        return;
-    }
-    const char* prefix;
-    bmcl::ColorAttr attr;
-    switch (level)
-    {
-    case bmcl::LogLevel::Debug:
-        prefix = "DEBUG:   ";
-        attr = bmcl::ColorAttr::FgBlack;
-        break;
-    case bmcl::LogLevel::Info:
-        prefix = "INFO:    ";
-        attr = bmcl::ColorAttr::FgCyan;
-        break;
-    case bmcl::LogLevel::Warning:
-        prefix = "WARNING: ";
-        attr = bmcl::ColorAttr::FgYellow;
-        break;
-    case bmcl::LogLevel::Critical:
-        prefix = "CRITICAL:";
-        attr = bmcl::ColorAttr::FgRed;
-        break;
-    case bmcl::LogLevel::Panic:
-        prefix = "PANIC:   ";
-        attr = bmcl::ColorAttr::FgRed;
-        break;
-    default:
-        prefix = "????:    ";
-    }
-
-    char timeStr[20];
-    std::time_t t = std::time(nullptr);
-    std::strftime(timeStr, sizeof(timeStr), "%T", std::localtime(&t));
-    bmcl::ColorStdError out;
-    out << bmcl::ColorAttr::Bright << timeStr << " [" << std::setfill(' ') << std::setw(2) << id << "] ";
-    out << attr << prefix << bmcl::ColorAttr::Reset << ' ';
-#ifdef BMCL_HAVE_QT
-    if (_isConsole)
-        out << QString::fromUtf8(msg).toLocal8Bit().constData();
-    else
-        out << msg;
-#else
-    out << msg;
-#endif
-    if (!hasEndl)
-        out << std::endl;
-    if (level == bmcl::LogLevel::Panic)
-        abort();
-}
-
 caf::behavior Logger::make_behavior()
 {
     set_down_handler( [this](caf::down_msg&)
@@ -166,7 +108,7 @@ caf::behavior Logger::make_behavior()
         }
       , [this](caf::actor_id id, bmcl::LogLevel level, const std::string& msg)
         {
-            handle(id, level, msg.c_str(), false);
+            _log->push(level, id, msg);
         }
       , [this](std::string& virtual_file, const std::string& line)
         {
@@ -180,12 +122,12 @@ caf::behavior Logger::make_behavior()
                 aid = id();
                 errno = 0;
             }
-            handle(aid, bmcl::LogLevel::Warning, line.c_str(), true);
+            _log->push(bmcl::LogLevel::Warning, aid, line);
         }
       , [this](caf::actor_id id, const mccmsg::tm::LogPtr& log)
         {
             const auto& data = log->data();
-            handle(id, data.logLevel(), data.text().c_str(), false);
+            _log->push(data.logLevel(), id, data.text());
         }
       , [this](log_set_atom, const std::string& folder)
         {
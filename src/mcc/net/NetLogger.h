@@ -1,20 +1,23 @@
 #pragma once
 #include <map>
+#include <memory>
 #include <caf/event_based_actor.hpp>
 #include "mcc/net/NetLoggerInf.h"
 
 namespace mccnet {
 
+class AsyncLog;
+
+// Writes packet log files of channels, console text goes to AsyncLog and is written on its own thread
 class Logger : public caf::event_based_actor
 {
 public:
-    Logger(caf::actor_config& cfg, bool isConsole);
+    Logger(caf::actor_config& cfg, const std::shared_ptr<AsyncLog>& log);
     void on_exit() override;
     caf::behavior make_behavior() override;
     const char* name() const override;
 private:
-    void handle(caf::actor_id id, bmcl::LogLevel level, const char* msg, bool hasEndl);
-    bool _isConsole;
+    std::shared_ptr<AsyncLog> _log;
     std::string _folder;
     std::map<mccmsg::Channel, bmcl::SystemTime> _toOpen;
     std::map<mccmsg::Channel, ILogWriterPtr> _files;
@@ -19,6 +19,7 @@ using deactivated_atom = caf::atom_constant<caf::atom("deact")>;
 using connected_atom = caf::atom_constant<caf::atom("conn")>;
 using disconnected_atom = caf::atom_constant<caf::atom("disconn")>;
 using activated_list_atom = caf::atom_constant<caf::atom("actlist")>;
+using activated_change_atom = caf::atom_constant<caf::atom("actchange")>;
 using req_atom = caf::atom_constant<caf::atom("request")>;
 using resp_atom = caf::atom_constant<caf::atom("response")>;
 
@@ -1,3 +1,4 @@
+#include <cstring>
 #include <caf/actor.hpp>
 #include <caf/actor_system.hpp>
 #include <caf/actor_system_config.hpp>
@@ -7,6 +8,7 @@
 #include <QtGlobal>
 #include <bmcl/MakeRc.h>
 
+#include "mcc/net/AsyncLog.h"
 #include "mcc/net/Error.h"
 #include "mcc/net/NetProxy.h"
 #include "mcc/net/NetLoader.h"
@@ -107,7 +109,8 @@ NetProxy::NetProxy(bool isConsole, bmcl::Option<uint16_t> maxThreads, mccplugin:
     _sys = std::make_unique<caf::actor_system>(*_cfg);
     mccmsg::add_renderer(*_cfg);
     caf::actor_ostream::redirect_all(*_sys, ":log");
-    _logger = _sys->spawn <mccnet::Logger, caf::detached>(isConsole);
+    _log = std::make_shared<mccnet::AsyncLog>(stderr, isConsole);
+    _logger = _sys->spawn <mccnet::Logger, caf::detached>(_log);
     _loader = _sys->spawn<mccnet::NetLoader>(_logger);
 
     setBmclLogHandler();
@@ -174,6 +177,7 @@ NetProxy::~NetProxy()
 
     if (_qtLog) qInstallMessageHandler(0);
     if (_bmclLog) bmcl::setDefaulLogHandler();
+    _log.reset();
     std::cout.flush();
     std::cerr.flush();
 
@@ -236,18 +240,16 @@ void NetProxy::setQtLogHandler()
 
 void NetProxy::setBmclLogHandler()
 {
-    caf::weak_actor_ptr a;
-    if (_logger)
-        a = caf::actor_cast<caf::weak_actor_ptr>(_logger);
+    // text is queued straight to log writer, logger actor mailbox is left for packet logs
+    std::weak_ptr<AsyncLog> a = _log;
     auto r = [a](bmcl::LogLevel level, const char* msg)
     {
-        auto t = caf::actor_cast<caf::actor>(a);
-        if (!t)
+        auto log = a.lock();
+        if (!log)
         {
             return;
         }
-        //auto aid = t->home_system().logger().thread_local_aid();
-        caf::anon_send(t, (caf::actor_id)0, level, std::string(msg));
+        log->push(level, 0, msg, std::strlen(msg));
     };
     bmcl::setLogHandler(r);
     _bmclLog = true;
@@ -12,6 +12,8 @@ namespace caf { class actor_system_config; }
 
 namespace mccnet {
 
+class AsyncLog;
+
 class MCC_NET_DECLSPEC NetProxy : public mcc::RefCountable
 {
 public:
@@ -33,6 +35,7 @@ private:
     bool _internal;
     bool _qtLog;
     bool _bmclLog;
+    std::shared_ptr<AsyncLog> _log;
     caf::actor _logger;
     caf::actor _loader;
     std::unique_ptr<caf::actor_system> _sys;
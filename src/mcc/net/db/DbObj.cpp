@@ -12,6 +12,7 @@
 #include "mcc/msg/ptr/TmSession.h"
 #include "mcc/msg/ptr/ReqVisitor.h"
 #include "mcc/msg/ptr/NoteVisitor.h"
+#include "mcc/msg/ProtocolController.h"
 
 #include "mcc/path/Paths.h"
 
@@ -140,6 +141,8 @@ caf::behavior DbObj::make_behavior()
             {
                 _db->protocol().updatePlugins(controller.get());
                 _db->firmware().updatePlugins(controller.get());
+                for (const mccmsg::ProtocolDescription& d : controller->dscrs())
+                    _db->firmware().upgrade(d->info());
             }
     };
 }
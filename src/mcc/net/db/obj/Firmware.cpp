@@ -30,11 +30,19 @@ Firmware::Firmware(DbObjInternal* db)
     , _devices_by_firmware(db->db())
     , _clean_firmware(db->db())
     , _delete_firmware(db->db())
+    , _firmware_by_protocol(db->db())
+    , _update_binary(db->db())
+    , _upgraded(db->db())
+    , _set_upgraded(db->db())
 {
     sql_prepare(_firmware_by_local, "select id from firmware where info=:info and protocol_id = (select id from protocol where name=:protocol);");
     sql_prepare(_devices_by_firmware, "select name from device where firmware_id = (select id from firmware where name=:firmware)");
     sql_prepare(_clean_firmware, "update device set firmware_id = null where firmware_id = (select id from firmware where name=:firmware)");
     sql_prepare(_delete_firmware, "delete from firmware where name = :firmware");
+    sql_prepare(_firmware_by_protocol, "select name, info, protocol_id, binary from firmware where protocol_id = (select id from protocol where info=:protocol)");
+    sql_prepare(_update_binary, "update firmware set binary = :binary where name = :firmware");
+    sql_prepare(_upgraded, "select value from property where name = :name");
+    sql_prepare(_set_upgraded, "insert or replace into property (name, value) values (:name, '1')");
 }
 
 caf::result<mccmsg::firmware::Update_ResponsePtr> Firmware::execute(const mccmsg::firmware::Update_Request&)
@@ -150,8 +158,8 @@ bmcl::OptionRc<const mccmsg::IFirmware> Firmware::loadFrm(const mccmsg::Protocol
     auto r = _pc->decodeFirmware(id, bytes);
     if(r.isNone())
     {
-        BMCL_WARNING() << fmt::format("Прошивка для неизвестного протокола {}", id.protocol().toStdString());
-        assert(false);
+        // protocol is unknown or stored firmware is damaged
+        BMCL_WARNING() << fmt::format("Не удалось загрузить прошивку {} протокола {}", id.value(), id.protocol().toStdString());
         return bmcl::None;
     }
     return r;
@@ -177,6 +185,66 @@ bmcl::Option<mccmsg::FirmwareDescription> Firmware::get(const sqlite3pp::selecte
     return bmcl::makeRc<const mccmsg::FirmwareDescriptionObj>(name, pv, f.take());
 }
 
+void Firmware::upgrade(bmcl::StringView protocolInfo)
+{
+    std::string property = fmt::format("firmware_upgraded_{}", protocolInfo.toStdString());
+    _upgraded.reset();
+    print(binds(&_upgraded, ":name", bmcl::StringView(property), sqlite3pp::nocopy));
+    auto r = print(exec(&_upgraded));
+    if (r.isSome() || _upgraded.next())
+        return;
+
+    // firmware stored in older format is decoded and written back in current one,
+    // upgrade is repeated on next start until every firmware is decoded and written
+    bool isComplete = true;
+    std::vector<std::pair<std::string, bmcl::Buffer>> updated;
+    _firmware_by_protocol.reset();
+    print(binds(&_firmware_by_protocol, ":protocol", protocolInfo, sqlite3pp::copy));
+    r = print(exec(&_firmware_by_protocol));
+    if (r.isSome())
+        return;
+    while (_firmware_by_protocol.next())
+    {
+        const auto row = _firmware_by_protocol.get_row();
+        bmcl::Bytes bs = row.get<bmcl::Bytes>("binary");
+        auto p = _db->protocol().getOne(row.get<int64_t>("protocol_id"));
+        if (p.isErr())
+        {
+            isComplete = false;
+            continue;
+        }
+        mccmsg::ProtocolValue pv(p.unwrap()->name(), row.get<bmcl::StringView>("info").toStdString());
+        auto f = loadFrm(pv, bs);
+        if (f.isNone())
+        {
+            isComplete = false;
+            continue;
+        }
+        bmcl::Buffer encoded = f.unwrap()->encode();
+        if (!isSame(encoded.asBytes(), bs))
+            updated.emplace_back(row.get<bmcl::StringView>("name").toStdString(), std::move(encoded));
+    }
+
+    for (const auto& i : updated)
+    {
+        _update_binary.reset();
+        print(binds(&_update_binary, ":binary", i.second.asBytes(), sqlite3pp::nocopy));
+        print(binds(&_update_binary, ":firmware", bmcl::StringView(i.first), sqlite3pp::nocopy));
+        r = print(exec(&_update_binary));
+        if (r.isSome())
+            return;
+    }
+
+    if (!isComplete)
+        return;
+
+    _set_upgraded.reset();
+    print(binds(&_set_upgraded, ":name", bmcl::StringView(property), sqlite3pp::nocopy));
+    print(exec(&_set_upgraded));
+    if (!updated.empty())
+        BMCL_DEBUG() << fmt::format("Обновлён формат прошивок протокола {}: {}", protocolInfo.toStdString(), updated.size());
+}
+
 bmcl::Result<mccmsg::Firmware, caf::error> Firmware::insert(const mccmsg::FirmwareDescription& d, ObjectId& id)
 {
     const auto& f = d->frm();
@@ -19,6 +19,8 @@ public:
     explicit Firmware(DbObjInternal*);
     ~Firmware();
     void updatePlugins(const mccmsg::ProtocolController*);
+    // rewrites firmware of given protocol stored in older encoding, once per db
+    void upgrade(bmcl::StringView protocolInfo);
 
     caf::result<mccmsg::firmware::Update_ResponsePtr> execute(const mccmsg::firmware::Update_Request& request);
     caf::result<mccmsg::firmware::List_ResponsePtr> execute(const mccmsg::firmware::List_Request& request);
@@ -39,6 +41,10 @@ private:
     sqlite3pp::selecter _devices_by_firmware;
     sqlite3pp::statement _clean_firmware;
     sqlite3pp::statement _delete_firmware;
+    sqlite3pp::selecter _firmware_by_protocol;
+    sqlite3pp::statement _update_binary;
+    sqlite3pp::selecter _upgraded;
+    sqlite3pp::statement _set_upgraded;
     bmcl::Rc<const mccmsg::ProtocolController> _pc;
 };
 
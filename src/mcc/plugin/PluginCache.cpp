@@ -11,8 +11,15 @@
 #include <QString>
 #include <QDir>
 
+#include <chrono>
+
 namespace mccplugin {
 
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
 PluginCache::PluginCache()
 {
 }
@@ -46,16 +53,19 @@ void PluginCacheWriter::loadAllFromDir(const QString& path)
 #else
     QFileInfoList lst = QDir(path).entryInfoList(QStringList() << "*.so");
 #endif
+    auto start = std::chrono::steady_clock::now();
     for (const QFileInfo& info : lst) {
         loadLibrary(info.absoluteFilePath());
     }
+    BMCL_INFO() << "loaded " << lst.size() << " plugin libraries in " << elapsedMs(start) << " ms";
 }
 
 bool PluginCacheWriter::loadLibrary(const QString& path)
 {
+    auto start = std::chrono::steady_clock::now();
     QLibrary lib;
     lib.setFileName(path);
-    bmcl::Logger logger(bmcl::LogLevel::Debug);
+    bmcl::Logger logger(bmcl::LogLevel::Info);
     logger << "Loading plugin " << path << "... ";
     if (!lib.load()) {
         logger << "FAILED to load (" << lib.errorString() << ")";
@@ -66,8 +76,9 @@ bool PluginCacheWriter::loadLibrary(const QString& path)
         logger << "FAILED to find init symbol '" MCC_PLUGIN_MAIN_SYMBOL << "'";
         return false;
     }
-    logger << "OK";
     symbol(this);
+    // load time includes plugin constructors run by entry point
+    logger << "OK (" << elapsedMs(start) << " ms)";
     return true;
 }
 
@@ -108,9 +119,11 @@ void PluginCacheWriter::initPlugins()
         std::vector<PluginPtr> currentUnitialized;
         currentUnitialized.reserve(uninitialized.size());
         for (const PluginPtr& plugin : uninitialized) {
+            auto start = std::chrono::steady_clock::now();
             if (!plugin->init(this)) {
                 currentUnitialized.push_back(plugin);
             } else {
+                BMCL_INFO() << "initialized plugin " << plugin->typeId() << " in " << elapsedMs(start) << " ms";
                 initialized.push_back(plugin);
             }
         }
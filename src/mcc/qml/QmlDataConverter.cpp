@@ -1,14 +1,28 @@
 #include "mcc/qml/QmlDataConverter.h"
+#include "mcc/qml/QmlFrameDecoder.h"
 
 #include <QObject>
 #include <QMetaObject>
 #include <QList>
+#include <QQmlEngine>
 
 #include <bmcl/MemWriter.h>
 #include <bmcl/MemReader.h>
 
 namespace mccqml {
 
+// QList<int> from js array holds one byte per element
+template <std::size_t N>
+static bool toBytes(const QList<int>& data, uint8_t (&dest)[N])
+{
+    if ((std::size_t)data.size() < N)
+        return false;
+
+    for (std::size_t i = 0; i < N; i++)
+        dest[i] = (uint8_t)data[(int)i];
+    return true;
+}
+
 QmlDataConverter::QmlDataConverter(QObject* parent)
     : QObject(parent)
 {
@@ -20,148 +34,153 @@ QmlDataConverter::~QmlDataConverter()
 
 float QmlDataConverter::toFloatLe(const QList<int>& data)
 {
-    if ((size_t)data.size() < sizeof(float))
+    uint8_t bytes[sizeof(float)];
+    if (!toBytes(data, bytes))
         return 0.0;
 
-    auto vec = toVector(data);
-    bmcl::MemReader reader(vec.data(), vec.size());
+    bmcl::MemReader reader(bytes, sizeof(bytes));
     return reader.readFloat32Le();
 }
 
 float QmlDataConverter::toFloatBe(const QList<int>& data)
 {
-    if ((size_t)data.size() < sizeof(float))
+    uint8_t bytes[sizeof(float)];
+    if (!toBytes(data, bytes))
         return 0.0;
 
-    auto vec = toVector(data);
-    bmcl::MemReader reader(vec.data(), vec.size());
+    bmcl::MemReader reader(bytes, sizeof(bytes));
     return reader.readFloat32Be();
 }
 
 double QmlDataConverter::toDoubleLe(const QList<int>& data)
 {
-    if ((size_t)data.size() < sizeof(double))
+    uint8_t bytes[sizeof(double)];
+    if (!toBytes(data, bytes))
         return 0.0;
 
-    auto vec = toVector(data);
-    bmcl::MemReader reader(vec.data(), vec.size());
+    bmcl::MemReader reader(bytes, sizeof(bytes));
     return reader.readFloat64Le();
 }
 
 double QmlDataConverter::toDoubleBe(const QList<int>& data)
 {
-    if ((size_t)data.size() < sizeof(double))
+    uint8_t bytes[sizeof(double)];
+    if (!toBytes(data, bytes))
         return 0.0;
 
-    auto vec = toVector(data);
-    bmcl::MemReader reader(vec.data(), vec.size());
+    bmcl::MemReader reader(bytes, sizeof(bytes));
     return reader.readFloat64Be();
 }
 
 int QmlDataConverter::toInt32Le(const QList<int>& data)
 {
-    if ((size_t)data.size() < sizeof(int32_t))
+    uint8_t bytes[sizeof(int32_t)];
+    if (!toBytes(data, bytes))
         return 0;
 
-    auto vec = toVector(data);
-    bmcl::MemReader reader(vec.data(), vec.size());
+    bmcl::MemReader reader(bytes, sizeof(bytes));
     return reader.readInt32Le();
 }
 
 int QmlDataConverter::toInt32Be(const QList<int>& data)
 {
-    if ((size_t)data.size() < sizeof(int32_t))
+    uint8_t bytes[sizeof(int32_t)];
+    if (!toBytes(data, bytes))
         return 0;
 
-    auto vec = toVector(data);
-    bmcl::MemReader reader(vec.data(), vec.size());
+    bmcl::MemReader reader(bytes, sizeof(bytes));
     return reader.readInt32Be();
 }
 
 unsigned int QmlDataConverter::toUInt32Le(const QList<int>& data)
 {
-    if ((size_t)data.size() < sizeof(uint32_t))
+    uint8_t bytes[sizeof(uint32_t)];
+    if (!toBytes(data, bytes))
         return 0;
 
-    auto vec = toVector(data);
-    bmcl::MemReader reader(vec.data(), vec.size());
+    bmcl::MemReader reader(bytes, sizeof(bytes));
     return reader.readUint32Le();
 }
 
 unsigned int QmlDataConverter::toUInt32Be(const QList<int>& data)
 {
-    if ((size_t)data.size() < sizeof(uint32_t))
+    uint8_t bytes[sizeof(uint32_t)];
+    if (!toBytes(data, bytes))
         return 0;
 
-    auto vec = toVector(data);
-    bmcl::MemReader reader(vec.data(), vec.size());
+    bmcl::MemReader reader(bytes, sizeof(bytes));
     return reader.readUint32Be();
 }
 
 unsigned int QmlDataConverter::toUInt16Le(const QList<int>& data)
 {
-    if ((size_t)data.size() < sizeof(uint16_t))
+    uint8_t bytes[sizeof(uint16_t)];
+    if (!toBytes(data, bytes))
         return 0;
-    auto vec = toVector(data);
-    bmcl::MemReader reader(vec.data(), vec.size());
+
+    bmcl::MemReader reader(bytes, sizeof(bytes));
     return reader.readUint16Le();
 }
 
 unsigned int QmlDataConverter::toUInt16Be(const QList<int>& data)
 {
-    if ((size_t)data.size() < sizeof(uint16_t))
+    uint8_t bytes[sizeof(uint16_t)];
+    if (!toBytes(data, bytes))
         return 0;
 
-    auto vec = toVector(data);
-    bmcl::MemReader reader(vec.data(), vec.size());
+    bmcl::MemReader reader(bytes, sizeof(bytes));
     return reader.readUint16Be();
 }
 
 int QmlDataConverter::toInt16Le(const QList<int>& data)
 {
-    if ((size_t)data.size() < sizeof(int16_t))
+    uint8_t bytes[sizeof(int16_t)];
+    if (!toBytes(data, bytes))
         return 0;
 
-    auto vec = toVector(data);
-    bmcl::MemReader reader(vec.data(), vec.size());
+    bmcl::MemReader reader(bytes, sizeof(bytes));
     return reader.readInt16Le();
 }
 
 int QmlDataConverter::toInt16Be(const QList<int>& data)
 {
-    if ((size_t)data.size() < sizeof(int16_t))
+    uint8_t bytes[sizeof(int16_t)];
+    if (!toBytes(data, bytes))
         return 0;
 
-    auto vec = toVector(data);
-    bmcl::MemReader reader(vec.data(), vec.size());
+    bmcl::MemReader reader(bytes, sizeof(bytes));
     return reader.readInt16Be();
 }
 
 int QmlDataConverter::toInt8(const QList<int>& data)
 {
-    if ((size_t)data.size() < sizeof(int8_t))
+    uint8_t bytes[sizeof(int8_t)];
+    if (!toBytes(data, bytes))
         return 0;
 
-    auto vec = toVector(data);
-    bmcl::MemReader reader(vec.data(), vec.size());
+    bmcl::MemReader reader(bytes, sizeof(bytes));
     return reader.readInt8();
 }
 
 int QmlDataConverter::toUInt8(const QList<int>& data)
 {
-    if ((size_t)data.size() < sizeof(uint8_t))
+    uint8_t bytes[sizeof(uint8_t)];
+    if (!toBytes(data, bytes))
         return 0;
 
-    auto vec = toVector(data);
-    bmcl::MemReader reader(vec.data(), vec.size());
+    bmcl::MemReader reader(bytes, sizeof(bytes));
     return reader.readUint8();
 }
 
-std::vector<uint8_t> QmlDataConverter::toVector(const QList<int>& data) const
+QObject* QmlDataConverter::createFrameDecoder(const QVariantList& layout)
 {
-    std::vector<uint8_t> vec;
-    for (auto x : data)
-        vec.push_back((uint8_t)x);
-    return vec;
+    auto decoder = new QmlFrameDecoder;
+    if (!decoder->setLayout(layout))
+    {
+        delete decoder;
+        return nullptr;
+    }
+    QQmlEngine::setObjectOwnership(decoder, QQmlEngine::JavaScriptOwnership);
+    return decoder;
 }
 }
@@ -2,6 +2,7 @@
 
 #include "mcc/Config.h"
 #include <QObject>
+#include <QVariant>
 
 template <typename T>
 class QList;
@@ -31,7 +32,7 @@ public:
     Q_INVOKABLE int toInt8(const QList<int>& data);
     Q_INVOKABLE int toUInt8(const QList<int>& data);
 
-private:
-    std::vector<uint8_t> toVector(const QList<int>& data) const;
+    // decoder of frames with given field layout, see QmlFrameDecoder::setLayout
+    Q_INVOKABLE QObject* createFrameDecoder(const QVariantList& layout);
 };
 }
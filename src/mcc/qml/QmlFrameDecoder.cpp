@@ -0,0 +1,269 @@
+#include "mcc/qml/QmlFrameDecoder.h"
+
+#include <QQmlPropertyMap>
+#include <QVariantMap>
+
+#include <bmcl/Endian.h>
+#include <bmcl/Logging.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace mccqml {
+
+struct TypeName
+{
+    const char* name;
+    QmlFrameDecoder::FieldType type;
+};
+
+static const TypeName typeNames[] =
+{
+    {"u8",    QmlFrameDecoder::FieldType::Uint8},
+    {"i8",    QmlFrameDecoder::FieldType::Int8},
+    {"u16le", QmlFrameDecoder::FieldType::Uint16Le},
+    {"u16be", QmlFrameDecoder::FieldType::Uint16Be},
+    {"i16le", QmlFrameDecoder::FieldType::Int16Le},
+    {"i16be", QmlFrameDecoder::FieldType::Int16Be},
+    {"u32le", QmlFrameDecoder::FieldType::Uint32Le},
+    {"u32be", QmlFrameDecoder::FieldType::Uint32Be},
+    {"i32le", QmlFrameDecoder::FieldType::Int32Le},
+    {"i32be", QmlFrameDecoder::FieldType::Int32Be},
+    {"u64le", QmlFrameDecoder::FieldType::Uint64Le},
+    {"u64be", QmlFrameDecoder::FieldType::Uint64Be},
+    {"i64le", QmlFrameDecoder::FieldType::Int64Le},
+    {"i64be", QmlFrameDecoder::FieldType::Int64Be},
+    {"f32le", QmlFrameDecoder::FieldType::Float32Le},
+    {"f32be", QmlFrameDecoder::FieldType::Float32Be},
+    {"f64le", QmlFrameDecoder::FieldType::Float64Le},
+    {"f64be", QmlFrameDecoder::FieldType::Float64Be},
+};
+
+QmlFrameDecoder::QmlFrameDecoder(QObject* parent)
+    : QObject(parent)
+    , _values(new QQmlPropertyMap(this))
+    , _frameSize(0)
+{
+}
+
+QmlFrameDecoder::~QmlFrameDecoder()
+{
+}
+
+bmcl::Option<QmlFrameDecoder::FieldType> QmlFrameDecoder::parseType(const QString& name)
+{
+    for (const TypeName& t : typeNames)
+    {
+        if (name.compare(QLatin1String(t.name), Qt::CaseInsensitive) == 0)
+            return t.type;
+    }
+    return bmcl::None;
+}
+
+std::size_t QmlFrameDecoder::typeSize(FieldType type)
+{
+    switch (type)
+    {
+    case FieldType::Uint8:
+    case FieldType::Int8:
+        return 1;
+    case FieldType::Uint16Le:
+    case FieldType::Uint16Be:
+    case FieldType::Int16Le:
+    case FieldType::Int16Be:
+        return 2;
+    case FieldType::Uint32Le:
+    case FieldType::Uint32Be:
+    case FieldType::Int32Le:
+    case FieldType::Int32Be:
+    case FieldType::Float32Le:
+    case FieldType::Float32Be:
+        return 4;
+    case FieldType::Uint64Le:
+    case FieldType::Uint64Be:
+    case FieldType::Int64Le:
+    case FieldType::Int64Be:
+    case FieldType::Float64Le:
+    case FieldType::Float64Be:
+        return 8;
+    }
+    return 0;
+}
+
+bool QmlFrameDecoder::setLayout(const QVariantList& layout)
+{
+    clearLayout();
+    std::size_t offset = 0;
+    for (const QVariant& v : layout)
+    {
+        QVariantMap field = v.toMap();
+        QString name = field.value("name").toString();
+        auto type = parseType(field.value("type").toString());
+        if (name.isEmpty() || type.isNone())
+        {
+            BMCL_WARNING() << "invalid frame field: " << name.toStdString() << " " << field.value("type").toString().toStdString();
+            clearLayout();
+            return false;
+        }
+        auto explicitOffset = field.find("offset");
+        if (explicitOffset != field.end())
+            offset = explicitOffset->toUInt();
+        addField(name, type.unwrap(), offset);
+        offset += typeSize(type.unwrap());
+    }
+    emit layoutChanged();
+    return true;
+}
+
+void QmlFrameDecoder::addField(const QString& name, FieldType type, std::size_t offset)
+{
+    Field f;
+    f.name = name;
+    f.offset = offset;
+    f.type = type;
+    f.isSet = false;
+    f.raw = 0;
+    _fields.push_back(f);
+    _frameSize = std::max(_frameSize, offset + typeSize(type));
+}
+
+void QmlFrameDecoder::clearLayout()
+{
+    for (const Field& f : _fields)
+        _values->clear(f.name);
+    _fields.clear();
+    _frameSize = 0;
+}
+
+uint64_t QmlFrameDecoder::readRaw(FieldType type, const uint8_t* data)
+{
+    switch (type)
+    {
+    case FieldType::Uint8:
+    case FieldType::Int8:
+        return data[0];
+    case FieldType::Uint16Le:
+    case FieldType::Int16Le:
+        return le16dec(data);
+    case FieldType::Uint16Be:
+    case FieldType::Int16Be:
+        return be16dec(data);
+    case FieldType::Uint32Le:
+    case FieldType::Int32Le:
+    case FieldType::Float32Le:
+        return le32dec(data);
+    case FieldType::Uint32Be:
+    case FieldType::Int32Be:
+    case FieldType::Float32Be:
+        return be32dec(data);
+    case FieldType::Uint64Le:
+    case FieldType::Int64Le:
+    case FieldType::Float64Le:
+        return le64dec(data);
+    case FieldType::Uint64Be:
+    case FieldType::Int64Be:
+    case FieldType::Float64Be:
+        return be64dec(data);
+    }
+    return 0;
+}
+
+QVariant QmlFrameDecoder::toVariant(FieldType type, uint64_t raw)
+{
+    switch (type)
+    {
+    case FieldType::Uint8:
+    case FieldType::Uint16Le:
+    case FieldType::Uint16Be:
+    case FieldType::Uint32Le:
+    case FieldType::Uint32Be:
+        return QVariant((uint)raw);
+    case FieldType::Int8:
+        return QVariant((int)(int8_t)raw);
+    case FieldType::Int16Le:
+    case FieldType::Int16Be:
+        return QVariant((int)(int16_t)raw);
+    case FieldType::Int32Le:
+    case FieldType::Int32Be:
+        return QVariant((int)(int32_t)raw);
+    // js numbers are doubles anyway
+    case FieldType::Uint64Le:
+    case FieldType::Uint64Be:
+        return QVariant((double)raw);
+    case FieldType::Int64Le:
+    case FieldType::Int64Be:
+        return QVariant((double)(int64_t)raw);
+    case FieldType::Float32Le:
+    case FieldType::Float32Be:
+    {
+        uint32_t bits = (uint32_t)raw;
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return QVariant(value);
+    }
+    case FieldType::Float64Le:
+    case FieldType::Float64Be:
+    {
+        double value;
+        std::memcpy(&value, &raw, sizeof(value));
+        return QVariant(value);
+    }
+    }
+    return QVariant();
+}
+
+int QmlFrameDecoder::decode(const QByteArray& frame)
+{
+    const uint8_t* data = (const uint8_t*)frame.constData();
+    std::size_t size = frame.size();
+    int changed = 0;
+    for (Field& f : _fields)
+    {
+        if (f.offset + typeSize(f.type) > size)
+            continue;
+        uint64_t raw = readRaw(f.type, data + f.offset);
+        if (f.isSet && f.raw == raw)
+            continue;
+        f.isSet = true;
+        f.raw = raw;
+        _values->insert(f.name, toVariant(f.type, raw));
+        changed++;
+    }
+    emit decoded(changed);
+    return changed;
+}
+
+QVariant QmlFrameDecoder::value(int index) const
+{
+    if (index < 0 || (std::size_t)index >= _fields.size() || !_fields[index].isSet)
+        return QVariant();
+    return toVariant(_fields[index].type, _fields[index].raw);
+}
+
+const QByteArray& QmlFrameDecoder::frame() const
+{
+    return _frame;
+}
+
+void QmlFrameDecoder::setFrame(const QByteArray& frame)
+{
+    _frame = frame;
+    decode(_frame);
+    emit frameChanged();
+}
+
+QObject* QmlFrameDecoder::values() const
+{
+    return _values;
+}
+
+int QmlFrameDecoder::fieldsCount() const
+{
+    return (int)_fields.size();
+}
+
+int QmlFrameDecoder::frameSize() const
+{
+    return (int)_frameSize;
+}
+}
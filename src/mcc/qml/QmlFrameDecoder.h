@@ -0,0 +1,99 @@
+#pragma once
+
+#include "mcc/Config.h"
+
+#include <bmcl/Option.h>
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QVariant>
+
+#include <cstdint>
+#include <vector>
+
+class QQmlPropertyMap;
+
+namespace mccqml {
+
+// Decodes telemetry frames with fixed field layout. Layout is described once, every frame is decoded in C++
+// and only changed fields are written into values map, so QML bindings to unchanged fields are not reevaluated.
+// Frame is exposed to QML as ArrayBuffer
+class MCC_QML_DECLSPEC QmlFrameDecoder : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QByteArray frame READ frame WRITE setFrame NOTIFY frameChanged)
+    Q_PROPERTY(QObject* values READ values CONSTANT)
+    Q_PROPERTY(int fieldsCount READ fieldsCount NOTIFY layoutChanged)
+    Q_PROPERTY(int frameSize READ frameSize NOTIFY layoutChanged)
+
+public:
+    enum class FieldType : uint8_t
+    {
+        Uint8,
+        Int8,
+        Uint16Le,
+        Uint16Be,
+        Int16Le,
+        Int16Be,
+        Uint32Le,
+        Uint32Be,
+        Int32Le,
+        Int32Be,
+        Uint64Le,
+        Uint64Be,
+        Int64Le,
+        Int64Be,
+        Float32Le,
+        Float32Be,
+        Float64Le,
+        Float64Be,
+    };
+
+    explicit QmlFrameDecoder(QObject* parent = nullptr);
+    ~QmlFrameDecoder();
+
+    // type names are u8, i8, u16le, i16be, f32le, f64be and so on
+    static bmcl::Option<FieldType> parseType(const QString& name);
+    static std::size_t typeSize(FieldType type);
+
+    // list of {name, type, offset} objects, field without offset follows previous field
+    Q_INVOKABLE bool setLayout(const QVariantList& layout);
+    void addField(const QString& name, FieldType type, std::size_t offset);
+    void clearLayout();
+
+    // returns number of changed fields, fields outside of frame keep previous values
+    Q_INVOKABLE int decode(const QByteArray& frame);
+    Q_INVOKABLE QVariant value(int index) const;
+
+    const QByteArray& frame() const;
+    void setFrame(const QByteArray& frame);
+    QObject* values() const;
+    int fieldsCount() const;
+    int frameSize() const;
+
+signals:
+    void frameChanged();
+    void layoutChanged();
+    void decoded(int changedCount);
+
+private:
+    struct Field
+    {
+        QString name;
+        std::size_t offset;
+        FieldType type;
+        bool isSet;
+        uint64_t raw;
+    };
+
+    static uint64_t readRaw(FieldType type, const uint8_t* data);
+    static QVariant toVariant(FieldType type, uint64_t raw);
+
+    std::vector<Field> _fields;
+    QByteArray _frame;
+    QQmlPropertyMap* _values;
+    std::size_t _frameSize;
+};
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "mcc/Config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mccuav {
+
+// Deadlines of many objects on monotonic clock. Objects are kept in slots by deadline tick,
+// rearming moves object between slots only when its tick changes, advance() visits only slots of passed ticks.
+// Deadlines further than slotsCount ticks are kept in slot and checked again on next round
+template <typename T>
+class DeadlineWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    DeadlineWheel(Clock::duration resolution, std::size_t slotsCount)
+        : _resolution(resolution)
+        , _slots(std::max<std::size_t>(slotsCount, 1))
+        , _lastTick(toTick(Clock::now()))
+    {
+    }
+
+    void arm(T* obj, Clock::time_point deadline)
+    {
+        // deadline is rounded up, so every object in slot of passed tick is expired
+        int64_t tick = toTick(deadline + _resolution - Clock::duration(1));
+        auto it = _entries.find(obj);
+        if (it == _entries.end()) {
+            Entry& entry = _entries[obj];
+            entry.tick = tick;
+            insert(obj, &entry);
+            return;
+        }
+        Entry& entry = it->second;
+        if (entry.tick == tick || (entry.tick <= _lastTick && tick <= _lastTick)) {
+            entry.tick = tick;
+            return;
+        }
+        erase(entry);
+        entry.tick = tick;
+        insert(obj, &entry);
+    }
+
+    void remove(T* obj)
+    {
+        auto it = _entries.find(obj);
+        if (it == _entries.end()) {
+            return;
+        }
+        erase(it->second);
+        _entries.erase(it);
+    }
+
+    bool contains(T* obj) const
+    {
+        return _entries.find(obj) != _entries.end();
+    }
+
+    std::size_t size() const
+    {
+        return _entries.size();
+    }
+
+    void clear()
+    {
+        _entries.clear();
+        for (auto& slot : _slots) {
+            slot.clear();
+        }
+    }
+
+    // removes objects with passed deadlines and appends them to expired
+    void advance(Clock::time_point now, std::vector<T*>* expired)
+    {
+        int64_t nowTick = toTick(now);
+        if (nowTick <= _lastTick) {
+            return;
+        }
+        int64_t count = std::min<int64_t>(nowTick - _lastTick, _slots.size());
+        for (int64_t tick = nowTick - count + 1; tick <= nowTick; tick++) {
+            std::vector<T*>& slot = _slots[slotIndex(tick)];
+            for (std::size_t i = 0; i < slot.size();) {
+                auto it = _entries.find(slot[i]);
+                if (it->second.tick > nowTick) {
+                    i++;
+                    continue;
+                }
+                expired->push_back(slot[i]);
+                erase(it->second);
+                _entries.erase(it);
+            }
+        }
+        _lastTick = nowTick;
+    }
+
+private:
+    struct Entry {
+        int64_t tick;
+        std::size_t slot;
+        std::size_t index;
+    };
+
+    int64_t toTick(Clock::time_point time) const
+    {
+        return time.time_since_epoch() / _resolution;
+    }
+
+    std::size_t slotIndex(int64_t tick) const
+    {
+        return (std::size_t)(tick % (int64_t)_slots.size());
+    }
+
+    void insert(T* obj, Entry* entry)
+    {
+        // passed deadline is handled by next advance()
+        entry->slot = slotIndex(std::max(entry->tick, _lastTick + 1));
+        std::vector<T*>& slot = _slots[entry->slot];
+        entry->index = slot.size();
+        slot.push_back(obj);
+    }
+
+    void erase(const Entry& entry)
+    {
+        std::vector<T*>& slot = _slots[entry.slot];
+        T* last = slot.back();
+        slot[entry.index] = last;
+        _entries[last].index = entry.index;
+        slot.pop_back();
+    }
+
+    Clock::duration _resolution;
+    std::vector<std::vector<T*>> _slots;
+    std::unordered_map<T*, Entry> _entries;
+    int64_t _lastTick;
+};
+}
@@ -15,6 +15,8 @@
 #include <bmcl/Logging.h>
 #include <bmcl/DoubleEq.h>
 
+#include <algorithm>
+
 namespace mccuav {
 
 static const char* kmlLineStringTemplate =
@@ -166,6 +168,7 @@ bool Route::addWaypoint(const mccmsg::Waypoint& waypoint)
     mccmsg::Waypoint wp = waypoint;
     if(wp.properties.values().empty())
         setDefaultProperties(wp);
+    emit waypointAboutToBeInserted(_points.size());
     _points.push_back(wp);
     emit waypointInserted(wp, _points.size() - 1);
 
@@ -206,6 +209,7 @@ bool Route::insertWaypoint(const mccmsg::Waypoint& waypoint, int afterIndex /*=
     if(wp.properties.values().empty())
         setDefaultProperties(wp);
 
+    emit waypointAboutToBeInserted(afterIndex);
     _points.insert(_points.begin() + afterIndex, wp);
 
     emit waypointInserted(wp, afterIndex);
@@ -227,6 +231,7 @@ bool Route::removeWaypoint(int index)
     if (index < 0 || index >= waypointsCount())
         return false;
 
+    emit waypointAboutToBeRemoved(index);
     _points.erase(_points.begin() + index);
     emit waypointRemoved(index);
 
@@ -285,21 +290,44 @@ void Route::selectAll()
     _selectedPointIndexes.reserve(_points.size());
     for (std::size_t i = 0; i < _points.size(); i++) {
         _selectedPointIndexes.push_back(i);
-        emit selectedWaypointsChanged(i, true);
     }
+    if (_points.empty())
+        return;
+    emit waypointsSelectionChanged(0, _points.size() - 1, true);
+    emit selectedWaypointsChanged();
 }
 
 void Route::clearSelection()
 {
     if (_selectedPointIndexes.empty())
         return;
-    auto indexesToEmit = _selectedPointIndexes;
+    auto indexesToEmit = std::move(_selectedPointIndexes);
 
     _selectedPointIndexes.clear();
-    for (auto idx : indexesToEmit)
+    emitSelectionRanges(std::move(indexesToEmit), false);
+    emit selectedWaypointsChanged();
+}
+
+void Route::emitSelectionRanges(std::vector<std::size_t> indexes, bool selected)
+{
+    if (indexes.empty())
+        return;
+
+    std::sort(indexes.begin(), indexes.end());
+    std::size_t first = indexes[0];
+    std::size_t last = first;
+    for (std::size_t i = 1; i < indexes.size(); i++)
     {
-        emit selectedWaypointsChanged(idx, false);
+        if (indexes[i] <= last + 1)
+        {
+            last = indexes[i];
+            continue;
+        }
+        emit waypointsSelectionChanged(first, last, selected);
+        first = indexes[i];
+        last = first;
     }
+    emit waypointsSelectionChanged(first, last, selected);
 }
 
 void Route::setSelectedPoint(std::size_t index, bool forced /*= false*/)
@@ -312,7 +340,8 @@ void Route::selectPoint(std::size_t index)
     auto it = std::find(_selectedPointIndexes.begin(), _selectedPointIndexes.end(), index);
     if (it == _selectedPointIndexes.end()) {
         _selectedPointIndexes.push_back(index);
-        emit selectedWaypointsChanged(index, true);
+        emit waypointsSelectionChanged(index, index, true);
+        emit selectedWaypointsChanged();
     }
 }
 
@@ -321,7 +350,8 @@ void Route::deselectPoint(std::size_t index)
     auto it = std::find(_selectedPointIndexes.begin(), _selectedPointIndexes.end(), index);
     if (it != _selectedPointIndexes.end()) {
         _selectedPointIndexes.erase(it);
-        emit selectedWaypointsChanged(index, false);
+        emit waypointsSelectionChanged(index, index, false);
+        emit selectedWaypointsChanged();
     }
 }
 
@@ -339,12 +369,11 @@ void Route::setSelectedPoints(const std::vector<std::size_t>& indexes, bool forc
 
     if (needUpdate)
     {
-        clearSelection();
+        auto deselected = std::move(_selectedPointIndexes);
         _selectedPointIndexes = indexes;
-        for (auto idx : _selectedPointIndexes)
-        {
-            emit selectedWaypointsChanged(idx, true);
-        }
+        emitSelectionRanges(std::move(deselected), false);
+        emitSelectionRanges(_selectedPointIndexes, true);
+        emit selectedWaypointsChanged();
     }
 }
 
@@ -375,6 +404,7 @@ bool Route::moveWaypointUp(int index)
     int newIndex = index - 1;
 
     auto wp = _points[oldIndex];
+    emit waypointAboutToBeMoved(oldIndex, newIndex);
     _points.erase(_points.begin() + oldIndex);
     _points.insert(_points.begin() + newIndex, wp);
 
@@ -393,6 +423,7 @@ bool Route::moveWaypointDown(int index)
     int newIndex = index + 1;
 
     auto wp = _points[oldIndex];
+    emit waypointAboutToBeMoved(oldIndex, newIndex);
     _points.erase(_points.begin() + oldIndex);
     _points.insert(_points.begin() + newIndex, wp);
 
@@ -141,13 +141,20 @@ signals:
     void allWaypointsChanged();
     void waypointOnlyAltChanged(const mccmsg::Waypoint& waypoint, int index);
 
+    // emitted before points change, so that models can notify views in advance
+    void waypointAboutToBeInserted(int index);
+    void waypointAboutToBeRemoved(int index);
+    void waypointAboutToBeMoved(int oldIndex, int newIndex);
     void waypointInserted(const mccmsg::Waypoint& waypoint, int index);
     void waypointRemoved(int index);
     void waypointMoved(int oldIndex, int newIndex);
     void waypointChanged(const mccmsg::Waypoint& waypoint, int index);
 
     void activeWaypointChanged(const bmcl::Option<std::size_t>& index);
-    void selectedWaypointsChanged(std::size_t index, bool selected);
+    // points [first, last] were selected or deselected, emitted before selectedWaypointsChanged
+    void waypointsSelectionChanged(std::size_t first, std::size_t last, bool selected);
+    // emitted once per selection change
+    void selectedWaypointsChanged();
 
     void closedPathFlagChanged(bool isRing);
     void userVisibilityFlagChanged(bool isVisible);
@@ -168,6 +175,7 @@ private:
 
     void syncActivePoint();
     void syncSelectedPoint();
+    void emitSelectionRanges(std::vector<std::size_t> indexes, bool selected);
     void setDefaultProperties(mccmsg::Waypoint& wp);
 
     mccuav::Uav*                  _uav;
@@ -34,6 +34,9 @@
 #include <random>
 #include <set>
 
+// memory for telemetry history of one vehicle: about an hour of position, attitude and velocity at 10 Hz
+static const std::size_t tmHistoryBudget = 4 * 1024 * 1024;
+
 #define SET_IF_CHANGED_DOUBLE(oldValue, newValue) \
     if (!bmcl::doubleEq(oldValue, newValue)) \
             { \
@@ -267,11 +270,6 @@ const mccmsg::StatDevice& Uav::statDevice() const
     return _statistics;
 }
 
-void Uav::setLastMsgTime(const QDateTime &time)
-{
-    _lastTmMsgDateTime = time;
-}
-
 const bmcl::Option<const mccgeo::Position&> Uav::position() const
 {
     if(_tmStorage.isNull())
@@ -425,6 +423,7 @@ void Uav::processSetTmView(const bmcl::Rc<const mccmsg::ITmView>& view)
             return;
         }
         _tmStorage = tmStorage.unwrap();
+        _tmStorage->setHistoryBudget(tmHistoryBudget);
     }
     else
     {
@@ -462,12 +461,19 @@ void Uav::processUpdateTmStatusView(const bmcl::Rc<const mccmsg::ITmViewUpdate>&
 
 QTime Uav::lastTmMsgTime() const
 {
-    return  _lastTmMsgDateTime.time();
+    return lastTmMsgDateTime().time();
+}
+
+QDateTime Uav::lastTmMsgDateTime() const
+{
+    if (_lastTmMsgTime.isNone())
+        return QDateTime();
+    return QDateTime::fromMSecsSinceEpoch(bmcl::toMsecs(_lastTmMsgTime->time_since_epoch()).count());
 }
 
-const QDateTime& Uav::lastTmMsgDateTime() const
+const bmcl::Option<bmcl::SystemTime>& Uav::lastTmMsgSystemTime() const
 {
-    return  _lastTmMsgDateTime;
+    return _lastTmMsgTime;
 }
 
 bool Uav::isAlive() const
@@ -496,17 +502,19 @@ void Uav::setSignalBad()
     showAlert("Потеряна связь!");
 }
 
-void Uav::setStatDevice(const mccmsg::StatDevice& state)
+bool Uav::setStatDevice(const mccmsg::StatDevice& state)
 {
     _statistics = state;
 
-    if (state._rcvd._packets > _rcvdPackets)
+    bool hasNewPackets = state._rcvd._packets > _rcvdPackets;
+    if (hasNewPackets)
     {
-        setLastMsgTime(QDateTime::fromMSecsSinceEpoch(bmcl::toMsecs(state._rcvd._time.time_since_epoch()).count()));
+        _lastTmMsgTime = state._rcvd._time;
         _rcvdPackets = state._rcvd._packets;
     }
 
     emit uavStatisticsChanged();
+    return hasNewPackets;
 }
 
 const mccmsg::Channels& Uav::channels() const
@@ -26,6 +26,7 @@
 #include "mcc/geo/Attitude.h"
 
 #include <bmcl/OptionPtr.h>
+#include <bmcl/TimeUtils.h>
 
 namespace mccuav {
 
@@ -82,7 +83,8 @@ public:
     void              setColor(const QColor& color, double scale);
     void              setColor(const QColor& color);
     QTime             lastTmMsgTime()   const;
-    const QDateTime&  lastTmMsgDateTime()   const;
+    QDateTime         lastTmMsgDateTime()   const;
+    const bmcl::Option<bmcl::SystemTime>& lastTmMsgSystemTime() const;
     bool              isAlive()         const;
     void              setAlive(bool active);
     void              setSignalGood();
@@ -94,7 +96,7 @@ public:
     const TrackSettings& trackSettings() const;
 
     const mccmsg::StatDevice& statDevice() const;
-    void setStatDevice(const mccmsg::StatDevice& state);
+    bool setStatDevice(const mccmsg::StatDevice& state);
 
     const mccmsg::Channels& channels() const;
     void setChannels(const mccmsg::Channels& channels);
@@ -213,8 +215,6 @@ public slots:
     void processSetTmView(const bmcl::Rc<const mccmsg::ITmView>& view);
     void processUpdateTmStatusView(const bmcl::Rc<const mccmsg::ITmViewUpdate>& update);
 
-    void setLastMsgTime(const QDateTime& time);
-
     void resetEditableRoute(int routeIdx = 0);
     void resetEditableRoute(Route* route);
     void uploadEditableRoute();
@@ -235,7 +235,7 @@ protected:
     QString             _uiFile;
 
     UavController*      _manager; //non owning ref
-    QDateTime           _lastTmMsgDateTime;
+    bmcl::Option<bmcl::SystemTime> _lastTmMsgTime;
     size_t              _rcvdPackets;
 
     bool                _isAlive;
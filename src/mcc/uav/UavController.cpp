@@ -41,7 +41,8 @@ UavController::UavController(mccui::Settings* settings,
                              const mccui::HeightmapController* hmController,
                              const mccmsg::ProtocolController* protocolController,
                              mccuav::ExchangeService* service)
-    : _selectedUav(nullptr)
+    : _liveness(std::chrono::seconds(1), 8)
+    , _selectedUav(nullptr)
     , _offlineMode(false)
     , _messageBox(new QMessageBox())
     , _settings(settings)
@@ -201,6 +202,10 @@ void UavController::addUav(const mccmsg::DeviceDescription& id, bool setCurrent
     device->setColor(findFreeUavColor(), _uavPixmapScale);
 
     _uavs.push_back(device);
+    _uavsByDevice.emplace(device->device(), device);
+    _uavsSet.insert(device);
+    // signal of device without telemetry is lost on next tick
+    _liveness.arm(device, DeadlineWheel<Uav>::Clock::now());
 
     if (setCurrent)
         selectUav(device);
@@ -221,7 +226,7 @@ void UavController::removeUav(Uav* device)
     Q_ASSERT(device != nullptr);
     BMCL_DEBUG() << "Removing device " << device->device().toStdString();
 
-    auto it = std::find_if(_uavs.begin(), _uavs.end(), [device](const Uav* d) {return d->device() == device->device(); });
+    auto it = std::find(_uavs.begin(), _uavs.end(), device);
     if (it == _uavs.end())
     {
         BMCL_ASSERT(false);
@@ -277,7 +282,11 @@ void UavController::clearUavs()
     }
 
     _uavs.clear();
+    _uavsByDevice.clear();
+    _uavsSet.clear();
+    _uavsByRequest.clear();
     _uavsForExchange.clear();
+    _liveness.clear();
 }
 
 const std::vector<Uav*>& UavController::uavsList() const
@@ -366,7 +375,7 @@ void UavController::sortUavList()
 
 bool UavController::isUavValid(const Uav* uav)
 {
-    return _uavs.end() != std::find_if(_uavs.begin(), _uavs.end(), [uav](const Uav* i){ return i == uav; });
+    return _uavsSet.find(uav) != _uavsSet.end();
 }
 
 bool UavController::isUavSelected(const Uav* uav)
@@ -510,44 +519,43 @@ void UavController::timerEvent(QTimerEvent *)
     if (_offlineMode)
         return;
 
-    const int INACTIVE_STATE = 3;
-
-    QDateTime currentDateTime = QDateTime::currentDateTime();
-
-    for (auto device : _uavs)
+    // only devices with passed deadlines are visited
+    _expiredUavs.clear();
+    _liveness.advance(DeadlineWheel<Uav>::Clock::now(), &_expiredUavs);
+    for (auto device : _expiredUavs)
     {
-        if (device->lastTmMsgDateTime().isNull())
+        if (device->isAlive() || device->lastTmMsgSystemTime().isNone())
         {
-            QDateTime pastDateTime = currentDateTime.addSecs(-INACTIVE_STATE - 1);
-
-            device->setLastMsgTime(pastDateTime);
             device->setAlive(false);
             device->setSignalBad();
             emit(uavSignalBad(device));
-            continue;
         }
+    }
+}
 
-        int inactiveSecs = device->lastTmMsgDateTime().secsTo(currentDateTime);
-        if ((inactiveSecs > INACTIVE_STATE) && device->isAlive())
-        {
-            device->setAlive(false);
-            device->setSignalBad();
-            emit(uavSignalBad(device));
-        }
+void UavController::armLiveness(Uav* device)
+{
+    const auto inactiveTimeout = std::chrono::seconds(3);
 
-        if ((inactiveSecs <= INACTIVE_STATE) && !device->isAlive())
-        {
-            device->setAlive(true);
-            device->setSignalGood();
-            emit(uavSignalGood(device));
-        }
+    // telemetry time is on system clock, deadline is on monotonic one
+    auto age = bmcl::SystemClock::now() - device->lastTmMsgSystemTime().unwrap();
+    if (age < bmcl::SystemClock::duration::zero())
+        age = bmcl::SystemClock::duration::zero();
+    if (age >= inactiveTimeout)
+        return;
 
-        auto it = _uavsForExchange.find(device->device());
-        if (!device->isStateActive() && it != _uavsForExchange.end())
-        {
-            emit uavNotReadyForExchange(device);
-            _uavsForExchange.erase(it);
-        }
+    auto deadline = DeadlineWheel<Uav>::Clock::now() + std::chrono::duration_cast<DeadlineWheel<Uav>::Clock::duration>(inactiveTimeout - age);
+    _liveness.arm(device, deadline);
+
+    // as in timerEvent, signal state is not toggled in offline mode
+    if (_offlineMode)
+        return;
+
+    if (!device->isAlive())
+    {
+        device->setAlive(true);
+        device->setSignalGood();
+        emit(uavSignalGood(device));
     }
 }
 
@@ -656,6 +664,16 @@ void UavController::processUavRemoving(Uav* device)
 
     emit uavRemoved(device);
     _uavsForExchange.erase(device->device());
+    _uavsByDevice.erase(device->device());
+    _uavsSet.erase(device);
+    for (auto it = _uavsByRequest.begin(); it != _uavsByRequest.end();)
+    {
+        if (it->second == device)
+            it = _uavsByRequest.erase(it);
+        else
+            ++it;
+    }
+    _liveness.remove(device);
     delete device;
     emit uavRemovingCompleted();
 }
@@ -684,12 +702,11 @@ void UavController::onUavStatistics(const mccmsg::StatDevice& deviceState)
 {
     if (!_chanController->isUavInChannel(deviceState._device))
     {
-        const auto i = std::find_if(_uavs.begin(), _uavs.end(), [&deviceState](const Uav* uav) { return deviceState._device == uav->device(); });
-        if (i != _uavs.end())
+        auto uav = this->uav(deviceState._device);
+        if (uav.isSome())
         {
-            auto uav = *i;
-            _uavs.erase(i);
-            processUavRemoving(uav);
+            _uavs.erase(std::find(_uavs.begin(), _uavs.end(), uav.unwrap()));
+            processUavRemoving(uav.unwrap());
         }
         return;
     }
@@ -701,7 +718,15 @@ void UavController::onUavStatistics(const mccmsg::StatDevice& deviceState)
         return;
     }
 
-    uav->setStatDevice(deviceState);
+    if (uav->setStatDevice(deviceState))
+        armLiveness(uav.unwrap());
+
+    auto it = _uavsForExchange.find(uav->device());
+    if (!deviceState._isActive && it != _uavsForExchange.end())
+    {
+        emit uavNotReadyForExchange(uav.unwrap());
+        _uavsForExchange.erase(it);
+    }
 
     if (deviceState._isActive /*&& deviceState.isRegistered()*/ && (_uavsForExchange.find(uav->device()) == _uavsForExchange.end()))
     {
@@ -782,26 +807,36 @@ void UavController::saveSettings()
 
 void UavController::onRequestAdded(const mccmsg::DevReqPtr& req)
 {
-    for (auto dev : _uavs)
-    {
-        dev->onCmdAdded(req);
-    }
+    auto device = req->device();
+    if (device.isNone())
+        return;
+
+    auto dev = uav(device.unwrap());
+    if (dev.isNone())
+        return;
+
+    _uavsByRequest[req->requestId()] = dev.unwrap();
+    dev->onCmdAdded(req);
 }
 
 void UavController::onRequestStateChanged(const mccmsg::DevReqPtr& req, const mccmsg::Request_StatePtr& state)
 {
-    for (auto dev : _uavs)
-    {
-        dev->onCmdStateChanged(req, state);
-    }
+    auto it = _uavsByRequest.find(req->requestId());
+    if (it == _uavsByRequest.end())
+        return;
+
+    it->second->onCmdStateChanged(req, state);
 }
 
 void UavController::onRequestRemoved(const mccmsg::DevReqPtr& req)
 {
-    for (auto dev : _uavs)
-    {
-        dev->onCmdRemoved(req);
-    }
+    auto it = _uavsByRequest.find(req->requestId());
+    if (it == _uavsByRequest.end())
+        return;
+
+    Uav* dev = it->second;
+    _uavsByRequest.erase(it);
+    dev->onCmdRemoved(req);
 }
 
 void UavController::onLog(bmcl::LogLevel logLevel, const mccmsg::Device& device, const std::string& text)
@@ -1005,10 +1040,10 @@ bool UavController::readyForExchange(const mccmsg::Device& device) const
 
 bmcl::OptionPtr<Uav> UavController::uav(const mccmsg::Device& name) const
 {
-    const auto it = std::find_if(_uavs.begin(), _uavs.end(), [name](const Uav* uav) { return uav->device() == name; });
-    if(it == _uavs.end())
+    const auto it = _uavsByDevice.find(name);
+    if(it == _uavsByDevice.end())
         return bmcl::None;
-    return *it;
+    return it->second;
 }
 
 template <typename F, typename... A>
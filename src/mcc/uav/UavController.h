@@ -1,5 +1,6 @@
 #pragma once
 #include <unordered_map>
+#include <unordered_set>
 #include <QObject>
 #include <QVector>
 #include <QMap>
@@ -7,8 +8,10 @@
 #include <bmcl/Option.h>
 #include <bmcl/OptionPtr.h>
 #include <bmcl/StringView.h>
+#include <bmcl/UuidHash.h>
 
 #include "mcc/uav/Uav.h"
+#include "mcc/uav/DeadlineWheel.h"
 #include "mcc/ui/Fwd.h"
 #include "mcc/ui/QObjectRefCountable.h"
 #include "mcc/uav/WaypointTemplateType.h"
@@ -243,9 +246,15 @@ private:
     void executeUavUnregistering(Uav* uav);
     void executeUavAndChannelUnregistering(Uav* uav);
     void processUavRemoving(Uav* uav);
+    void armLiveness(Uav* uav);
 
-    std::vector<Uav*>                   _uavs;
+    std::vector<Uav*>                   _uavs; // display order
+    std::unordered_map<bmcl::Uuid, Uav*> _uavsByDevice;
+    std::unordered_set<const Uav*>      _uavsSet;
+    std::unordered_map<mccmsg::RequestId, Uav*> _uavsByRequest;
     std::set<mccmsg::Device>            _uavsForExchange;
+    DeadlineWheel<Uav>                  _liveness;
+    std::vector<Uav*>                   _expiredUavs;
 
     Uav*                                _selectedUav;
 
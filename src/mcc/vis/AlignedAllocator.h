@@ -0,0 +1,67 @@
+#pragma once
+
+#include "mcc/vis/Config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace mccvis {
+
+// Allocator for arrays processed with simd, memory is aligned to cache line
+template <typename T, std::size_t alignment = 64>
+class AlignedAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, alignment>&)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        // original pointer is stored right before aligned block
+        std::size_t size = n * sizeof(T) + alignment + sizeof(void*);
+        void* raw = std::malloc(size);
+        if (!raw) {
+            throw std::bad_alloc();
+        }
+        std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+        std::uintptr_t aligned = (start + alignment - 1) & ~std::uintptr_t(alignment - 1);
+        reinterpret_cast<void**>(aligned)[-1] = raw;
+        return reinterpret_cast<T*>(aligned);
+    }
+
+    void deallocate(T* p, std::size_t)
+    {
+        if (p) {
+            std::free(reinterpret_cast<void**>(p)[-1]);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, alignment>&) const
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, alignment>&) const
+    {
+        return false;
+    }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+}
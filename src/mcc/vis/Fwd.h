@@ -2,18 +2,23 @@
 
 namespace mccvis {
 
+class PolylineLod;
 class Profile;
 class ProfileDataViewer;
+class ProfileGeometry;
 class ProfileViewer;
 class Radar;
 class RadarGroup;
+class RadarTerrainCache;
 struct RadarParams;
 class Region;
+class RegionGeometry;
 class RegionViewer;
 struct ReportConfig;
 class ReportGen;
 class ResultsWidget;
 struct Ticks;
+class Viewshed;
 class Zone;
 class ZoneMaker;
 }
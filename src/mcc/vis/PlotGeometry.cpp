@@ -0,0 +1,296 @@
+#include "mcc/vis/PlotGeometry.h"
+#include "mcc/vis/Profile.h"
+#include "mcc/vis/Region.h"
+
+#include <bmcl/Math.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mccvis {
+
+// tolerance of first simplified level, relative to units
+constexpr const double baseTolerance = 1.0 / 4096;
+constexpr const std::size_t maxLevels = 12;
+constexpr const double maxPixelError = 0.5;
+
+static QPolygonF simplify(const QPolygonF& points, double unitX, double unitY, double tolerance)
+{
+    QPolygonF rv;
+    if (points.size() < 3) {
+        return points;
+    }
+    rv.reserve(points.size());
+    rv.append(points[0]);
+    QPointF last = points[0];
+    for (int i = 1; i < points.size() - 1; i++) {
+        double dx = (points[i].x() - last.x()) / unitX;
+        double dy = (points[i].y() - last.y()) / unitY;
+        if (dx * dx + dy * dy < tolerance * tolerance) {
+            continue;
+        }
+        rv.append(points[i]);
+        last = points[i];
+    }
+    rv.append(points.back());
+    rv.squeeze();
+    return rv;
+}
+
+PolylineLod::PolylineLod()
+    : _unitX(1)
+    , _unitY(1)
+{
+    _levels.emplace_back(0, QPolygonF());
+}
+
+PolylineLod::PolylineLod(QPolygonF&& points, double unitX, double unitY)
+    : _unitX(unitX > 0 ? unitX : 1)
+    , _unitY(unitY > 0 ? unitY : 1)
+{
+    // reference to original stays valid while levels are added
+    _levels.reserve(maxLevels);
+    _levels.emplace_back(0, std::move(points));
+    const QPolygonF& full = _levels[0].second;
+    double tolerance = baseTolerance;
+    for (std::size_t i = 1; i < maxLevels && _levels.back().second.size() > 4; i++, tolerance *= 2) {
+        QPolygonF level = simplify(full, _unitX, _unitY, tolerance);
+        if (level.size() == _levels.back().second.size()) {
+            // nothing dropped, previous level is valid for larger tolerance
+            if (_levels.size() > 1) {
+                _levels.back().first = tolerance;
+            }
+            continue;
+        }
+        _levels.emplace_back(tolerance, std::move(level));
+    }
+}
+
+PolylineLod::~PolylineLod()
+{
+}
+
+const QPolygonF& PolylineLod::level(double pixelsPerUnitX, double pixelsPerUnitY) const
+{
+    double pixelsPerTolerance = std::max(std::abs(pixelsPerUnitX) * _unitX, std::abs(pixelsPerUnitY) * _unitY);
+    for (auto it = _levels.rbegin(); it < _levels.rend(); it++) {
+        if (it->first * pixelsPerTolerance <= maxPixelError) {
+            return it->second;
+        }
+    }
+    return _levels[0].second;
+}
+
+const QPolygonF& PolylineLod::full() const
+{
+    return _levels[0].second;
+}
+
+std::size_t PolylineLod::levelsCount() const
+{
+    return _levels.size();
+}
+
+bool PolylineLod::isEmpty() const
+{
+    return _levels[0].second.isEmpty();
+}
+
+ProfileGeometry::ProfileGeometry(const Profile* profile)
+    : _profile(profile)
+{
+    _ymin = profile->rayRect().bottom();
+    _ymax = profile->rayRect().top();
+    _yticks = Ticks::fromMinMax(_ymin, _ymax);
+    _ymin = std::min(_ymin, _yticks.min);
+    _ymax = std::max(_ymax, _yticks.max);
+
+    double unitX = profile->rayRect().right() - profile->rayRect().left();
+    double unitY = _ymax - _ymin;
+
+    const ProfileSamples& samples = profile->samples();
+    QPolygonF earth(samples.size());
+    QPolygonF target(samples.size());
+    for (std::size_t i = 0; i < samples.size(); i++) {
+        earth[i] = QPointF(samples.x[i], samples.y[i]);
+        target[i] = QPointF(samples.x[i], samples.targetY[i]);
+    }
+    _earth = PolylineLod(std::move(earth), unitX, unitY);
+    _target = PolylineLod(std::move(target), unitX, unitY);
+
+    const PointVector& region = profile->viewRegion();
+    _viewRegion = PolylineLod(QPolygonF(QVector<QPointF>::fromStdVector(region)), unitX, unitY);
+}
+
+ProfileGeometry::~ProfileGeometry()
+{
+}
+
+const Profile* ProfileGeometry::profile() const
+{
+    return _profile.get();
+}
+
+const PolylineLod& ProfileGeometry::earth() const
+{
+    return _earth;
+}
+
+const PolylineLod& ProfileGeometry::target() const
+{
+    return _target;
+}
+
+const PolylineLod& ProfileGeometry::viewRegion() const
+{
+    return _viewRegion;
+}
+
+const Ticks& ProfileGeometry::yticks() const
+{
+    return _yticks;
+}
+
+double ProfileGeometry::ymin() const
+{
+    return _ymin;
+}
+
+double ProfileGeometry::ymax() const
+{
+    return _ymax;
+}
+
+double ProfileGeometry::deltay() const
+{
+    return _ymax - _ymin;
+}
+
+static inline QPointF fromPolar(const QPointF& p)
+{
+    constexpr double pi = bmcl::pi<double>();
+    double phi = p.x() * pi / 180.0;
+    double r = p.y();
+    return QPointF(r * std::sin(phi), r * std::cos(phi));
+}
+
+static std::vector<PolylineLod> polarCurves(const std::vector<PointVector>& curves, double unit)
+{
+    std::vector<PolylineLod> rv;
+    rv.reserve(curves.size());
+    for (const PointVector& curve : curves) {
+        QPolygonF polygon(curve.size());
+        for (std::size_t i = 0; i < curve.size(); i++) {
+            polygon[i] = fromPolar(curve[i]);
+        }
+        rv.emplace_back(std::move(polygon), unit, unit);
+    }
+    return rv;
+}
+
+RegionGeometry::RegionGeometry(const Region* region)
+    : _region(region)
+    , _profiles(region->profiles().size())
+{
+    const ViewParams& params = region->params();
+    _maxDistance = std::max(params.maxBeamDistance, params.maxHitDistance) * (params.additionalDistancePercent / 100.0 + 1.0);
+    _viewZones = polarCurves(region->curves(), _maxDistance);
+    _hitZones = polarCurves(region->hitCurves(), _maxDistance);
+
+    double minViewAngle = 90;
+    double maxViewAngle = -90;
+    for (const Rc<Profile>& prof : region->profiles()) {
+        minViewAngle = std::min(minViewAngle, prof->viewAngle());
+        maxViewAngle = std::max(maxViewAngle, prof->viewAngle());
+    }
+    if (qFuzzyCompare(minViewAngle, maxViewAngle)) {
+        _angleTicks = Ticks::fromMinMax(minViewAngle - 0.1, maxViewAngle + 0.1);
+    } else {
+        _angleTicks = Ticks::fromMinMax(minViewAngle, maxViewAngle);
+    }
+
+    const std::vector<Rc<Profile>>& profiles = region->profiles();
+    if (profiles.empty()) {
+        return;
+    }
+    double rOffset = 0;
+    if (_angleTicks.min < 0) {
+        rOffset = -_angleTicks.min;
+    }
+    auto anglePoint = [rOffset](const Profile* prof) {
+        return fromPolar(QPointF(prof->direction(), prof->viewAngle() + rOffset));
+    };
+    QPolygonF angles;
+    angles.reserve(profiles.size() + 3);
+    if (params.isBidirectional) {
+        angles.append(anglePoint(profiles[0].get()));
+    } else {
+        angles.append(QPointF(0, 0));
+        angles.append(anglePoint(profiles[0].get()));
+    }
+    for (const Rc<Profile>& prof : profiles) {
+        angles.append(anglePoint(prof.get()));
+    }
+    if (params.isBidirectional) {
+        angles.append(anglePoint(profiles[0].get()));
+    } else {
+        angles.append(QPointF(0, 0));
+    }
+    double unit = _angleTicks.max - _angleTicks.min;
+    _angles = PolylineLod(std::move(angles), unit, unit);
+}
+
+RegionGeometry::~RegionGeometry()
+{
+}
+
+const Region* RegionGeometry::region() const
+{
+    return _region.get();
+}
+
+const std::vector<PolylineLod>& RegionGeometry::viewZones() const
+{
+    return _viewZones;
+}
+
+const std::vector<PolylineLod>& RegionGeometry::hitZones() const
+{
+    return _hitZones;
+}
+
+const PolylineLod& RegionGeometry::angles() const
+{
+    return _angles;
+}
+
+const Ticks& RegionGeometry::angleTicks() const
+{
+    return _angleTicks;
+}
+
+double RegionGeometry::maxDistance() const
+{
+    return _maxDistance;
+}
+
+Rc<const ProfileGeometry> RegionGeometry::profile(std::size_t index) const
+{
+    if (index >= _profiles.size()) {
+        return Rc<const ProfileGeometry>();
+    }
+    {
+        std::lock_guard<std::mutex> lock(_profilesMutex);
+        if (!_profiles[index].isNull()) {
+            return _profiles[index];
+        }
+    }
+    // built outside of lock, profile requested by several threads at once is built twice and one copy is kept
+    Rc<const ProfileGeometry> geometry = new ProfileGeometry(_region->profiles()[index].get());
+    std::lock_guard<std::mutex> lock(_profilesMutex);
+    if (_profiles[index].isNull()) {
+        _profiles[index] = geometry;
+    }
+    return _profiles[index];
+}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "mcc/vis/Config.h"
+#include "mcc/vis/Rc.h"
+#include "mcc/vis/Ticks.h"
+
+#include <QPolygonF>
+
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace mccvis {
+
+class Profile;
+class Region;
+
+// Polyline or polygon kept in several resolutions. Coarser levels drop vertices closer than level tolerance
+// to previous kept vertex, so they differ from original by less than tolerance.
+// Distances are measured in units of unitX and unitY, so plots with different axis scales are simplified evenly
+class MCC_VIS_DECLSPEC PolylineLod {
+public:
+    PolylineLod();
+    PolylineLod(QPolygonF&& points, double unitX, double unitY);
+    ~PolylineLod();
+
+    // coarsest level which differs from original by less than half of pixel
+    const QPolygonF& level(double pixelsPerUnitX, double pixelsPerUnitY) const;
+    const QPolygonF& full() const;
+    std::size_t levelsCount() const;
+    bool isEmpty() const;
+
+private:
+    // tolerance relative to units and points
+    std::vector<std::pair<double, QPolygonF>> _levels;
+    double _unitX;
+    double _unitY;
+};
+
+// Plot geometry of single profile in profile coordinates, built once and reused by every render
+class MCC_VIS_DECLSPEC ProfileGeometry : public RefCountable {
+public:
+    explicit ProfileGeometry(const Profile* profile);
+    ~ProfileGeometry();
+
+    const Profile* profile() const;
+    // terrain line, plot fill is closed down to ymin() when drawn
+    const PolylineLod& earth() const;
+    const PolylineLod& target() const;
+    const PolylineLod& viewRegion() const;
+    const Ticks& yticks() const;
+    double ymin() const;
+    double ymax() const;
+    double deltay() const;
+
+private:
+    Rc<const Profile> _profile;
+    PolylineLod _earth;
+    PolylineLod _target;
+    PolylineLod _viewRegion;
+    Ticks _yticks;
+    double _ymin;
+    double _ymax;
+};
+
+// Plot geometry of region, shared by RegionViewer, ProfileViewer and ReportGen.
+// Zones and closing angles are built in constructor, profiles are built on first request.
+// Geometry is immutable after building, so it can be drawn from several threads
+class MCC_VIS_DECLSPEC RegionGeometry : public RefCountable {
+public:
+    explicit RegionGeometry(const Region* region);
+    ~RegionGeometry();
+
+    const Region* region() const;
+    // polygons in cartesian coordinates, y axis points to north
+    const std::vector<PolylineLod>& viewZones() const;
+    const std::vector<PolylineLod>& hitZones() const;
+    // closing angles in cartesian coordinates, angle is radius offset by angleTicks().min
+    const PolylineLod& angles() const;
+    const Ticks& angleTicks() const;
+    double maxDistance() const;
+    Rc<const ProfileGeometry> profile(std::size_t index) const;
+
+private:
+    Rc<const Region> _region;
+    std::vector<PolylineLod> _viewZones;
+    std::vector<PolylineLod> _hitZones;
+    PolylineLod _angles;
+    Ticks _angleTicks;
+    double _maxDistance;
+    mutable std::mutex _profilesMutex;
+    mutable std::vector<Rc<const ProfileGeometry>> _profiles;
+};
+}
@@ -46,6 +46,21 @@ static bmcl::Option<Point> intersect(const Point& a1, const Point& a2, const Poi
     return Point(std::fma(t, bx, a1.x()), std::fma(t, by, a1.y()));
 }
 
+// cheap check before intersect(), segment b lies strictly on one side of line a with margin for rounding
+static inline bool isOnOneSide(const Point& a1, const Point& a2, const Point& b1, const Point& b2)
+{
+    double bx = a2.x() - a1.x();
+    double by = a2.y() - a1.y();
+    double c1x = b1.x() - a1.x();
+    double c1y = b1.y() - a1.y();
+    double c2x = b2.x() - a1.x();
+    double c2y = b2.y() - a1.y();
+    double s1 = bx * c1y - by * c1x;
+    double s2 = bx * c2y - by * c2x;
+    double eps = 1e-9 * (std::abs(bx) + std::abs(by)) * (std::abs(c1x) + std::abs(c1y) + std::abs(c2x) + std::abs(c2y));
+    return (s1 > eps && s2 > eps) || (s1 < -eps && s2 < -eps);
+}
+
 constexpr const double pi = bmcl::pi<double>();
 
 static inline Point findEdgeIntersection(const ViewParams& params, const Point& start, double k)
@@ -57,9 +72,14 @@ static inline Point findEdgeIntersection(const ViewParams& params, const Point&
     return Point(x, y);
 }
 
-bool Profile::findProfIntersection(std::vector<Data>::const_iterator it, Point* end)
+bool Profile::findProfIntersection(std::size_t i, Point* end)
 {
-    bmcl::Option<Point> profIntersection = intersect(_rays.start, *end, it->profile, (it + 1)->profile);
+    Point p1 = profileAt(i);
+    Point p2 = profileAt(i + 1);
+    if (isOnOneSide(_rays.start, *end, p1, p2)) {
+        return true;
+    }
+    bmcl::Option<Point> profIntersection = intersect(_rays.start, *end, p1, p2);
     if (profIntersection.isSome()) {
         *end = profIntersection.unwrap();
         return false;
@@ -67,21 +87,27 @@ bool Profile::findProfIntersection(std::vector<Data>::const_iterator it, Point*
     return true;
 }
 
-bool Profile::findProfAndAddTargetIntersection(std::vector<Data>::const_iterator it, Point* end, bool* hasTargetInt)
+bool Profile::findProfAndAddTargetIntersection(std::size_t i, Point* end, bool* hasTargetInt)
 {
-    bmcl::Option<Point> targetIntersection = intersect(_rays.start, *end, it->target, (it + 1)->target);
+    Point t1 = targetAt(i);
+    Point t2 = targetAt(i + 1);
+    if (isOnOneSide(_rays.start, *end, t1, t2)) {
+        *hasTargetInt = false;
+        return findProfIntersection(i, end);
+    }
+    bmcl::Option<Point> targetIntersection = intersect(_rays.start, *end, t1, t2);
     if (targetIntersection.isSome()) {
         _intersections.push_back(targetIntersection.unwrap());
     }
     *hasTargetInt = targetIntersection.isSome();
-    return findProfIntersection(it, end);
+    return findProfIntersection(i, end);
 }
 
 void Profile::findRays(const ViewParams& params, double radarY)
 {
     double maxk = std::tan(params.maxAngle * pi / 180.0);
     double mink = std::tan(params.minAngle * pi / 180.0);
-    _rays.start.setX(_data.at(0).profile.x());
+    _rays.start.setX(_samples.x.at(0));
     _rays.start.setY(radarY);
     _rays.minEnd = findEdgeIntersection(params, _rays.start, mink);
     _rays.maxEnd = findEdgeIntersection(params, _rays.start, maxk);
@@ -91,8 +117,9 @@ void Profile::findRays(const ViewParams& params, double radarY)
    //TODO: усечение по мин длине луча
 
     double current = params.minAngle;
-    auto it = _data.begin();
-    auto iend = _data.end() - 1;
+    const double* kview = _samples.kview.data();
+    std::size_t it = 0;
+    std::size_t iend = _samples.size() - 1;
     bool hasTargetInt;
 //     while (it->profile.x() > _params.minBeamDistance) {
 //         if (it == kend) {
@@ -121,26 +148,26 @@ void Profile::findRays(const ViewParams& params, double radarY)
                 break;
             }
         }
-        if (it == _data.begin()) {
+        if (it == 0) {
             it++;
         }
         for (; it < iend; it++) {
-            if (it->profile.x() > _params.maxBeamDistance) {
+            if (_samples.x[it] > _params.maxBeamDistance) {
                 break;
             }
-            _viewRegion.push_back(it->profile);
-            double kp = (it - 1)->kview;
-            double k = it->kview;
-            double kn = (it + 1)->kview;
+            _viewRegion.push_back(profileAt(it));
+            double kp = kview[it - 1];
+            double k = kview[it];
+            double kn = kview[it + 1];
             if ((k > kp) && (k > kn) && (k < maxk) && (k > mink) && (k > current)) {
                 current = k;
                 double correctedK;
-                Point peak = it->profile;
+                Point peak = profileAt(it);
                 if (_params.useFresnelRegion) {
-                    double x = it->profile.x();
+                    double x = _samples.x[it];
                     double dy = frenelR(_params.frequency, x, _params.maxBeamDistance - x);
                     peak.ry() += dy;
-                    correctedK = (it->profile.y() - radarY + dy) / x;
+                    correctedK = (_samples.y[it] - radarY + dy) / x;
                     _viewRegion.push_back(peak);
                 } else {
                     correctedK = k;
@@ -176,8 +203,8 @@ void Profile::findRays(const ViewParams& params, double radarY)
         auto peakIt = it;
         double current = _params.minAngle;
         for (; it < iend; it++) {
-            double k = it->kview;
-            if (it->profile.x() > _params.maxBeamDistance) {
+            double k = kview[it];
+            if (_samples.x[it] > _params.maxBeamDistance) {
                 break;
             }
             if ((k < maxk) && (k > mink) && (k > current)) {
@@ -186,19 +213,19 @@ void Profile::findRays(const ViewParams& params, double radarY)
             }
         }
         if (_params.useFresnelRegion) {
-            double x = peakIt->profile.x();
+            double x = _samples.x[peakIt];
             double dy;
             if (x >= _params.maxBeamDistance) {
                 dy = 0;
             } else {
                 dy = frenelR(_params.frequency, x, _params.maxBeamDistance - x);
             }
-            current = (peakIt->profile.y() - radarY + dy) / x;
+            current = (_samples.y[peakIt] - radarY + dy) / x;
         }
         Point end = findEdgeIntersection(params, _rays.start, current);
-        const Point& peak = (peakIt + 1)->profile;
+        Point peak = profileAt(peakIt + 1);
         if (current <= _params.minAngle) {
-            for (it = _data.begin(); it < iend; it++) {
+            for (it = 0; it < iend; it++) {
                 if (!findProfAndAddTargetIntersection(it, &_rays.minEnd, &hasTargetInt)) {
                     _rays.minIsCut = true;
                 }
@@ -208,7 +235,7 @@ void Profile::findRays(const ViewParams& params, double radarY)
                 }
             }
         } else if (current < _params.maxAngle) {
-            for (it = _data.begin(); it < iend; it++) {
+            for (it = 0; it < iend; it++) {
                 findProfIntersection(it, &_rays.minEnd);
                 findProfAndAddTargetIntersection(it, &end, &hasTargetInt);
                 if (!findProfAndAddTargetIntersection(it, &_rays.maxEnd, &hasTargetInt)) {
@@ -227,12 +254,12 @@ void Profile::findRays(const ViewParams& params, double radarY)
 alignIntersections:
     if (_params.canViewGround) {
         if (_rays.ends.empty()) {
-            Point prof = _data.back().profile;
+            Point prof = profileAt(iend);
             _rays.ends.emplace_back(prof, prof, false);
         } else {
             Point end = _rays.ends.back().peak;
             Point start = _rays.start;
-            Point prof = _data.back().profile;
+            Point prof = profileAt(iend);
             double klast = (end.y() - start.y()) / (end.x() - start.x());
             double k = (prof.y() - start.y()) / (prof.x() - start.x());
             if (k > klast) {
@@ -249,7 +276,7 @@ alignIntersections:
 
     if (_intersections.size() % 2) {
         //TODO: усечение по макс длине луча
-        _intersections.push_back(_data.back().target);
+        _intersections.push_back(targetAt(iend));
     }
     //HACK
     std::sort(_intersections.begin(), _intersections.end(), [](const Point& p1, const Point& p2) {
@@ -265,9 +292,9 @@ alignIntersections:
                 intsToRemoveFront += 2;
             } else {
                 _intersections[i].rx() = mind;
-                for (std::size_t j = 0; j < (_data.size() - 1); j++) {
-                    const Point& p1 = _data[j].target;
-                    const Point& p2 = _data[j + 1].target;
+                for (std::size_t j = 0; j < iend; j++) {
+                    Point p1 = targetAt(j);
+                    Point p2 = targetAt(j + 1);
                     if (p1.x() <= mind && p2.x() >= mind) {
                         double k = (p2.y() - p1.y()) / (p2.x() - p1.x());
                         double b = p2.y() - k * p2.x();
@@ -288,9 +315,9 @@ alignIntersections:
                 intsToRemoveBack += 2;
             } else {
                 _intersections[i + 1].rx() = maxd;
-                for (std::size_t j = (_data.size() - 1); j >= 2; j--) {
-                    const Point& p1 = _data[j].target;
-                    const Point& p2 = _data[j + 1].target;
+                for (std::size_t j = iend - 1; iend > 2 && j >= 2; j--) {
+                    Point p1 = targetAt(j);
+                    Point p2 = targetAt(j + 1);
                     if (p1.x() <= maxd && p2.x() >= maxd) {
                         double k = (p2.y() - p1.y()) / (p2.x() - p1.x());
                         double b = p2.y() - k * p2.x();
@@ -404,7 +431,7 @@ private:
 template <bool isTowards>
 void Profile::findHits()
 {
-    if (_data.size() < 2) {
+    if (_samples.size() < 2) {
         return;
     }
     if (_visionIntervals.empty()) {
@@ -413,17 +440,29 @@ void Profile::findHits()
 
     Comparator<isTowards> comp;
 
-    auto begin = ItSelector<Data, isTowards>::begin(_data);
-    auto end = ItSelector<Data, isTowards>::end(_data);
-    auto it = end - 1;
+    // position in walk direction, samples are walked from the far end when target is directed towards radar
+    const std::ptrdiff_t size = _samples.size();
+    const double* xs = _samples.x.data();
+    const double* ys = _samples.targetY.data();
+    auto index = [size](std::ptrdiff_t pos) {
+        return isTowards ? pos : size - 1 - pos;
+    };
+    auto xAt = [xs, &index](std::ptrdiff_t pos) {
+        return xs[index(pos)];
+    };
+    auto targetAt = [xs, ys, &index](std::ptrdiff_t pos) {
+        std::ptrdiff_t i = index(pos);
+        return Point(xs[i], ys[i]);
+    };
+
+    const std::ptrdiff_t begin = 0;
+    const std::ptrdiff_t end = size;
+    std::ptrdiff_t it = end - 1;
 
     auto intervalBegin = ItSelector<Interval, isTowards>::begin(_visionIntervals);
     auto intervalEnd = ItSelector<Interval, isTowards>::end(_visionIntervals);
     auto intervalIt = intervalEnd - 1;
 
-    auto rocketBegin = _data.begin();
-    //auto rocketEnd = _data.end();
-    auto rocketIt = rocketBegin;
     Point rocket;
 
     double minHit;
@@ -446,36 +485,39 @@ void Profile::findHits()
     bool hasEdgeHit = false;
     QPointF edgeHit;
     QPointF edgeDetection;
-    auto edgeDetectionIt = it;
+    std::ptrdiff_t edgeDetectionIt = it;
     if (true) {
-        while (comp.more(it->profile.x(), maxHit)) {
+        while (comp.more(xAt(it), maxHit)) {
             it--;
             if (it == begin) {
                 goto findAllIntervals;
             }
         }
-        const QPointF& p1 = it->target;
-        const QPointF& p2 = (it + 1)->target;
+        if (it + 1 >= end) {
+            goto findAllIntervals;
+        }
+        const QPointF p1 = targetAt(it);
+        const QPointF p2 = targetAt(it + 1);
         double k = (p2.y() - p1.y()) / (p2.x() - p1.x());
         double b = p2.y() - k * p2.x();
         edgeHit.rx() = maxHit;
         edgeHit.ry() = k * maxHit + b;
 
-        rocket.rx() = _data.begin()->target.x();
+        rocket.rx() = xs[0];
         rocket.ry() = _radarY;
 
         while (true) {
-            const Point& current = it->target;
+            const Point current = targetAt(it);
             it++;
             if (it >= end) {
                 goto findAllIntervals;
             }
-            const Point& next = it->target;
+            const Point next = targetAt(it);
             calcNextRocketInterval(current, next, &rocket);
             if (rocket.x() >= maxHit) {
                 hasEdgeHit = true;
                 edgeDetectionIt = it;
-                edgeDetection = it->target;
+                edgeDetection = targetAt(it);
                 break;
             }
         }
@@ -498,19 +540,19 @@ findAllIntervals:
         double accumTime = 0;
         Point detection;
 
-        while (comp.more(it->profile.x(), currentIntervalEnd)) {
+        while (comp.more(xAt(it), currentIntervalEnd)) {
             it--;
             if (it == begin) {
                 return;
             }
         }
-        if (comp.less(it->profile.x(), minHit)) {
+        if (comp.less(xAt(it), minHit)) {
             return;
         }
         while (true) {
-            double currentX = it->profile.x();
+            double currentX = xAt(it);
             it--;
-            double nextX = it->profile.x();
+            double nextX = xAt(it);
             if (comp.less(nextX, currentIntervalStart)) {
                 goto selectNextInterval;
             }
@@ -525,7 +567,7 @@ findAllIntervals:
             }
             accumTime += deltaX / _params.targetSpeed;
             if (accumTime >= (_params.reactionTime + _params.externReactionTime)) {
-                detection = it->target;
+                detection = targetAt(it);
                 break;
             }
             if (it == begin) {
@@ -533,16 +575,16 @@ findAllIntervals:
             }
         }
 
-        rocketIt = rocketBegin;
-        rocket.rx() = _data.begin()->target.x();
+        rocket.rx() = xs[0];
         rocket.ry() = _radarY;
-        //PointVector rocketPath;
-        //rocketPath.emplace_back(rocketIt->profile.x(), _params.radarHeight);
 
         while (true) {
-            const Point& current = it->target;
+            if (it == begin) {
+                return;
+            }
+            const Point current = targetAt(it);
             it--;
-            const Point& next = it->target;
+            const Point next = targetAt(it);
             if (comp.less(next.x(), currentIntervalStart)) {
                 goto selectNextInterval;
             }
@@ -575,13 +617,13 @@ findAllIntervals:
                     double timeLeft = _params.reactionTime + _params.externReactionTime;
 
                     while (true) {
-                        const Point& current = edgeDetectionIt->target;
+                        const Point current = targetAt(edgeDetectionIt);
                         edgeDetectionIt++;
-                        if (comp.moreEq(edgeDetectionIt->target.x(), currentIntervalEnd)) {
+                        if (edgeDetectionIt >= end || comp.moreEq(xAt(edgeDetectionIt), currentIntervalEnd)) {
                             hasEdgeHit = false;
                             break;
                         }
-                        const Point& next = edgeDetectionIt->target;
+                        const Point next = targetAt(edgeDetectionIt);
                         double dx = current.x() - next.x();
                         double dy = current.y() - next.y();
                         double targetDistance = std::hypot(dx, dy);
@@ -641,43 +683,107 @@ void Profile::calcNextRocketInterval(const Point& current, const Point& next, Po
     rocket->ry() += rocketYDistance;
 }
 
-template <bool isRelativeHeight, bool hasRefraction>
+// sin and cos series are exact to double precision for angles below this limit, used for slices up to ~600 km
+constexpr const double maxSeriesAngle = 0.1;
+
+template <bool hasRefraction>
 void Profile::fillData(const PointVector& slice)
 {
-    for(std::size_t i = 0; i < slice.size(); i++) {
-        double l = slice[i].x();
-        double h = slice[i].y();
-        double dy;
-
-        if (hasRefraction) {
-            dy = -l * l / 1000 / 1000 / 16.97;
-            h += dy;
-        } else {
-            double a = l / earthRadius;
-            l = std::sin(a) * (earthRadius + h);
-            double h2 = -earthRadius + std::cos(a) * (earthRadius + h);
-            dy = h2 - h;
-            h = h2;
+    const std::size_t size = slice.size();
+    double* xs = _samples.x.data();
+    double* ys = _samples.y.data();
+    double* dys = _samples.dy.data();
+    for (std::size_t i = 0; i < size; i++) {
+        xs[i] = slice[i].x();
+        ys[i] = slice[i].y();
+    }
+
+    if (hasRefraction) {
+#pragma omp simd
+        for (std::size_t i = 0; i < size; i++) {
+            double l = xs[i];
+            double dy = -l * l / 1000 / 1000 / 16.97;
+            ys[i] += dy;
+            dys[i] = dy;
         }
+        return;
+    }
 
-        Data& row = _data[i];
-        row.profile.setX(l);
-        row.profile.setY(h);
-        row.dy = dy;
-        if (isRelativeHeight) {
-            row.target.setX(row.profile.x());
-            row.target.setY(row.profile.y() + _params.objectHeight);
-        } else {
-            row.target.setX(row.profile.x());
-            row.target.setY(std::max(_params.objectHeight + dy, row.profile.y() + 1));
+    double maxAngle = 0;
+    for (std::size_t i = 0; i < size; i++) {
+        maxAngle = std::max(maxAngle, std::abs(xs[i]) / earthRadius);
+    }
+    if (maxAngle > maxSeriesAngle) {
+        for (std::size_t i = 0; i < size; i++) {
+            double h = ys[i];
+            double a = xs[i] / earthRadius;
+            double h2 = -earthRadius + std::cos(a) * (earthRadius + h);
+            xs[i] = std::sin(a) * (earthRadius + h);
+            dys[i] = h2 - h;
+            ys[i] = h2;
         }
-        if (_hmin > row.profile.y()) {
-            _hmin = row.profile.y();
+        return;
+    }
+
+#pragma omp simd
+    for (std::size_t i = 0; i < size; i++) {
+        double h = ys[i];
+        double a = xs[i] / earthRadius;
+        double a2 = a * a;
+        double sina = a * (1 - a2 / 6 * (1 - a2 / 20 * (1 - a2 / 42 * (1 - a2 / 72))));
+        double cosa = 1 - a2 / 2 * (1 - a2 / 12 * (1 - a2 / 30 * (1 - a2 / 56 * (1 - a2 / 90))));
+        double h2 = -earthRadius + cosa * (earthRadius + h);
+        xs[i] = sina * (earthRadius + h);
+        dys[i] = h2 - h;
+        ys[i] = h2;
+    }
+}
+
+void Profile::fillTargets()
+{
+    const std::size_t size = _samples.size();
+    const double* ys = _samples.y.data();
+    const double* dys = _samples.dy.data();
+    double* targets = _samples.targetY.data();
+    double objectHeight = _params.objectHeight;
+    if (_params.isTargetRelativeHeight) {
+#pragma omp simd
+        for (std::size_t i = 0; i < size; i++) {
+            targets[i] = ys[i] + objectHeight;
         }
-        if (_hmax < row.target.y()) {
-            _hmax = row.target.y();
+    } else {
+#pragma omp simd
+        for (std::size_t i = 0; i < size; i++) {
+            targets[i] = std::max(objectHeight + dys[i], ys[i] + 1);
         }
     }
+
+    double hmin = _hmin;
+    double hmax = _hmax;
+#pragma omp simd reduction(min:hmin) reduction(max:hmax)
+    for (std::size_t i = 0; i < size; i++) {
+        hmin = std::min(hmin, ys[i]);
+        hmax = std::max(hmax, targets[i]);
+    }
+    _hmin = hmin;
+    _hmax = hmax;
+}
+
+void Profile::fillViewSlopes(double radarY)
+{
+    static_assert(std::numeric_limits<double>::is_iec559, "iec559 double required");
+    const std::size_t size = _samples.size();
+    const double* xs = _samples.x.data();
+    const double* ys = _samples.y.data();
+    double* kview = _samples.kview.data();
+    // tan(atan(k) + delta) expanded to avoid trigonometry in loop
+    double t = std::tan(_params.deltaAngle * pi / 180.0);
+    kview[0] = -std::numeric_limits<double>::infinity();
+#pragma omp simd
+    for (std::size_t i = 1; i < size; i++) {
+        double k = (ys[i] - radarY) / xs[i];
+        kview[i] = (k + t) / (1 - k * t);
+    }
 }
 
 Profile::Profile(double direction, const PointVector& slice, const ViewParams& params)
@@ -689,7 +795,6 @@ Profile::Profile(double direction, const PointVector& slice, const ViewParams& p
     _params = params;
     _start = slice[0];
     assert(params.minAngle <= params.maxAngle);
-    _data.resize(slice.size());
     double radarY;
     if (params.isRelativeHeight) {
         radarY = _start.y() + params.radarHeight;
@@ -699,34 +804,18 @@ Profile::Profile(double direction, const PointVector& slice, const ViewParams& p
     _radarY = radarY;
     _hmin = radarY;
     _hmax = _hmin;
-    // не оптимально
-    if (params.isTargetRelativeHeight) {
-        if (params.hasRefraction) {
-            fillData<true, true>(slice);
-        } else {
-            fillData<true, false>(slice);
-        }
+    _samples.resize(slice.size());
+    if (params.hasRefraction) {
+        fillData<true>(slice);
     } else {
-        if (params.hasRefraction) {
-            fillData<false, true>(slice);
-        } else {
-            fillData<false, false>(slice);
-        }
-    }
-
-    //unused Data& first = _data[0];
-    double deltaAngleRadians = params.deltaAngle * pi / 180.0;
-    static_assert(std::numeric_limits<double>::is_iec559, "iec559 double required");
-    _data.front().kview = -std::numeric_limits<double>::infinity();
-    for(std::size_t i = 1; i < slice.size(); i++) {
-        Data& d = _data[i];
-        double k = (d.profile.y() - radarY) / d.profile.x();
-        d.kview = std::tan(std::atan(k) + deltaAngleRadians);
+        fillData<false>(slice);
     }
+    fillTargets();
+    fillViewSlopes(radarY);
 
-    _rect.setLeft(_data.front().profile.x());
+    _rect.setLeft(_samples.x.front());
     _rect.setTop(_hmax);
-    _rect.setRight(_data.back().profile.x());
+    _rect.setRight(_samples.x.back());
     _rect.setBottom(_hmin);
 
     double dy = (_rect.top() - _rect.bottom()) * 0.02;
@@ -775,9 +864,34 @@ Profile::Profile(double direction, const PointVector& slice, const ViewParams& p
     }
 }
 
-const std::vector<Profile::Data>& Profile::data() const
+const ProfileSamples& Profile::samples() const
+{
+    return _samples;
+}
+
+std::size_t Profile::size() const
+{
+    return _samples.size();
+}
+
+Point Profile::profileAt(std::size_t i) const
 {
-    return _data;
+    return Point(_samples.x[i], _samples.y[i]);
+}
+
+Point Profile::targetAt(std::size_t i) const
+{
+    return Point(_samples.x[i], _samples.targetY[i]);
+}
+
+Profile::Data Profile::sample(std::size_t i) const
+{
+    Data d;
+    d.profile = profileAt(i);
+    d.target = targetAt(i);
+    d.kview = _samples.kview[i];
+    d.dy = _samples.dy[i];
+    return d;
 }
 
 const Rays& Profile::rays() const
@@ -798,18 +912,13 @@ bmcl::Option<std::pair<double, double>> Profile::verticalVisionIntervalAt(double
     };
 
     auto yAtProf = [this](double x) {
-        std::size_t i = 1;
-        assert(_data.size() > 1);
-        while (i < _data.size() && _data[i].profile.x() < x) {
-            i++;
-        }
-        //return yAt(_data[i - 1].profile, _data[i].profile, x);
-        //BMCL_DEBUG() << _data.size() << " " << i;
-        //assert(i < _data.size());
-        if (i >= _data.size()) {
-            i = _data.size() - 1;
+        assert(_samples.size() > 1);
+        // distances grow along ray
+        std::size_t i = std::lower_bound(_samples.x.begin() + 1, _samples.x.end(), x) - _samples.x.begin();
+        if (i >= _samples.size()) {
+            i = _samples.size() - 1;
         }
-        return _data[i - 1].profile.y();
+        return _samples.y[i - 1];
     };
 
     auto dAtCircle = [](const Point& center, double r, double x) {
@@ -4,6 +4,7 @@
 #include "mcc/vis/Rc.h"
 #include "mcc/vis/RadarParams.h"
 #include "mcc/vis/Point.h"
+#include "mcc/vis/AlignedAllocator.h"
 
 #include <bmcl/Option.h>
 
@@ -69,6 +70,29 @@ struct Hit {
     double endX;
 };
 
+// Profile samples as separate arrays, target x is always equal to profile x
+struct ProfileSamples {
+    std::size_t size() const
+    {
+        return x.size();
+    }
+
+    void resize(std::size_t size)
+    {
+        x.resize(size);
+        y.resize(size);
+        targetY.resize(size);
+        dy.resize(size);
+        kview.resize(size);
+    }
+
+    AlignedVector<double> x;       // distance from radar with earth correction
+    AlignedVector<double> y;       // terrain height with earth correction
+    AlignedVector<double> targetY; // target height
+    AlignedVector<double> dy;      // earth curvature or refraction correction
+    AlignedVector<double> kview;   // slope of line of sight from radar to terrain
+};
+
 class MCC_VIS_DECLSPEC Profile : public RefCountable {
 public:
     struct Data {
@@ -82,7 +106,12 @@ public:
     ~Profile();
 
     bmcl::Option<std::pair<double, double>> verticalVisionIntervalAt(double x) const;
-    const std::vector<Data>& data() const;
+    const ProfileSamples& samples() const;
+    std::size_t size() const;
+    // single sample in old row form, for viewers and reports
+    Data sample(std::size_t i) const;
+    Point profileAt(std::size_t i) const;
+    Point targetAt(std::size_t i) const;
     const Rays& rays() const;
     const IntervalVector& horizontalVisionIntervals() const;
     const IntervalVector& horizontalHitIntervals() const;
@@ -162,15 +191,17 @@ private:
     template <bool isTowards>
     void findHits();
 
-    bool findProfIntersection(std::vector<Data>::const_iterator it, Point* end);
-    bool findProfAndAddTargetIntersection(std::vector<Data>::const_iterator it, Point* end, bool* hasTargetInt);
+    bool findProfIntersection(std::size_t i, Point* end);
+    bool findProfAndAddTargetIntersection(std::size_t i, Point* end, bool* hasTargetInt);
 
-    template <bool isRelativeHeight, bool hasRefraction>
+    template <bool hasRefraction>
     void fillData(const PointVector& slice);
+    void fillTargets();
+    void fillViewSlopes(double radarY);
 
     void calcNextRocketInterval(const Point& p1, const Point& p2, Point* rocket);
 
-    std::vector<Data> _data;
+    ProfileSamples _samples;
     Rays _rays;
     Rect _rect;
     Rect _rayRect;
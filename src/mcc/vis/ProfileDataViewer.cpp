@@ -26,7 +26,7 @@ public:
         if (_prof.isNull()) {
             return 0;
         }
-        return _prof->data().size();
+        return _prof->size();
     }
 
     int columnCount(const QModelIndex & parent) const override
@@ -67,11 +67,11 @@ public:
         }
 
         int i = index.row();
-        if (i >= _prof->data().size()) {
+        if (i >= _prof->size()) {
             return QVariant();
         }
 
-        const Profile::Data& d = _prof->data()[i];
+        const Profile::Data d = _prof->sample(i);
         switch (index.column()) {
         case 0:
             return d.profile.x() / 1000;
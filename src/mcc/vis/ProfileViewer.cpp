@@ -6,6 +6,7 @@
 #include <bmcl/Math.h>
 
 #include <QPainter>
+#include <QPainterPath>
 #include <QFontDatabase>
 #include <QFontMetrics>
 #include <QMouseEvent>
@@ -118,14 +119,32 @@ void ProfileViewer::setProfile(bmcl::OptionPtr<const Profile> profile)
     if (profile.isNone()) {
         return;
     }
-    _data.emplace_back(profile.unwrap());
+    _data.emplace_back(new ProfileGeometry(profile.unwrap()));
     onProfileReset();
 }
 
 void ProfileViewer::setProfiles(bmcl::ArrayView<Rc<const Profile>> profiles)
 {
     _data.clear();
-    _data.insert(_data.begin(), profiles.begin(), profiles.end());
+    for (const Rc<const Profile>& profile : profiles) {
+        _data.emplace_back(new ProfileGeometry(profile.get()));
+    }
+    onProfileReset();
+}
+
+void ProfileViewer::setGeometry(bmcl::OptionPtr<const ProfileGeometry> geometry)
+{
+    _data.clear();
+    if (geometry.isNone()) {
+        return;
+    }
+    _data.emplace_back(geometry.unwrap());
+    onProfileReset();
+}
+
+void ProfileViewer::setGeometries(bmcl::ArrayView<Rc<const ProfileGeometry>> geometries)
+{
+    _data.assign(geometries.begin(), geometries.end());
     onProfileReset();
 }
 
@@ -136,14 +155,14 @@ void ProfileViewer::onProfileReset()
         return;
     }
 
-    const Profile* first = _data[0].profile.get();
+    const Profile* first = _data[0]->profile();
 
     _xmin = first->rayRect().left();
     _xmax = first->rayRect().right();
 
     for (auto it = (_data.begin() + 1); it < _data.end(); it++) {
-        _xmin = std::min(_xmin, it->profile->rayRect().left());
-        _xmax = std::max(_xmax, it->profile->rayRect().right());
+        _xmin = std::min(_xmin, (*it)->profile()->rayRect().left());
+        _xmax = std::max(_xmax, (*it)->profile()->rayRect().right());
     }
 
     _xticks = Ticks::fromMinMax(_xmin, _xmax);
@@ -152,41 +171,8 @@ void ProfileViewer::onProfileReset()
     _deltax = _xmax - _xmin;
 
     _totalDeltay = 0;
-
-    for (Data& d : _data) {
-        d.ymin = d.profile->rayRect().bottom();
-        d.ymax = d.profile->rayRect().top();
-        d.yticks = Ticks::fromMinMax(d.ymin, d.ymax);
-        d.ymin = std::min(d.ymin, d.yticks.min);
-        d.ymax = std::max(d.ymax, d.yticks.max);
-        d.deltay = d.ymax - d.ymin;
-        _totalDeltay += d.deltay;
-
-        auto begin = d.profile->data().begin();
-        auto end = d.profile->data().end();
-        d.earthFillPath = QPainterPath();
-        d.earthFillPath.moveTo(begin->profile.x(), begin->profile.y());
-        for (auto it = begin + 1; it < end; it++) {
-            d.earthFillPath.lineTo(it->profile);
-        }
-        d.earthStrokePath = d.earthFillPath;
-        d.earthFillPath.lineTo((end - 1)->profile.x(), d.ymin);
-        d.earthFillPath.lineTo(begin->profile.x(), d.ymin);
-        d.earthFillPath.lineTo(begin->profile.x(), begin->profile.y());
-
-        d.targetStrokePath = QPainterPath();
-        d.targetStrokePath.moveTo(begin->target.x(), begin->target.y());
-        for (auto it = begin + 1; it < end; it++) {
-            d.targetStrokePath.lineTo(it->target);
-        }
-
-        d.viewRegionPath = QPainterPath();
-        if (!d.profile->viewRegion().empty()) {
-            d.viewRegionPath.moveTo(d.profile->viewRegion()[0]);
-            for (const Point& p : d.profile->viewRegion()) {
-                d.viewRegionPath.lineTo(p);
-            }
-        }
+    for (const Rc<const ProfileGeometry>& d : _data) {
+        _totalDeltay += d->deltay();
     }
 
     update();
@@ -311,7 +297,7 @@ void ProfileViewer::renderPlot(QPaintDevice* dev, const RenderConfig& cfg)
     bool isFirst = true;
 
     for (auto it = _data.rbegin(); it < _data.rend(); it++) {
-        const Data& d = *it;
+        const ProfileGeometry& d = **it;
         p.setClipping(false);
         p.setBrush(Qt::white);
         p.setPen(Qt::black);
@@ -319,13 +305,13 @@ void ProfileViewer::renderPlot(QPaintDevice* dev, const RenderConfig& cfg)
         p.fillRect(borderRect, Qt::white);
         p.drawRect(borderRect);
 
-        double yscale = ((dev->height() - 2 * plotYmargin) / d.deltay) / _data.size();
+        double yscale = ((dev->height() - 2 * plotYmargin) / d.deltay()) / _data.size();
 
         QTransform plotTransform;
         plotTransform.translate(0, dev->height());
         plotTransform.translate(plotXmargin, -(plotYmargin + currentYOffset));
         plotTransform.scale(1 * xscale, -1 * yscale);
-        plotTransform.translate(-_xmin, -d.ymin);
+        plotTransform.translate(-_xmin, -d.ymin());
 
         double maxTextHeight = 0;
         if (isFirst) {
@@ -334,7 +320,7 @@ void ProfileViewer::renderPlot(QPaintDevice* dev, const RenderConfig& cfg)
                 QString text = QString::number(i);
                 QRect textRect = metrics.tightBoundingRect(text);
                 maxTextHeight = std::max<double>(maxTextHeight, textRect.width());
-                QPointF pos = plotTransform.map(QPointF(i, d.ymin));
+                QPointF pos = plotTransform.map(QPointF(i, d.ymin()));
                 p.translate(pos);
                 p.rotate(-90);
                 p.drawText(-textRect.bottomRight() - QPointF(metrics.descent(), -metrics.descent()), text);
@@ -343,7 +329,7 @@ void ProfileViewer::renderPlot(QPaintDevice* dev, const RenderConfig& cfg)
         }
 
         double maxTextWidth = 0;
-        for (double i = d.yticks.min; i <= d.yticks.max; i += d.yticks.step) {
+        for (double i = d.yticks().min; i <= d.yticks().max; i += d.yticks().step) {
             p.save();
             QString text = QString::number(i);
             QRect textRect = metrics.tightBoundingRect(text);
@@ -379,9 +365,9 @@ void ProfileViewer::renderPlot(QPaintDevice* dev, const RenderConfig& cfg)
         }
 
         {
-            QString azText = "Азимут " + QString::number(d.profile->direction()) + "°";
+            QString azText = "Азимут " + QString::number(d.profile()->direction()) + "°";
             QRect azRect = metrics.boundingRect(azText);
-            QPointF azPos = plotTransform.map(QPointF(_xmax, d.ymin + (d.ymax - d.ymin) / 2));
+            QPointF azPos = plotTransform.map(QPointF(_xmax, d.ymin() + (d.ymax() - d.ymin()) / 2));
             azPos.rx() += azRect.height() / 2 + 2 * metrics.descent();
             p.save();
             p.translate(azPos);
@@ -393,16 +379,26 @@ void ProfileViewer::renderPlot(QPaintDevice* dev, const RenderConfig& cfg)
         p.setClipRect(borderRect);
         p.setTransform(plotTransform);
 
+        // cached geometry in resolution of this device
+        const QPolygonF& earth = d.earth().level(xscale, yscale);
+        p.setPen(Qt::NoPen);
         if (cfg.drawViewArea) {
-            p.fillPath(d.viewRegionPath, _viewBlue);
+            p.setBrush(_viewBlue);
+            p.drawPolygon(d.viewRegion().level(xscale, yscale));
         }
-        if (cfg.drawGround) {
-            p.fillPath(d.earthFillPath, _fillBlue);
+        if (cfg.drawGround && !earth.isEmpty()) {
+            QPolygonF earthFill = earth;
+            earthFill << QPointF(earth.back().x(), d.ymin()) << QPointF(earth.front().x(), d.ymin());
+            p.setBrush(_fillBlue);
+            p.drawPolygon(earthFill);
         }
-        p.strokePath(d.earthStrokePath, _earthPen);
-        p.strokePath(d.targetStrokePath, _targetPen);
+        p.setBrush(Qt::NoBrush);
+        p.setPen(_earthPen);
+        p.drawPolyline(earth);
+        p.setPen(_targetPen);
+        p.drawPolyline(d.target().level(xscale, yscale));
 
-        const Rays& rays = d.profile->rays();
+        const Rays& rays = d.profile()->rays();
         p.setPen(_rayInvisibleLimitsPen);
         p.drawLine(rays.start, rays.minEdge);
         p.drawLine(rays.start, rays.maxEdge);
@@ -417,7 +413,7 @@ void ProfileViewer::renderPlot(QPaintDevice* dev, const RenderConfig& cfg)
             }
         }
         if (!rays.ends.empty()) {
-            if (d.profile->params().canViewGround && !rays.ends.back().hasTargetIntersections) {
+            if (d.profile()->params().canViewGround && !rays.ends.back().hasTargetIntersections) {
                 QPen rayPen = _raysPen;
                 QColor c = _raysPen.color();
                 c.setAlpha(85);
@@ -429,10 +425,10 @@ void ProfileViewer::renderPlot(QPaintDevice* dev, const RenderConfig& cfg)
 
         p.setPen(_gridPen);
         for (double i = _xticks.min; i <= _xticks.max; i += _xticks.step) {
-            p.drawLine(i, d.ymin, i, d.ymax);
+            p.drawLine(i, d.ymin(), i, d.ymax());
         }
 
-        for (double i = d.yticks.min; i <= d.yticks.max; i += d.yticks.step) {
+        for (double i = d.yticks().min; i <= d.yticks().max; i += d.yticks().step) {
             p.drawLine(_xmin, i, _xmax, i);
         }
 
@@ -442,23 +438,23 @@ void ProfileViewer::renderPlot(QPaintDevice* dev, const RenderConfig& cfg)
         limitPen.setStyle(Qt::DashLine);
         limitPen.setWidthF(1.5);
         p.setPen(limitPen);
-        p.drawLine(d.profile->params().minBeamDistance, d.ymin, d.profile->params().minBeamDistance, d.ymax);
-        p.drawLine(d.profile->params().maxBeamDistance, d.ymin, d.profile->params().maxBeamDistance, d.ymax);
+        p.drawLine(d.profile()->params().minBeamDistance, d.ymin(), d.profile()->params().minBeamDistance, d.ymax());
+        p.drawLine(d.profile()->params().maxBeamDistance, d.ymin(), d.profile()->params().maxBeamDistance, d.ymax());
         limitPen.setColor(_red);
         p.setPen(limitPen);
-        p.drawLine(d.profile->params().minHitDistance, d.ymin, d.profile->params().minHitDistance, d.ymax);
-        p.drawLine(d.profile->params().maxHitDistance, d.ymin, d.profile->params().maxHitDistance, d.ymax);
+        p.drawLine(d.profile()->params().minHitDistance, d.ymin(), d.profile()->params().minHitDistance, d.ymax());
+        p.drawLine(d.profile()->params().maxHitDistance, d.ymin(), d.profile()->params().maxHitDistance, d.ymax());
 
         p.setTransform(QTransform());
 
-        bool isUp = !d.profile->params().isTargetDirectedTowards;
-        for (const auto& i : d.profile->viewIntersections()) {
+        bool isUp = !d.profile()->params().isTargetDirectedTowards;
+        for (const auto& i : d.profile()->viewIntersections()) {
             QPointF point = plotTransform.map(i);
             drawTriangle(&p, point, 10, isUp);
             isUp = !isUp;
         }
 
-        for (const auto& i : d.profile->hits()) {
+        for (const auto& i : d.profile()->hits()) {
             QPointF point = plotTransform.map(i.detection);
             drawStar(&p, point, 7);
         }
@@ -467,13 +463,13 @@ void ProfileViewer::renderPlot(QPaintDevice* dev, const RenderConfig& cfg)
         xpen.setCosmetic(true);
         xpen.setWidth(2);
         p.setPen(xpen);
-        for (const auto& i : d.profile->hits()) {
+        for (const auto& i : d.profile()->hits()) {
             QPointF point = plotTransform.map(i.hit);
             drawX(&p, point, 4);
         }
         xpen.setColor(Qt::blue);
         p.setPen(xpen);
-        for (const auto& i : d.profile->outOfRangeHits()) {
+        for (const auto& i : d.profile()->outOfRangeHits()) {
             QPointF point = plotTransform.map(i.hit);
             drawX(&p, point, 4);
         }
@@ -506,9 +502,9 @@ void ProfileViewer::mouseMoveEvent(QMouseEvent* event)
     int yPixelOffset = posInside.y() - yPixelsPerPlot * plotIndex;
     int xPixelsPerPlot = width() - 2 * plotXmargin;
     int xPixelOffset = posInside.x();
-    const Data& d = _data[plotIndex];
+    const ProfileGeometry& d = *_data[plotIndex];
     double distance = _xmin + xPixelOffset / double(xPixelsPerPlot) * (_xmax - _xmin);
-    double height = d.ymin + yPixelOffset / double(yPixelsPerPlot) * (d.ymax - d.ymin);
+    double height = d.ymin() + yPixelOffset / double(yPixelsPerPlot) * (d.ymax() - d.ymin());
 
     _positionText = QString("d = %1м, h = %2м").arg(distance).arg(height);
     update();
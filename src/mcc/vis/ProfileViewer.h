@@ -2,13 +2,13 @@
 
 #include "mcc/vis/Config.h"
 #include "mcc/vis/Profile.h"
+#include "mcc/vis/PlotGeometry.h"
 #include "mcc/vis/Ticks.h"
 
 #include <bmcl/Fwd.h>
 
 #include <QWidget>
 #include <QPen>
-#include <QPainterPath>
 
 
 class QCheckBox;
@@ -33,33 +33,14 @@ public:
         bool drawViewArea;
     };
 
-    struct Data {
-        Data(const Profile* prof)
-            : profile(prof)
-        {
-        }
-
-        Data(const Rc<const Profile>& prof)
-            : profile(prof)
-        {
-        }
-
-        Rc<const Profile> profile;
-        QPainterPath earthFillPath;
-        QPainterPath earthStrokePath;
-        QPainterPath targetStrokePath;
-        QPainterPath viewRegionPath;
-        Ticks yticks;
-        double ymin;
-        double ymax;
-        double deltay;
-    };
-
     ProfileViewer(QWidget* parent = nullptr);
     ~ProfileViewer();
 
     void setProfile(bmcl::OptionPtr<const Profile> profile);
     void setProfiles(bmcl::ArrayView<Rc<const Profile>> profiles);
+    // geometry is shared with other viewers and is not rebuilt
+    void setGeometry(bmcl::OptionPtr<const ProfileGeometry> geometry);
+    void setGeometries(bmcl::ArrayView<Rc<const ProfileGeometry>> geometries);
     void renderPlot(QPaintDevice* paintDevice, const RenderConfig& cfg);
     void setTitle(const QString& title);
 
@@ -99,7 +80,7 @@ private:
     QString _title;
     QString _positionText;
 
-    std::vector<Data> _data;
+    std::vector<Rc<const ProfileGeometry>> _data;
 
     double _xmin;
     double _xmax;
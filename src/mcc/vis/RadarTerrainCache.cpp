@@ -0,0 +1,131 @@
+#include "mcc/vis/RadarTerrainCache.h"
+#include "mcc/vis/Radar.h"
+#include "mcc/vis/Profile.h"
+#include "mcc/hm/HmReader.h"
+
+#include <algorithm>
+
+namespace mccvis {
+
+RadarTerrainCache::Ray::Ray()
+    : distance(0)
+    , azimuth(0)
+    , hasTerrain(false)
+{
+}
+
+RadarTerrainCache::RadarTerrainCache(const mcchm::HmReader* reader, const mccgeo::Geod& geod)
+    : _reader(reader)
+    , _geod(geod)
+    , _sampledRays(0)
+{
+}
+
+RadarTerrainCache::~RadarTerrainCache()
+{
+}
+
+void RadarTerrainCache::setReader(const mcchm::HmReader* reader)
+{
+    _reader = reader;
+    clear();
+}
+
+void RadarTerrainCache::remove(const Radar* radar)
+{
+    _entries.erase(radar);
+}
+
+void RadarTerrainCache::clear()
+{
+    _entries.clear();
+}
+
+std::size_t RadarTerrainCache::sampledRays() const
+{
+    return _sampledRays;
+}
+
+RadarTerrainCache::Ray& RadarTerrainCache::ray(Entry* entry, std::map<std::pair<double, double>, Ray>* oldRays, const mccgeo::LatLon& target)
+{
+    auto key = std::make_pair(target.latitude(), target.longitude());
+    auto it = entry->rays.find(key);
+    if (it != entry->rays.end()) {
+        return it->second;
+    }
+    auto old = oldRays->find(key);
+    if (old != oldRays->end()) {
+        return entry->rays.emplace(key, std::move(old->second)).first->second;
+    }
+    Ray& ray = entry->rays[key];
+    double a2;
+    _geod.inverse(entry->position, target, &ray.distance, &ray.azimuth, &a2);
+    _geod.direct(entry->position, ray.azimuth, ray.distance, &ray.end, &a2);
+    return ray;
+}
+
+void RadarTerrainCache::sampleTerrain(const Entry* entry, Ray* ray) const
+{
+    if (entry->useCalcStep) {
+        double step = std::max(90.0, entry->calcStep);
+        ray->terrain = _reader->relativePointProfile(entry->position, ray->end, step);
+    } else {
+        ray->terrain = _reader->relativePointProfileAutostep(entry->position, ray->end);
+    }
+    ray->hasTerrain = true;
+}
+
+std::vector<Point> RadarTerrainCache::visionArea(const Radar* radar, const std::vector<mccgeo::PositionAndDistance>& profile)
+{
+    const ViewParams& params = radar->viewParams();
+    Entry& entry = _entries[radar];
+    // rays not used by current profile are dropped
+    std::map<std::pair<double, double>, Ray> oldRays;
+    if (entry.position == radar->position() && entry.useCalcStep == params.useCalcStep
+        && (!params.useCalcStep || entry.calcStep == params.calcStep)) {
+        oldRays = std::move(entry.rays);
+    }
+    entry.rays.clear();
+    entry.position = radar->position();
+    entry.useCalcStep = params.useCalcStep;
+    entry.calcStep = params.calcStep;
+
+    std::vector<Point> top;
+    top.reserve(profile.size());
+    std::vector<Point> bot;
+    bot.reserve(profile.size());
+
+    std::vector<Point> slice;
+    for (const mccgeo::PositionAndDistance& pAd : profile) {
+        const mccgeo::Position& point = pAd.position();
+        Ray& r = ray(&entry, &oldRays, point.latLon());
+        double d = r.distance;
+        if (d > params.maxBeamDistance || d < params.minBeamDistance) {
+            continue;
+        }
+        double a1norm = r.azimuth;
+        while (a1norm < params.minAzimuth) {
+            a1norm += 360;
+        }
+        if (!(a1norm >= params.minAzimuth && a1norm <= params.maxAzimuth)) {
+            continue;
+        }
+        if (!r.hasTerrain) {
+            sampleTerrain(&entry, &r);
+            _sampledRays++;
+        }
+
+        slice.assign(r.terrain.begin(), r.terrain.end());
+        slice.push_back(Point(d, point.altitude()));
+        Profile vI(a1norm, slice, params);
+        bmcl::Option<std::pair<double, double>> interval = vI.verticalVisionIntervalAt(d);
+
+        if (interval.isSome()) {
+            bot.emplace_back(pAd.distance() / 1000, interval->first);
+            top.emplace_back(pAd.distance() / 1000, interval->second);
+        }
+    }
+    bot.insert(bot.end(), top.rbegin(), top.rend());
+    return bot;
+}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "mcc/vis/Config.h"
+#include "mcc/vis/Point.h"
+#include "mcc/vis/Rc.h"
+#include "mcc/geo/LatLon.h"
+#include "mcc/geo/Geod.h"
+#include "mcc/geo/Position.h"
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mcchm { class HmReader; }
+
+namespace mccvis {
+
+class Radar;
+
+// Terrain profiles sampled along rays from radars to route points.
+// Terrain under a ray depends only on radar position and sampling step, so changes of beam
+// geometry (height, angles, ranges) reuse cached profiles and redo only ray analysis.
+class MCC_VIS_DECLSPEC RadarTerrainCache {
+public:
+    RadarTerrainCache(const mcchm::HmReader* reader, const mccgeo::Geod& geod);
+    ~RadarTerrainCache();
+
+    // drops all profiles
+    void setReader(const mcchm::HmReader* reader);
+
+    std::vector<Point> visionArea(const Radar* radar, const std::vector<mccgeo::PositionAndDistance>& profile);
+
+    void remove(const Radar* radar);
+    void clear();
+
+    std::size_t sampledRays() const;
+
+private:
+    struct Ray {
+        Ray();
+
+        double distance;
+        double azimuth;
+        mccgeo::LatLon end;
+        bool hasTerrain;
+        std::vector<Point> terrain;
+    };
+
+    struct Entry {
+        mccgeo::LatLon position;
+        bool useCalcStep;
+        double calcStep;
+        std::map<std::pair<double, double>, Ray> rays;
+    };
+
+    Ray& ray(Entry* entry, std::map<std::pair<double, double>, Ray>* oldRays, const mccgeo::LatLon& target);
+    void sampleTerrain(const Entry* entry, Ray* ray) const;
+
+    Rc<const mcchm::HmReader> _reader;
+    mccgeo::Geod _geod;
+    std::unordered_map<const Radar*, Entry> _entries;
+    std::size_t _sampledRays;
+};
+}
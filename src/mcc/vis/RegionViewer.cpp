@@ -11,7 +11,6 @@
 #include <QCheckBox>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
-#include <QPainterPath>
 #include <bmcl/Math.h>
 
 #include <chrono>
@@ -21,8 +20,7 @@ namespace mccvis {
 
 RegionViewer::RegionViewer(QWidget* parent)
     : QWidget(parent)
-    , _minViewAngle(0)
-    , _maxViewAngle(0)
+    , _maxDistance(0)
     , _mouseScale(1)
     , _isMousePressed(false)
     , _mode(RegionViewer::RegionMode)
@@ -85,53 +83,16 @@ static inline QPointF toPolar(Point p)
 
 void RegionViewer::setRegion(const Region* region)
 {
-    _paths.clear();
-    _hitPaths.clear();
-    _region.reset(region);
-    _anglePath.clear();
-    _selectedProfile = bmcl::None;
-    const ViewParams& params = region->params();
-    _maxDistance = std::max(params.maxBeamDistance, params.maxHitDistance) * (params.additionalDistancePercent / 100.0 + 1.0);
-    for (const auto& curve : _region->curves()) {
-        _paths.emplace_back();
-        QPainterPath& path = _paths.back();
-        if (curve.empty()) {
-            continue;
-        }
-        path.moveTo(fromPolar(curve[0]));
-        for (std::size_t i = 1; i < curve.size(); i++) {
-            path.lineTo(fromPolar(curve[i]));
-        }
-    }
-    for (const auto& curve : _region->hitCurves()) {
-        _hitPaths.emplace_back();
-        QPainterPath& path = _hitPaths.back();
-        if (curve.empty()) {
-            continue;
-        }
-        path.moveTo(fromPolar(curve[0]));
-        for (std::size_t i = 1; i < curve.size(); i++) {
-            path.lineTo(fromPolar(curve[i]));
-        }
-    }
-
-    _minViewAngle = 90;
-    _maxViewAngle = -90;
-    for (const Rc<Profile>& prof : _region->profiles()) {
-        double dir = prof->direction();
-        double angle = prof->viewAngle();
-        _minViewAngle = std::min(_minViewAngle, angle);
-        _maxViewAngle = std::max(_maxViewAngle, angle);
-        _anglePath.emplace_back(dir, angle);
-    }
-
-    if (qFuzzyCompare(_minViewAngle, _maxViewAngle)) {
-        _angleTicks = Ticks::fromMinMax(_minViewAngle - 0.1, _maxViewAngle + 0.1);
-    } else {
-        _angleTicks = Ticks::fromMinMax(_minViewAngle, _maxViewAngle);
-    }
-
+    setGeometry(new RegionGeometry(region));
+}
 
+void RegionViewer::setGeometry(const RegionGeometry* geometry)
+{
+    _geometry.reset(geometry);
+    _region.reset(geometry->region());
+    _selectedProfile = bmcl::None;
+    _maxDistance = geometry->maxDistance();
+    _angleTicks = geometry->angleTicks();
     update();
 }
 
@@ -370,51 +331,34 @@ void RegionViewer::paintMain(QPainter* p, const RenderConfig& cfg)
     p->setPen(Qt::NoPen);
     p->drawEllipse(QPointF(0, 0), maxr, maxr);
 
+    // cached geometry in resolution of this device
+    double xscale = transform.m11();
+    double yscale = transform.m22();
     if (isRegionView()) {
         QColor fillGreen;
         fillGreen.setRgba(_region->params().viewZonesColorArgb);
-        for (const QPainterPath& path : _paths) {
-            //auto c = QRgba64::fromRgba(rand(), rand(), rand(), 0);
-            //p->fillPath(path, QColor::fromRgba64(c));
-            p->fillPath(path, fillGreen);
+        p->setBrush(fillGreen);
+        for (const PolylineLod& zone : _geometry->viewZones()) {
+            p->drawPolygon(zone.level(xscale, yscale));
         }
 
         QColor fillRed;
         fillRed.setRgba(_region->params().hitZonesColorArgb);
-        for (const QPainterPath& path : _hitPaths) {
-            //p.fillPath(path, QColor::fromRgb(rand()));
-            p->fillPath(path, fillRed);
+        p->setBrush(fillRed);
+        for (const PolylineLod& zone : _geometry->hitZones()) {
+            p->drawPolygon(zone.level(xscale, yscale));
         }
-        //auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - now);
-        //p.setTransform(QTransform());
-        //p.drawText(20, 20, QString::number(delta.count()));
     } else {
-        if (!_anglePath.empty()) {
+        if (!_geometry->angles().isEmpty()) {
             QPen anglePen;
             anglePen.setCosmetic(true);
             anglePen.setWidth(2);
             QColor red;
             red.setRgb(227, 26, 28);
             anglePen.setColor(red);
-            QPainterPath anglePath;
-
-            if (_region->params().isBidirectional) {
-                anglePath.moveTo(fromPolar(QPointF(_anglePath[0].x(), _anglePath[0].y() + rOffset)));
-            } else {
-                anglePath.moveTo(0, 0);
-                anglePath.lineTo(fromPolar(QPointF(_anglePath[0].x(), _anglePath[0].y() + rOffset)));
-            }
-
-            for (std::size_t i = 0; i < _anglePath.size(); i++) {
-                anglePath.lineTo(fromPolar(QPointF(_anglePath[i].x(), _anglePath[i].y() + rOffset)));
-            }
-            if (_region->params().isBidirectional) {
-                anglePath.lineTo(fromPolar(QPointF(_anglePath[0].x(), _anglePath[0].y() + rOffset)));
-            } else {
-                anglePath.lineTo(0, 0);
-            }
-
-            p->strokePath(anglePath, anglePen);
+            p->setPen(anglePen);
+            p->setBrush(Qt::NoBrush);
+            p->drawPolyline(_geometry->angles().level(xscale, yscale));
         }
     }
 
@@ -566,8 +510,6 @@ const RegionViewer::RenderConfig& RegionViewer::renderConfig() const
 void RegionViewer::setMode(Mode mode)
 {
     _mode = mode;
-    if (!_region.isNull()) {
-        setRegion(_region.get());
-    }
+    update();
 }
 }
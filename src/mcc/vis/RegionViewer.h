@@ -3,6 +3,7 @@
 #include "mcc/vis/Config.h"
 #include "mcc/vis/Rc.h"
 #include "mcc/vis/Region.h"
+#include "mcc/vis/PlotGeometry.h"
 #include "mcc/vis/Ticks.h"
 
 #include <bmcl/Option.h>
@@ -36,6 +37,8 @@ public:
     ~RegionViewer();
 
     void setRegion(const Region* region);
+    // geometry is shared with other viewers and is not rebuilt
+    void setGeometry(const RegionGeometry* geometry);
     void setSelectedProfile(bmcl::Option<std::size_t> idx);
     void renderPlot(QPaintDevice* paintDevice, const RenderConfig& cfg);
 
@@ -64,11 +67,7 @@ private:
     void updatePosLabel(const QPoint& mousePos);
 
     Rc<const Region> _region;
-    std::vector<QPainterPath> _paths;
-    std::vector<QPainterPath> _hitPaths;
-    std::vector<QPointF> _anglePath;
-    double _minViewAngle;
-    double _maxViewAngle;
+    Rc<const RegionGeometry> _geometry;
     double _maxDistance;
     Ticks _angleTicks;
     QPoint _mousePos;
@@ -1,18 +1,20 @@
 #include "mcc/vis/ReportGen.h"
 #include "mcc/vis/Region.h"
 #include "mcc/vis/Profile.h"
+#include "mcc/vis/PlotGeometry.h"
 #include "mcc/vis/RegionViewer.h"
 #include "mcc/vis/ProfileViewer.h"
+#include "mcc/vis/XlsxWriter.h"
 
 #include <QEventLoop>
 #include <QProgressDialog>
 #include <QDir>
 
-#include <xlnt/xlnt.hpp>
-
 #include <bmcl/OptionPtr.h>
+#include <bmcl/Logging.h>
 #include <bmcl/ArrayView.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <cmath>
@@ -91,19 +93,19 @@ static const char* boolToString(bool b, const char* first, const char* second)
     return second;
 }
 
-static xlnt::color colorFromArgb(uint32_t argb)
+static XlsxStyle numberStyle(const char* format, bool hasBorder = false)
 {
-    return xlnt::rgb_color(
-        (argb & 0x00ff0000) >> 16,
-        (argb & 0x0000ff00) >>  8,
-        (argb & 0x000000ff)      ,
-        (argb & 0xff000000) >> 24
-    );
+    XlsxStyle style;
+    style.numberFormat = format;
+    style.hasBorder = hasBorder;
+    return style;
 }
 
-static xlnt::fill fillFromArgb(uint32_t argb)
+static XlsxStyle fillStyle(uint32_t argb)
 {
-    return xlnt::fill::solid(colorFromArgb(argb));
+    XlsxStyle style;
+    style.fillArgb = argb;
+    return style;
 }
 
 void ReportGen::gen()
@@ -113,297 +115,156 @@ void ReportGen::gen()
     double progressDelta = double(100.0) / double(stages);
     double progress = 0;
 
+    const ViewParams& p = _region->params();
+    const auto& profiles = _region->profiles();
+
+    // styles are shared by all sheets
+    XlsxWriter writer;
+    std::size_t degreeFormat = writer.addStyle(numberStyle("0.00°"));
+    std::size_t percentFormat = writer.addStyle(numberStyle("0.00%"));
+    std::size_t meterFormat = writer.addStyle(numberStyle("0.00м"));
+    std::size_t msFormat = writer.addStyle(numberStyle("0.00м/с"));
+    std::size_t mhzFormat = writer.addStyle(numberStyle("0.00МГц"));
+    std::size_t secondsFormat = writer.addStyle(numberStyle("0.00с"));
+    XlsxStyle rightAlignment;
+    rightAlignment.isRightAligned = true;
+    std::size_t rightTextFormat = writer.addStyle(rightAlignment);
+    XlsxStyle border;
+    border.hasBorder = true;
+    std::size_t borderFormat = writer.addStyle(border);
+    std::size_t doubleAndBorderFormat = writer.addStyle(numberStyle("0.00", true));
+    std::size_t viewZonesFill = writer.addStyle(fillStyle(p.viewZonesColorArgb));
+    std::size_t hitZonesFill = writer.addStyle(fillStyle(p.hitZonesColorArgb));
+
+    bool isExcelOk = false;
+    if (_config.genExcelReport) {
+        isExcelOk = writer.open(_path + QDir::separator() + "report.xlsx");
+        if (!isExcelOk) {
+            BMCL_CRITICAL() << "failed to create excel report";
+        }
+    }
+    int numPages = 0;
+    if (isExcelOk && _config.profilesPerExcelPage) {
+        numPages = (profiles.size() + _config.profilesPerExcelPage - 1) / _config.profilesPerExcelPage;
+    }
 
     #pragma omp parallel
     {
         #pragma omp single nowait
         {
-            if (_config.genExcelReport) {
-                xlnt::workbook wb;
-
-                xlnt::format degreeFormat = wb.create_format().number_format(xlnt::number_format("0.00°"));
-                xlnt::format percentFormat = wb.create_format().number_format(xlnt::number_format("0.00%"));
-                xlnt::format meterFormat = wb.create_format().number_format(xlnt::number_format("0.00м"));
-                xlnt::format msFormat = wb.create_format().number_format(xlnt::number_format("0.00м/с"));
-                xlnt::format mhzFormat = wb.create_format().number_format(xlnt::number_format("0.00МГц"));
-                xlnt::format secondsFormat = wb.create_format().number_format(xlnt::number_format("0.00с"));
-                xlnt::alignment rightAlignment;
-                rightAlignment.horizontal(xlnt::horizontal_alignment::right);
-                xlnt::format rightTextFormat = wb.create_format().alignment(rightAlignment);
-                //xlnt::format doubleFormat = wb.create_format().number_format(xlnt::number_format("0.00"));
-
-
-                xlnt::border b;
-                xlnt::border::border_property prop;
-                prop.color(xlnt::color::black());
-                prop.style(xlnt::border_style::thin);
-                b.side(xlnt::border_side::top, prop);
-                b.side(xlnt::border_side::bottom, prop);
-                b.side(xlnt::border_side::start, prop);
-                b.side(xlnt::border_side::end, prop);
-
-                xlnt::format borderFormat = wb.create_format().border(b);
-                xlnt::format doubleAndBorderFormat = wb.create_format().border(b).number_format(xlnt::number_format("0.00"));
-
-                wb.remove_sheet(wb.active_sheet());
-
-                const ViewParams& p = _region->params();
-                xlnt::worksheet ws = wb.create_sheet();
-                ws.title("Параметры");
+            if (isExcelOk) {
+                XlsxSheet ws("Параметры");
                 std::size_t rowOffset = 1;
-                std::size_t columnOffset = 1;
-                ws.cell(1, rowOffset).value("Имя антенны");
-                ws.cell(2, rowOffset).value(p.name);
-                ws.cell(2, rowOffset).format(rightTextFormat);
-                rowOffset++;
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Распространение радиоволн");
-                ws.cell(2, rowOffset).value(boolToString(p.hasRefraction, "С рефракцией", "Без рефракции"));
-                ws.cell(2, rowOffset).format(rightTextFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Тип антенны");
-                ws.cell(2, rowOffset).value(boolToString(p.isBidirectional, "Всенаправленная", "Направленная"));
-                ws.cell(2, rowOffset).format(rightTextFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Минимальный азимут");
-                ws.cell(2, rowOffset).value(p.minAzimuth);
-                ws.cell(2, rowOffset).format(degreeFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Максимальный азимут");
-                ws.cell(2, rowOffset).value(p.maxAzimuth);
-                ws.cell(2, rowOffset).format(degreeFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Нижний угол раскрытия");
-                ws.cell(2, rowOffset).value(p.minAngle);
-                ws.cell(2, rowOffset).format(degreeFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Верхний угол раскрытия");
-                ws.cell(2, rowOffset).value(p.maxAngle);
-                ws.cell(2, rowOffset).format(degreeFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Минимальная дальность");
-                ws.cell(2, rowOffset).value(p.minBeamDistance);
-                ws.cell(2, rowOffset).format(meterFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Максимальная дальность");
-                ws.cell(2, rowOffset).value(p.maxBeamDistance);
-                ws.cell(2, rowOffset).format(meterFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Высота радара задается");
-                ws.cell(2, rowOffset).value(boolToString(p.isRelativeHeight, "Относительно местности", "Относительно эллипсойда"));
-                ws.cell(2, rowOffset).format(rightTextFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Высота радара");
-                if (p.isRelativeHeight && !_region->profiles().empty()) {
-                    double totalHeight = _region->profiles()[0]->totalRadarHeight();
+                auto addText = [&](const char* title, bmcl::StringView value) {
+                    ws.beginRow(rowOffset);
+                    ws.addString(1, title);
+                    ws.addString(2, value, rightTextFormat);
+                    rowOffset++;
+                };
+                auto addNumber = [&](const char* title, double value, std::size_t format) {
+                    ws.beginRow(rowOffset);
+                    ws.addString(1, title);
+                    ws.addNumber(2, value, format);
+                    rowOffset++;
+                };
+                auto addFill = [&](const char* title, std::size_t format) {
+                    ws.beginRow(rowOffset);
+                    ws.addString(1, title);
+                    ws.addEmpty(2, format);
+                    rowOffset++;
+                };
+
+                addText("Имя антенны", p.name);
+                rowOffset++;
+                addText("Распространение радиоволн", boolToString(p.hasRefraction, "С рефракцией", "Без рефракции"));
+                addText("Тип антенны", boolToString(p.isBidirectional, "Всенаправленная", "Направленная"));
+                addNumber("Минимальный азимут", p.minAzimuth, degreeFormat);
+                addNumber("Максимальный азимут", p.maxAzimuth, degreeFormat);
+                addNumber("Нижний угол раскрытия", p.minAngle, degreeFormat);
+                addNumber("Верхний угол раскрытия", p.maxAngle, degreeFormat);
+                addNumber("Минимальная дальность", p.minBeamDistance, meterFormat);
+                addNumber("Максимальная дальность", p.maxBeamDistance, meterFormat);
+                addText("Высота радара задается", boolToString(p.isRelativeHeight, "Относительно местности", "Относительно эллипсойда"));
+                if (p.isRelativeHeight && !profiles.empty()) {
+                    double totalHeight = profiles[0]->totalRadarHeight();
                     std::string h =  doubleToString(totalHeight, " (");
                     h += doubleToString(totalHeight - p.radarHeight, "+");
                     h += doubleToString(p.radarHeight, ")м");
-                    ws.cell(2, rowOffset).value(h);
+                    addText("Высота радара", h);
                 } else {
-                    ws.cell(2, rowOffset).value(p.radarHeight);
-                    ws.cell(2, rowOffset).format(meterFormat);
+                    addNumber("Высота радара", p.radarHeight, meterFormat);
                 }
-                ws.cell(2, rowOffset).format(rightTextFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Обнаружение на фоне земли");
-                ws.cell(2, rowOffset).value(boolToString(p.canViewGround, "Да", "Нет"));
-                ws.cell(2, rowOffset).format(rightTextFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Учет зон Френеля");
-                ws.cell(2, rowOffset).value(boolToString(p.useFresnelRegion, "Да", "Нет"));
-                ws.cell(2, rowOffset).format(rightTextFormat);
-                rowOffset++;
+                addText("Обнаружение на фоне земли", boolToString(p.canViewGround, "Да", "Нет"));
+                addText("Учет зон Френеля", boolToString(p.useFresnelRegion, "Да", "Нет"));
                 if (p.useFresnelRegion) {
-                    ws.cell(1, rowOffset).value("Частота передатчика");
-                    ws.cell(2, rowOffset).value(p.frequency);
-                    ws.cell(2, rowOffset).format(mhzFormat);
-                    rowOffset++;
+                    addNumber("Частота передатчика", p.frequency, mhzFormat);
                 }
                 rowOffset++;
 
-                ws.cell(1, rowOffset).value("Профиль полета ЛА");
-                ws.cell(2, rowOffset).value(boolToString(p.isTargetRelativeHeight, "Относительно местности", "Относительно эллипсойда"));
-                ws.cell(2, rowOffset).format(rightTextFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Направление полета ЛА");
-                ws.cell(2, rowOffset).value(boolToString(p.isTargetDirectedTowards, "Навстречу радару", "От радара"));
-                ws.cell(2, rowOffset).format(rightTextFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Высота ЛА");
-                ws.cell(2, rowOffset).value(p.objectHeight);
-                ws.cell(2, rowOffset).format(meterFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Скорость ЛА");
-                ws.cell(2, rowOffset).value(p.targetSpeed);
-                ws.cell(2, rowOffset).format(msFormat);
-                rowOffset++;
+                addText("Профиль полета ЛА", boolToString(p.isTargetRelativeHeight, "Относительно местности", "Относительно эллипсойда"));
+                addText("Направление полета ЛА", boolToString(p.isTargetDirectedTowards, "Навстречу радару", "От радара"));
+                addNumber("Высота ЛА", p.objectHeight, meterFormat);
+                addNumber("Скорость ЛА", p.targetSpeed, msFormat);
                 rowOffset++;
 
-                ws.cell(1, rowOffset).value("Минимальная дальность поражения");
-                ws.cell(2, rowOffset).value(p.minHitDistance);
-                ws.cell(2, rowOffset).format(meterFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Максимальная дальность поражения");
-                ws.cell(2, rowOffset).value(p.maxHitDistance);
-                ws.cell(2, rowOffset).format(meterFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Время реакции комплекса");
-                ws.cell(2, rowOffset).value(p.reactionTime);
-                ws.cell(2, rowOffset).format(secondsFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Время реакции внешних источников");
-                ws.cell(2, rowOffset).value(p.externReactionTime);
-                ws.cell(2, rowOffset).format(secondsFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Скорость изделия");
-                ws.cell(2, rowOffset).value(p.missleSpeed);
-                ws.cell(2, rowOffset).format(msFormat);
-                rowOffset++;
+                addNumber("Минимальная дальность поражения", p.minHitDistance, meterFormat);
+                addNumber("Максимальная дальность поражения", p.maxHitDistance, meterFormat);
+                addNumber("Время реакции комплекса", p.reactionTime, secondsFormat);
+                addNumber("Время реакции внешних источников", p.externReactionTime, secondsFormat);
+                addNumber("Скорость изделия", p.missleSpeed, msFormat);
                 rowOffset++;
 
-                ws.cell(1, rowOffset).value("Постоянный шаг расчета по дальности");
-                ws.cell(2, rowOffset).value(boolToString(p.useCalcStep, "Да", "Нет"));
-                ws.cell(2, rowOffset).format(rightTextFormat);
-                rowOffset++;
+                addText("Постоянный шаг расчета по дальности", boolToString(p.useCalcStep, "Да", "Нет"));
                 if (p.useCalcStep) {
-                    ws.cell(1, rowOffset).value("Шаг расчета по дальности");
-                    ws.cell(2, rowOffset).value(p.calcStep);
-                    ws.cell(2, rowOffset).format(meterFormat);
-                    rowOffset++;
-                }
-                ws.cell(1, rowOffset).value("Шаг расчета по углу");
-                ws.cell(2, rowOffset).value(p.angleStep);
-                ws.cell(2, rowOffset).format(degreeFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Запас расчета по дальности");
-                ws.cell(2, rowOffset).value(double(p.additionalDistancePercent) / 100);
-                ws.cell(2, rowOffset).format(percentFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Расчет зон поражения");
-                ws.cell(2, rowOffset).value(boolToString(p.calcHits, "Да", "Нет"));
-                ws.cell(2, rowOffset).format(rightTextFormat);
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Цвет зон обнаружения");
-                ws.cell(2, rowOffset).fill(fillFromArgb(p.viewZonesColorArgb));
-                rowOffset++;
-                ws.cell(1, rowOffset).value("Цвет зон поражения");
-                ws.cell(2, rowOffset).fill(fillFromArgb(p.hitZonesColorArgb));
-                rowOffset++;
-
-                ws = wb.create_sheet();
-                ws.title("Расчет");
-
-                rowOffset = 1;
-                ws.cell(columnOffset + 1, rowOffset).value("k обн.");
-                ws.cell(columnOffset + 2, rowOffset).value("k пор.");
-                ws.cell(columnOffset + 1, rowOffset).format(borderFormat);
-                ws.cell(columnOffset + 2, rowOffset).format(borderFormat);
-
-                rowOffset++;
-                ws.cell(columnOffset + 1, rowOffset).value(_region->viewCoeff());
-                ws.cell(columnOffset + 2, rowOffset).value(_region->hitCoeff());
-                ws.cell(columnOffset + 1, rowOffset).format(doubleAndBorderFormat);
-                ws.cell(columnOffset + 2, rowOffset).format(doubleAndBorderFormat);
-
-                rowOffset += 2;
-                ws.cell(columnOffset + 1, rowOffset).value("β напр.");
-                ws.cell(columnOffset + 2, rowOffset).value("ε закр.");
-                ws.cell(columnOffset + 3, rowOffset).value("d препят.(м)");
-                ws.cell(columnOffset + 4, rowOffset).value("d обн.min.(м)");
-                ws.cell(columnOffset + 5, rowOffset).value("d обн.max.(м)");
-                ws.cell(columnOffset + 6, rowOffset).value("d пор.min.(м)");
-                ws.cell(columnOffset + 7, rowOffset).value("d пор.max.(м)");
-                ws.cell(columnOffset + 1, rowOffset).format(borderFormat);
-                ws.cell(columnOffset + 2, rowOffset).format(borderFormat);
-                ws.cell(columnOffset + 3, rowOffset).format(borderFormat);
-                ws.cell(columnOffset + 4, rowOffset).format(borderFormat);
-                ws.cell(columnOffset + 5, rowOffset).format(borderFormat);
-                ws.cell(columnOffset + 6, rowOffset).format(borderFormat);
-                ws.cell(columnOffset + 7, rowOffset).format(borderFormat);
-
-                rowOffset++;
-                xlnt::column_properties cprops;
-                cprops.hidden = true;
-                ws.add_column_properties(1, cprops);
-                ws.freeze_panes(ws.cell(1, rowOffset));
-
-                for (std::size_t i = 0; i < _region->profiles().size(); i++) {
-                    const Profile* prof = _region->profiles()[i].get();
-                    ws.cell(columnOffset + 1, i + rowOffset).value(_region->profiles()[i]->direction());
-                    ws.cell(columnOffset + 2, i + rowOffset).value(toDegreesMinutesSeconds(prof->viewAngle()));
-                    ws.cell(columnOffset + 3, i + rowOffset).value(prof->peakDistance());
-                    ws.cell(columnOffset + 4, i + rowOffset).value(prof->minViewDistance());
-                    ws.cell(columnOffset + 5, i + rowOffset).value(prof->maxViewDistance());
-                    ws.cell(columnOffset + 6, i + rowOffset).value(prof->minHitDistance());
-                    ws.cell(columnOffset + 7, i + rowOffset).value(prof->maxHitDistance());
-
-                    ws.cell(columnOffset + 1, i + rowOffset).format(doubleAndBorderFormat);
-                    ws.cell(columnOffset + 2, i + rowOffset).format(borderFormat);
-                    ws.cell(columnOffset + 3, i + rowOffset).format(doubleAndBorderFormat);
-                    ws.cell(columnOffset + 4, i + rowOffset).format(doubleAndBorderFormat);
-                    ws.cell(columnOffset + 5, i + rowOffset).format(doubleAndBorderFormat);
-                    ws.cell(columnOffset + 6, i + rowOffset).format(doubleAndBorderFormat);
-                    ws.cell(columnOffset + 7, i + rowOffset).format(doubleAndBorderFormat);
+                    addNumber("Шаг расчета по дальности", p.calcStep, meterFormat);
                 }
+                addNumber("Шаг расчета по углу", p.angleStep, degreeFormat);
+                addNumber("Запас расчета по дальности", double(p.additionalDistancePercent) / 100, percentFormat);
+                addText("Расчет зон поражения", boolToString(p.calcHits, "Да", "Нет"));
+                addFill("Цвет зон обнаружения", viewZonesFill);
+                addFill("Цвет зон поражения", hitZonesFill);
+                writer.addSheet(0, &ws);
                 #pragma omp atomic
                 progress += progressDelta;
                 emit progressChanged(progress);
 
-                if (_config.profilesPerExcelPage) {
-                    for (std::size_t i = 0; i < _region->profiles().size();) {
-                        std::size_t rowOffset = 1;
-                        std::size_t columnOffset = 1;
-                        xlnt::worksheet ws = wb.create_sheet();
-                        std::ostringstream name;
-                        for (std::size_t k = 0; k < _config.profilesPerExcelPage; k++) {
-                            if (i >= _region->profiles().size()) {
-                                break;
-                            }
-                            const Profile* prof = _region->profiles()[i].get();
-                            name << std::fixed << std::setprecision(2) << _region->profiles()[i]->direction();
-                            name << " ";
-                            ws.cell(columnOffset + 1, 1).value("D(км)");
-                            ws.cell(columnOffset + 2, 1).value("H(м)");
-                            ws.cell(columnOffset + 3, 1).value("Hц(м)");
-                            ws.cell(columnOffset + 4, 1).value("dH(м)");
-                            for (std::size_t j = 0; j < prof->data().size(); j++) {
-                                ws.cell(columnOffset + 1, j + rowOffset + 1).value(prof->data()[j].profile.x() / 1000);
-                                ws.cell(columnOffset + 2, j + rowOffset + 1).value(prof->data()[j].profile.y());
-                                ws.cell(columnOffset + 3, j + rowOffset + 1).value(prof->data()[j].target.y());
-                                ws.cell(columnOffset + 4, j + rowOffset + 1).value(prof->data()[j].dy);
-
-                                ws.cell(columnOffset + 1, j + rowOffset + 1).format(doubleAndBorderFormat);
-                                ws.cell(columnOffset + 2, j + rowOffset + 1).format(doubleAndBorderFormat);
-                                ws.cell(columnOffset + 3, j + rowOffset + 1).format(doubleAndBorderFormat);
-                                ws.cell(columnOffset + 4, j + rowOffset + 1).format(doubleAndBorderFormat);
-                            }
-                            //for (std::size_t j = 0; j < (prof->data().size() + rowOffset); j++) {
-                            //    ws.cell(columnOffset + 1, j + 1).format(borderFormat);
-                            //    ws.cell(columnOffset + 2, j + 1).format(borderFormat);
-                            //    ws.cell(columnOffset + 3, j + 1).format(borderFormat);
-                            //    ws.cell(columnOffset + 4, j + 1).format(borderFormat);
-                            //}
-                            i++;
-                            columnOffset += 5;
-                            #pragma omp atomic
-                            progress += progressDelta;
-                            emit progressChanged(progress);
-                        }
-                        std::string title = name.str();
-                        if (title.size() > 31) {
-                            title.resize(31);
-                        }
-                        ws.title(title);
-                        xlnt::column_properties cprops;
-                        cprops.hidden = true;
-                        ws.add_column_properties(1, cprops);
-                        ws.freeze_panes(ws.cell(1, 2));
-                    }
+                XlsxSheet calc("Расчет");
+                std::size_t columnOffset = 1;
+                rowOffset = 5;
+                calc.setHiddenColumn(1);
+                calc.setFrozenRows(rowOffset - 1);
+
+                calc.beginRow(1);
+                calc.addString(columnOffset + 1, "k обн.", borderFormat);
+                calc.addString(columnOffset + 2, "k пор.", borderFormat);
+                calc.beginRow(2);
+                calc.addNumber(columnOffset + 1, _region->viewCoeff(), doubleAndBorderFormat);
+                calc.addNumber(columnOffset + 2, _region->hitCoeff(), doubleAndBorderFormat);
+
+                calc.beginRow(4);
+                calc.addString(columnOffset + 1, "β напр.", borderFormat);
+                calc.addString(columnOffset + 2, "ε закр.", borderFormat);
+                calc.addString(columnOffset + 3, "d препят.(м)", borderFormat);
+                calc.addString(columnOffset + 4, "d обн.min.(м)", borderFormat);
+                calc.addString(columnOffset + 5, "d обн.max.(м)", borderFormat);
+                calc.addString(columnOffset + 6, "d пор.min.(м)", borderFormat);
+                calc.addString(columnOffset + 7, "d пор.max.(м)", borderFormat);
+
+                for (std::size_t i = 0; i < profiles.size(); i++) {
+                    const Profile* prof = profiles[i].get();
+                    calc.beginRow(i + rowOffset);
+                    calc.addNumber(columnOffset + 1, prof->direction(), doubleAndBorderFormat);
+                    calc.addString(columnOffset + 2, toDegreesMinutesSeconds(prof->viewAngle()), borderFormat);
+                    calc.addNumber(columnOffset + 3, prof->peakDistance(), doubleAndBorderFormat);
+                    calc.addNumber(columnOffset + 4, prof->minViewDistance(), doubleAndBorderFormat);
+                    calc.addNumber(columnOffset + 5, prof->maxViewDistance(), doubleAndBorderFormat);
+                    calc.addNumber(columnOffset + 6, prof->minHitDistance(), doubleAndBorderFormat);
+                    calc.addNumber(columnOffset + 7, prof->maxHitDistance(), doubleAndBorderFormat);
                 }
-
-                QByteArray xlPath = QString(_path + QDir::separator() + "report.xlsx").toUtf8();
-                wb.save(xlPath.data());
+                writer.addSheet(1, &calc);
+                #pragma omp atomic
+                progress += progressDelta;
+                emit progressChanged(progress);
             }
         }
 
@@ -411,7 +272,7 @@ void ReportGen::gen()
         {
             if (_config.genZoneImages) {
                 RegionViewer regionViewer;
-                regionViewer.setRegion(_region.get());
+                regionViewer.setGeometry(_geometry.get());
                 QString fname = _path + QDir::separator() + "zone.png";
                 QImage img(_config.zoneImageWidth, _config.zoneImageHeight, QImage::Format_ARGB32_Premultiplied);
                 regionViewer.renderPlot(&img, _config.zoneRenderCfg);
@@ -426,7 +287,7 @@ void ReportGen::gen()
         {
             if (_config.genAnglesImages) {
                 RegionViewer regionViewer;
-                regionViewer.setRegion(_region.get());
+                regionViewer.setGeometry(_geometry.get());
                 regionViewer.setMode(RegionViewer::AnglesMode);
                 QString fname = _path + QDir::separator() + "angles.png";
                 QImage img(_config.anglesImageWidth, _config.anglesImageHeight, QImage::Format_ARGB32_Premultiplied);
@@ -439,24 +300,24 @@ void ReportGen::gen()
         }
 
         if (_config.genProfileImages) {
-            std::vector<Rc<const Profile>> slice;
+            std::vector<Rc<const ProfileGeometry>> slice;
             slice.reserve(_config.profilesPerImage);
             ProfileViewer profViewer;
             QImage img(_config.profileImageWidth, _config.profileImageHeight, QImage::Format_ARGB32_Premultiplied);
 
-            #pragma omp for schedule(dynamic, 1)
+            #pragma omp for schedule(dynamic, 1) nowait
             for (int i = 0; i < _region->profiles().size(); i += _config.profilesPerImage) {
                 QString name;
                 std::size_t minK = std::min<std::size_t>(i + _config.profilesPerImage, _region->profiles().size());
                 slice.clear();
                 for (std::size_t k = i; k < minK; k++) {
-                    const auto& prof = _region->profiles()[k];
-                    slice.emplace_back(prof);
-                    name += QString::number(prof->direction());
+                    Rc<const ProfileGeometry> prof = _geometry->profile(k);
+                    name += QString::number(prof->profile()->direction());
+                    slice.emplace_back(std::move(prof));
                     name += '_';
                 }
 
-                profViewer.setProfiles(slice);
+                profViewer.setGeometries(slice);
                 QString fname = _path + QDir::separator() + name + ".png";
                 profViewer.renderPlot(&img, _config.profileRenderCfg);
                 img.save(fname);
@@ -465,6 +326,63 @@ void ReportGen::gen()
                 emit progressChanged(progress);
             }
         }
+
+        // every page is a separate sheet written row by row, so pages are generated in parallel
+        #pragma omp for schedule(dynamic, 1)
+        for (int page = 0; page < numPages; page++) {
+            std::size_t first = page * _config.profilesPerExcelPage;
+            std::size_t last = std::min<std::size_t>(first + _config.profilesPerExcelPage, profiles.size());
+            std::ostringstream name;
+            std::size_t maxSize = 0;
+            for (std::size_t i = first; i < last; i++) {
+                name << std::fixed << std::setprecision(2) << profiles[i]->direction();
+                name << " ";
+                maxSize = std::max(maxSize, profiles[i]->size());
+            }
+            std::string title = name.str();
+            if (title.size() > 31) {
+                title.resize(31);
+            }
+
+            XlsxSheet ws(title);
+            ws.setHiddenColumn(1);
+            ws.setFrozenRows(1);
+            ws.beginRow(1);
+            std::size_t columnOffset = 1;
+            for (std::size_t i = first; i < last; i++) {
+                ws.addString(columnOffset + 1, "D(км)");
+                ws.addString(columnOffset + 2, "H(м)");
+                ws.addString(columnOffset + 3, "Hц(м)");
+                ws.addString(columnOffset + 4, "dH(м)");
+                columnOffset += 5;
+            }
+            for (std::size_t j = 0; j < maxSize; j++) {
+                ws.beginRow(j + 2);
+                columnOffset = 1;
+                for (std::size_t i = first; i < last; i++) {
+                    const Profile* prof = profiles[i].get();
+                    if (j < prof->size()) {
+                        const ProfileSamples& samples = prof->samples();
+                        ws.addNumber(columnOffset + 1, samples.x[j] / 1000, doubleAndBorderFormat);
+                        ws.addNumber(columnOffset + 2, samples.y[j], doubleAndBorderFormat);
+                        ws.addNumber(columnOffset + 3, samples.targetY[j], doubleAndBorderFormat);
+                        ws.addNumber(columnOffset + 4, samples.dy[j], doubleAndBorderFormat);
+                    }
+                    columnOffset += 5;
+                }
+            }
+            writer.addSheet(2 + page, &ws);
+            #pragma omp atomic
+            progress += progressDelta * (last - first);
+            emit progressChanged(progress);
+        }
+
+        #pragma omp single
+        {
+            if (isExcelOk && !writer.close()) {
+                BMCL_CRITICAL() << "failed to write excel report";
+            }
+        }
     }
 }
 
@@ -482,9 +400,10 @@ ReportGen::~ReportGen()
 {
 }
 
-void ReportGen::generateReport(const Region* region, const QString& path, const ReportConfig& conf)
+void ReportGen::generateReport(const RegionGeometry* geometry, const QString& path, const ReportConfig& conf)
 {
-    _region = region;
+    _geometry = geometry;
+    _region = geometry->region();
     _path = path;
     _config = conf;
     start();
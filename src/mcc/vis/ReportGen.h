@@ -12,6 +12,7 @@ class QWidget;
 namespace mccvis {
 
 class Region;
+class RegionGeometry;
 
 class MCC_VIS_DECLSPEC ReportGen : public QThread {
     Q_OBJECT
@@ -19,7 +20,7 @@ public:
     ReportGen();
     ~ReportGen();
 
-    void generateReport(const Region* region, const QString& path, const ReportConfig& conf);
+    void generateReport(const RegionGeometry* geometry, const QString& path, const ReportConfig& conf);
 
 protected:
     void run() override;
@@ -33,6 +34,7 @@ private:
 
     QString _path;
     Rc<const Region> _region;
+    Rc<const RegionGeometry> _geometry;
     ReportConfig _config;
 
 };
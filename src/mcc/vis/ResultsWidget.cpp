@@ -1,5 +1,6 @@
 #include "mcc/vis/ResultsWidget.h"
 #include "mcc/vis/Region.h"
+#include "mcc/vis/PlotGeometry.h"
 #include "mcc/vis/RegionViewer.h"
 #include "mcc/vis/ProfileViewer.h"
 #include "mcc/vis/ProfileDataViewer.h"
@@ -399,7 +400,7 @@ ResultsWidget::ResultsWidget(const Region* region)
         _dialog->setAutoClose(false);
         QObject::connect(_gen, &ReportGen::finished, _dialog, &QProgressDialog::accept, Qt::QueuedConnection);
         QObject::connect(_gen, &ReportGen::progressChanged, _dialog, &QProgressDialog::setValue, Qt::QueuedConnection);
-        _gen->generateReport(_region.get(), dir, conf);
+        _gen->generateReport(_geometry.get(), dir, conf);
         _dialog->exec();
         _gen->wait();
         QObject::disconnect(_dialog, 0, 0, 0);
@@ -444,7 +445,7 @@ void ResultsWidget::selectProfile(std::size_t i)
         return;
     }
     const Profile* p = _region->profiles()[i].get();
-    _profileViewer->setProfile(p);
+    _profileViewer->setGeometry(_geometry->profile(i).get());
     _dataViewer->setProfile(p);
     _regionViewer->setSelectedProfile(bmcl::Option<std::size_t>(i));
     _angleViewer->setSelectedProfile(bmcl::Option<std::size_t>(i));
@@ -458,8 +459,10 @@ void ResultsWidget::setRegion(const Region* region)
 
 void ResultsWidget::updateView()
 {
-    _regionViewer->setRegion(_region.get());
-    _angleViewer->setRegion(_region.get());
+    // zones and profiles are drawn from same geometry by viewers and report
+    _geometry = new RegionGeometry(_region.get());
+    _regionViewer->setGeometry(_geometry.get());
+    _angleViewer->setGeometry(_geometry.get());
     _tabWidget->setCurrentIndex(0);
     _directionsModel->setRegion(_region.get());
     _directionsView->selectionModel()->setCurrentIndex(_directionsModel->index(0, 0), QItemSelectionModel::Select);
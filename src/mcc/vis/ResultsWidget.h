@@ -12,6 +12,7 @@ class QProgressDialog;
 namespace mccvis {
 
 class Region;
+class RegionGeometry;
 class ProfileViewer;
 class ProfileDataViewer;
 class RegionViewer;
@@ -40,6 +41,7 @@ private:
     ProfileDataViewer* _dataViewer;
     DirectionListModel* _directionsModel;
     Rc<const Region> _region;
+    Rc<const RegionGeometry> _geometry;
     ReportGen* _gen;
     QProgressDialog* _dialog;
 };
@@ -0,0 +1,320 @@
+#include "mcc/vis/Viewshed.h"
+#include "mcc/hm/HmReader.h"
+
+#include <bmcl/ArrayView.h>
+#include <bmcl/Math.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace mccvis {
+
+constexpr const double earthRadius = 6371110;
+constexpr const double pi = bmcl::pi<double>();
+constexpr const double metersPerDegree = earthRadius * pi / 180.0;
+
+// terrain point in profile plane, same transform as in Profile::fillData
+struct PlanePoint {
+    double x;
+    double y;
+    double dy;
+};
+
+static inline PlanePoint toPlane(double d, double h, bool hasRefraction)
+{
+    if (hasRefraction) {
+        double dy = -d * d / 1000 / 1000 / 16.97;
+        return PlanePoint{d, h + dy, dy};
+    }
+    double a = d / earthRadius;
+    double y = -earthRadius + std::cos(a) * (earthRadius + h);
+    return PlanePoint{std::sin(a) * (earthRadius + h), y, y - h};
+}
+
+static inline double azimuthOf(double east, double north)
+{
+    double a = std::atan2(east, north);
+    if (a < 0) {
+        a += 2 * pi;
+    }
+    return a;
+}
+
+// max over active cells with distance rank less then given, inactive cells hold -inf
+class SlopeTree {
+public:
+    explicit SlopeTree(std::size_t size)
+        : _size(size)
+        , _data(2 * size, -std::numeric_limits<float>::infinity())
+    {
+    }
+
+    void set(std::size_t i, float value)
+    {
+        i += _size;
+        _data[i] = value;
+        for (i >>= 1; i > 0; i >>= 1) {
+            _data[i] = std::max(_data[2 * i], _data[2 * i + 1]);
+        }
+    }
+
+    void reset(std::size_t i)
+    {
+        set(i, -std::numeric_limits<float>::infinity());
+    }
+
+    float maxBefore(std::size_t end) const
+    {
+        float rv = -std::numeric_limits<float>::infinity();
+        std::size_t l = _size;
+        std::size_t r = end + _size;
+        while (l < r) {
+            if (l & 1) {
+                rv = std::max(rv, _data[l++]);
+            }
+            if (r & 1) {
+                rv = std::max(rv, _data[--r]);
+            }
+            l >>= 1;
+            r >>= 1;
+        }
+        return rv;
+    }
+
+private:
+    std::size_t _size;
+    std::vector<float> _data;
+};
+
+Viewshed::Viewshed(const mccgeo::LatLon& observer, const ViewParams& params, double cellSize)
+    : _params(params)
+    , _observer(observer)
+    , _cellSize(std::max(1.0, cellSize))
+    , _radarY(0)
+{
+    _radius = std::size_t(std::ceil(_params.maxBeamDistance / _cellSize));
+    _size = 2 * _radius + 1;
+    _latStep = _cellSize / metersPerDegree;
+    double cosLat = std::max(1e-6, std::cos(observer.latitude() * pi / 180.0));
+    _lonStep = _latStep / cosLat;
+}
+
+Viewshed::~Viewshed()
+{
+}
+
+mccgeo::LatLon Viewshed::cellCenter(std::size_t x, std::size_t y) const
+{
+    double lat = _observer.latitude() + (double(_radius) - double(y)) * _latStep;
+    double lon = _observer.longitude() + (double(x) - double(_radius)) * _lonStep;
+    return mccgeo::LatLon(lat, lon);
+}
+
+ViewshedCell Viewshed::cellAt(std::size_t x, std::size_t y) const
+{
+    if (x >= _size || y >= _size || _cells.empty()) {
+        return ViewshedCell::OutOfRange;
+    }
+    return _cells[y * _size + x];
+}
+
+bmcl::Option<ViewshedCell> Viewshed::cellAt(const mccgeo::LatLon& latLon) const
+{
+    double x = std::round((latLon.longitude() - _observer.longitude()) / _lonStep) + _radius;
+    double y = std::round((_observer.latitude() - latLon.latitude()) / _latStep) + _radius;
+    if (x < 0 || y < 0 || x >= _size || y >= _size) {
+        return bmcl::None;
+    }
+    return cellAt(std::size_t(x), std::size_t(y));
+}
+
+float Viewshed::minVisibleHeightAt(std::size_t x, std::size_t y) const
+{
+    if (x >= _size || y >= _size || _minVisibleHeights.empty()) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    return _minVisibleHeights[y * _size + x];
+}
+
+void Viewshed::calculate(const mcchm::HmReader* reader)
+{
+    readHeights(reader);
+    sweep();
+    _heights.clear();
+    _heights.shrink_to_fit();
+}
+
+void Viewshed::readHeights(const mcchm::HmReader* reader)
+{
+    _heights.resize(_size * _size);
+    std::vector<double> lons(_size);
+    for (std::size_t x = 0; x < _size; x++) {
+        lons[x] = cellCenter(x, 0).longitude();
+    }
+
+    std::ptrdiff_t rows = _size;
+    #pragma omp parallel
+    {
+        mcchm::Rc<const mcchm::HmReader> local(reader->clone());
+        #pragma omp for schedule(dynamic, 16)
+        for (std::ptrdiff_t y = 0; y < rows; y++) {
+            double lat = cellCenter(0, y).latitude();
+            local->readAltitudeMatrix(bmcl::ArrayView<double>(&lat, 1), lons, &_heights[y * _size], 0, 0);
+        }
+    }
+}
+
+void Viewshed::sweep()
+{
+    const std::size_t total = _size * _size;
+    const std::size_t center = _radius * _size + _radius;
+    const double half = _cellSize / 2;
+    const double maxD = _params.maxBeamDistance;
+    const double minD = _params.minBeamDistance;
+    const double deltaAngleRadians = _params.deltaAngle * pi / 180.0;
+    const double mink = std::tan(_params.minAngle * pi / 180.0);
+    const double maxk = std::tan(_params.maxAngle * pi / 180.0);
+
+    _cells.assign(total, ViewshedCell::OutOfRange);
+    _minVisibleHeights.assign(total, std::numeric_limits<float>::quiet_NaN());
+
+    double groundY = _heights[center];
+    if (_params.isRelativeHeight) {
+        _radarY = groundY + _params.radarHeight;
+    } else {
+        _radarY = std::max(groundY + 0.1, _params.radarHeight);
+    }
+    _cells[center] = ViewshedCell::Visible;
+    _minVisibleHeights[center] = 0;
+
+    struct CellInfo {
+        std::uint32_t index;
+        float distance;
+    };
+
+    std::vector<CellInfo> infos;
+    infos.reserve(total);
+    for (std::size_t y = 0; y < _size; y++) {
+        double north = (double(_radius) - double(y)) * _cellSize;
+        for (std::size_t x = 0; x < _size; x++) {
+            double east = (double(x) - double(_radius)) * _cellSize;
+            double d = std::hypot(east, north);
+            if (d > maxD || (y * _size + x) == center) {
+                continue;
+            }
+            infos.push_back(CellInfo{std::uint32_t(y * _size + x), float(d)});
+        }
+    }
+    const std::size_t count = infos.size();
+    if (count == 0) {
+        return;
+    }
+
+    std::sort(infos.begin(), infos.end(), [](const CellInfo& left, const CellInfo& right) {
+        return left.distance < right.distance;
+    });
+
+    // index in infos == distance rank
+    std::vector<float> enterAngles(count);
+    std::vector<float> centerAngles(count);
+    std::vector<float> exitAngles(count);
+    std::vector<float> blockSlopes(count);
+    SlopeTree tree(count);
+
+    for (std::size_t i = 0; i < count; i++) {
+        std::size_t x = infos[i].index % _size;
+        std::size_t y = infos[i].index / _size;
+        double east = (double(x) - double(_radius)) * _cellSize;
+        double north = (double(_radius) - double(y)) * _cellSize;
+        double d = infos[i].distance;
+
+        PlanePoint p = toPlane(d, _heights[infos[i].index], _params.hasRefraction);
+        double k = (p.y - _radarY) / p.x;
+        blockSlopes[i] = float(std::tan(std::atan(k) + deltaAngleRadians));
+
+        double a1 = azimuthOf(east - half, north - half);
+        double a2 = azimuthOf(east - half, north + half);
+        double a3 = azimuthOf(east + half, north - half);
+        double a4 = azimuthOf(east + half, north + half);
+        centerAngles[i] = float(azimuthOf(east, north));
+        if (x == _radius && y < _radius) {
+            // cell crosses the initial sweep direction
+            enterAngles[i] = float(std::min(a1, a2));
+            exitAngles[i] = float(std::max(a3, a4));
+            tree.set(i, blockSlopes[i]);
+        } else {
+            enterAngles[i] = float(std::min(std::min(a1, a2), std::min(a3, a4)));
+            exitAngles[i] = float(std::max(std::max(a1, a2), std::max(a3, a4)));
+        }
+    }
+
+    auto sortedByAngle = [count](const std::vector<float>& angles) {
+        std::vector<std::uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&angles](std::uint32_t left, std::uint32_t right) {
+            return angles[left] < angles[right];
+        });
+        return order;
+    };
+
+    std::vector<std::uint32_t> enterOrder = sortedByAngle(enterAngles);
+    std::vector<std::uint32_t> centerOrder = sortedByAngle(centerAngles);
+    std::vector<std::uint32_t> exitOrder = sortedByAngle(exitAngles);
+
+    double minAzimuth = _params.minAzimuth;
+    double maxAzimuth = _params.maxAzimuth;
+    auto isInSector = [minAzimuth, maxAzimuth](double azimuthDeg) {
+        while (azimuthDeg < minAzimuth) {
+            azimuthDeg += 360;
+        }
+        return azimuthDeg >= minAzimuth && azimuthDeg <= maxAzimuth;
+    };
+
+    const float inf = std::numeric_limits<float>::infinity();
+    std::size_t enterIt = 0;
+    std::size_t centerIt = 0;
+    std::size_t exitIt = 0;
+    // at equal angles cells enter first and exit last
+    while (centerIt < count) {
+        float enterAngle = enterIt < count ? enterAngles[enterOrder[enterIt]] : inf;
+        float centerAngle = centerAngles[centerOrder[centerIt]];
+        float exitAngle = exitIt < count ? exitAngles[exitOrder[exitIt]] : inf;
+
+        if (enterAngle <= centerAngle && enterAngle <= exitAngle) {
+            std::uint32_t i = enterOrder[enterIt];
+            tree.set(i, blockSlopes[i]);
+            enterIt++;
+            continue;
+        }
+        if (exitAngle < centerAngle) {
+            tree.reset(exitOrder[exitIt]);
+            exitIt++;
+            continue;
+        }
+
+        std::uint32_t i = centerOrder[centerIt];
+        centerIt++;
+        double d = infos[i].distance;
+        if (d < minD || !isInSector(centerAngle * 180.0 / pi)) {
+            continue;
+        }
+        std::uint32_t index = infos[i].index;
+        PlanePoint p = toPlane(d, _heights[index], _params.hasRefraction);
+        double targetY;
+        if (_params.isTargetRelativeHeight) {
+            targetY = p.y + _params.objectHeight;
+        } else {
+            targetY = std::max(_params.objectHeight + p.dy, p.y + 1);
+        }
+        double targetK = (targetY - _radarY) / p.x;
+        float horizon = tree.maxBefore(i);
+
+        bool isVisible = targetK >= horizon && targetK >= mink && targetK <= maxk;
+        _cells[index] = isVisible ? ViewshedCell::Visible : ViewshedCell::Hidden;
+        double horizonY = std::max<double>(horizon, mink) * p.x + _radarY;
+        _minVisibleHeights[index] = float(std::max(0.0, horizonY - p.y));
+    }
+}
+}
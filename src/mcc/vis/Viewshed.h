@@ -0,0 +1,102 @@
+#pragma once
+
+#include "mcc/vis/Config.h"
+#include "mcc/vis/Rc.h"
+#include "mcc/vis/RadarParams.h"
+#include "mcc/hm/HmReader.h"
+#include "mcc/geo/LatLon.h"
+
+#include <bmcl/Option.h>
+
+#include <vector>
+#include <cstdint>
+
+namespace mccvis {
+
+enum class ViewshedCell : std::uint8_t {
+    OutOfRange = 0,
+    Hidden = 1,
+    Visible = 2,
+};
+
+// Visibility raster around an observer computed with a radial sweep line (van Kreveld).
+// Grid is regular in lat/lon, rows go from north to south, observer is in the central cell.
+class MCC_VIS_DECLSPEC Viewshed : public RefCountable {
+public:
+    Viewshed(const mccgeo::LatLon& observer, const ViewParams& params, double cellSize);
+    ~Viewshed();
+
+    void calculate(const mcchm::HmReader* reader);
+
+    std::size_t width() const
+    {
+        return _size;
+    }
+
+    std::size_t height() const
+    {
+        return _size;
+    }
+
+    double cellSize() const
+    {
+        return _cellSize;
+    }
+
+    double latStep() const
+    {
+        return _latStep;
+    }
+
+    double lonStep() const
+    {
+        return _lonStep;
+    }
+
+    double totalRadarHeight() const
+    {
+        return _radarY;
+    }
+
+    const mccgeo::LatLon& observer() const
+    {
+        return _observer;
+    }
+
+    const ViewParams& params() const
+    {
+        return _params;
+    }
+
+    const std::vector<ViewshedCell>& cells() const
+    {
+        return _cells;
+    }
+
+    const std::vector<float>& minVisibleHeights() const
+    {
+        return _minVisibleHeights;
+    }
+
+    mccgeo::LatLon cellCenter(std::size_t x, std::size_t y) const;
+    ViewshedCell cellAt(std::size_t x, std::size_t y) const;
+    bmcl::Option<ViewshedCell> cellAt(const mccgeo::LatLon& latLon) const;
+    float minVisibleHeightAt(std::size_t x, std::size_t y) const;
+
+private:
+    void readHeights(const mcchm::HmReader* reader);
+    void sweep();
+
+    std::vector<double> _heights;
+    std::vector<ViewshedCell> _cells;
+    std::vector<float> _minVisibleHeights;
+    ViewParams _params;
+    mccgeo::LatLon _observer;
+    double _cellSize;
+    double _latStep;
+    double _lonStep;
+    double _radarY;
+    std::size_t _radius;
+    std::size_t _size;
+};
+}
@@ -0,0 +1,585 @@
+#include "mcc/vis/XlsxWriter.h"
+
+#include <bmcl/Buffer.h>
+
+#include <QDateTime>
+#include <QString>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <map>
+
+namespace mccvis {
+
+static constexpr std::size_t pendingSize = 64 * 1024;
+static constexpr std::size_t chunkSize = 64 * 1024;
+
+static const char* mainNamespace = "http://schemas.openxmlformats.org/spreadsheetml/2006/main";
+static const char* relNamespace = "http://schemas.openxmlformats.org/officeDocument/2006/relationships";
+
+// Raw deflate stream of zip entry, input is buffered and compressed in chunks
+class XlsxDeflater {
+public:
+    XlsxDeflater()
+        : _crc(crc32(0, Z_NULL, 0))
+        , _size(0)
+        , _isFinished(false)
+    {
+        std::memset(&_stream, 0, sizeof(_stream));
+        // xml compresses well enough with fastest level
+        _isOk = deflateInit2(&_stream, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+        _pending.reserve(pendingSize);
+    }
+
+    ~XlsxDeflater()
+    {
+        deflateEnd(&_stream);
+    }
+
+    void write(bmcl::StringView str)
+    {
+        _pending.append(str.data(), str.size());
+        if (_pending.size() >= pendingSize) {
+            flush(Z_NO_FLUSH);
+        }
+    }
+
+    void write(char c)
+    {
+        _pending.push_back(c);
+    }
+
+    void finish()
+    {
+        if (!_isFinished) {
+            flush(Z_FINISH);
+            _isFinished = true;
+        }
+    }
+
+    bool isOk() const
+    {
+        return _isOk;
+    }
+
+    uint32_t crc() const
+    {
+        return _crc;
+    }
+
+    uint64_t size() const
+    {
+        return _size;
+    }
+
+    const bmcl::Buffer& compressed() const
+    {
+        return _compressed;
+    }
+
+private:
+    void flush(int mode)
+    {
+        if (!_isOk) {
+            _pending.clear();
+            return;
+        }
+        _crc = crc32(_crc, (const Bytef*)_pending.data(), _pending.size());
+        _size += _pending.size();
+        _stream.next_in = (Bytef*)_pending.data();
+        _stream.avail_in = _pending.size();
+        do {
+            std::size_t offset = _compressed.size();
+            _compressed.resize(offset + chunkSize);
+            _stream.next_out = _compressed.data() + offset;
+            _stream.avail_out = chunkSize;
+            if (deflate(&_stream, mode) == Z_STREAM_ERROR) {
+                _isOk = false;
+            }
+            _compressed.resize(offset + chunkSize - _stream.avail_out);
+        } while (_isOk && _stream.avail_out == 0);
+        _pending.clear();
+    }
+
+    z_stream _stream;
+    std::string _pending;
+    bmcl::Buffer _compressed;
+    uint32_t _crc;
+    uint64_t _size;
+    bool _isOk;
+    bool _isFinished;
+};
+
+static void writeEscaped(XlsxDeflater* dest, bmcl::StringView str)
+{
+    for (char c : str) {
+        switch (c) {
+        case '&':
+            dest->write("&amp;");
+            break;
+        case '<':
+            dest->write("&lt;");
+            break;
+        case '>':
+            dest->write("&gt;");
+            break;
+        case '"':
+            dest->write("&quot;");
+            break;
+        case '\t':
+        case '\n':
+        case '\r':
+            dest->write(c);
+            break;
+        default:
+            // other control characters are not allowed in xml
+            if ((unsigned char)c >= 0x20) {
+                dest->write(c);
+            }
+        }
+    }
+}
+
+static void writeNumber(XlsxDeflater* dest, uint64_t value)
+{
+    char buf[24];
+    int size = std::snprintf(buf, sizeof(buf), "%llu", (unsigned long long)value);
+    dest->write(bmcl::StringView(buf, size));
+}
+
+static void writeColumnName(XlsxDeflater* dest, std::size_t column)
+{
+    char buf[16];
+    std::size_t size = 0;
+    while (column > 0) {
+        column--;
+        buf[size++] = 'A' + column % 26;
+        column /= 26;
+    }
+    while (size) {
+        dest->write(buf[--size]);
+    }
+}
+
+XlsxSheet::XlsxSheet(const std::string& title)
+    : _title(title)
+    , _deflater(new XlsxDeflater)
+    , _frozenRows(0)
+    , _hasHeader(false)
+    , _hasRow(false)
+{
+}
+
+XlsxSheet::~XlsxSheet()
+{
+}
+
+void XlsxSheet::setHiddenColumn(std::size_t column)
+{
+    _hiddenColumns.push_back(column);
+}
+
+void XlsxSheet::setFrozenRows(std::size_t rows)
+{
+    _frozenRows = rows;
+}
+
+const std::string& XlsxSheet::title() const
+{
+    return _title;
+}
+
+void XlsxSheet::writeHeader()
+{
+    _hasHeader = true;
+    _deflater->write("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n<worksheet xmlns=\"");
+    _deflater->write(mainNamespace);
+    _deflater->write("\">");
+    if (_frozenRows) {
+        _deflater->write("<sheetViews><sheetView workbookViewId=\"0\"><pane ySplit=\"");
+        writeNumber(_deflater.get(), _frozenRows);
+        _deflater->write("\" topLeftCell=\"A");
+        writeNumber(_deflater.get(), _frozenRows + 1);
+        _deflater->write("\" activePane=\"bottomLeft\" state=\"frozen\"/></sheetView></sheetViews>");
+    }
+    if (!_hiddenColumns.empty()) {
+        std::sort(_hiddenColumns.begin(), _hiddenColumns.end());
+        _hiddenColumns.erase(std::unique(_hiddenColumns.begin(), _hiddenColumns.end()), _hiddenColumns.end());
+        _deflater->write("<cols>");
+        for (std::size_t column : _hiddenColumns) {
+            _deflater->write("<col min=\"");
+            writeNumber(_deflater.get(), column);
+            _deflater->write("\" max=\"");
+            writeNumber(_deflater.get(), column);
+            _deflater->write("\" width=\"9.140625\" hidden=\"1\" customWidth=\"1\"/>");
+        }
+        _deflater->write("</cols>");
+    }
+    _deflater->write("<sheetData>");
+}
+
+void XlsxSheet::beginRow(std::size_t row)
+{
+    if (!_hasHeader) {
+        writeHeader();
+    }
+    if (_hasRow) {
+        _deflater->write("</row>");
+    }
+    _hasRow = true;
+    _rowRef = std::to_string(row);
+    _deflater->write("<row r=\"");
+    _deflater->write(_rowRef);
+    _deflater->write("\">");
+}
+
+void XlsxSheet::beginCell(std::size_t column, std::size_t style)
+{
+    _deflater->write("<c r=\"");
+    writeColumnName(_deflater.get(), column);
+    _deflater->write(_rowRef);
+    _deflater->write('"');
+    if (style) {
+        _deflater->write(" s=\"");
+        writeNumber(_deflater.get(), style);
+        _deflater->write('"');
+    }
+}
+
+void XlsxSheet::addNumber(std::size_t column, double value, std::size_t style)
+{
+    if (!std::isfinite(value)) {
+        addEmpty(column, style);
+        return;
+    }
+    beginCell(column, style);
+    char buf[32];
+    int size = std::snprintf(buf, sizeof(buf), "%.15g", value);
+    // snprintf uses decimal separator of current locale
+    std::replace(buf, buf + size, ',', '.');
+    _deflater->write("><v>");
+    _deflater->write(bmcl::StringView(buf, size));
+    _deflater->write("</v></c>");
+}
+
+void XlsxSheet::addString(std::size_t column, bmcl::StringView value, std::size_t style)
+{
+    beginCell(column, style);
+    if (value.startsWith(" ") || value.endsWith(" ")) {
+        _deflater->write(" t=\"inlineStr\"><is><t xml:space=\"preserve\">");
+    } else {
+        _deflater->write(" t=\"inlineStr\"><is><t>");
+    }
+    writeEscaped(_deflater.get(), value);
+    _deflater->write("</t></is></c>");
+}
+
+void XlsxSheet::addEmpty(std::size_t column, std::size_t style)
+{
+    beginCell(column, style);
+    _deflater->write("/>");
+}
+
+void XlsxSheet::finish()
+{
+    if (!_hasHeader) {
+        writeHeader();
+    }
+    if (_hasRow) {
+        _deflater->write("</row>");
+        _hasRow = false;
+    }
+    _deflater->write("</sheetData></worksheet>");
+    _deflater->finish();
+}
+
+XlsxWriter::XlsxWriter()
+    : _hasErrors(false)
+{
+    _styles.emplace_back();
+    QDateTime now = QDateTime::currentDateTime();
+    QDate date = now.date();
+    QTime time = now.time();
+    _dosTime = (time.hour() << 11) | (time.minute() << 5) | (time.second() / 2);
+    _dosDate = ((std::max(date.year(), 1980) - 1980) << 9) | (date.month() << 5) | date.day();
+}
+
+XlsxWriter::~XlsxWriter()
+{
+}
+
+std::size_t XlsxWriter::addStyle(const XlsxStyle& style)
+{
+    _styles.push_back(style);
+    return _styles.size() - 1;
+}
+
+bool XlsxWriter::open(const QString& path)
+{
+    _file.setFileName(path);
+    _entries.clear();
+    _sheets.clear();
+    _hasErrors = !_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    return !_hasErrors;
+}
+
+bool XlsxWriter::writeEntry(const std::string& name, XlsxDeflater* deflater)
+{
+    const bmcl::Buffer& data = deflater->compressed();
+    // no zip64 support
+    const uint64_t maxSize = std::numeric_limits<uint32_t>::max();
+    uint64_t offset = _file.pos();
+    if (!deflater->isOk() || deflater->size() > maxSize || data.size() > maxSize || offset > maxSize) {
+        _hasErrors = true;
+        return false;
+    }
+
+    Entry entry;
+    entry.name = name;
+    entry.crc = deflater->crc();
+    entry.compressedSize = data.size();
+    entry.size = deflater->size();
+    entry.offset = offset;
+
+    bmcl::Buffer header;
+    header.writeUint32Le(0x04034b50);
+    header.writeUint16Le(20);
+    header.writeUint16Le(0);
+    header.writeUint16Le(Z_DEFLATED);
+    header.writeUint16Le(_dosTime);
+    header.writeUint16Le(_dosDate);
+    header.writeUint32Le(entry.crc);
+    header.writeUint32Le(entry.compressedSize);
+    header.writeUint32Le(entry.size);
+    header.writeUint16Le(name.size());
+    header.writeUint16Le(0);
+    header.write(name.data(), name.size());
+
+    if (_file.write((const char*)header.data(), header.size()) != qint64(header.size())
+        || _file.write((const char*)data.data(), data.size()) != qint64(data.size())) {
+        _hasErrors = true;
+        return false;
+    }
+    _entries.push_back(std::move(entry));
+    return true;
+}
+
+bool XlsxWriter::writeEntry(const std::string& name, bmcl::StringView data)
+{
+    XlsxDeflater deflater;
+    deflater.write(data);
+    deflater.finish();
+    return writeEntry(name, &deflater);
+}
+
+bool XlsxWriter::addSheet(std::size_t position, XlsxSheet* sheet)
+{
+    sheet->finish();
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_hasErrors) {
+        return false;
+    }
+    std::size_t index = _sheets.size() + 1;
+    if (!writeEntry("xl/worksheets/sheet" + std::to_string(index) + ".xml", sheet->_deflater.get())) {
+        return false;
+    }
+    // compressed data is no longer needed
+    sheet->_deflater.reset();
+    _sheets.push_back(SheetInfo{position, index, sheet->title()});
+    return true;
+}
+
+static void appendEscaped(std::string* dest, bmcl::StringView str)
+{
+    for (char c : str) {
+        switch (c) {
+        case '&':
+            dest->append("&amp;");
+            break;
+        case '<':
+            dest->append("&lt;");
+            break;
+        case '>':
+            dest->append("&gt;");
+            break;
+        case '"':
+            dest->append("&quot;");
+            break;
+        default:
+            if ((unsigned char)c >= 0x20) {
+                dest->push_back(c);
+            }
+        }
+    }
+}
+
+static std::string argbToString(uint32_t argb)
+{
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "%08X", argb);
+    return buf;
+}
+
+std::string XlsxWriter::stylesXml() const
+{
+    std::map<std::string, std::size_t> numFmts;
+    std::vector<uint32_t> fills;
+    std::string cellXfs;
+    for (const XlsxStyle& style : _styles) {
+        std::size_t numFmtId = 0;
+        if (!style.numberFormat.empty()) {
+            auto it = numFmts.emplace(style.numberFormat, 164 + numFmts.size()).first;
+            numFmtId = it->second;
+        }
+        std::size_t fillId = 0;
+        if (style.fillArgb.isSome()) {
+            fills.push_back(style.fillArgb.unwrap());
+            fillId = fills.size() + 1;
+        }
+        cellXfs += "<xf numFmtId=\"" + std::to_string(numFmtId) + "\" fontId=\"0\" fillId=\"" + std::to_string(fillId)
+            + "\" borderId=\"" + (style.hasBorder ? "1" : "0") + "\" xfId=\"0\"";
+        if (numFmtId) {
+            cellXfs += " applyNumberFormat=\"1\"";
+        }
+        if (fillId) {
+            cellXfs += " applyFill=\"1\"";
+        }
+        if (style.hasBorder) {
+            cellXfs += " applyBorder=\"1\"";
+        }
+        if (style.isRightAligned) {
+            cellXfs += " applyAlignment=\"1\"><alignment horizontal=\"right\"/></xf>";
+        } else {
+            cellXfs += "/>";
+        }
+    }
+
+    std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n<styleSheet xmlns=\"";
+    xml += mainNamespace;
+    xml += "\">";
+    if (!numFmts.empty()) {
+        xml += "<numFmts count=\"" + std::to_string(numFmts.size()) + "\">";
+        for (const auto& fmt : numFmts) {
+            xml += "<numFmt numFmtId=\"" + std::to_string(fmt.second) + "\" formatCode=\"";
+            appendEscaped(&xml, fmt.first);
+            xml += "\"/>";
+        }
+        xml += "</numFmts>";
+    }
+    xml += "<fonts count=\"1\"><font><sz val=\"11\"/><name val=\"Calibri\"/><family val=\"2\"/></font></fonts>";
+    xml += "<fills count=\"" + std::to_string(fills.size() + 2) + "\">";
+    xml += "<fill><patternFill patternType=\"none\"/></fill><fill><patternFill patternType=\"gray125\"/></fill>";
+    for (uint32_t argb : fills) {
+        xml += "<fill><patternFill patternType=\"solid\"><fgColor rgb=\"" + argbToString(argb) + "\"/><bgColor indexed=\"64\"/></patternFill></fill>";
+    }
+    xml += "</fills>";
+    xml += "<borders count=\"2\"><border><left/><right/><top/><bottom/><diagonal/></border><border>";
+    for (const char* side : {"left", "right", "top", "bottom"}) {
+        xml += std::string("<") + side + " style=\"thin\"><color rgb=\"FF000000\"/></" + side + ">";
+    }
+    xml += "<diagonal/></border></borders>";
+    xml += "<cellStyleXfs count=\"1\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\"/></cellStyleXfs>";
+    xml += "<cellXfs count=\"" + std::to_string(_styles.size()) + "\">" + cellXfs + "</cellXfs>";
+    xml += "<cellStyles count=\"1\"><cellStyle name=\"Normal\" xfId=\"0\" builtinId=\"0\"/></cellStyles>";
+    xml += "</styleSheet>";
+    return xml;
+}
+
+bool XlsxWriter::close()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_file.isOpen()) {
+        return false;
+    }
+    std::stable_sort(_sheets.begin(), _sheets.end(), [](const SheetInfo& left, const SheetInfo& right) {
+        return left.position < right.position;
+    });
+
+    const char* header = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n";
+    std::string contentTypes = header;
+    contentTypes += "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+                    "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+                    "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+                    "<Override PartName=\"/xl/workbook.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>"
+                    "<Override PartName=\"/xl/styles.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.styles+xml\"/>";
+    std::string workbook = header;
+    workbook += "<workbook xmlns=\"";
+    workbook += mainNamespace;
+    workbook += "\" xmlns:r=\"";
+    workbook += relNamespace;
+    workbook += "\"><sheets>";
+    std::string workbookRels = header;
+    workbookRels += "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">";
+    for (std::size_t i = 0; i < _sheets.size(); i++) {
+        std::string index = std::to_string(_sheets[i].index);
+        contentTypes += "<Override PartName=\"/xl/worksheets/sheet" + index
+            + ".xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>";
+        workbook += "<sheet name=\"";
+        appendEscaped(&workbook, _sheets[i].title);
+        workbook += "\" sheetId=\"" + std::to_string(i + 1) + "\" r:id=\"rId" + index + "\"/>";
+        workbookRels += "<Relationship Id=\"rId" + index + "\" Type=\"" + relNamespace
+            + "/worksheet\" Target=\"worksheets/sheet" + index + ".xml\"/>";
+    }
+    contentTypes += "</Types>";
+    workbook += "</sheets></workbook>";
+    workbookRels += "<Relationship Id=\"rId" + std::to_string(_sheets.size() + 1) + "\" Type=\"" + relNamespace
+        + "/styles\" Target=\"styles.xml\"/></Relationships>";
+    std::string rootRels = header;
+    rootRels += "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+                "<Relationship Id=\"rId1\" Type=\"";
+    rootRels += relNamespace;
+    rootRels += "/officeDocument\" Target=\"xl/workbook.xml\"/></Relationships>";
+
+    writeEntry("[Content_Types].xml", contentTypes);
+    writeEntry("_rels/.rels", rootRels);
+    writeEntry("xl/workbook.xml", workbook);
+    writeEntry("xl/_rels/workbook.xml.rels", workbookRels);
+    writeEntry("xl/styles.xml", stylesXml());
+
+    uint64_t centralOffset = _file.pos();
+    bmcl::Buffer central;
+    for (const Entry& entry : _entries) {
+        central.writeUint32Le(0x02014b50);
+        central.writeUint16Le(20);
+        central.writeUint16Le(20);
+        central.writeUint16Le(0);
+        central.writeUint16Le(Z_DEFLATED);
+        central.writeUint16Le(_dosTime);
+        central.writeUint16Le(_dosDate);
+        central.writeUint32Le(entry.crc);
+        central.writeUint32Le(entry.compressedSize);
+        central.writeUint32Le(entry.size);
+        central.writeUint16Le(entry.name.size());
+        central.writeUint16Le(0);
+        central.writeUint16Le(0);
+        central.writeUint16Le(0);
+        central.writeUint16Le(0);
+        central.writeUint32Le(0);
+        central.writeUint32Le(entry.offset);
+        central.write(entry.name.data(), entry.name.size());
+    }
+    uint64_t centralSize = central.size();
+    if (_entries.size() > std::numeric_limits<uint16_t>::max() || centralOffset > std::numeric_limits<uint32_t>::max()) {
+        _hasErrors = true;
+    }
+    central.writeUint32Le(0x06054b50);
+    central.writeUint16Le(0);
+    central.writeUint16Le(0);
+    central.writeUint16Le(_entries.size());
+    central.writeUint16Le(_entries.size());
+    central.writeUint32Le(centralSize);
+    central.writeUint32Le(centralOffset);
+    central.writeUint16Le(0);
+
+    if (_file.write((const char*)central.data(), central.size()) != qint64(central.size())) {
+        _hasErrors = true;
+    }
+    _file.close();
+    return !_hasErrors;
+}
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <bmcl/Option.h>
+#include <bmcl/StringView.h>
+
+#include <QFile>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class QString;
+
+namespace mccvis {
+
+class XlsxDeflater;
+
+struct XlsxStyle {
+    XlsxStyle()
+        : hasBorder(false)
+        , isRightAligned(false)
+    {
+    }
+
+    std::string numberFormat;
+    bmcl::Option<uint32_t> fillArgb;
+    bool hasBorder;
+    bool isRightAligned;
+};
+
+// Worksheet that is compressed while rows are added, only deflated xml is kept in memory.
+// Rows and cells must be added in increasing order, rows and columns are 1-based
+class XlsxSheet {
+public:
+    explicit XlsxSheet(const std::string& title);
+    ~XlsxSheet();
+
+    // must be called before first row
+    void setHiddenColumn(std::size_t column);
+    void setFrozenRows(std::size_t rows);
+
+    void beginRow(std::size_t row);
+    void addNumber(std::size_t column, double value, std::size_t style = 0);
+    void addString(std::size_t column, bmcl::StringView value, std::size_t style = 0);
+    void addEmpty(std::size_t column, std::size_t style);
+
+    const std::string& title() const;
+
+private:
+    friend class XlsxWriter;
+
+    void beginCell(std::size_t column, std::size_t style);
+    void writeHeader();
+    void finish();
+
+    std::string _title;
+    std::unique_ptr<XlsxDeflater> _deflater;
+    std::vector<std::size_t> _hiddenColumns;
+    std::string _rowRef;
+    std::size_t _frozenRows;
+    bool _hasHeader;
+    bool _hasRow;
+};
+
+// Minimal xlsx writer: sheets are appended to zip file as soon as they are finished,
+// so they can be filled in parallel and memory usage does not depend on total cell count.
+// Styles are shared by all sheets and must be added before first sheet
+class XlsxWriter {
+public:
+    XlsxWriter();
+    ~XlsxWriter();
+
+    // returns style index for cells, 0 is default style
+    std::size_t addStyle(const XlsxStyle& style);
+
+    bool open(const QString& path);
+    // thread safe, position is sheet index in workbook. Sheet can not be modified after it is added
+    bool addSheet(std::size_t position, XlsxSheet* sheet);
+    bool close();
+
+private:
+    struct Entry {
+        std::string name;
+        uint32_t crc;
+        uint32_t compressedSize;
+        uint32_t size;
+        uint32_t offset;
+    };
+
+    struct SheetInfo {
+        std::size_t position;
+        std::size_t index;
+        std::string title;
+    };
+
+    bool writeEntry(const std::string& name, XlsxDeflater* deflater);
+    bool writeEntry(const std::string& name, bmcl::StringView data);
+    std::string stylesXml() const;
+
+    QFile _file;
+    std::mutex _mutex;
+    std::vector<XlsxStyle> _styles;
+    std::vector<Entry> _entries;
+    std::vector<SheetInfo> _sheets;
+    uint16_t _dosTime;
+    uint16_t _dosDate;
+    bool _hasErrors;
+};
+}
@@ -0,0 +1,232 @@
+#include "mcc/vis/Viewshed.h"
+#include "mcc/vis/Profile.h"
+#include "mcc/vis/Radar.h"
+#include "mcc/vis/RadarParams.h"
+#include "mcc/hm/SrtmReader.h"
+#include "mcc/hm/OmhmReader.h"
+#include "mcc/geo/LatLon.h"
+#include "mcc/geo/Geod.h"
+#include "mcc/geo/Constants.h"
+
+#include <bmcl/Result.h>
+
+#include <tclap/CmdLine.h>
+
+#include <QGuiApplication>
+#include <QImage>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include <chrono>
+#include <iostream>
+
+using namespace mccvis;
+
+static bool saveWorldFile(const Viewshed* vs, const QString& imagePath)
+{
+    QFileInfo info(imagePath);
+    QString path = info.path() + "/" + info.completeBaseName() + ".pgw";
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        return false;
+    }
+    mccgeo::LatLon topLeft = vs->cellCenter(0, 0);
+    QTextStream out(&file);
+    out.setRealNumberPrecision(12);
+    out << vs->lonStep() << "\n0\n0\n" << -vs->latStep() << "\n"
+        << topLeft.longitude() << "\n" << topLeft.latitude() << "\n";
+    return true;
+}
+
+static bool saveImage(const Viewshed* vs, const QString& path)
+{
+    QImage img(vs->width(), vs->height(), QImage::Format_Indexed8);
+    img.setColorCount(3);
+    img.setColor((int)ViewshedCell::OutOfRange, qRgba(0, 0, 0, 0));
+    img.setColor((int)ViewshedCell::Hidden, qRgba(251, 154, 153, 255));
+    img.setColor((int)ViewshedCell::Visible, qRgba(178, 223, 138, 255));
+    const ViewshedCell* cells = vs->cells().data();
+    for (std::size_t y = 0; y < vs->height(); y++) {
+        uchar* line = img.scanLine(y);
+        for (std::size_t x = 0; x < vs->width(); x++) {
+            line[x] = (uchar)cells[y * vs->width() + x];
+        }
+    }
+    return img.save(path) && saveWorldFile(vs, path);
+}
+
+static bool saveMinHeights(const Viewshed* vs, const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        return false;
+    }
+    mccgeo::LatLon bottomLeft = vs->cellCenter(0, vs->height() - 1);
+    QTextStream out(&file);
+    out.setRealNumberPrecision(12);
+    out << "ncols " << vs->width() << "\n";
+    out << "nrows " << vs->height() << "\n";
+    out << "xllcenter " << bottomLeft.longitude() << "\n";
+    out << "yllcenter " << bottomLeft.latitude() << "\n";
+    out << "dx " << vs->lonStep() << "\n";
+    out << "dy " << vs->latStep() << "\n";
+    out << "nodata_value -9999\n";
+    out.setRealNumberPrecision(6);
+    for (std::size_t y = 0; y < vs->height(); y++) {
+        for (std::size_t x = 0; x < vs->width(); x++) {
+            float h = vs->minVisibleHeightAt(x, y);
+            if (std::isnan(h)) {
+                out << "-9999 ";
+            } else {
+                out << h << " ";
+            }
+        }
+        out << "\n";
+    }
+    return true;
+}
+
+// compares raster with Profile vision intervals on evenly spaced azimuths
+static void checkLines(const Viewshed* vs, const mcchm::HmReader* reader, std::size_t count)
+{
+    const ViewParams& params = vs->params();
+    const mccgeo::Geod* geod = reader->geod();
+    constexpr mccgeo::GeodMask mask = mccgeo::GeodMask::Latitude | mccgeo::GeodMask::Longitude | mccgeo::GeodMask::DistanceIn;
+
+    std::size_t total = 0;
+    std::size_t matched = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        double azimuth = params.minAzimuth + (params.maxAzimuth - params.minAzimuth) * i / count;
+        mccgeo::LatLon end;
+        geod->direct(vs->observer(), azimuth, params.maxBeamDistance, &end, 0);
+        PointVector slice = reader->relativePointProfile(vs->observer(), end, vs->cellSize());
+        Rc<Profile> profile = new Profile(azimuth, slice, params);
+
+        std::size_t lineTotal = 0;
+        std::size_t lineMatched = 0;
+        mccgeo::GeodLine line(*geod, vs->observer(), azimuth, mask);
+        for (const Point& sample : slice) {
+            if (sample.x() < std::max(vs->cellSize(), params.minBeamDistance)) {
+                continue;
+            }
+            mccgeo::LatLon latLon;
+            line.position(sample.x(), &latLon, 0);
+            bmcl::Option<ViewshedCell> cell = vs->cellAt(latLon);
+            if (cell.isNone() || cell.unwrap() == ViewshedCell::OutOfRange) {
+                continue;
+            }
+            bool isVisibleInProfile = false;
+            for (const Interval& interval : profile->horizontalVisionIntervals()) {
+                if (sample.x() >= interval.start() && sample.x() <= interval.end()) {
+                    isVisibleInProfile = true;
+                    break;
+                }
+            }
+            lineTotal++;
+            if (isVisibleInProfile == (cell.unwrap() == ViewshedCell::Visible)) {
+                lineMatched++;
+            }
+        }
+        total += lineTotal;
+        matched += lineMatched;
+        std::cout << "azimuth " << azimuth << ": " << lineMatched << "/" << lineTotal << " samples match" << std::endl;
+    }
+    if (total != 0) {
+        std::cout << "total: " << matched << "/" << total << " (" << 100.0 * matched / total << "%)" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    QGuiApplication app(argc, argv);
+
+    TCLAP::CmdLine cmdLine("mcc viewshed");
+    TCLAP::ValueArg<std::string> srtmPathArg("", "srtm-path", "Srtm path", false, "", "path");
+    TCLAP::ValueArg<std::string> omhmPathArg("", "omhm", "Omhm heightmap file", false, "", "path");
+    TCLAP::ValueArg<std::string> radarArg("", "radar", "Radar file with position and view params", false, "", "path");
+    TCLAP::ValueArg<double> latArg("", "lat", "Latitude", false, 0.0, "degrees");
+    TCLAP::ValueArg<double> lonArg("", "lon", "Longitude", false, 0.0, "degrees");
+    TCLAP::ValueArg<double> radiusArg("", "radius", "Max beam distance", false, 60000, "meters");
+    TCLAP::ValueArg<double> heightArg("", "height", "Radar height", false, 5, "meters");
+    TCLAP::ValueArg<double> objectHeightArg("", "object-height", "Target height", false, 50, "meters");
+    TCLAP::ValueArg<double> cellArg("", "cell-size", "Raster cell size", false, 30, "meters");
+    TCLAP::SwitchArg refractionArg("", "refraction", "Use standard refraction");
+    TCLAP::ValueArg<std::string> outputArg("o", "output", "Output image (with .pgw world file)", true, "", "path");
+    TCLAP::ValueArg<std::string> minHeightArg("", "min-height", "Output ascii grid with min visible heights", false, "", "path");
+    TCLAP::ValueArg<unsigned> checkArg("", "check-lines", "Compare with profiles on given number of azimuths", false, 0, "count");
+
+    cmdLine.add(&srtmPathArg);
+    cmdLine.add(&omhmPathArg);
+    cmdLine.add(&radarArg);
+    cmdLine.add(&latArg);
+    cmdLine.add(&lonArg);
+    cmdLine.add(&radiusArg);
+    cmdLine.add(&heightArg);
+    cmdLine.add(&objectHeightArg);
+    cmdLine.add(&cellArg);
+    cmdLine.add(&refractionArg);
+    cmdLine.add(&outputArg);
+    cmdLine.add(&minHeightArg);
+    cmdLine.add(&checkArg);
+    cmdLine.parse(argc, argv);
+
+    mcchm::Rc<mcchm::RcGeod> geod = new mcchm::RcGeod(mccgeo::wgs84a<double>(), mccgeo::wgs84f<double>());
+    mcchm::Rc<const mcchm::HmReader> reader;
+    if (omhmPathArg.isSet()) {
+        auto rv = mcchm::OmhmReader::create(geod.get(), QString::fromStdString(omhmPathArg.getValue()));
+        if (rv.isErr()) {
+            std::cerr << "failed to open heightmap: " << rv.unwrapErr().toStdString() << std::endl;
+            return -1;
+        }
+        reader = rv.unwrap().get();
+    } else if (srtmPathArg.isSet()) {
+        reader = new mcchm::SrtmReader(geod.get(), QString::fromStdString(srtmPathArg.getValue()));
+    } else {
+        std::cerr << "no heightmap specified" << std::endl;
+        return -1;
+    }
+
+    ViewParams params;
+    mccgeo::LatLon position;
+    if (radarArg.isSet()) {
+        auto rv = Radar::loadFrom(QString::fromStdString(radarArg.getValue()));
+        if (rv.isErr()) {
+            std::cerr << "failed to load radar" << std::endl;
+            return -1;
+        }
+        params = rv.unwrap()->viewParams();
+        position = rv.unwrap()->position();
+    } else {
+        params.maxBeamDistance = radiusArg.getValue();
+        params.radarHeight = heightArg.getValue();
+        params.objectHeight = objectHeightArg.getValue();
+        params.hasRefraction = refractionArg.getValue();
+    }
+    if (latArg.isSet()) {
+        position.latitude() = latArg.getValue();
+    }
+    if (lonArg.isSet()) {
+        position.longitude() = lonArg.getValue();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Rc<Viewshed> viewshed = new Viewshed(position, params, cellArg.getValue());
+    viewshed->calculate(reader.get());
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "viewshed " << viewshed->width() << "x" << viewshed->height() << " calculated in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << std::endl;
+
+    if (!saveImage(viewshed.get(), QString::fromStdString(outputArg.getValue()))) {
+        std::cerr << "failed to save image" << std::endl;
+        return -1;
+    }
+    if (minHeightArg.isSet() && !saveMinHeights(viewshed.get(), QString::fromStdString(minHeightArg.getValue()))) {
+        std::cerr << "failed to save min heights" << std::endl;
+        return -1;
+    }
+    if (checkArg.getValue() != 0) {
+        checkLines(viewshed.get(), reader.get(), checkArg.getValue());
+    }
+    return 0;
+}
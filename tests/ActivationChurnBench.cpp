@@ -0,0 +1,317 @@
+#include "broker/Broker.h"
+
+#include "mcc/msg/obj/Channel.h"
+#include "mcc/msg/obj/Protocol.h"
+#include "mcc/msg/ptr/Channel.h"
+#include "mcc/msg/ptr/Device.h"
+#include "mcc/msg/ptr/NoteVisitor.h"
+#include "mcc/msg/ptr/ReqVisitor.h"
+#include "mcc/net/NetLoggerInf.h"
+
+#include <caf/actor_system.hpp>
+#include <caf/actor_system_config.hpp>
+#include <caf/event_based_actor.hpp>
+#include <caf/scoped_actor.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::DbReqPtr)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::Device)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::NotificationPtr)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::ProtocolId)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::channel::DescriptionList_ResponsePtr)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::device::Activate_ResponsePtr)
+
+// Toggles activation of devices in mavlink broker and stops half of device actors. Broker tells every device
+// actor about each change of active list, so cost of churn grows with number of devices. Each phase ends when
+// every device actor answered request routed through broker, by then it handled all changes sent before it
+
+using device_down_atom = caf::atom_constant<caf::atom("devdown")>;
+
+static constexpr std::size_t devicesCount = 500;
+static constexpr std::size_t togglesCount = 2000;
+
+// notes and telemetry of devices are dropped without reply, caf::drop would answer them with error
+static caf::result<caf::message> dropQuietly(caf::scheduled_actor* self, caf::message_view&)
+{
+    if (self->current_message_id().is_request())
+        return caf::sec::unexpected_message;
+    return caf::make_message();
+}
+
+// db of stub knows only channel all devices are connected to, other requests fail as for unknown objects
+class CoreReqVisitor : public mccmsg::ReqVisitor
+{
+public:
+    CoreReqVisitor(caf::event_based_actor* self, const mccmsg::ChannelDescription& channel)
+        : mccmsg::ReqVisitor([self](const mccmsg::DbReq*) { self->response(caf::sec::unexpected_message); })
+        , _self(self), _channel(channel)
+    {
+    }
+
+    using mccmsg::ReqVisitor::visit;
+
+    void visit(const mccmsg::channel::DescriptionList_Request* msg) override
+    {
+        _self->response(mccmsg::make<mccmsg::channel::DescriptionList_Response>(msg, mccmsg::ChannelDescriptions{_channel}));
+    }
+
+private:
+    caf::event_based_actor* _self;
+    mccmsg::ChannelDescription _channel;
+};
+
+// broker reports stopped device actors only with log
+class CoreNoteVisitor : public mccmsg::NoteVisitor
+{
+public:
+    CoreNoteVisitor(caf::event_based_actor* self, const caf::actor& waiter, const std::string& broker)
+        : _self(self), _waiter(waiter), _broker(broker)
+    {
+    }
+
+    using mccmsg::NoteVisitor::visit;
+
+    void visit(const mccmsg::tm::Log* msg) override
+    {
+        if (msg->data().sender() == _broker && msg->data().device().isSome())
+            _self->send(_waiter, device_down_atom::value, msg->data().device().unwrap());
+    }
+
+private:
+    caf::event_based_actor* _self;
+    caf::actor _waiter;
+    std::string _broker;
+};
+
+// stands for core and logger of broker
+caf::behavior coreStub(caf::event_based_actor* self, const caf::actor& waiter, const mccmsg::ChannelDescription& channel, const std::string& broker)
+{
+    self->set_default_handler(dropQuietly);
+    return
+    {
+        [=](const mccmsg::DbReqPtr& msg)
+        {
+            CoreReqVisitor visitor(self, channel);
+            msg->visit(visitor);
+            return caf::delegated<mccmsg::ResponsePtr>();
+        }
+      , [=](const mccmsg::NotificationPtr& msg)
+        {
+            CoreNoteVisitor visitor(self, waiter, broker);
+            msg->visit(visitor);
+        }
+    };
+}
+
+// device actors register in group actor, bench keeps them to stop some of them
+caf::behavior groupStub(caf::event_based_actor* self, const caf::actor& waiter)
+{
+    self->set_default_handler(dropQuietly);
+    return
+    {
+        [=](mccnet::group_dev, const mccmsg::ProtocolId& id, const caf::actor& device)
+        {
+            self->send(waiter, id, device);
+        }
+    };
+}
+
+struct Vehicle
+{
+    mccmsg::Device name;
+    caf::actor actor;
+    bool isActive;
+    bool isStopped;
+};
+
+class Bench
+{
+public:
+    explicit Bench(caf::actor_system& system)
+        : _self(system), _changes(0)
+    {
+    }
+
+    // device actor reports activation to broker this way after its firmware is registered
+    void setActive(Vehicle& v, bool state)
+    {
+        _self->send(_broker, mccnet::activated_atom::value, v.name, state);
+        if (v.isActive == state)
+            return;
+        v.isActive = state;
+        // broker sends change to device actors it knows
+        for (const Vehicle& w : _vehicles)
+        {
+            if (!w.isStopped)
+                _changes++;
+        }
+    }
+
+    bool start()
+    {
+        auto protocol = mccmsg::Protocol::generate();
+        mccmsg::ProtocolDescription dscr = new mccmsg::ProtocolDescriptionObj(protocol, false, false, std::chrono::milliseconds(1000)
+            , "churn", "", bmcl::Buffer(), mccmsg::PropertyDescriptionPtrs(), mccmsg::PropertyDescriptionPtrs());
+        mccmsg::ProtocolIds ids;
+        for (std::size_t i = 0; i < devicesCount; i++)
+            ids.emplace_back(mccmsg::Device::generate(), protocol, i + 1);
+        mccmsg::INetPtr net = new mccmsg::NetUdpParams("127.0.0.1", bmcl::None, bmcl::None);
+        mccmsg::ChannelDescription channel = new mccmsg::ChannelDescriptionObj(mccmsg::Channel::generate(), protocol, "churn", net, false
+            , std::chrono::milliseconds(100), false, false, bmcl::None, bmcl::None, ids);
+
+        caf::actor waiter = caf::actor_cast<caf::actor>(_self);
+        _core = _self->spawn(coreStub, waiter, channel, "net.churn.broker");
+        _group = _self->spawn(groupStub, waiter);
+        _broker = _self->spawn<mccmav::Broker>(_core, _core, _group, dscr);
+        _self->monitor(_broker);
+
+        bool isOk = true;
+        for (std::size_t i = 0; i < devicesCount && isOk; i++)
+        {
+            _self->receive(
+                [&](const mccmsg::ProtocolId& id, const caf::actor& a)
+                {
+                    _vehicles.push_back(Vehicle{id.device(), a, false, false});
+                }
+              , caf::after(std::chrono::seconds(10)) >> [&]()
+                {
+                    isOk = false;
+                }
+            );
+        }
+        return isOk;
+    }
+
+    // device actors answer in order, stopped ones are already unknown to broker
+    bool sync()
+    {
+        std::size_t answered = 0;
+        std::size_t unknown = 0;
+        for (const Vehicle& v : _vehicles)
+        {
+            _self->request(_broker, caf::infinite, mccmsg::makeReq(new mccmsg::device::Activate_Request(v.name, false))).receive(
+                [&](const mccmsg::device::Activate_ResponsePtr&)
+                {
+                    answered += v.isStopped ? 0 : 1;
+                }
+              , [&](const caf::error& e)
+                {
+                    unknown += (v.isStopped && e == caf::sec::request_receiver_down) ? 1 : 0;
+                }
+            );
+        }
+        return answered + unknown == _vehicles.size();
+    }
+
+    bool churn()
+    {
+        std::mt19937 gen(1);
+        for (std::size_t t = 0; t < togglesCount; t++)
+        {
+            Vehicle& v = _vehicles[gen() % _vehicles.size()];
+            setActive(v, !v.isActive);
+        }
+        for (Vehicle& v : _vehicles)
+            setActive(v, false);
+        return sync();
+    }
+
+    bool stopHalf()
+    {
+        for (Vehicle& v : _vehicles)
+            setActive(v, true);
+        std::size_t stopped = 0;
+        for (std::size_t i = 0; i < _vehicles.size(); i += 2)
+        {
+            _self->send_exit(_vehicles[i].actor, caf::exit_reason::user_shutdown);
+            _vehicles[i].isStopped = true;
+            stopped++;
+            for (const Vehicle& w : _vehicles)
+            {
+                if (!w.isStopped)
+                    _changes++;
+            }
+        }
+
+        bool isOk = true;
+        for (std::size_t i = 0; i < stopped && isOk; i++)
+        {
+            _self->receive(
+                [&](device_down_atom, const mccmsg::Device&) {}
+              , caf::after(std::chrono::seconds(10)) >> [&]()
+                {
+                    isOk = false;
+                }
+            );
+        }
+        for (Vehicle& v : _vehicles)
+        {
+            if (!v.isStopped)
+                setActive(v, false);
+        }
+        return isOk && sync();
+    }
+
+    void stop()
+    {
+        _self->send_exit(_broker, caf::exit_reason::user_shutdown);
+        _self->receive([](const caf::down_msg&) {});
+        _self->send_exit(_core, caf::exit_reason::user_shutdown);
+        _self->send_exit(_group, caf::exit_reason::user_shutdown);
+    }
+
+    std::size_t changes() const
+    {
+        return _changes;
+    }
+
+private:
+    caf::scoped_actor _self;
+    caf::actor _core;
+    caf::actor _group;
+    caf::actor _broker;
+    std::vector<Vehicle> _vehicles;
+    std::size_t _changes;
+};
+
+template<typename F>
+static double measure(F&& f, bool* isOk)
+{
+    auto start = std::chrono::steady_clock::now();
+    *isOk &= f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    caf::actor_system_config cfg;
+    caf::actor_system system{cfg};
+
+    bool isOk = true;
+    double churnTime = 0;
+    double downTime = 0;
+    std::size_t churnChanges = 0;
+    std::size_t downChanges = 0;
+    {
+        Bench bench(system);
+        isOk = bench.start();
+        if (isOk)
+        {
+            churnTime = measure([&]() { return bench.churn(); }, &isOk);
+            churnChanges = bench.changes();
+            downTime = measure([&]() { return bench.stopHalf(); }, &isOk);
+            downChanges = bench.changes() - churnChanges;
+        }
+        bench.stop();
+    }
+
+    std::printf("%zu devices, %zu toggles\n", devicesCount, togglesCount);
+    std::printf("%-12s %8.3f s, %8zu active list messages\n", "churn", churnTime, churnChanges);
+    std::printf("%-12s %8.3f s, %8zu active list messages\n", "device down", downTime, downChanges);
+    std::printf("%s\n", isOk ? "OK" : "FAILED");
+    return isOk ? 0 : 1;
+}
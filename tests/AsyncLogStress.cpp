@@ -0,0 +1,80 @@
+#include "mcc/net/AsyncLog.h"
+
+#include <bmcl/Logging.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::size_t countLines(std::FILE* file)
+{
+    std::rewind(file);
+    std::size_t lines = 0;
+    char buf[64 * 1024];
+    std::size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), file)) != 0) {
+        for (std::size_t i = 0; i < n; i++) {
+            lines += buf[i] == '\n';
+        }
+    }
+    return lines;
+}
+
+// messagesCount messages are logged from threadsCount threads, returns false if some message is lost
+static bool run(const char* name, bmcl::LogLevel level, std::size_t messagesCount, std::size_t threadsCount)
+{
+    std::FILE* file = std::tmpfile();
+    if (!file) {
+        std::printf("could not create temporary file\n");
+        return false;
+    }
+    mccnet::AsyncLog::Stats stats;
+    double producerTime;
+    {
+        mccnet::AsyncLog log(file, false);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < threadsCount; t++) {
+            threads.emplace_back([&log, level, t, messagesCount, threadsCount]() {
+                std::string msg = "device " + std::to_string(t) + " reports something unusual, message ";
+                std::size_t prefixSize = msg.size();
+                for (std::size_t i = t; i < messagesCount; i += threadsCount) {
+                    msg.resize(prefixSize);
+                    msg += std::to_string(i);
+                    log.push(level, t, msg);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        producerTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        log.flush();
+        stats = log.stats();
+    }
+    // overload reports are written as separate lines
+    std::size_t lines = countLines(file);
+    std::fclose(file);
+
+    bool isOk = stats.written + stats.dropped == messagesCount && lines >= stats.written;
+    if ((int)level <= (int)bmcl::LogLevel::Critical) {
+        isOk &= stats.dropped == 0;
+    }
+    std::printf("%-9s %zu messages: %.1f ns/message in producers, written %zu, dropped %zu, lines %zu %s\n", name,
+                messagesCount, producerTime / messagesCount, stats.written, stats.dropped, lines, isOk ? "OK" : "FAILED");
+    return isOk;
+}
+
+int main()
+{
+    bmcl::setLogLevel(bmcl::LogLevel::Debug);
+    const std::size_t messagesCount = 1000000;
+    bool isOk = true;
+    // critical messages wait for writer, nothing is dropped
+    isOk &= run("critical", bmcl::LogLevel::Critical, messagesCount, 4);
+    isOk &= run("warning", bmcl::LogLevel::Warning, messagesCount, 4);
+    isOk &= run("debug", bmcl::LogLevel::Debug, messagesCount, 4);
+    return isOk ? 0 : 1;
+}
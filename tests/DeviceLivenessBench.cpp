@@ -0,0 +1,158 @@
+#include "mcc/uav/DeadlineWheel.h"
+
+#include <QDateTime>
+
+#include <chrono>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+static constexpr int devicesCount = 500;
+static constexpr int packetsPerSecond = 10;
+static constexpr int seconds = 600;
+static constexpr int inactiveSecs = 3;
+
+struct Device {
+    std::string name;
+    QDateTime lastTime;
+    bool isAlive;
+    bool isActive;
+    int signalChanges;
+};
+
+using Clock = std::chrono::steady_clock;
+using SystemClock = std::chrono::system_clock;
+
+// every tenth device stops sending telemetry in the middle of run
+static bool isSending(int device, int second)
+{
+    return device % 10 != 0 || second < seconds / 2;
+}
+
+static std::vector<Device> makeDevices()
+{
+    std::vector<Device> devices(devicesCount);
+    for (int i = 0; i < devicesCount; i++) {
+        devices[i].name = "device" + std::to_string(i);
+        devices[i].isAlive = false;
+        devices[i].isActive = true;
+        devices[i].signalChanges = 0;
+    }
+    return devices;
+}
+
+// timer visits every device every second
+static double runScan(std::vector<Device>* devices, double* tickUs)
+{
+    std::set<std::string> forExchange;
+    for (const Device& d : *devices) {
+        forExchange.insert(d.name);
+    }
+    SystemClock::time_point start = SystemClock::now();
+    Clock::duration packets(0);
+    Clock::duration ticks(0);
+    for (int s = 0; s < seconds; s++) {
+        Clock::time_point t1 = Clock::now();
+        for (int p = 0; p < packetsPerSecond; p++) {
+            SystemClock::time_point time = start + std::chrono::seconds(s) + std::chrono::milliseconds(p * 1000 / packetsPerSecond);
+            for (int i = 0; i < devicesCount; i++) {
+                if (isSending(i, s)) {
+                    (*devices)[i].lastTime = QDateTime::fromMSecsSinceEpoch(std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count());
+                }
+            }
+        }
+        Clock::time_point t2 = Clock::now();
+        QDateTime current = QDateTime::fromMSecsSinceEpoch(std::chrono::duration_cast<std::chrono::milliseconds>((start + std::chrono::seconds(s + 1)).time_since_epoch()).count());
+        for (Device& d : *devices) {
+            int inactive = d.lastTime.secsTo(current);
+            if (inactive > inactiveSecs && d.isAlive) {
+                d.isAlive = false;
+                d.signalChanges++;
+            }
+            if (inactive <= inactiveSecs && !d.isAlive) {
+                d.isAlive = true;
+                d.signalChanges++;
+            }
+            auto it = forExchange.find(d.name);
+            if (!d.isActive && it != forExchange.end()) {
+                forExchange.erase(it);
+            }
+        }
+        Clock::time_point t3 = Clock::now();
+        packets += t2 - t1;
+        ticks += t3 - t2;
+    }
+    *tickUs = std::chrono::duration<double, std::micro>(ticks).count() / seconds;
+    return std::chrono::duration<double, std::micro>(packets + ticks).count() / seconds;
+}
+
+// packets rearm deadlines, timer visits only expired devices
+static double runWheel(std::vector<Device>* devices, double* tickUs)
+{
+    mccuav::DeadlineWheel<Device> wheel(std::chrono::seconds(1), 8);
+    std::vector<Device*> expired;
+    Clock::time_point start = Clock::now();
+    Clock::duration packets(0);
+    Clock::duration ticks(0);
+    for (int s = 0; s < seconds; s++) {
+        Clock::time_point t1 = Clock::now();
+        for (int p = 0; p < packetsPerSecond; p++) {
+            Clock::time_point time = start + std::chrono::seconds(s) + std::chrono::milliseconds(p * 1000 / packetsPerSecond);
+            for (int i = 0; i < devicesCount; i++) {
+                if (!isSending(i, s)) {
+                    continue;
+                }
+                Device& d = (*devices)[i];
+                wheel.arm(&d, time + std::chrono::seconds(inactiveSecs));
+                if (!d.isAlive) {
+                    d.isAlive = true;
+                    d.signalChanges++;
+                }
+            }
+        }
+        Clock::time_point t2 = Clock::now();
+        expired.clear();
+        wheel.advance(start + std::chrono::seconds(s + 1), &expired);
+        for (Device* d : expired) {
+            if (d->isAlive) {
+                d->isAlive = false;
+                d->signalChanges++;
+            }
+        }
+        Clock::time_point t3 = Clock::now();
+        packets += t2 - t1;
+        ticks += t3 - t2;
+    }
+    *tickUs = std::chrono::duration<double, std::micro>(ticks).count() / seconds;
+    return std::chrono::duration<double, std::micro>(packets + ticks).count() / seconds;
+}
+
+static bool check(const std::vector<Device>& devices)
+{
+    for (int i = 0; i < devicesCount; i++) {
+        int expected = i % 10 == 0 ? 2 : 1;
+        if (devices[i].signalChanges != expected || devices[i].isAlive != (expected == 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    std::vector<Device> scanDevices = makeDevices();
+    std::vector<Device> wheelDevices = makeDevices();
+
+    double scanTick;
+    double wheelTick;
+    double scanTotal = runScan(&scanDevices, &scanTick);
+    double wheelTotal = runWheel(&wheelDevices, &wheelTick);
+
+    bool isOk = check(scanDevices) && check(wheelDevices);
+    std::printf("%d devices, %d packets/s each, %d s\n", devicesCount, packetsPerSecond, seconds);
+    std::printf("scan every tick:  %8.1f us/tick, %8.1f us/s with packets\n", scanTick, scanTotal);
+    std::printf("deadline wheel:   %8.1f us/tick, %8.1f us/s with packets\n", wheelTick, wheelTotal);
+    std::printf("%s\n", isOk ? "OK" : "FAILED");
+    return isOk ? 0 : 1;
+}
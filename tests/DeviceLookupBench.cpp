@@ -0,0 +1,100 @@
+#include "UavFleetFixture.h"
+
+#include "mcc/msg/Tm.h"
+#include "mcc/uav/Uav.h"
+#include "mcc/uav/UavExecCommands.h"
+
+#include <QApplication>
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+// Replays exchange traffic of large fleet into UavController: requests to vehicles are added, change state and are
+// removed, statistics arrive for every vehicle at 10 Hz. Then checks that every vehicle got its commands and statistics
+
+static constexpr std::size_t devicesCount = 1000;
+static constexpr std::size_t requestsPerSecond = 10000;
+static constexpr std::size_t statsPerSecond = 10 * devicesCount;
+static constexpr std::size_t inFlight = 200;
+static constexpr int seconds = 5;
+
+static const uint8_t progressAdded = 50;
+static const uint8_t progressDone = 100;
+
+static bool check(const UavFleet& fleet, const std::deque<mccmsg::DevReqPtr>& active, const std::vector<std::size_t>& packets)
+{
+    const mccuav::UavController* controller = fleet.uavController();
+    if (controller->uavsCount() != devicesCount)
+        return false;
+
+    std::size_t commands = 0;
+    for (std::size_t i = 0; i < devicesCount; i++)
+    {
+        auto uav = controller->uav(fleet.devices()[i]);
+        if (uav.isNone() || uav->statDevice()._rcvd._packets != packets[i])
+            return false;
+        commands += uav->execCommands()->commands().size();
+    }
+    if (commands != active.size())
+        return false;
+
+    for (const mccmsg::DevReqPtr& req : active)
+    {
+        auto uav = controller->uav(req->device().unwrap());
+        auto cmd = uav->execCommands()->command(req->requestId());
+        if (cmd.isNone() || cmd->progress() != progressAdded)
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    auto start = std::chrono::steady_clock::now();
+    UavFleet fleet(devicesCount);
+    double addTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    StubExchangeService* service = fleet.service();
+    const std::vector<mccmsg::Device>& devices = fleet.devices();
+    std::vector<std::size_t> packets(devicesCount, 0);
+    std::deque<mccmsg::DevReqPtr> active;
+
+    start = std::chrono::steady_clock::now();
+    for (int s = 0; s < seconds; s++)
+    {
+        for (std::size_t i = 0; i < requestsPerSecond; i++)
+        {
+            mccmsg::DevReqPtr req = new mccmsg::CmdGetTmView(devices[(i * 7919) % devicesCount]);
+            emit service->requestAdded(req);
+            emit service->requestStateChanged(req, mccmsg::make<mccmsg::Request_State>(req.get(), progressAdded));
+            active.push_back(req);
+            if (active.size() > inFlight)
+            {
+                const mccmsg::DevReqPtr& done = active.front();
+                emit service->requestStateChanged(done, mccmsg::make<mccmsg::Request_State>(done.get(), progressDone));
+                emit service->requestRemoved(done);
+                active.pop_front();
+            }
+        }
+        for (std::size_t i = 0; i < statsPerSecond; i++)
+        {
+            std::size_t index = (i * 104729) % devicesCount;
+            mccmsg::StatDevice stat(devices[index]);
+            stat._rcvd._packets = ++packets[index];
+            emit service->deviceState(stat);
+        }
+    }
+    double trafficTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / seconds;
+
+    bool isOk = check(fleet, active, packets);
+    std::printf("%zu devices, %zu requests/s, %zu statistics/s\n", devicesCount, requestsPerSecond, statsPerSecond);
+    std::printf("add devices: %8.2f ms\n", addTime * 1000);
+    std::printf("traffic:     %8.2f ms per second of traffic\n", trafficTime * 1000);
+    std::printf("%s\n", isOk ? "OK" : "FAILED");
+    return isOk ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+#include "UavFleetFixture.h"
+
+#include "mcc/ide/models/LogMessagesFilterModel.h"
+#include "mcc/ide/models/LogMessagesModel.h"
+
+#include <QApplication>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Pushes a million log messages of fleet through LogMessagesModel and filter models attached to it. Batches between
+// timer flushes vary, some of them are larger than model limit. After flushes model must keep only newest messages,
+// level and device indexes must point exactly to kept rows, filters must match brute force selection
+
+static constexpr std::size_t messagesCount = 1000000;
+static constexpr std::size_t maxMessages = 10000;
+static constexpr std::size_t devicesCount = 50;
+static constexpr std::size_t checkEvery = 50;
+static const std::size_t batches[] = {1000, 3000, 25000, 7, 500};
+
+using mccide::AbstractLogMessage;
+using mccide::LogMessagesFilterModel;
+using mccide::LogMessagesModel;
+
+static const bmcl::LogLevel levels[] = {bmcl::LogLevel::None, bmcl::LogLevel::Panic, bmcl::LogLevel::Critical,
+                                        bmcl::LogLevel::Warning, bmcl::LogLevel::Info, bmcl::LogLevel::Debug};
+
+struct Filter
+{
+    LogMessagesFilterModel* model;
+    bmcl::LogLevel level;
+    bmcl::Option<mccmsg::Device> device;
+};
+
+static bool checkSequences(const LogMessagesModel::Sequences& sequences, const std::vector<uint64_t>& expected)
+{
+    return sequences.size() == expected.size() && std::equal(sequences.begin(), sequences.end(), expected.begin());
+}
+
+static bool checkModel(const LogMessagesModel& model, std::size_t total, const UavFleet& fleet, const std::vector<Filter>& filters)
+{
+    std::size_t rows = static_cast<std::size_t>(model.rowCount());
+    if (rows != std::min(total, model.maxMessages()) || model.firstSequence() != total - rows)
+        return false;
+
+    // text of message is its number, so kept rows must be exactly newest messages in order
+    std::vector<std::vector<uint64_t>> levelSequences(6);
+    std::map<mccmsg::Device, std::vector<uint64_t>> deviceSequences;
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        const AbstractLogMessage* msg = model.message(static_cast<int>(row));
+        uint64_t sequence = model.firstSequence() + row;
+        if (msg->message().toULongLong() != sequence)
+            return false;
+        levelSequences[static_cast<std::size_t>(msg->logLevel())].push_back(sequence);
+        if (msg->device().isSome())
+            deviceSequences[msg->device().unwrap()].push_back(sequence);
+    }
+    for (std::size_t level = 0; level < levelSequences.size(); level++)
+    {
+        if (!checkSequences(model.levelSequences(static_cast<bmcl::LogLevel>(level)), levelSequences[level]))
+            return false;
+    }
+    for (const mccmsg::Device& device : fleet.devices())
+    {
+        const LogMessagesModel::Sequences* sequences = model.deviceSequences(device);
+        auto it = deviceSequences.find(device);
+        if (it == deviceSequences.end())
+        {
+            if (sequences)
+                return false;
+            continue;
+        }
+        if (!sequences || !checkSequences(*sequences, it->second))
+            return false;
+        deviceSequences.erase(it);
+    }
+    // messages of devices unknown to UavController are not indexed by device
+    if (!deviceSequences.empty())
+        return false;
+
+    for (const Filter& filter : filters)
+    {
+        std::vector<int> expected;
+        for (std::size_t row = 0; row < rows; row++)
+        {
+            const AbstractLogMessage* msg = model.message(static_cast<int>(row));
+            if (filter.device.isSome() && (msg->device().isNone() || msg->device().unwrap() != filter.device.unwrap()))
+                continue;
+            if ((int)msg->logLevel() <= (int)filter.level)
+                expected.push_back(static_cast<int>(row));
+        }
+        if (filter.model->rowCount() != static_cast<int>(expected.size()))
+            return false;
+        for (std::size_t row = 0; row < expected.size(); row++)
+        {
+            if (filter.model->mapToSource(filter.model->index(static_cast<int>(row), 0)).row() != expected[row])
+                return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    UavFleet fleet(devicesCount);
+    // messages of these devices are reported, but they are not in UavController
+    std::vector<mccmsg::Device> strangers;
+    for (std::size_t i = 0; i < 5; i++)
+        strangers.push_back(mccmsg::Device::generate());
+
+    LogMessagesModel model(nullptr);
+    model.setContext(fleet.uavController());
+    model.setMaxMessages(maxMessages);
+
+    std::vector<Filter> filters;
+    filters.push_back(Filter{new LogMessagesFilterModel(&model), bmcl::LogLevel::Debug, bmcl::None});
+    filters.push_back(Filter{new LogMessagesFilterModel(&model), bmcl::LogLevel::Warning, bmcl::None});
+    filters.push_back(Filter{new LogMessagesFilterModel(&model), bmcl::LogLevel::Info, fleet.devices()[3]});
+    filters[1].model->setLogLevel(filters[1].level);
+    filters[2].model->setLogLevel(filters[2].level);
+    filters[2].model->setDevice(filters[2].device);
+
+    std::mt19937 gen(1);
+    bool isOk = checkModel(model, 0, fleet, filters);
+    std::size_t total = 0;
+    std::size_t flushes = 0;
+    double firstTime = 0;
+    double lastTime = 0;
+    double time = 0;
+    while (total < messagesCount && isOk)
+    {
+        std::size_t count = std::min(batches[flushes % (sizeof(batches) / sizeof(batches[0]))], messagesCount - total);
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < count; i++)
+        {
+            bmcl::LogLevel level = levels[gen() % 6];
+            std::string text = std::to_string(total + i);
+            switch (gen() % 4)
+            {
+            case 0:
+                fleet.service()->onLog(level, text);
+                break;
+            case 1:
+                fleet.service()->onLog(level, strangers[gen() % strangers.size()], text);
+                break;
+            default:
+                fleet.service()->onLog(level, fleet.devices()[gen() % devicesCount], text);
+                break;
+            }
+        }
+        model.timerEvent(nullptr);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        time += elapsed;
+        if (total < messagesCount / 10)
+            firstTime += elapsed;
+        else if (total >= messagesCount - messagesCount / 10)
+            lastTime += elapsed;
+        total += count;
+        flushes++;
+
+        if (flushes % checkEvery == 0)
+            isOk = checkModel(model, total, fleet, filters);
+    }
+    isOk = isOk && checkModel(model, total, fleet, filters);
+
+    // shrinking limit removes oldest rows right away
+    model.setMaxMessages(maxMessages / 10);
+    isOk = isOk && checkModel(model, total, fleet, filters);
+
+    // model is bounded, so last messages must not cost more than first ones
+    bool isBounded = lastTime < 3 * firstTime;
+
+    std::size_t indexed = 0;
+    for (bmcl::LogLevel level : levels)
+        indexed += model.levelSequences(level).size();
+
+    std::printf("%zu messages, %zu devices, limit %zu, %zu flushes\n", total, devicesCount, maxMessages, flushes);
+    std::printf("insert: %8.3f us/message, first 10%% %6.3f s, last 10%% %6.3f s\n", time * 1e6 / total, firstTime, lastTime);
+    std::printf("kept: %d rows, %zu level index entries\n", model.rowCount(), indexed);
+    isOk = isOk && isBounded;
+    std::printf("%s\n", isOk ? "OK" : "FAILED");
+
+    for (const Filter& filter : filters)
+        delete filter.model;
+    return isOk ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+#include "mcc/map/Layer.h"
+#include "mcc/map/LayerGroup.h"
+#include "mcc/map/MapRect.h"
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <QPainterPath>
+#include <QRegion>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+static constexpr int width = 1920;
+static constexpr int height = 1080;
+static constexpr int vehiclesCount = 40;
+static constexpr int framesCount = 300;
+
+// stands in for kml and route layers: many long antialiased polylines which do not change
+class VectorLayer : public mccmap::Layer {
+public:
+    VectorLayer(const mccmap::MapRect* rect, int seed)
+        : mccmap::Layer(rect)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> x(0, width);
+        std::uniform_real_distribution<double> y(0, height);
+        for (int i = 0; i < 60; i++) {
+            QPainterPath path(QPointF(x(gen), y(gen)));
+            for (int j = 0; j < 100; j++) {
+                path.lineTo(x(gen), y(gen));
+            }
+            _paths.push_back(path);
+        }
+    }
+
+    void draw(QPainter* p) const override
+    {
+        p->setPen(QPen(QColor(40, 90, 200, 180), 2));
+        for (const QPainterPath& path : _paths) {
+            p->drawPath(path);
+        }
+    }
+
+    bool isStatic() const override
+    {
+        return true;
+    }
+
+    bool zoomEvent(const QPoint&, int, int) override
+    {
+        return false;
+    }
+
+    void changeProjection(const mccgeo::MercatorProjection&, const mccgeo::MercatorProjection&) override
+    {
+    }
+
+private:
+    std::vector<QPainterPath> _paths;
+};
+
+// vehicle icons move every frame and report old and new icon rects
+class VehicleLayer : public mccmap::Layer {
+public:
+    explicit VehicleLayer(const mccmap::MapRect* rect)
+        : mccmap::Layer(rect)
+    {
+        for (int i = 0; i < vehiclesCount; i++) {
+            _positions.emplace_back(100 + (i % 8) * 220, 100 + (i / 8) * 180);
+        }
+    }
+
+    void draw(QPainter* p) const override
+    {
+        p->setPen(QPen(Qt::black, 1));
+        p->setBrush(Qt::yellow);
+        for (const QPointF& pos : _positions) {
+            QPolygonF icon;
+            icon << pos + QPointF(0, -12) << pos + QPointF(9, 10) << pos + QPointF(0, 5) << pos + QPointF(-9, 10);
+            p->drawPolygon(icon);
+        }
+    }
+
+    void move(int frame)
+    {
+        for (std::size_t i = 0; i < _positions.size(); i++) {
+            QRect old = iconRect(_positions[i]);
+            _positions[i] += QPointF(std::cos(frame * 0.05 + i), std::sin(frame * 0.05 + i));
+            emit sceneRectUpdated(old | iconRect(_positions[i]));
+        }
+    }
+
+    bool zoomEvent(const QPoint&, int, int) override
+    {
+        return false;
+    }
+
+    void changeProjection(const mccgeo::MercatorProjection&, const mccgeo::MercatorProjection&) override
+    {
+    }
+
+private:
+    static QRect iconRect(const QPointF& pos)
+    {
+        // pen and antialiasing reach one pixel outside of polygon
+        return QRectF(pos.x() - 11, pos.y() - 14, 22, 26).toAlignedRect();
+    }
+
+    std::vector<QPointF> _positions;
+};
+
+static double run(bool isCached, QImage* target)
+{
+    mccmap::Rc<mccmap::MapRect> rect = new mccmap::MapRect;
+    rect->setZoomLevel(4);
+    rect->resize(width, height);
+
+    mccmap::Rc<mccmap::LayerGroup> group = new mccmap::LayerGroup(rect.get());
+    group->appendLayer(new VectorLayer(rect.get(), 1));
+    VehicleLayer* vehicles = new VehicleLayer(rect.get());
+    group->appendLayer(vehicles);
+    group->appendLayer(new VectorLayer(rect.get(), 2));
+
+    // what widget would repaint, whole viewport for first frame
+    QRegion dirty(0, 0, width, height);
+    QObject::connect(group.get(), &mccmap::Layer::sceneRectUpdated, [&dirty](const QRect& r) { dirty += r; });
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int frame = 0; frame < framesCount; frame++) {
+        QPainter p(target);
+        p.setRenderHint(QPainter::Antialiasing);
+        if (isCached) {
+            // backing store keeps pixels outside of update region
+            p.setClipRegion(dirty);
+            p.fillRect(dirty.boundingRect(), Qt::white);
+            p.setClipping(false);
+            group->drawCached(&p, dirty);
+        } else {
+            p.fillRect(target->rect(), Qt::white);
+            group->drawTiled(&p);
+        }
+        p.end();
+        dirty = QRegion();
+        vehicles->move(frame);
+    }
+    return timer.nsecsElapsed() / 1000000.0 / framesCount;
+}
+
+// cached layers are composited, antialiased edges may differ by rounding
+static bool isSame(const QImage& left, const QImage& right)
+{
+    for (int y = 0; y < left.height(); y++) {
+        const QRgb* l = (const QRgb*)left.constScanLine(y);
+        const QRgb* r = (const QRgb*)right.constScanLine(y);
+        for (int x = 0; x < left.width(); x++) {
+            if (std::abs(qRed(l[x]) - qRed(r[x])) > 8 || std::abs(qGreen(l[x]) - qGreen(r[x])) > 8
+                || std::abs(qBlue(l[x]) - qBlue(r[x])) > 8) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+
+    QImage full(width, height, QImage::Format_ARGB32_Premultiplied);
+    QImage cached(width, height, QImage::Format_ARGB32_Premultiplied);
+    double fullTime = run(false, &full);
+    double cachedTime = run(true, &cached);
+
+    bool isOk = isSame(full, cached);
+    std::printf("%dx%d, 2 static vector layers, %d moving vehicles, %d frames\n", width, height, vehiclesCount, framesCount);
+    std::printf("all layers every frame:      %8.2f ms/frame\n", fullTime);
+    std::printf("cached static, dirty region: %8.2f ms/frame\n", cachedTime);
+    std::printf("%s\n", isOk ? "OK" : "FAILED");
+    return isOk ? 0 : 1;
+}
@@ -0,0 +1,250 @@
+#include "broker/ChannelActor.h"
+
+#include "mcc/msg/obj/Channel.h"
+#include "mcc/msg/obj/Protocol.h"
+#include "mcc/msg/Packet.h"
+#include "mcc/net/Asio.h"
+#include "mcc/net/NetLoggerInf.h"
+
+#include <caf/actor_system.hpp>
+#include <caf/actor_system_config.hpp>
+#include <caf/event_based_actor.hpp>
+#include <caf/scoped_actor.hpp>
+#include <caf/send.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::Channel)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::PacketPtr)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::ProtocolId)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccnet::ChannelPtr)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(std::shared_ptr<mccnet::Asio>)
+
+using done_atom = caf::atom_constant<caf::atom("done")>;
+using probe_atom = caf::atom_constant<caf::atom("probe")>;
+
+// packets sent to channel come back as received, remote side of channel is emulated by receive()
+class LoopbackChannel : public mccnet::Channel
+{
+public:
+    LoopbackChannel(mccnet::ChannelId id, const mccmsg::Channel& name, const caf::actor& target)
+        : mccnet::Channel(id), _name(name), _target(target)
+    {
+    }
+    void send(std::size_t, mccmsg::PacketPtr&& pkt) override { receive(std::move(pkt)); }
+    void connect(mccnet::OpCompletion&& f) override
+    {
+        caf::anon_send(_target, mccnet::activated_atom::value, _name);
+        f(caf::error());
+    }
+    void disconnect(mccnet::OpCompletion&& f) override
+    {
+        caf::anon_send(_target, mccnet::deactivated_atom::value, caf::error(), _name);
+        f(caf::error());
+    }
+    void update(const mccmsg::ChannelDescription&) override {}
+
+    // what exchanger does for each framed packet on asio thread
+    void receive(mccmsg::PacketPtr pkt) { caf::anon_send(_target, mccnet::atom_rcvd::value, _name, std::move(pkt)); }
+
+private:
+    mccmsg::Channel _name;
+    caf::actor _target;
+};
+
+caf::behavior deviceSink(caf::event_based_actor* self, const caf::actor& waiter, std::size_t expected)
+{
+    auto count = std::make_shared<std::size_t>(0);
+    return
+    {
+        [=](const mccmsg::PacketPtr&)
+        {
+            if (++*count == expected)
+                self->send(waiter, done_atom::value);
+        }
+    };
+}
+
+// stands for core and broker, caf::drop would answer every message with error which kills channel actor
+caf::behavior dropAll(caf::event_based_actor* self)
+{
+    self->set_default_handler([](caf::scheduled_actor*, caf::message_view&) -> caf::result<caf::message> { return caf::make_message(); });
+    return
+    {
+        [](done_atom) {}
+    };
+}
+
+// previous topology: all channels are framed and prioritised in one broker actor.
+// Without channels it stands for broker of new topology, which only registers and routes.
+// Probe stands for device request or registration waiting in broker mailbox
+class SharedBroker : public caf::event_based_actor
+{
+public:
+    SharedBroker(caf::actor_config& cfg, const std::vector<mccmsg::ChannelDescription>& ds)
+        : caf::event_based_actor(cfg)
+    {
+        // channel state and ready reports of channel actors are not needed here
+        set_default_handler([](caf::scheduled_actor*, caf::message_view&) -> caf::result<caf::message> { return caf::make_message(); });
+        for (const auto& d : ds)
+            _channels.emplace(d->name(), std::make_unique<mccmav::CItem>(this, d));
+    }
+    caf::behavior make_behavior() override
+    {
+        return
+        {
+            [this](const mccmsg::Channel& c, const mccnet::ChannelPtr& ptr)
+            {
+                _channels[c]->setChannel(ptr);
+                _channels[c]->activated(true);
+            }
+          , [this](mccmav::channel_attach_atom, const mccmsg::Channel& c, const mccmsg::ProtocolId& id, const caf::actor& device)
+            {
+                _channels[c]->add_device(id, device);
+            }
+          , [this](mccnet::atom_rcvd, const mccmsg::Channel& c, mccmsg::PacketPtr& pkt)
+            {
+                auto i = _channels.find(c);
+                if (i != _channels.end())
+                    i->second->pull(std::move(pkt));
+            }
+          , [](mccnet::activated_atom, const mccmsg::Channel&) {}
+          , [](probe_atom) { return probe_atom::value; }
+        };
+    }
+    // loopback channels refer back to broker, as ChannelActor does they are dropped on exit
+    void on_exit() override
+    {
+        _channels.clear();
+    }
+private:
+    std::map<mccmsg::Channel, std::unique_ptr<mccmav::CItem>> _channels;
+};
+
+static mccmsg::PacketPtr makePacket(mccmav::DeviceId system)
+{
+    // mavlink 1 frame, only magic and system id are looked at by channel
+    uint8_t frame[40] = {0xfe, 32, 0, system};
+    return new mccmsg::Packet(frame, sizeof(frame));
+}
+
+struct RunResult {
+    double seconds;
+    double probeMicros;
+};
+
+// all packets of every channel are received by device actors of channels, meanwhile broker is probed
+static RunResult run(caf::actor_system& system, std::size_t channelsCount, std::size_t packetsCount, bool isSharded)
+{
+    caf::scoped_actor waiter{system};
+    auto core = system.spawn(dropAll);
+    auto protocol = mccmsg::Protocol::generate();
+    std::vector<mccmsg::ChannelDescription> ds;
+    for (std::size_t i = 0; i < channelsCount; i++)
+    {
+        mccmsg::INetPtr net = new mccmsg::NetUdpParams("127.0.0.1", bmcl::None, bmcl::None);
+        ds.emplace_back(new mccmsg::ChannelDescriptionObj(mccmsg::Channel::generate(), protocol, "loopback", net, false
+            , std::chrono::milliseconds(100), false, false, bmcl::None, bmcl::None));
+    }
+
+    caf::actor shared;
+    if (isSharded)
+        shared = system.spawn<SharedBroker>(std::vector<mccmsg::ChannelDescription>());
+    else
+        shared = system.spawn<SharedBroker>(ds);
+
+    std::vector<caf::actor> actors;
+    std::vector<std::shared_ptr<LoopbackChannel>> channels;
+    for (std::size_t i = 0; i < channelsCount; i++)
+    {
+        const auto& name = ds[i]->name();
+        mccmsg::ProtocolId id(mccmsg::Device::generate(), protocol, 1);
+        auto device = system.spawn(deviceSink, caf::actor(waiter), packetsCount);
+        caf::actor target = shared;
+        if (isSharded)
+            target = system.spawn<mccmav::ChannelActor>(core, shared, ds[i]);
+        auto channel = std::make_shared<LoopbackChannel>(i, name, target);
+        if (isSharded)
+        {
+            caf::anon_send(target, mccnet::ChannelPtr(channel), std::shared_ptr<mccnet::Asio>());
+            caf::anon_send(target, mccmav::channel_attach_atom::value, id, device);
+            caf::anon_send(target, mccnet::activated_atom::value, name);
+        }
+        else
+        {
+            caf::anon_send(target, name, mccnet::ChannelPtr(channel));
+            caf::anon_send(target, mccmav::channel_attach_atom::value, name, id, device);
+        }
+        actors.push_back(device);
+        actors.push_back(target);
+        channels.push_back(channel);
+    }
+    mccmsg::PacketPtr pkt = makePacket(1);
+    // let channels attach devices before traffic starts
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<std::size_t> sending(channelsCount);
+    std::vector<std::thread> threads;
+    for (const auto& channel : channels)
+    {
+        threads.emplace_back([channel, pkt, packetsCount, &sending]() {
+            for (std::size_t i = 0; i < packetsCount; i++)
+                channel->receive(pkt);
+            sending--;
+        });
+    }
+
+    // round trip of probe through broker while channels are flooded
+    caf::scoped_actor prober{system};
+    std::size_t probes = 0;
+    double probeTime = 0;
+    while (sending != 0)
+    {
+        auto sent = std::chrono::steady_clock::now();
+        prober->request(shared, caf::infinite, probe_atom::value).receive([](probe_atom) {}, [](caf::error&) {});
+        probeTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - sent).count();
+        probes++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    for (std::size_t i = 0; i < channelsCount; i++)
+        waiter->receive([](done_atom) {});
+    auto end = std::chrono::steady_clock::now();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    for (const caf::actor& a : actors)
+        caf::anon_send_exit(a, caf::exit_reason::user_shutdown);
+    caf::anon_send_exit(shared, caf::exit_reason::user_shutdown);
+    caf::anon_send_exit(core, caf::exit_reason::user_shutdown);
+    return RunResult{std::chrono::duration<double>(end - start).count(), probes == 0 ? 0 : probeTime / probes * 1e6};
+}
+
+// received packets per second through channels of one protocol, one asio thread per loopback channel,
+// and round trip of message through broker under that load. Throughput can grow with channels
+// only up to number of cores, broker latency does not depend on it
+int main()
+{
+    caf::actor_system_config cfg;
+    caf::actor_system system{cfg};
+    const std::size_t packetsCount = 200000;
+    std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+    for (std::size_t channelsCount : {1, 4, 16})
+    {
+        RunResult shared = run(system, channelsCount, packetsCount, false);
+        RunResult sharded = run(system, channelsCount, packetsCount, true);
+        double total = double(channelsCount * packetsCount);
+        std::printf("%2zu channels: one broker actor %.2f Mpkt/s, broker round trip %.0f us; "
+                    "actor per channel %.2f Mpkt/s, broker round trip %.0f us\n",
+                    channelsCount, total / shared.seconds / 1e6, shared.probeMicros,
+                    total / sharded.seconds / 1e6, sharded.probeMicros);
+    }
+    return 0;
+}
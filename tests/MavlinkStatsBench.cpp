@@ -0,0 +1,171 @@
+#include "broker/Channel.h"
+
+#include "mcc/msg/obj/Channel.h"
+#include "mcc/msg/obj/Protocol.h"
+#include "mcc/msg/Packet.h"
+
+#include <caf/actor_system.hpp>
+#include <caf/actor_system_config.hpp>
+#include <caf/event_based_actor.hpp>
+#include <caf/scoped_actor.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(mccmsg::PacketPtr)
+
+using run_atom = caf::atom_constant<caf::atom("run")>;
+using count_atom = caf::atom_constant<caf::atom("count")>;
+
+static const std::size_t packetsPerSnapshot = 20000;
+
+// per packet path of channel before flat counters: stats map updated for every packet, attached device
+// is searched linearly
+class MapChannel
+{
+public:
+    MapChannel(caf::event_based_actor* self, const mccmsg::ChannelDescription&) : _self(self) {}
+    void add_device(const mccmsg::ProtocolId& id, const caf::actor& a)
+    {
+        _devices.emplace_back(new mccmav::CDevice(id, a));
+    }
+    void pull(mccmsg::PacketPtr&& pkt)
+    {
+        if (pkt->size() <= 4)
+            return;
+        mccmav::DeviceId id = mccmav::MavlinkCoder::device_id(*pkt);
+        _stats._devices[id].add(pkt->size(), 1);
+        auto i = std::find_if(_devices.begin(), _devices.end(), [id](const mccmav::CDevicePtr& item) { return item->id().id() == id; });
+        if (i == _devices.end())
+            return;
+        _self->send((*i)->actor(), std::move(pkt));
+    }
+    mccmsg::StatChannel getStats() { return _stats; }
+private:
+    caf::event_based_actor* _self;
+    std::vector<mccmav::CDevicePtr> _devices;
+    mccmsg::StatChannel _stats;
+};
+
+caf::behavior deviceSink(caf::event_based_actor*)
+{
+    auto count = std::make_shared<std::size_t>(0);
+    return
+    {
+        [=](const mccmsg::PacketPtr&) { ++*count; }
+      , [=](count_atom) { return *count; }
+    };
+}
+
+// channel actor pulls every packet and builds channel state every packetsPerSnapshot packets,
+// answers with time per packet in nanoseconds
+template <typename C>
+caf::behavior channelPath(caf::event_based_actor* self, const mccmsg::ChannelDescription& dscr
+                        , const std::vector<std::pair<mccmsg::ProtocolId, caf::actor>>& devices
+                        , const std::vector<mccmsg::PacketPtr>& packets)
+{
+    auto channel = std::make_shared<C>(self, dscr);
+    for (const auto& d : devices)
+        channel->add_device(d.first, d.second);
+    return
+    {
+        [=](run_atom)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < packets.size(); i++)
+            {
+                channel->pull(mccmsg::PacketPtr(packets[i]));
+                if (i % packetsPerSnapshot == 0)
+                    channel->getStats();
+            }
+            auto end = std::chrono::steady_clock::now();
+            return std::chrono::duration<double, std::nano>(end - start).count() / packets.size();
+        }
+    };
+}
+
+struct RunResult {
+    double nsPerPacket;
+    std::size_t delivered;
+};
+
+template <typename C>
+static RunResult run(caf::actor_system& system, const mccmsg::ChannelDescription& dscr, const mccmsg::Protocol& protocol,
+                     std::size_t devicesCount, const std::vector<mccmsg::PacketPtr>& packets)
+{
+    caf::scoped_actor self{system};
+    std::vector<std::pair<mccmsg::ProtocolId, caf::actor>> devices;
+    for (std::size_t i = 1; i <= devicesCount; i++)
+        devices.emplace_back(mccmsg::ProtocolId(mccmsg::Device::generate(), protocol, i), system.spawn(deviceSink));
+    auto channel = system.spawn(channelPath<C>, dscr, devices, packets);
+
+    RunResult rv{0, 0};
+    self->request(channel, caf::infinite, run_atom::value).receive([&](double ns) { rv.nsPerPacket = ns; }, [](caf::error&) {});
+    for (const auto& d : devices)
+        self->request(d.second, caf::infinite, count_atom::value).receive([&](std::size_t count) { rv.delivered += count; }, [](caf::error&) {});
+
+    self->send_exit(channel, caf::exit_reason::user_shutdown);
+    for (const auto& d : devices)
+        self->send_exit(d.second, caf::exit_reason::user_shutdown);
+    return rv;
+}
+
+static mccmsg::PacketPtr makePacket(mccmav::DeviceId system, std::size_t size)
+{
+    // mavlink 1 frame, only magic and system id are looked at by channel
+    std::vector<uint8_t> frame(size);
+    frame[0] = 0xfe;
+    frame[1] = uint8_t(size - 8);
+    frame[3] = system;
+    return new mccmsg::Packet(frame.data(), frame.size());
+}
+
+// per packet cost of channel actor on one channel with 50 attached devices and 10 unknown ones:
+// counting, device lookup and forwarding to device actor, channel state every 20000 packets (~100 ms at full rate)
+int main()
+{
+    caf::actor_system_config cfg;
+    caf::actor_system system{cfg};
+
+    const std::size_t devicesCount = 50;
+    const std::size_t packetsCount = 200000;
+    const std::size_t repeats = 5;
+    auto protocol = mccmsg::Protocol::generate();
+    mccmsg::INetPtr net = new mccmsg::NetUdpParams("127.0.0.1", bmcl::None, bmcl::None);
+    mccmsg::ChannelDescription dscr = new mccmsg::ChannelDescriptionObj(mccmsg::Channel::generate(), protocol, "bench", net, false
+        , std::chrono::milliseconds(100), false, false, bmcl::None, bmcl::None);
+
+    std::mt19937 rng(1);
+    std::vector<mccmsg::PacketPtr> pool;
+    for (std::size_t i = 0; i < 1024; i++)
+        pool.push_back(makePacket(mccmav::DeviceId(1 + rng() % (devicesCount + 10)), 20 + rng() % 260));
+    std::vector<mccmsg::PacketPtr> packets;
+    std::size_t expected = 0;
+    for (std::size_t i = 0; i < packetsCount; i++)
+    {
+        packets.push_back(pool[rng() % pool.size()]);
+        if (mccmav::MavlinkCoder::device_id(*packets.back()) <= devicesCount)
+            expected++;
+    }
+
+    // runs alternate and best of them is taken, cost of sending to device actor varies from run to run
+    double mapTime = 0;
+    double flatTime = 0;
+    bool isOk = true;
+    for (std::size_t i = 0; i < repeats; i++)
+    {
+        RunResult map = run<MapChannel>(system, dscr, protocol, devicesCount, packets);
+        RunResult flat = run<mccmav::CItem>(system, dscr, protocol, devicesCount, packets);
+        isOk &= map.delivered == expected && flat.delivered == expected;
+        mapTime = i == 0 ? map.nsPerPacket : std::min(mapTime, map.nsPerPacket);
+        flatTime = i == 0 ? flat.nsPerPacket : std::min(flatTime, flat.nsPerPacket);
+    }
+    std::printf("map and linear search: %.1f ns/packet, flat counters and slot table: %.1f ns/packet, %zu packets to devices %s\n",
+                mapTime, flatTime, expected, isOk ? "OK" : "FAILED");
+    return isOk ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+#include "mcc/map/MemoryCache.h"
+#include "mcc/map/TilePosition.h"
+#include "MemoryCacheReference.h"
+
+#include <QColor>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <QPixmap>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// 4K viewport, tile counts are computed as in MapLayer::onResize()
+static constexpr int width = 3840;
+static constexpr int height = 2160;
+static constexpr int tileSize = 256;
+static constexpr int tileCountX = width / tileSize + 2;
+static constexpr int tileCountY = height / tileSize + 2;
+static constexpr int zoomLevel = 12;
+static constexpr int fps = 60;
+static constexpr int seconds = 10;
+static constexpr int poolSize = 64;
+
+// pan right and back with vertical swing, pixels from start position
+static double panX(double t)
+{
+    return t < seconds / 2.0 ? 3000 * t : 3000 * (seconds - t);
+}
+
+static double panY(double t)
+{
+    return 1500 * std::sin(t * 1.3);
+}
+
+static int tileIndex(double pos)
+{
+    return (int)std::floor(pos / tileSize);
+}
+
+static const QPixmap& tileAt(const std::vector<QPixmap>& pool, int globalOffsetX, int globalOffsetY)
+{
+    return pool[(globalOffsetX * 31 + globalOffsetY * 17) % poolSize];
+}
+
+// requested tiles are downloaded immediately
+template <typename C>
+static void deliver(C* cache, const std::vector<mccmap::TilePosition>& queue, const std::vector<QPixmap>& pool)
+{
+    for (const mccmap::TilePosition& pos : queue) {
+        cache->updatePixmap(pos, tileAt(pool, pos.globalOffsetX, pos.globalOffsetY));
+    }
+}
+
+// after pan every cell of viewport must show tile of its position, as if viewport was loaded there from scratch
+template <typename C>
+static bool isExpected(const C& cache, const std::vector<QPixmap>& pool)
+{
+    QImage drawn(tileCountX * tileSize, tileCountY * tileSize, QImage::Format_ARGB32_Premultiplied);
+    QImage expected(drawn.size(), drawn.format());
+    drawn.fill(Qt::transparent);
+    expected.fill(Qt::transparent);
+    {
+        QPainter p(&drawn);
+        cache.drawNonTiled(&p);
+    }
+    {
+        QPainter p(&expected);
+        for (int y = 0; y < tileCountY; y++) {
+            for (int x = 0; x < tileCountX; x++) {
+                p.drawPixmap(x * tileSize, y * tileSize, tileAt(pool, cache.globalOffsetX(x), cache.globalOffsetY(y)));
+            }
+        }
+    }
+    return drawn == expected;
+}
+
+template <typename C>
+static double run(const std::vector<QPixmap>& pool, std::size_t* scrolls, bool* isOk)
+{
+    C cache;
+    cache.setDefaultPixmap(pool[0]);
+    cache.resize(tileCountX, tileCountY);
+    deliver(&cache, cache.setPosition(zoomLevel, 1000, 1000), pool);
+
+    int tileX = 0;
+    int tileY = 0;
+    *scrolls = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int frame = 1; frame <= fps * seconds; frame++) {
+        double t = double(frame) / fps;
+        int newTileX = tileIndex(panX(t));
+        int newTileY = tileIndex(panY(t));
+        for (; tileX < newTileX; tileX++, (*scrolls)++) {
+            deliver(&cache, cache.scrollRight(), pool);
+        }
+        for (; tileX > newTileX; tileX--, (*scrolls)++) {
+            deliver(&cache, cache.scrollLeft(), pool);
+        }
+        for (; tileY < newTileY; tileY++, (*scrolls)++) {
+            deliver(&cache, cache.scrollDown(), pool);
+        }
+        for (; tileY > newTileY; tileY--, (*scrolls)++) {
+            deliver(&cache, cache.scrollUp(), pool);
+        }
+    }
+    double elapsed = timer.nsecsElapsed() / 1000000.0;
+
+    // pan returns to start column, rows follow the sine swing
+    *isOk = cache.globalOffsetX() == 1000 + tileIndex(panX(seconds)) && cache.globalOffsetY() == 1000 + tileIndex(panY(seconds));
+    *isOk = *isOk && isExpected(cache, pool);
+    return elapsed;
+}
+
+int main(int argc, char** argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+
+    std::vector<QPixmap> pool;
+    for (int i = 0; i < poolSize; i++) {
+        QPixmap pixmap(tileSize, tileSize);
+        pixmap.fill(QColor::fromHsv(i * 360 / poolSize, 200, 200));
+        pool.push_back(pixmap);
+    }
+
+    std::size_t dequeScrolls;
+    std::size_t ringScrolls;
+    bool isDequeOk;
+    bool isRingOk;
+    double dequeTime = run<mccmapref::MemoryCache>(pool, &dequeScrolls, &isDequeOk);
+    double ringTime = run<mccmap::MemoryCache>(pool, &ringScrolls, &isRingOk);
+
+    bool isOk = isDequeOk && isRingOk && dequeScrolls == ringScrolls;
+    std::printf("%dx%d viewport, %dx%d tiles, %d s pan at %d fps, %zu scrolls\n", width, height, tileCountX, tileCountY, seconds, fps, ringScrolls);
+    std::printf("deque of deques: %8.2f ms\n", dequeTime);
+    std::printf("ring array:      %8.2f ms\n", ringTime);
+    std::printf("%s\n", isOk ? "OK" : "FAILED");
+    return isOk ? 0 : 1;
+}
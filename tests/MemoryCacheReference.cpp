@@ -0,0 +1,392 @@
+#include "MemoryCacheReference.h"
+
+#include <bmcl/Logging.h>
+#include <bmcl/Assert.h>
+#include <bmcl/OptionPtr.h>
+
+#include <QPainter>
+
+#include <cmath>
+
+namespace mccmapref {
+
+using namespace mccmap;
+
+constexpr const int tileSize = 256;
+// max zoom difference of parent tile used while tile is loading
+constexpr const int maxPlaceholderDepth = 4;
+
+MemoryCache::MemoryCache()
+    : _requestedTileCount(0)
+    , _cachedTileCount(0)
+    , _zoomLevel(0)
+    , _width(0)
+    , _height(0)
+    , _maxWidth(1)
+    , _maxHeight(1)
+    , _globalOffsetX(0)
+    , _globalOffsetY(0)
+{
+    updateMaxSize();
+}
+
+void MemoryCache::draw(QPainter* p) const
+{
+    int pixmapOffsetX = 0;
+    int pixmapOffsetY = 0;
+    for (int tileY = 0; tileY < _height; tileY++) {
+        pixmapOffsetX = 0;
+        for (int tileX = 0; tileX < _width; tileX++) {
+            const QPixmap& current = pixmapAt(tileX, tileY);
+            p->drawPixmap(pixmapOffsetX, pixmapOffsetY, current);
+            pixmapOffsetX += 256;
+        }
+        pixmapOffsetY += 256;
+    }
+}
+
+void MemoryCache::drawNonTiled(QPainter* p) const
+{
+    int pixmapOffsetX = 0;
+    int pixmapOffsetY = 0;
+    for (const std::deque<QPixmap>& row : _cache) {
+        pixmapOffsetX = 0;
+        for (const QPixmap& pixmap : row) {
+            p->drawPixmap(pixmapOffsetX, pixmapOffsetY, pixmap);
+            pixmapOffsetX += 256;
+        }
+        pixmapOffsetY += 256;
+    }
+}
+
+void MemoryCache::updatePixmap(const TilePosition& pos, const QPixmap& image)
+{
+    // tiles of other zoom levels are kept for later zooming
+    _pixmaps.add(pos, image);
+    setPixmap(pos, image);
+}
+
+void MemoryCache::setPixmap(const TilePosition& pos, const QPixmap& image)
+{
+    if (pos.zoomLevel != _zoomLevel) {
+        return;
+    }
+
+    int y = absOffset(pos.globalOffsetY - _globalOffsetY);
+    int x = absOffset(pos.globalOffsetX - _globalOffsetX);
+
+    for (int j = y; j < _height; j += _maxSize) {
+        std::deque<QPixmap>& pixmapsRow = _cache[j];
+        if ((int)pixmapsRow.size() < _width)
+        {
+            BMCL_CRITICAL() << "MemoryCache::updatePixmap(): pixmapsRow.size() < _width";
+            BMCL_ASSERT((int)pixmapsRow.size() < _width);
+            continue;
+        }
+        for (int i = x; i < _width; i += _maxSize) {
+            pixmapsRow[i] = image;
+        }
+    }
+}
+
+QRect MemoryCache::tileRect(const TilePosition& pos) const
+{
+    if (pos.zoomLevel != _zoomLevel) {
+        return QRect();
+    }
+    int y = absOffset(pos.globalOffsetY - _globalOffsetY);
+    int x = absOffset(pos.globalOffsetX - _globalOffsetX);
+    if (x >= _width || y >= _height) {
+        return QRect();
+    }
+    return QRect(x * 256, y * 256, 256, 256);
+}
+
+const QPixmap& MemoryCache::pixmapAt(int x, int y) const
+{
+    if (y > _height - 1) {
+        return _emptyPixmap;
+    }
+    const std::deque<QPixmap>& pixmapsRow = _cache[y];
+    if (x > _width - 1) {
+        return _emptyPixmap;
+    }
+    return pixmapsRow[x];
+}
+
+std::vector<TilePosition> MemoryCache::setSize(int tileCountX, int tileCountY)
+{
+    tileCountY = std::min(tileCountY, _maxSize);
+    tileCountX = std::min(tileCountX, _maxSize);
+    int dx = tileCountX - _width;
+    int dy = tileCountY - _height;
+    std::vector<TilePosition> queue;
+
+    if (dy > 0) {
+        queue.reserve(dy * _width);
+        for (int i = 0; i < dy; i++) {
+            _cache.emplace_back();
+            populateEmptyRow(_cache.back());
+            loadRow((int)_cache.size() - 1, &queue);
+        }
+    } else if (dy < 0) {
+        dy = -dy;
+        for (int i = 0; i < dy; i++) {
+            _cache.pop_back();
+        }
+    }
+
+    if (dx > 0) {
+        queue.reserve(queue.size() + dx * _height);
+        for (int i = 0; i < dx; i++) {
+            for (auto& row : _cache) {
+                row.push_back(_emptyPixmap);
+            }
+            loadColumn((int)_cache[0].size() - 1, &queue);
+        }
+    } else if (dx < 0) {
+        dx = -dx;
+        for (auto& row : _cache) {
+            for (int i = 0; i < dx; i++) {
+                row.pop_back();
+            }
+        }
+    }
+
+    _height = tileCountY;
+    _width = tileCountX;
+
+    return queue;
+}
+
+std::vector<TilePosition> MemoryCache::resize(int tileCountX, int tileCountY)
+{
+    _maxHeight = tileCountY;
+    _maxWidth = tileCountX;
+    return setSize(tileCountX, tileCountY);
+}
+
+std::vector<TilePosition> MemoryCache::scrollUp()
+{
+    std::vector<TilePosition> queue;
+    _globalOffsetY = absOffset(_globalOffsetY - 1);
+    if (_maxHeight == _maxSize) {
+        std::deque<QPixmap> last = std::move(_cache.back());
+        _cache.pop_back();
+        _cache.push_front(std::move(last));
+    } else {
+        _cache.pop_back();
+        _cache.emplace_front();
+        populateEmptyRow(_cache.front());
+        queue.reserve(_width);
+        loadRow(0, &queue);
+    }
+    return queue;
+}
+
+std::vector<TilePosition> MemoryCache::scrollDown()
+{
+    std::vector<TilePosition> queue;
+    _globalOffsetY = absOffset(_globalOffsetY + 1);
+    if (_maxHeight == _maxSize) {
+        std::deque<QPixmap> first = std::move(_cache.front());
+        _cache.pop_front();
+        _cache.push_back(std::move(first));
+    } else {
+        _cache.pop_front();
+        _cache.emplace_back();
+        populateEmptyRow(_cache.back());
+        queue.reserve(_width);
+        loadRow(_height - 1, &queue);
+    }
+    return queue;
+}
+
+std::vector<TilePosition> MemoryCache::scrollLeft()
+{
+    std::vector<TilePosition> queue;
+    _globalOffsetX = absOffset(_globalOffsetX - 1);
+    if (_width >= _maxSize) {
+        for (std::deque<QPixmap>& row : _cache) {
+            QPixmap last = std::move(row.back());
+            row.pop_back();
+            row.push_front(std::move(last));
+        }
+    } else {
+        queue.reserve(_height);
+        for (std::deque<QPixmap>& row : _cache) {
+            row.pop_back();
+            row.push_front(_emptyPixmap);
+        }
+        loadColumn(0, &queue);
+    }
+    return queue;
+}
+
+std::vector<TilePosition> MemoryCache::scrollRight()
+{
+    std::vector<TilePosition> queue;
+    _globalOffsetX = absOffset(_globalOffsetX + 1);
+    if (_width >= _maxSize) {
+        for (std::deque<QPixmap>& row : _cache) {
+            QPixmap first = std::move(row.front());
+            row.pop_front();
+            row.push_back(std::move(first));
+        }
+    } else {
+        queue.reserve(_height);
+        for (std::deque<QPixmap>& row : _cache) {
+            row.pop_front();
+            row.push_back(_emptyPixmap);
+        }
+        loadColumn(_width - 1, &queue);
+    }
+    return queue;
+}
+
+std::vector<TilePosition> MemoryCache::setPosition(int zoomLevel, int globalOffsetX, int globalOffsetY)
+{
+    if (zoomLevel < 0) {
+        return std::vector<TilePosition>();
+    }
+    _zoomLevel = zoomLevel;
+    updateMaxSize();
+    setSize(std::min(_maxWidth, _maxSize), std::min(_maxHeight, _maxSize));
+    _globalOffsetX = absOffset(globalOffsetX);
+    _globalOffsetY = absOffset(globalOffsetY);
+    return loadCache();
+}
+
+std::vector<TilePosition> MemoryCache::setOffset(int globalOffsetX, int globalOffsetY)
+{
+    _globalOffsetX = absOffset(globalOffsetX);
+    _globalOffsetY = absOffset(globalOffsetY);
+    return loadCache();
+}
+
+int MemoryCache::absOffset(int globalOffset) const
+{
+    if (_zoomLevel == 0) {
+        return 0;
+    }
+    if (globalOffset < 0) {
+        return _maxSize + globalOffset % _maxSize;
+    }
+    return globalOffset % _maxSize;
+}
+
+std::vector<TilePosition> MemoryCache::reloadCache()
+{
+    _pixmaps.clear();
+    return loadCache();
+}
+
+std::vector<TilePosition> MemoryCache::loadCache()
+{
+    std::vector<TilePosition> queue;
+    queue.reserve(_height * _width);
+    for (int i = 0; i < _height; i++) {
+        loadRow(i, &queue);
+    }
+    return queue;
+}
+
+void MemoryCache::loadTile(int column, int row, std::vector<TilePosition>* queue)
+{
+    TilePosition pos(_zoomLevel, absOffset(_globalOffsetX + column), absOffset(_globalOffsetY + row));
+    bmcl::OptionPtr<const QPixmap> pixmap = _pixmaps.get(pos);
+    if (pixmap.isSome()) {
+        _cache[row][column] = *pixmap.unwrap();
+        _cachedTileCount++;
+        return;
+    }
+    _cache[row][column] = placeholder(pos);
+    queue->push_back(pos);
+    _requestedTileCount++;
+}
+
+void MemoryCache::loadRow(int row, std::vector<TilePosition>* queue)
+{
+    for (int i = 0; i < (int)_cache[row].size(); i++) {
+        loadTile(i, row, queue);
+    }
+}
+
+void MemoryCache::loadColumn(int column, std::vector<TilePosition>* queue)
+{
+    for (int i = 0; i < (int)_cache.size(); i++) {
+        loadTile(column, i, queue);
+    }
+}
+
+bool MemoryCache::parentPlaceholder(const TilePosition& pos, int depth, QPixmap* dest) const
+{
+    if (depth > pos.zoomLevel) {
+        return false;
+    }
+    TilePosition parent(pos.zoomLevel - depth, pos.globalOffsetX >> depth, pos.globalOffsetY >> depth);
+    bmcl::OptionPtr<const QPixmap> pixmap = _pixmaps.find(parent);
+    if (pixmap.isNone()) {
+        return false;
+    }
+    int size = pixmap.unwrap()->width() >> depth;
+    if (size == 0) {
+        return false;
+    }
+    int mask = (1 << depth) - 1;
+    QRect rect((pos.globalOffsetX & mask) * size, (pos.globalOffsetY & mask) * size, size, size);
+    *dest = pixmap.unwrap()->copy(rect).scaled(tileSize, tileSize);
+    return true;
+}
+
+bool MemoryCache::childrenPlaceholder(const TilePosition& pos, QPixmap* dest) const
+{
+    QPainter p;
+    for (int dy = 0; dy < 2; dy++) {
+        for (int dx = 0; dx < 2; dx++) {
+            TilePosition child(pos.zoomLevel + 1, pos.globalOffsetX * 2 + dx, pos.globalOffsetY * 2 + dy);
+            bmcl::OptionPtr<const QPixmap> pixmap = _pixmaps.find(child);
+            if (pixmap.isNone()) {
+                continue;
+            }
+            if (!p.isActive()) {
+                *dest = _emptyPixmap.isNull() ? QPixmap(tileSize, tileSize) : _emptyPixmap.copy();
+                p.begin(dest);
+            }
+            p.drawPixmap(QRect(dx * tileSize / 2, dy * tileSize / 2, tileSize / 2, tileSize / 2), *pixmap.unwrap());
+        }
+    }
+    if (!p.isActive()) {
+        return false;
+    }
+    p.end();
+    return true;
+}
+
+QPixmap MemoryCache::placeholder(const TilePosition& pos) const
+{
+    // scaled tiles of nearby zoom levels are shown until tile is loaded
+    QPixmap pixmap;
+    if (parentPlaceholder(pos, 1, &pixmap) || childrenPlaceholder(pos, &pixmap)) {
+        return pixmap;
+    }
+    for (int depth = 2; depth <= maxPlaceholderDepth; depth++) {
+        if (parentPlaceholder(pos, depth, &pixmap)) {
+            return pixmap;
+        }
+    }
+    return _emptyPixmap;
+}
+
+void MemoryCache::populateEmptyRow(std::deque<QPixmap>& row)
+{
+    std::size_t size = _width;
+    for (std::size_t i = 0; i < size; i++) {
+        row.push_back(_emptyPixmap);
+    }
+}
+
+MemoryCache::~MemoryCache()
+{
+}
+}
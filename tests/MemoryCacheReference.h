@@ -0,0 +1,169 @@
+#pragma once
+
+// MemoryCache implementation before tile grid was moved to flat ring array, pan benchmark compares against it.
+
+#include "mcc/Config.h"
+#include "mcc/map/TilePixmapCache.h"
+#include "mcc/map/TilePosition.h"
+
+#include <deque>
+#include <vector>
+#include <cmath>
+
+#include <QPixmap>
+
+class QPainter;
+
+namespace mccmapref {
+
+using namespace mccmap;
+
+class MemoryCache {
+public:
+    MemoryCache();
+    ~MemoryCache();
+
+    inline int zoomLevel() const;
+    const QPixmap& pixmapAt(int x, int y) const;
+    inline int globalOffsetX(int offset = 0) const;
+    inline int globalOffsetY(int offset = 0) const;
+    inline QPoint globalOffset() const;
+    inline int width() const; //FIXME: size_t
+    inline int height() const; //FIXME: size_t
+    inline int maxSize() const; //FIXME: size_t
+    inline bool isAtTop() const;
+    inline bool isAtBottom() const;
+
+    inline void setDefaultPixmap(const QPixmap& p);
+    inline void setMaxCacheBytes(std::size_t bytes);
+    inline const TilePixmapCache& pixmapCache() const;
+    inline std::size_t requestedTileCount() const;
+    inline std::size_t cachedTileCount() const;
+
+    void draw(QPainter* p) const;
+    void drawNonTiled(QPainter* p) const;
+    void updatePixmap(const TilePosition& pos, const QPixmap& image);
+    // rect of tile as drawn by drawNonTiled(), null if tile is not in cache
+    QRect tileRect(const TilePosition& pos) const;
+    inline void resetPixmap(const TilePosition& pos);
+
+    std::vector<TilePosition> setPosition(int zoomLevel, int globalOffsetX, int globalOffsetY);
+    std::vector<TilePosition> setOffset(int globalOffsetX, int globalOffsetY);
+    std::vector<TilePosition> resize(int tileCountX, int tileCountY);
+    std::vector<TilePosition> scrollUp();
+    std::vector<TilePosition> scrollDown();
+    std::vector<TilePosition> scrollLeft();
+    std::vector<TilePosition> scrollRight();
+    // drops decoded tiles of all zoom levels and requests whole viewport again
+    std::vector<TilePosition> reloadCache();
+
+private:
+    std::vector<TilePosition> setSize(int tileCountX, int tileCountY);
+    std::vector<TilePosition> loadCache();
+    int absOffset(int globalOffset) const;
+    void setPixmap(const TilePosition& pos, const QPixmap& image);
+    void loadTile(int column, int row, std::vector<TilePosition>* queue);
+    void loadRow(int row, std::vector<TilePosition>* queue);
+    void loadColumn(int column, std::vector<TilePosition>* queue);
+    QPixmap placeholder(const TilePosition& pos) const;
+    bool parentPlaceholder(const TilePosition& pos, int depth, QPixmap* dest) const;
+    bool childrenPlaceholder(const TilePosition& pos, QPixmap* dest) const;
+    void populateEmptyRow(std::deque<QPixmap>& row);
+    inline void updateMaxSize();
+
+    QPixmap _emptyPixmap;
+    std::deque<std::deque<QPixmap>> _cache;
+    TilePixmapCache _pixmaps;
+    std::size_t _requestedTileCount;
+    std::size_t _cachedTileCount;
+    int _zoomLevel;
+    int _width;
+    int _height;
+    int _maxWidth;
+    int _maxHeight;
+    int _globalOffsetX;
+    int _globalOffsetY;
+    int _maxSize;
+};
+
+inline int MemoryCache::zoomLevel() const
+{
+    return _zoomLevel;
+}
+
+inline void MemoryCache::setDefaultPixmap(const QPixmap& p)
+{
+    _emptyPixmap = p;
+}
+
+inline void MemoryCache::setMaxCacheBytes(std::size_t bytes)
+{
+    _pixmaps.setMaxBytes(bytes);
+}
+
+inline const TilePixmapCache& MemoryCache::pixmapCache() const
+{
+    return _pixmaps;
+}
+
+inline std::size_t MemoryCache::requestedTileCount() const
+{
+    return _requestedTileCount;
+}
+
+inline std::size_t MemoryCache::cachedTileCount() const
+{
+    return _cachedTileCount;
+}
+
+inline int MemoryCache::maxSize() const
+{
+    return _maxSize;
+}
+
+inline void MemoryCache::resetPixmap(const TilePosition& pos)
+{
+    _pixmaps.remove(pos);
+    setPixmap(pos, _emptyPixmap);
+}
+
+inline bool MemoryCache::isAtBottom() const
+{
+    return _globalOffsetY + _height >= _maxSize;
+}
+
+inline bool MemoryCache::isAtTop() const
+{
+    return _globalOffsetY <= 0;
+}
+
+inline int MemoryCache::height() const
+{
+    return _height;
+}
+
+inline int MemoryCache::width() const
+{
+    return _width;
+}
+
+inline int MemoryCache::globalOffsetX(int offset) const
+{
+    return absOffset(_globalOffsetX + offset);
+}
+
+inline int MemoryCache::globalOffsetY(int offset) const
+{
+    return absOffset(_globalOffsetY + offset);
+}
+
+inline QPoint MemoryCache::globalOffset() const
+{
+    return QPoint(_globalOffsetX, _globalOffsetY);
+}
+
+inline void MemoryCache::updateMaxSize()
+{
+    _maxSize = std::exp2(_zoomLevel);
+}
+}
@@ -0,0 +1,142 @@
+#include "mcc/map/MemoryCache.h"
+#include "mcc/map/TilePosition.h"
+
+#include <QColor>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <QPixmap>
+
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <vector>
+
+// viewport of 12x9 tiles zoomed in from 10 to 15 around one point and back out to 10
+static constexpr int tileCountX = 12;
+static constexpr int tileCountY = 9;
+static constexpr int tileSize = 256;
+static constexpr int minZoom = 10;
+static constexpr int maxZoom = 15;
+static constexpr int poolSize = 64;
+// center of viewport in tiles of min zoom level
+static constexpr double centerX = 300.5;
+static constexpr double centerY = 400.5;
+
+static const QPixmap& tileAt(const std::vector<QPixmap>& pool, const mccmap::TilePosition& pos)
+{
+    return pool[(pos.globalOffsetX * 31 + pos.globalOffsetY * 17 + pos.zoomLevel * 7) % poolSize];
+}
+
+// tiles of positions that are drawn as loaded tiles
+static bool isExpected(const mccmap::MemoryCache& cache, const std::vector<QPixmap>& pool)
+{
+    QImage drawn(tileCountX * tileSize, tileCountY * tileSize, QImage::Format_ARGB32_Premultiplied);
+    QImage expected(drawn.size(), drawn.format());
+    drawn.fill(Qt::transparent);
+    expected.fill(Qt::transparent);
+    {
+        QPainter p(&drawn);
+        cache.drawNonTiled(&p);
+    }
+    {
+        QPainter p(&expected);
+        for (int y = 0; y < tileCountY; y++) {
+            for (int x = 0; x < tileCountX; x++) {
+                mccmap::TilePosition pos(cache.zoomLevel(), cache.globalOffsetX(x), cache.globalOffsetY(y));
+                p.drawPixmap(x * tileSize, y * tileSize, tileAt(pool, pos));
+            }
+        }
+    }
+    return drawn == expected;
+}
+
+struct RunResult {
+    std::size_t requested;
+    double ms;
+    // every tile shown after first zoom step had tile of its position before it was loaded again
+    bool isShownBeforeLoad;
+    bool isOk;
+};
+
+// maxBytes 0 stands for previous cache, which dropped every tile when zoom changed.
+// Requested tiles are loaded immediately, their freshness ends at expires
+static RunResult run(const std::vector<QPixmap>& pool, std::size_t maxBytes, std::time_t expires)
+{
+    mccmap::MemoryCache cache;
+    cache.setDefaultPixmap(pool[0]);
+    cache.setMaxCacheBytes(maxBytes);
+    cache.resize(tileCountX, tileCountY);
+
+    std::vector<int> zooms;
+    for (int zoom = minZoom; zoom <= maxZoom; zoom++) {
+        zooms.push_back(zoom);
+    }
+    for (int zoom = maxZoom - 1; zoom >= minZoom; zoom--) {
+        zooms.push_back(zoom);
+    }
+
+    RunResult rv{0, 0, true, true};
+    QElapsedTimer timer;
+    timer.start();
+    for (std::size_t i = 0; i < zooms.size(); i++) {
+        int zoom = zooms[i];
+        double scale = std::exp2(zoom - minZoom);
+        int offsetX = (int)std::floor(centerX * scale - tileCountX / 2.0);
+        int offsetY = (int)std::floor(centerY * scale - tileCountY / 2.0);
+        std::vector<mccmap::TilePosition> queue = cache.setPosition(zoom, offsetX, offsetY);
+        if (maxBytes == 0) {
+            queue = cache.reloadCache();
+        }
+        // second half of zoom sequence shows levels that were loaded in first one
+        if (i > std::size_t(maxZoom - minZoom) && !isExpected(cache, pool)) {
+            rv.isShownBeforeLoad = false;
+        }
+        rv.requested += queue.size();
+        for (const mccmap::TilePosition& pos : queue) {
+            cache.updatePixmap(pos, tileAt(pool, pos), expires);
+        }
+        rv.isOk &= cache.zoomLevel() == zoom && isExpected(cache, pool);
+    }
+    rv.ms = timer.nsecsElapsed() / 1000000.0;
+    return rv;
+}
+
+int main(int argc, char** argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+
+    std::vector<QPixmap> pool;
+    for (int i = 0; i < poolSize; i++) {
+        QPixmap pixmap(tileSize, tileSize);
+        pixmap.fill(QColor::fromHsv(i * 360 / poolSize, 200, 200));
+        pool.push_back(pixmap);
+    }
+
+    const std::size_t mb = 1024 * 1024;
+    const std::time_t fresh = mccmap::TilePixmapCache::neverExpires;
+    const std::time_t expired = std::time(nullptr) - 1;
+    RunResult previous = run(pool, 0, fresh);
+    RunResult small = run(pool, 128 * mb, fresh);
+    RunResult large = run(pool, 256 * mb, fresh);
+    RunResult stale = run(pool, 256 * mb, expired);
+
+    std::size_t steps = 2 * (maxZoom - minZoom) + 1;
+    std::printf("%dx%d tiles, zoom %d to %d and back, %zu positions\n", tileCountX, tileCountY, minZoom, maxZoom, steps);
+    std::printf("%-24s %10s %10s\n", "cache", "requested", "time (ms)");
+    std::printf("%-24s %10zu %10.1f\n", "dropped on zoom", previous.requested, previous.ms);
+    std::printf("%-24s %10zu %10.1f\n", "128 MB", small.requested, small.ms);
+    std::printf("%-24s %10zu %10.1f\n", "256 MB", large.requested, large.ms);
+    std::printf("%-24s %10zu %10.1f\n", "256 MB, expired tiles", stale.requested, stale.ms);
+
+    bool isOk = previous.isOk && small.isOk && large.isOk && stale.isOk;
+    isOk &= previous.requested == steps * tileCountX * tileCountY;
+    isOk &= large.requested <= small.requested && small.requested < previous.requested;
+    isOk &= large.isShownBeforeLoad;
+    // expired tiles are requested again, but are shown until then
+    isOk &= stale.requested == previous.requested && stale.isShownBeforeLoad;
+    std::printf("%s\n", isOk ? "OK" : "FAILED");
+    return isOk ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+#include "mcc/map/OmcfCache.h"
+#include "mcc/map/TilePosCache.h"
+#include "mcc/map/TilePosition.h"
+
+#include <bmcl/Bytes.h>
+#include <bmcl/MemReader.h>
+#include <bmcl/MemWriter.h>
+#include <bmcl/Option.h>
+#include <bmcl/Result.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+// u16 zoom + 1, u32 x, u32 y, u64 offset, u64 size, same as in OmcfCache
+static constexpr std::size_t recordSize = 2 + 4 + 4 + 8 + 8;
+static constexpr std::size_t tileSize = 4;
+// zooms 0-10 are full, 11-16 have square region each, 17 has scattered tiles and gets no grid
+static constexpr int fullZooms = 11;
+static constexpr int regionZooms = 6;
+static constexpr uint32_t regionSide = 700;
+static constexpr std::size_t scatteredTiles = 20000;
+static constexpr std::size_t lookupsCount = 2000000;
+
+struct TileFileInfo {
+    int64_t offset;
+    int64_t size;
+};
+
+// data of every tile is its number in pack
+static bool writePack(const QString& path, const std::vector<mccmap::TilePosition>& tiles)
+{
+    std::size_t headerSize = 4 + 4 + 2 * sizeof(double) + 4 + 4 + 4 + tiles.size() * recordSize + 4;
+    std::size_t size = headerSize + tiles.size() * tileSize;
+    std::unique_ptr<uint8_t[]> data(new uint8_t[size]);
+    bmcl::MemWriter header(data.get(), size);
+    double a = 6378137.0;
+    double b = 6356752.3142;
+    header.writeUint32Le(mccmap::OmcfCache::headerMagic);
+    header.writeUint32Le(headerSize);
+    header.write(&a, sizeof(double));
+    header.write(&b, sizeof(double));
+    header.writeUint32Le(0);
+    header.writeUint32Le(0);
+    header.writeUint32Le(tiles.size());
+    for (std::size_t i = 0; i < tiles.size(); i++) {
+        header.writeUint16Le(tiles[i].zoomLevel + 1);
+        header.writeUint32Le(tiles[i].globalOffsetX);
+        header.writeUint32Le(tiles[i].globalOffsetY);
+        header.writeUint64Le(headerSize + i * tileSize);
+        header.writeUint64Le(tileSize);
+    }
+    uint32_t crc = mccmap::OmcfCache::crc32(header.start(), header.sizeUsed());
+    header.writeUint32Le(crc);
+    for (std::size_t i = 0; i < tiles.size(); i++) {
+        header.writeUint32Le(i);
+    }
+
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write((const char*)data.get(), size) == qint64(size);
+}
+
+// index of pack before per-zoom grid: records copied into nested hash maps on open
+static bool openNested(const QString& path, mccmap::FastTilePosCache<TileFileInfo>* index)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const uchar* mapped = file.map(0, file.size());
+    if (!mapped) {
+        return false;
+    }
+    bmcl::MemReader header(mapped, file.size());
+    header.skip(4 + 4 + 2 * sizeof(double));
+    header.skip(header.readUint32Le() * 2);
+    header.skip(header.readUint32Le() * 2);
+    uint32_t tilesNum = header.readUint32Le();
+    for (uint32_t i = 0; i < tilesNum; i++) {
+        mccmap::TilePosition pos;
+        pos.zoomLevel = header.readUint16Le() - 1;
+        pos.globalOffsetX = header.readUint32Le();
+        pos.globalOffsetY = header.readUint32Le();
+        TileFileInfo info;
+        info.offset = header.readUint64Le();
+        info.size = header.readUint64Le();
+        index->addValue(pos, info);
+    }
+    return true;
+}
+
+// keeps lookups from being optimized out
+static volatile std::size_t foundSink = 0;
+
+template <typename F>
+static double nsPerLookup(const std::vector<mccmap::TilePosition>& positions, F&& find)
+{
+    std::size_t found = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (const mccmap::TilePosition& pos : positions) {
+        found += find(pos);
+    }
+    double ns = double(timer.nsecsElapsed()) / positions.size();
+    foundSink = found;
+    return ns;
+}
+
+// synthetic pack of several million tiles, open time and tile lookup of nested hash maps and of OmcfCache grid.
+// Random lookups hit existing tiles anywhere in pack, viewport ones scan 12x9 tiles of map view, missing ones
+// miss tiles next to region of zoom
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        std::printf("FAILED: no temporary dir\n");
+        return 1;
+    }
+    QString path = dir.filePath("bench.omcf");
+
+    std::mt19937 rng(1);
+    std::vector<mccmap::TilePosition> tiles;
+    for (int zoom = 0; zoom < fullZooms; zoom++) {
+        for (int x = 0; x < (1 << zoom); x++) {
+            for (int y = 0; y < (1 << zoom); y++) {
+                tiles.emplace_back(zoom, x, y);
+            }
+        }
+    }
+    for (int zoom = fullZooms; zoom < fullZooms + regionZooms; zoom++) {
+        int start = (1 << zoom) / 3;
+        for (uint32_t x = 0; x < regionSide; x++) {
+            for (uint32_t y = 0; y < regionSide; y++) {
+                tiles.emplace_back(zoom, start + x, start + y);
+            }
+        }
+    }
+    int sparseZoom = fullZooms + regionZooms;
+    for (std::size_t i = 0; i < scatteredTiles; i++) {
+        tiles.emplace_back(sparseZoom, rng() % (1 << sparseZoom), rng() % (1 << sparseZoom));
+    }
+    if (!writePack(path, tiles)) {
+        std::printf("FAILED: pack not written\n");
+        return 1;
+    }
+
+    std::vector<mccmap::TilePosition> random;
+    for (std::size_t i = 0; i < lookupsCount; i++) {
+        random.push_back(tiles[rng() % tiles.size()]);
+    }
+    std::vector<mccmap::TilePosition> viewport;
+    int viewportZoom = fullZooms + 3;
+    int viewportStart = (1 << viewportZoom) / 3;
+    while (viewport.size() < lookupsCount) {
+        int offsetX = viewportStart + rng() % (regionSide - 12);
+        int offsetY = viewportStart + rng() % (regionSide - 9);
+        for (int y = 0; y < 9; y++) {
+            for (int x = 0; x < 12; x++) {
+                viewport.emplace_back(viewportZoom, offsetX + x, offsetY + y);
+            }
+        }
+    }
+    std::vector<mccmap::TilePosition> missing;
+    for (std::size_t i = 0; i < lookupsCount; i++) {
+        int zoom = fullZooms + rng() % regionZooms;
+        int start = (1 << zoom) / 3;
+        missing.emplace_back(zoom, start + regionSide + rng() % 64, start + rng() % regionSide);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    mccmap::FastTilePosCache<TileFileInfo> nested;
+    if (!openNested(path, &nested)) {
+        std::printf("FAILED: pack not opened\n");
+        return 1;
+    }
+    double nestedOpenMs = timer.nsecsElapsed() / 1000000.0;
+
+    timer.restart();
+    auto cache = mccmap::OmcfCache::create(path);
+    if (cache.isErr()) {
+        std::printf("FAILED: pack not opened\n");
+        return 1;
+    }
+    double gridOpenMs = timer.nsecsElapsed() / 1000000.0;
+    const mccmap::OmcfCache* grid = cache.unwrap().get();
+
+    auto findNested = [&nested](const mccmap::TilePosition& pos) {
+        return nested.get(pos).isSome();
+    };
+    auto findGrid = [grid](const mccmap::TilePosition& pos) {
+        return grid->tileExists(pos);
+    };
+
+    std::printf("%zu tiles, zooms 0-%d, %zu lookups\n", tiles.size(), sparseZoom, lookupsCount);
+    std::printf("%-12s %10s %10s %10s %10s\n", "index", "open (ms)", "random", "viewport", "missing");
+    std::printf("%-12s %10.0f %10.1f %10.1f %10.1f\n", "nested maps", nestedOpenMs,
+                nsPerLookup(random, findNested), nsPerLookup(viewport, findNested), nsPerLookup(missing, findNested));
+    std::printf("%-12s %10.0f %10.1f %10.1f %10.1f\n", "zoom grid", gridOpenMs,
+                nsPerLookup(random, findGrid), nsPerLookup(viewport, findGrid), nsPerLookup(missing, findGrid));
+
+    // both indexes point at same data, data of tile is its number
+    bool isOk = std::size_t(grid->size()) == tiles.size() && nested.count() == tiles.size();
+    const uint8_t* firstData = grid->tileData(tiles[0]).data();
+    int64_t firstOffset = nested.get(tiles[0]).unwrapOr(TileFileInfo{0, 0}).offset;
+    for (std::size_t i = 0; i < tiles.size(); i += 97) {
+        bmcl::Bytes data = grid->tileData(tiles[i]);
+        uint32_t number = 0;
+        if (data.size() == tileSize) {
+            std::memcpy(&number, data.data(), tileSize);
+        }
+        bmcl::Option<TileFileInfo> info = nested.get(tiles[i]);
+        isOk &= number == i && info.isSome();
+        isOk &= info.isSome() && data.data() - firstData == info.unwrap().offset - firstOffset;
+    }
+    for (const mccmap::TilePosition& pos : missing) {
+        isOk &= !grid->tileExists(pos) && nested.get(pos).isNone();
+    }
+    std::printf("%s\n", isOk ? "OK" : "FAILED");
+    return isOk ? 0 : 1;
+}
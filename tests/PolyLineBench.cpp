@@ -0,0 +1,74 @@
+#include "mcc/map/drawables/PolyLine.h"
+#include "mcc/map/drawables/Point.h"
+#include "mcc/map/drawables/WithRect.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+// point with hover rect as route and ruler markers have
+class HoverPoint : public mccmap::Point, public mccmap::WithRect<HoverPoint> {
+public:
+    HoverPoint(const QPointF& position)
+        : mccmap::Point(position)
+    {
+    }
+
+    QRectF rect() const
+    {
+        return QRectF(position() - QPointF(8, 8), QSizeF(16, 16));
+    }
+};
+
+template <typename F>
+static double measure(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// hover hit tests over long polylines, first query after zoom change includes index rebuild
+int main()
+{
+    mccmap::Rc<mccmap::MapRect> rect = new mccmap::MapRect;
+    const int queriesCount = 10000;
+    for (std::size_t count : {1000, 10000, 100000}) {
+        std::mt19937 rng(count);
+        std::uniform_real_distribution<double> step(-20, 20);
+        mccmap::PolyLineBase<HoverPoint> line(rect.get());
+        double x = 1000000;
+        double y = 1000000;
+        for (std::size_t i = 0; i < count; i++) {
+            x += step(rng);
+            y += step(rng);
+            line.emplaceBack(QPointF(x, y));
+        }
+        std::vector<QPointF> queries;
+        for (int i = 0; i < queriesCount; i++) {
+            QPointF pos = line.at(rng() % count).position();
+            queries.emplace_back(pos.x() + step(rng), pos.y() + step(rng));
+        }
+
+        std::size_t hits = 0;
+        double rebuild = measure([&]() {
+            line.changeZoomLevel(10, 10);
+            hits += line.nearestLine(queries[0], 5).isSome();
+        });
+        double lines = measure([&]() {
+            for (const QPointF& pos : queries) {
+                hits += line.nearestLine(pos, 5).isSome();
+            }
+        });
+        double points = measure([&]() {
+            for (const QPointF& pos : queries) {
+                hits += line.nearest(pos).isSome();
+            }
+        });
+        std::printf("%zu points: rebuild %.3f ms, nearestLine %.3f us, nearest %.3f us (%zu hits)\n", count,
+                    rebuild, lines * 1000 / queriesCount, points * 1000 / queriesCount, hits);
+    }
+    return 0;
+}
@@ -0,0 +1,372 @@
+#include "mcc/vis/Profile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Checks Profile on random terrains against outputs recorded from previous implementation, which kept samples
+// as vector of structures. Each case is recorded as sums of its outputs, values differ only by rounding
+
+struct Digest {
+    double size;
+    double hmin;
+    double hmax;
+    double samples;
+    double nonFinite;
+    double rays;
+    double rayPoints;
+    double viewRegion;
+    double intersections;
+    double visionIntervals;
+    double hitIntervals;
+    double hits;
+    double hitPoints;
+    double vertical;
+};
+
+static const char* const fields[] = {
+    "size", "hmin", "hmax", "samples", "non finite samples", "rays", "ray points", "view region", "view intersections",
+    "vision intervals", "hit intervals", "hits", "hit points", "vertical intervals",
+};
+
+static const Digest expected[] = {
+    {1396, -353.340214382, 1420.57111999, 267600072.112, 1, 5, 253312.833591, 254416.839061, 25432.9181583, 4814.27568352, 0, 0.001, 15279.2055112, 7128883.62614},
+    {644, -7.65652061629, 2538.06038012, 42904655.3291, 1, 4, 274850.707558, 276875.274042, 5626.36837891, 2879.70924024, 0, 0, 0, 4349731.0489},
+    {174, 369.386574199, 1079.95763642, 4259895.83925, 1, 1, 145485.805586, 142387.689805, 51446.9622084, 12767.4778094, 0, 0, 0, 426207.118053},
+    {293, 56.6082253771, 1050.21253407, 12127391.4644, 1, 3, 133531.841048, 135202.032461, 0, 0, 0, 0, 0, 861684.164307},
+    {546, 268.491858062, 1157.29862566, 44746338.4173, 1, 4, 254573.498337, 256173.914647, 101161.714327, 19209.2220796, 0, 0, 0, 4854725.32644},
+    {332, 60.9900677027, 359.406480898, 5013427.76102, 1, 5, 110708.534551, 123268.300259, 17420.7296516, 12447.9100997, 0, 0, 0, 313167.537078},
+    {1321, 28.3195799543, 3518.95992165, 131456877.094, 1, 5, 175496.055284, 189164.290902, 12487.0944035, 8523.03529109, 0, 0, 0, 2340979.91181},
+    {784, 13.9531846279, 2319.11112634, 81738050.366, 1, 5, 223462.831095, 245539.429423, 239436.64012, 11890.984449, 0, 0, 0, 5709854.72753},
+    {1213, 124.322812603, 1318.34136318, 153308517.85, 1, 1, 327884.571554, 242930.179591, 168926.830212, 97.6774815134, 0, 0, 0, 7618103.98824},
+    {96, 383.619382889, 769.901728772, 1349142.82467, 1, 11, 265206.829227, 335766.636913, 16046.9218627, 11199.4796674, 8975.58453528, 1, 21431.2155281, 276805.568347},
+    {629, 335.353588179, 2356.20599633, 22991921.3579, 1, 13, 236599.375115, 243925.121822, 15180.9812223, 9804.62823919, 1821.6800939, 1, 13524.1498793, 447607.100221},
+    {1020, 100.346580872, 1056.47018672, 127004612.709, 1, 1, 147198.270668, 134259.923654, 32380.4457953, 29609.0187925, 1801.59278862, 1.001, 120439.933235, 2137515.9393},
+    {560, 320.882457881, 1258.84032719, 24316317.0079, 1, 3, 80438.8299108, 84761.1137148, 0, 0, 0, 0, 0, 878663.368264},
+    {1230, 259.094025468, 1046.05267896, 146200184.544, 1, 21, 790805.189187, 924687.659261, 468146.10097, 2564.4418077, 0, 0, 0, 4664902.47413},
+    {753, 5.11147355009, 841.376511601, 54512109.0336, 1, 6, 337024.846344, 371660.852191, 93057.8135551, 4026.36378575, 0, 0, 0, 10967976.2672},
+    {742, -0.308214408346, 1110.73394876, 28156923.6379, 1, 8, 174343.657612, 187009.070941, 7889.62816832, 1186.03403526, 0, 0, 0, 2383651.87906},
+    {10, 65.9174405594, 228.197681708, 13465.7445579, 1, 1, 163475.924236, 162559.588625, 0, 0, 0, 0, 0, -2},
+    {654, 225.055540892, 1369.20360052, 51053438.3908, 1, 4, 170462.495042, 181280.736153, 121550.014228, 3815.43032686, 0, 0, 0, 3152326.1009},
+    {1347, -6.40499471407, 2140.30151101, 119513350.482, 1, 1, 331638.850727, 311707.974, 46627.0820311, 3312.07433618, 0, 0.001, 11887.4109727, 1612791.0763},
+    {1106, -0.00047829002142, 3944.65197137, 99275442.9617, 1, 5, 2100.62494214, 320.347748132, 0, 0, 0, 0, 0, 10173058.8309},
+    {459, 0, 746.84519465, 18577167.6213, 1, 4, 345465.815129, 347434.03994, 41684.4802969, 38425.6672033, 1648.2128163, 1.001, 127763.426428, 4523582.54248},
+    {680, 239.832216232, 1149.12902013, 40570211.4865, 1, 4, 194765.512238, 195222.330277, 0, 0, 0, 0, 0, 851445.126475},
+    {533, 259.86237118, 742.423825672, 15346681.7451, 1, 10, 266849.23427, 297947.955805, 124321.178691, 5729.95848905, 0, 0, 0, 623822.694964},
+    {311, -0.36444726016, 1030.43219066, 3587937.51566, 1, 17, 323208.889004, 359907.04662, 13910.5649499, 8987.64772357, 0, 0.001, 18691.4254242, 169156.946933},
+    {1410, 160.879346849, 1427.14614799, 232761334.507, 1, 10, 375183.534674, 388951.553819, 49853.0377383, 2960.07359059, 0, 0, 0, 10250874.8241},
+    {1234, -1.15654351415, 2474.90099162, 157279826.185, 1, 4, 183401.751218, 215111.249986, 8057.46160588, 2588.54519206, 0, 0, 0, 3485768.56669},
+    {717, 208.188787857, 1087.47524551, 38072018.62, 1, 4, 301688.316243, 302894.880006, 24548.36061, 5305.50124659, 0, 0, 0, 1642352.82362},
+    {901, 417.93211348, 2974.20267923, 79616627.0484, 1, 14, 605584.436113, 759794.852635, 39188.5343985, 33326.6467307, 17339.1258504, 1, 76898.1386628, 1907652.1827},
+    {930, 390.415707189, 3158.41262032, 50660722.9899, 1, 6, 296288.181392, 309445.914807, 68226.8508321, 10299.5187544, 0, 0, 0, 1415475.1794},
+    {736, 362.643414392, 1491.35916357, 40021291.757, 1, 3, 113178.975992, 114038.068042, 7522.67367104, 1656.1534288, 0, 0, 0, 835077.228011},
+    {396, 226.273843316, 1410.61682655, 6054126.03242, 1, 1, 323743.905739, 313354.135825, 143159.068695, 10111.4710998, 0, 0, 0, 63855.4487794},
+    {1470, 54.6496784305, 804.526657646, 113721418.538, 1, 1, 272659.173106, 259709.191842, 0, 0, 0, 0, 0, 7317174.88878},
+    {924, 210.669281663, 1200.77209103, 94581283.8914, 1, 27, 847120.783015, 1247563.88562, 816222.196507, 4856.45208295, 0, 0, 0, 1110502.90602},
+    {101, 216.255198249, 441.660078763, 1131806.75401, 1, 5, 234766.445178, 244996.793801, 14314.3914595, 130.957154323, 0, 0, 0, 133682.494626},
+    {524, 78.7702981671, 1350.32764394, 14073924.9513, 1, 5, 77493.6080474, 80857.4788608, 0, 0, 0, 0, 0, 295722.671809},
+    {111, 16.2087382395, 397.602471167, 957024.180572, 1, 3, 144043.168642, 144256.259991, 0, 0, 0, 0, 0, 20468.3899468},
+    {198, -1.72978794634, 476.142134668, 2297097.76644, 1, 1, 261258.446164, 252051.285964, 27452.8490781, 8930.21713561, 0, 0.002, 44598.8931602, 101090.255381},
+    {920, -110.164212035, 1484.93627363, 104253089.12, 1, 4, 345407.93038, 349612.836502, 12700.9563624, 9503.2066145, 0, 0.001, 17467.303753, 11534600.1095},
+    {2, 16.1585965902, 370.22691126, 1028.41690736, 1, 1, 149867.41055, 88083.4932209, 0, 0, 0, 0, 0, -1},
+    {918, 149.801402005, 1572.83388647, 105640430.597, 1, 7, 532626.292267, 632471.416378, 205454.171703, 71811.8755437, 0, 0, 0, 14452952.2453},
+    {1012, -6.43702697098, 2133.09705585, 111154558.71, 1, 21, 869017.061826, 1268268.35668, 293214.771277, 59712.9653998, 18135.8413461, 2, 297556.11646, 5727096.47306},
+    {1004, 279.38185437, 1937.08725385, 80877148.088, 1, 3, 216637.255691, 218098.806824, 176310.641146, 12001.8074354, 0, 0, 0, 7428094.3346},
+    {243, 77.8960163724, 491.94929139, 5648944.34217, 1, 5, 235692.572358, 240773.120904, 4715.58612815, 1703.04176794, 0, 0, 0, 219587.650945},
+    {1200, 131.361034593, 2980.75511893, 108003937.574, 1, 3, 163052.649304, 163338.506629, 0, 0, 0, 0, 0, 2754452.47835},
+    {1476, 352.159743299, 1608.52086337, 163358162.512, 1, 4, 299862.492364, 300248.083951, 0, 0, 0, 0, 0, 11536451.3257},
+    {1350, -2010.37205845, 773.955603334, 247840040.676, 1, 3, 249990.593461, 250412.800617, 8723.91919132, 2037.54566417, 0, 0, 0, 8353359.58165},
+    {746, 335.010060692, 1983.12617054, 30884305.2658, 1, 11, 356898.8054, 391628.71829, 529241.37781, 19899.9069505, 0, 0, 0, 434694.260262},
+    {1182, 278.110919497, 3203.2715007, 62845875.2615, 1, 3, 83297.7629651, 83574.9738846, 0, 0, 0, 0, 0, 707334.299806},
+    {1478, 13.0874520428, 2708.07791644, 212061774.777, 1, 9, 342168.511823, 405619.810037, 289352.691327, 25118.3277152, 3333.30855476, 1.001, 81995.2649802, 587690.307238},
+    {1482, 122.145807718, 1360.04360082, 304635232.476, 1, 4, 85028.4015428, 85358.0957185, 7310.4083363, 125.460564551, 0, 0, 0, 1027125.65344},
+    {938, -0.592701854184, 1884.40143024, 30186224.6663, 1, 13, 451897.555525, 536595.357918, 226712.931126, 8916.50610254, 0, 0, 0, 1445804.6372},
+    {1286, 236.064000493, 2460.0153801, 94372067.1828, 1, 1, 142520.959292, 140908.951911, 0, 0, 0, 0, 0, 1685218.96099},
+    {1041, 253.331249155, 2086.54857369, 145821132.967, 1, 1, 161055.008687, 125838.628305, 153962.686031, 26707.2529264, 8730.4008483, 1.001, 147327.081848, 1746207.24313},
+    {235, 184.826170234, 482.939188414, 4362407.17927, 1, 5, 167643.921967, 181111.901998, 24934.2631484, 15010.3433374, 202.067301098, 1, 15671.7163796, 273361.227072},
+    {781, 96.7726815166, 1874.34016501, 73456762.6497, 1, 1, 153517.559767, 147301.973997, 35840.4009093, 9961.98752513, 111.122421952, 1, 32929.9771793, 2338275.66585},
+    {1414, 489.722269692, 4145.40131597, 117004521.761, 1, 7, 142416.590271, 150018.857122, 38393.0033477, 8725.6655061, 0, 0.001, 17713.4255289, 1554905.06119},
+    {145, 302.529150423, 701.68033467, 2245286.09548, 1, 3, 111345.61166, 112294.209358, 27611.9606424, 5658.28340407, 0, 0.001, 16768.5942699, 223276.335886},
+    {884, 97.6372718019, 675.37246555, 94322184.5019, 1, 1, 264590.386587, 200612.513338, 150526.54853, 3365.56017553, 0, 0, 0, 3596582.93292},
+    {223, 199.304142638, 552.733490782, 4088978.95513, 1, 3, 181024.206684, 181715.733514, 0, 0, 0, 0, 0, 555696.325268},
+    {447, 365.08416255, 2490.21490101, 19226345.6128, 1, 3, 160412.238188, 160811.212507, 3478.02447753, 262.696037235, 0, 0, 0, 2880878.41457},
+    {1122, 34.6841647327, 1864.43832056, 46180864.7699, 1, 8, 105301.786172, 112816.505199, 3583.14411638, 2379.71654721, 0, 0.001, 6675.37088803, 841510.115282},
+    {250, 29.4567227249, 1715.32033113, 9640655.31301, 1, 1, 126207.174651, 91590.2828577, 121259.03723, 5070.22406644, 0, 0, 0, 719802.426749},
+    {999, -0.803749720566, 1203.07512835, 55405316.0915, 1, 6, 356824.586851, 378290.652059, 129686.988884, 16366.1614563, 0, 0.001, 23463.7178821, 1140548.63699},
+    {148, -4.84381901817, 345.504472017, 1389027.38394, 1, 3, 92877.0393529, 92949.0727267, 3887.04474762, 1141.13352905, 0, 0, 0, 146484.831602},
+    {899, 146.999770678, 1062.05917495, 104095454.205, 1, 8, 189000.844837, 196442.57684, 11398.216263, 8011.34910459, 5160.6667074, 1.001, 33700.2044066, 3745015.78127},
+    {1408, -211.879099402, 1080.66114603, 267756013.447, 1, 5, 490715.154094, 739354.79037, 108738.832704, 13416.3432054, 0, 0, 0, 7871033.63724},
+    {24, 422.91674865, 721.738017315, 59363.6327463, 1, 1, 69687.3542918, 69114.5596587, 3459.29725722, 574.287406406, 0, 0, 0, 2961.30757761},
+    {609, 419.020101371, 1672.62192222, 47159724.6502, 1, 1, 276353.039386, 274958.329752, 8381.64906059, 1012.40464573, 0, 0, 0, 7044203.12895},
+    {266, 114.519454407, 574.123462253, 9323813.97257, 1, 10, 172375.749059, 208755.517033, 62197.2976125, 18486.7757229, 889.580593281, 1.001, 51813.6890933, 579775.217481},
+    {1304, 0.873721271753, 1824.2369374, 158909432.572, 1, 1, 336168.678664, 333552.321463, 0, 0, 0, 0, 0, 12055952.2785},
+    {281, 63.1968271406, 702.167489328, 11492726.7013, 1, 3, 278925.623589, 279647.403095, 0, 0, 0, 0, 0, 3221275.37994},
+    {386, 14.9175912617, 1579.60833383, 8145400.68157, 1, 20, 690047.827092, 769350.789295, 51775.2671455, 17101.6477223, 0, 0.002, 77135.9061876, 620101.331754},
+    {760, 7.76840585005, 2232.6072968, 63369144.9601, 1, 1, 151211.269214, 150371.587591, 4315.85537152, 1363.35604779, 0, 0, 0, 2886042.09674},
+    {240, 65.9469032278, 1046.06254293, 4211466.66358, 1, 3, 315350.814376, 315472.918586, 0, 0, 0, 0, 0, 574825.243699},
+    {1057, 332.437216101, 2390.47719631, 111348162.288, 1, 9, 305058.932556, 333231.191266, 13862.2550244, 9067.83305921, 0, 0, 0, 3311826.84347},
+    {650, 203.40748967, 1252.84867019, 45047463.7704, 1, 13, 391643.578281, 436310.805811, 17527.4876497, 14490.7559526, 0, 0, 0, 5286635.15241},
+    {621, 186.962838133, 901.511010605, 19749650.2114, 1, 11, 435033.694489, 618282.742513, 301001.132659, 598.368057607, 0, 0, 0, 1742226.26366},
+    {937, 34.1387214922, 2235.99472901, 47129451.8052, 1, 3, 84314.723113, 84390.1639251, 0, 0, 0, 0, 0, 508440.58431},
+    {629, 321.252063189, 1161.43862629, 17195478.6032, 1, 22, 359050.760036, 540065.01843, 259850.338718, 14537.2440471, 0, 0, 0, 591405.986205},
+    {606, -52.8449727828, 726.403159898, 29781447.4257, 1, 7, 98446.8936469, 2664.87844381, 0, 0, 0, 0, 0, 4717101.26829},
+    {1026, 84.4836018177, 3056.62683457, 135755193.5, 1, 13, 475371.425697, 575136.08058, 247062.757683, 45362.7185845, 0, 0, 0, 10897395.2338},
+    {615, 224.52764637, 2769.874696, 33041717.8404, 1, 3, 191535.318727, 192188.09432, 8692.83107725, 799.541920904, 0, 0, 0, 4241807.75718},
+    {535, 34.9820958348, 530.893612118, 17748369.1578, 1, 3, 62945.1273988, 62981.6737766, 0, 0, 0, 0, 0, 267501.257995},
+    {520, 115.45834764, 1157.76148773, 16829035.7409, 1, 6, 240706.196877, 244784.568173, 3648.6910734, 1266.46072341, 0, 0, 0, 1270996.93059},
+    {348, 453.887317711, 782.46983054, 17996744.8423, 1, 4, 243933.218076, 246702.247013, 0, 0, 0, 0, 0, 3235493.27554},
+    {492, 314.80528176, 1490.84320884, 26208127.8805, 1, 7, 260982.151704, 298789.193055, 92495.9496414, 5260.18919116, 0, 0, 0, 3918661.89919},
+    {558, 347.84626419, 1389.97085456, 30197092.2293, 1, 6, 143046.993221, 165631.506609, 227681.196224, 39483.6983859, 0, 0.001, 30211.5250675, 1273772.50936},
+    {849, 204.370302117, 1647.53633323, 65395786.1819, 1, 3, 174788.670005, 175428.903084, 0, 0, 0, 0, 0, 5174099.96638},
+    {1055, 58.5304315449, 1391.03037779, 78725929.8443, 1, 4, 73013.2981162, 74177.5991129, 0, 0, 0, 0, 0, 654207.648012},
+    {743, 325.495257249, 2590.20696767, 33609940.6597, 1, 5, 312487.573292, 322381.843548, 0, 0, 0, 0, 0, 1648234.73021},
+    {361, 59.8831122834, 1734.12281773, 5029270.32046, 1, 1, 88400.3310186, 86363.7611354, 16592.9316371, 3107.94785655, 0, 0, 0, 188478.520801},
+    {474, 51.6633522427, 3375.67569328, 9114776.56029, 1, 7, 38074.1375471, 1400.88198596, 0, 0, 0, 0, 0, 3855158.15056},
+    {1353, 1.71201805212, 2290.61561387, 188282649.513, 1, 5, 168651.802352, 177235.887331, 1217463.10164, 31774.0479881, 0, 0, 0, 1460046.72719},
+    {152, 447.182461681, 951.724458318, 2374199.95233, 1, 1, 302410.652318, 301609.196045, 0, 0, 0, 0, 0, 422191.127673},
+    {369, 127.862821583, 1551.28723348, 14702240.9498, 1, 6, 373506.890284, 380008.45453, 36440.3082525, 10184.1487417, 0, 0.002, 57470.1987436, 655855.860783},
+    {210, -23.7810676601, 409.604377453, 4135961.56862, 1, 1, 102357.055961, 83495.4501371, 22623.104842, 16670.0791044, 0, 0, 0, 279117.506591},
+    {206, 413.549649813, 1492.34838519, 5915114.1932, 1, 4, 301345.740726, 304745.435481, 0, 0, 0, 0, 0, 248262.487959},
+    {1215, -0.193416394293, 2124.18730595, 103316257.801, 1, 13, 385057.264871, 471382.538816, 61592.1933632, 17084.58322, 0, 0, 0, 2098369.20528},
+    {687, 247.323449384, 861.260353027, 15213894.0391, 1, 3, 64779.3166126, 65625.5304373, 0, 0, 0, 0, 0, 397951.571306},
+    {1167, 469.013928099, 3045.53779706, 130811623.922, 1, 1, 57144.0993417, 52018.0167014, 43118.3707706, 10697.4315307, 0, 0, 0, 257869.53064},
+    {678, 5.50601900183, 407.654694194, 62468680.1102, 1, 3, 168751.774543, 169841.058326, 861.343256208, 315.570594197, 0, 0, 0, 5569115.17268},
+    {1404, -1364.08990648, 541.695898605, 254691011.185, 1, 5, 221641.018911, 221994.068998, 0, 0, 0, 0, 0, 6084976.95799},
+    {633, 101.874256288, 1628.07345002, 35426331.9367, 1, 10, 204407.794749, 217935.716542, 13411.7041214, 7006.91403024, 0, 0, 0, 886524.323601},
+    {1031, 78.5943103302, 1271.41410834, 73229261.0898, 1, 5, 76013.8245594, 77798.0558921, 27905.9182605, 911.823054091, 0, 0, 0, 571194.484131},
+    {1419, 192.82781396, 1807.73037188, 146323847.704, 1, 1, 288389.820316, 227762.611134, 1168069.03613, 82368.5207402, 19647.6009527, 3, 513946.30849, 5945932.69297},
+    {1115, 202.31565527, 1283.36671123, 76087137.1484, 1, 1, 162028.256511, 147627.945132, 53363.0491227, 1443.70479925, 0, 0, 0, 2568488.81288},
+    {767, 219.104494213, 1670.31827346, 33358695.4478, 1, 5, 85215.0507248, 87605.3322606, 345179.119659, 9657.27826008, 0, 0, 0, 868183.960637},
+    {391, 421.680327555, 1589.92135775, 8543582.64929, 1, 4, 219139.915662, 223925.068894, 19603.1750679, 3054.670668, 0, 0, 0, 231299.995297},
+    {1336, 438.441299507, 1993.4181175, 192929553.514, 1, 4, 247985.950974, 250136.279359, 7046.10388026, 116.420010406, 0, 0, 0, 4712776.47405},
+    {850, 161.904834808, 905.505305761, 106639769.979, 1, 1, 83006.5494965, 82245.6025604, 0, 0, 0, 0, 0, 336342.997806},
+    {342, 286.459223046, 1058.00195618, 4813502.9215, 1, 7, 142866.628344, 145009.027701, 53182.474762, 6261.31776738, 0, 0.001, 18876.140449, 146899.196945},
+    {130, 54.0659223683, 333.056674209, 1576890.91408, 1, 1, 237546.686479, 229460.69524, 6490.0844392, 3332.71619658, 0, 0, 0, 32095.4521063},
+    {37, 271.430318982, 655.76200753, 95264.1150822, 1, 1, 57771.5250042, 31529.7064052, 0, 0, 0, 0, 0, -2},
+    {305, 76.6209375067, 1500.82665316, 5883510.78716, 1, 5, 218561.316877, 219217.764157, 21645.3004773, 16064.5919629, 2690.26056594, 1, 14913.7874587, 264829.611087},
+    {433, 212.57502317, 1286.17413069, 25783451.8232, 1, 5, 57378.5388138, 58121.8604469, 4690.10142075, 3211.88548931, 726.199566204, 1, 5243.08557366, 177350.847921},
+    {668, 230.590433681, 2028.08114615, 24136754.8082, 1, 1, 72462.5616969, 50643.5646945, 24115.4964619, 19375.7427569, 0, 0, 0, 208893.530669},
+    {557, -53.3400201732, 1581.8054779, 36602190.0622, 1, 4, 165905.478502, 173688.806933, 13638.6787945, 11333.8406242, 0, 0, 0, 2418275.37432},
+    {172, -1.42789457552, 173.968710643, 1807973.85902, 1, 8, 283230.799717, 359497.2919, 21776.1574866, 6923.98084632, 0, 0, 0, 103350.219168},
+    {286, 235.000034174, 952.29968204, 11337598.6335, 1, 5, 181746.040228, 189743.891123, 96148.4840025, 22179.7880894, 0, 0, 0, 2044958.67218},
+    {1217, 370.611367952, 3175.3428608, 115903477.839, 1, 1, 74024.7316196, 54416.6626037, 233163.49494, 2175.92282818, 0, 0, 0, 245131.344046},
+    {580, 108.132500543, 1533.26072242, 33021552.3766, 1, 4, 239261.064521, 240017.234341, 9193.49831914, 3488.28519909, 0, 0, 0, 3153407.79963},
+    {801, 236.589348999, 2025.40276344, 84300351.686, 1, 3, 155934.695183, 157934.140358, 20946.6054763, 3382.77194587, 0, 0, 0, 3163152.14988},
+    {1137, 158.850078552, 1816.10612046, 170044489.97, 1, 11, 741677.753352, 843023.736505, 934663.289926, 52145.4246292, 0, 0.002, 66766.3547508, 10483506.9452},
+    {1093, 460.058487219, 2514.26619502, 43417279.1482, 1, 3, 91377.7840913, 92420.8049927, 0, 0, 0, 0, 0, 1443501.15239},
+    {791, 93.0245441208, 1619.01500847, 35673580.255, 1, 13, 449693.176596, 619934.944397, 24535.5779259, 19346.0005304, 4835.34385882, 1.001, 82831.9189964, 3424710.55225},
+    {1453, -208.797668858, 1673.98816141, 290429375.647, 1, 6, 360818.288748, 364857.948975, 28326.7404572, 5121.15431008, 0, 0, 0, 17182843.6123},
+    {158, 400.718339454, 1183.00107137, 1477442.34479, 1, 5, 228435.948828, 231592.122013, 25951.307044, 5218.47710499, 0, 0, 0, 163539.292622},
+    {879, -121.239202169, 1045.38286145, 104885338.202, 1, 1, 190574.606381, 136790.564543, 435948.477029, 1298.62684418, 0, 0, 0, 2077536.17408},
+    {1277, 49.0316420404, 1674.06973117, 157165876.197, 1, 9, 278396.038332, 371504.720485, 125903.975086, 55724.0379075, 0, 0, 0, 2918271.1595},
+    {352, 227.730490443, 929.536343396, 12352868.8511, 1, 1, 271567.139299, 256558.986504, 37513.8892058, 31879.6864215, 0, 0, 0, 1283271.21792},
+    {491, 218.00647004, 708.796161835, 12073741.8735, 1, 1, 264332.160981, 263564.008174, 0, 0, 0, 0, 0, 183128.140112},
+    {1231, 12.7965271519, 1690.74591632, 193561402.6, 1, 3, 291651.054136, 291832.419677, 6798.63579783, 679.750151253, 0, 0, 0, 9360950.66642},
+    {890, 382.163119953, 2688.94954264, 52559644.047, 1, 11, 341553.346179, 676501.342315, 149733.970316, 1601.40723278, 0, 0, 0, 1191401.41789},
+    {37, 369.102320853, 662.024627933, 187378.3108, 1, 7, 148739.900711, 159199.052263, 8180.91776949, 1177.60374242, 0, 0, 0, 8103.7620311},
+    {737, 318.946136169, 2269.83651372, 33931751.3747, 1, 1, 154770.59111, 148009.631903, 32346.8623216, 3837.37570364, 0, 0, 0, 1703365.36678},
+    {995, -3.93645570613, 1681.78670436, 41323891.3068, 1, 10, 234822.044263, 281048.083938, 295244.56537, 22088.7106427, 16545.5682577, 1, 43934.9777107, 1655978.715},
+    {124, 386.420195704, 977.451608552, 679821.659861, 1, 3, 298553.354216, 299517.943341, 4090.1106944, 157.533878587, 0, 0, 0, 17452.5762662},
+    {262, 380.878386942, 944.1410994, 7255570.70351, 1, 10, 322653.895465, 370304.948864, 29345.3499361, 25048.7288659, 8281.28187527, 1.001, 95140.0818336, 474026.701742},
+    {1283, -17.6807363452, 1765.8296979, 144182778.364, 1, 3, 330602.33929, 330852.966859, 5249.47743663, 880.01663448, 0, 0, 0, 13180557.9102},
+    {22, 3.5779619768, 387.780964106, 72689.4256603, 1, 5, 170826.483723, 177469.758674, 5819.08513675, 784.641755944, 0, 0, 0, -3},
+    {1439, 104.531985681, 1451.75819318, 97902038.0747, 1, 1, 296880.049705, 233207.411207, 714935.626156, 5827.80239428, 0, 0, 0, 6066955.85526},
+    {900, -11.7395722121, 2013.34480949, 25641139.2257, 1, 5, 194363.212346, 195073.618896, 11170.8897332, 585.033782148, 0, 0, 0, 736531.309631},
+    {672, 226.422670594, 1864.33787149, 21551490.0633, 1, 6, 219381.814461, 260600.323108, 82085.0474338, 6166.85314706, 0, 0.001, 32460.9348104, 1140329.32647},
+    {579, 116.082544358, 1303.93657718, 30836522.6219, 1, 12, 285385.938581, 312742.981984, 255927.382829, 17514.5548357, 5399.00375975, 1.001, 69227.2298196, 591167.77173},
+    {366, -0.00402374891325, 1396.18126661, 12099473.7507, 1, 1, 227725.642039, 220811.319854, 36949.5485667, 5130.07056028, 0, 0, 0, 227513.440823},
+    {1084, 272.787771633, 1691.93397652, 38930474.2572, 1, 1, 91471.8384261, 89509.6950011, 0, 0, 0, 0, 0, 1015527.76951},
+    {252, 191.856366369, 769.98051207, 3636767.6629, 1, 3, 104425.229978, 104674.559421, 0, 0, 0, 0, 0, 339805.240395},
+    {65, 104.00389336, 706.015562025, 285071.554117, 1, 5, 254643.940432, 269040.529241, 6204.47981713, 2159.66621637, 0, 0, 0, 14813.1660114},
+    {1216, 47.589442404, 2319.6341341, 140995425.716, 1, 4, 250044.703331, 251517.32222, 2771.11258971, 108.016261471, 0, 0, 0, 10800674.1234},
+    {1471, -39.4375821908, 3529.58262997, 87294729.6939, 1, 12, 708851.117554, 1502294.78603, 1074292.56202, 51006.9605158, 5600.44451842, 1, 101686.384813, 3459700.03564},
+    {62, -0.484389320053, 341.747461776, 382394.560765, 1, 5, 113014.607356, 116280.772237, 5129.02812895, 1377.25908887, 0, 0, 0, 75044.0563189},
+    {896, 160.762529328, 2171.53278027, 109241662.657, 1, 12, 529679.873408, 647587.258066, 82967.3294668, 41419.4048225, 0, 0, 0, 1457242.5255},
+    {1112, -595.709218121, 448.588829706, 167086340.397, 1, 3, 63361.7841181, 106172.689775, 26191.4619249, 24257.8703558, 0, 0, 0, 611775.690278},
+    {399, 205.615942142, 1051.6467088, 18229025.8055, 1, 1, 109568.752077, 91703.8557565, 34046.0519431, 67.9677993728, 0, 0, 0, 1195978.60898},
+    {744, -30.278460158, 720.76348464, 25122926.1369, 1, 10, 440589.758168, 468684.194944, 430713.874796, 14898.606665, 0, 0, 0, 427663.772948},
+    {1375, 32.5161450626, 2860.64952011, 266880066.691, 1, 5, 178466.785298, 181690.66557, 6421.14554075, 991.905143876, 0, 0, 0, 3211990.13935},
+    {1489, 232.693444792, 3871.43038859, 99160536.0763, 1, 8, 295318.069786, 299601.832344, 8052.36501961, 33.9017793283, 0, 0, 0, 4566900.80768},
+    {996, 256.454137606, 1571.22475021, 101285659.733, 1, 4, 190360.900016, 191172.78446, 33584.5897909, 10145.781327, 5164.28625353, 1, 12568.408483, 4313332.48715},
+    {322, 214.554560526, 1331.66136138, 6989331.76342, 1, 3, 235226.429588, 235501.135469, 0, 0, 0, 0, 0, 1054664.258},
+    {1328, 128.013443087, 2846.78789624, 125633265.396, 1, 16, 1133231.04093, 1719319.19222, 524138.985384, 42601.098904, 9341.50513307, 1.001, 56125.912596, 3658956.68004},
+    {1464, 357.023953494, 3125.37688127, 123224662.683, 1, 4, 117432.846092, 122154.288476, 3591.42233129, 968.608029344, 0, 0, 0, 2626745.45828},
+    {1284, -4.44192913652, 1438.88610739, 243742105.453, 1, 7, 275582.630045, 362842.743324, 80958.1134792, 29118.7585656, 13190.6077858, 1, 27890.8517432, 1487444.44068},
+    {1404, 303.5288628, 1350.71081509, 212689095.15, 1, 4, 350613.759704, 351331.905635, 7790.57852836, 3563.88893905, 0, 0, 0, 15083919.0883},
+    {423, 22.9760183571, 1840.97580502, 9942637.03068, 1, 8, 142700.96323, 147069.747322, 115193.068348, 10080.5932017, 0, 0, 0, 377383.225903},
+    {1115, -991.497155991, 546.664620188, 155350647.277, 1, 4, 171479.600014, 179059.998977, 73809.6441962, 20844.4081321, 0, 0, 0, 1306232.91093},
+    {755, 288.63614582, 1628.61897992, 28523192.9713, 1, 3, 230678.237586, 231455.875755, 8339.1419981, 2001.16873813, 0, 0, 0, 3452726.57087},
+    {1405, 47.0379697094, 1837.73858669, 284265635.389, 1, 1, 151970.773461, 116590.80477, 382247.74342, 15637.4352045, 0, 0.001, 107048.456655, 1934007.01629},
+    {584, -0.0820927478446, 1987.23408766, 44860525.187, 1, 3, 225918.393079, 226956.817666, 0, 0, 0, 0, 0, 4309426.29877},
+    {42, 382.724707582, 645.990813592, 146408.571846, 1, 1, 143970.369898, 142387.488648, 2623.30429239, 42.2342262886, 0, 0, 0, 4612.7113331},
+    {1492, 263.995022622, 2361.07962007, 86518551.6653, 1, 1, 155649.594409, 155250.79968, 0, 0, 0, 0, 0, 2262723.2553},
+    {479, -0.00344196241349, 1466.83531941, 12833390.4517, 1, 3, 238602.413463, 238662.66263, 0, 0, 0, 0, 0, 846650.513104},
+    {1204, 77.561463424, 3183.62188107, 136295062.257, 1, 12, 433251.64183, 563638.217274, 409281.603928, 37668.92722, 0, 0, 0, 2285405.22459},
+    {833, 62.846075478, 1427.52413087, 45836165.8681, 1, 3, 261141.253908, 261346.579095, 18252.1784225, 2431.13216529, 0, 0, 0, 3321118.76048},
+    {893, 25.6418196345, 2498.42572244, 56962946.9517, 1, 10, 589536.182559, 840666.413957, 186894.790857, 33278.3245432, 0, 0, 0, 5103259.05738},
+    {632, 504.632417131, 2006.90892665, 59487417.8813, 1, 10, 363010.456671, 453517.273544, 167128.234191, 2249.12224997, 0, 0, 0, 3104907.81611},
+    {250, 225.948180206, 544.453416946, 7692119.00752, 1, 3, 270333.710839, 271179.682547, 7787.63058022, 3138.99568144, 0, 0, 0, 550606.199263},
+    {1095, 72.2982806183, 1712.89147826, 128116782.407, 1, 7, 254357.326751, 328257.505409, 124331.092854, 11332.0656551, 2724.2471301, 1.001, 19773.9693231, 5640440.92772},
+    {1499, 147.602954718, 3354.5564764, 132350375.863, 1, 4, 240317.441167, 250383.81956, 28839.8238424, 3745.16786331, 0, 0, 0, 3017774.15095},
+    {111, 22.7170050498, 756.084733563, 1371320.05409, 1, 1, 244815.02519, 236350.017364, 15122.5300941, 9209.66831285, 0, 0.001, 21270.1591388, 88729.2309489},
+    {1061, -17.9019049723, 1195.33205219, 98787253.0647, 1, 8, 276309.310955, 291113.210147, 29799.3241366, 6522.7774339, 0, 0, 0, 2990476.63586},
+    {962, 429.18104135, 2486.54633796, 138731794.93, 1, 4, 185209.797579, 191059.1854, 4849.87867884, 2651.29921018, 0, 0, 0, 2543201.33721},
+    {674, 192.867809003, 2160.75463187, 26646326.5279, 1, 4, 127276.802474, 129287.56564, 0, 0, 0, 0, 0, 915706.863638},
+    {1272, 55.7470000908, 2009.47182101, 55122106.2422, 1, 7, 86313.2765247, 2816.29579458, 29263.8532621, 24180.9651665, 38.7375924136, 1, 9670.10171591, 964511.504855},
+    {919, 36.334071232, 1800.89020734, 103273604.732, 1, 3, 168236.546162, 169323.656799, 0, 0, 0, 0, 0, 4685453.24136},
+    {1169, 323.048208471, 1960.84453625, 96652251.7005, 1, 3, 338637.044023, 339657.659482, 0, 0, 0, 0, 0, 8893764.24129},
+    {628, -3.32380220831, 1828.33401943, 23076069.5182, 1, 1, 289859.116096, 278592.638545, 22216.1473844, 12.5157586607, 0, 0, 0, 685272.298461},
+    {888, 90.2852171445, 1158.41663631, 66447930.2908, 1, 1, 291243.892571, 285476.498812, 10824.6298815, 724.312173342, 0, 0, 0, 5857533.44713},
+    {1132, 5.18356307596, 3236.83939252, 110196677.761, 1, 1, 240612.851436, 236702.075782, 29089.454658, 8238.40255505, 0, 0.002, 46816.3901855, 7222596.51111},
+    {243, 417.15226074, 1376.69322416, 7232069.36322, 1, 3, 210433.211764, 210908.020486, 0, 0, 0, 0, 0, 737633.894669},
+    {217, 74.6469161175, 395.62766434, 3636847.77622, 1, 7, 34252.7835383, 1128.96343476, 0, 0, 0, 0, 0, 3154682.12304},
+    {757, 44.8415662888, 2621.34705848, 51117526.1405, 1, 3, 154619.270772, 155759.07649, 0, 0, 0, 0, 0, 3294949.35183},
+    {1192, 185.884079337, 3742.58267431, 67437068.6291, 1, 7, 112353.671293, 1290.79088483, 0, 0, 0, 0, 0, 8723600.61073},
+    {848, 259.060596899, 1443.06623815, 65141321.0144, 1, 5, 84731.0945115, 90790.1698605, 6579.18759314, 456.200293976, 0, 0, 0, 685637.93231},
+    {390, 149.109412726, 997.845327288, 10781843.9898, 1, 5, 224194.154076, 224770.954545, 6670.61382503, 85.370608051, 0, 0, 0, 547988.356451},
+    {665, 300.079923628, 1130.96355016, 54386992.5792, 1, 1, 241059.024284, 240338.112635, 5714.13099671, 690.14234249, 0, 0, 0, 4868601.44746},
+    {693, 282.388130328, 1596.74411802, 59433550.8007, 1, 3, 91331.1638258, 91748.1592283, 6172.06174232, 933.276858113, 0, 0, 0, 611228.673529},
+    {680, -31.1683220677, 558.619198372, 16726041.0523, 1, 3, 97539.1431504, 97664.4755252, 228108.450136, 11182.977086, 1969.66383664, 1.001, 31565.0202309, 451354.677027},
+    {209, 394.961225349, 1069.33131409, 2956953.36187, 1, 5, 242048.516198, 243099.192862, 11272.7035434, 39.5116612124, 0, 0, 0, 73030.6041745},
+    {914, -0.523868175223, 2574.64245007, 63691827.8051, 1, 17, 896780.984938, 1240640.49369, 643500.796356, 50921.706057, 16574.5582614, 1.001, 105163.139087, 4653130.47243},
+    {366, 157.017473403, 1134.89536438, 13031352.8817, 1, 4, 152681.393859, 152923.616907, 2234.75343236, 1221.43544419, 0, 0, 0, 1276342.95023},
+};
+
+static void addSample(double value, Digest* d)
+{
+    if (std::isfinite(value)) {
+        d->samples += value;
+    } else {
+        d->nonFinite += 1;
+    }
+}
+
+static double sumPoints(const mccvis::PointVector& points)
+{
+    double sum = 0;
+    for (const mccvis::Point& p : points) {
+        sum += p.x() + p.y();
+    }
+    return sum;
+}
+
+static double sumIntervals(const mccvis::IntervalVector& intervals)
+{
+    double sum = 0;
+    for (const mccvis::Interval& i : intervals) {
+        sum += i.end() - i.start() + 1e-3 * i.start();
+    }
+    return sum;
+}
+
+template <typename H>
+static double sumHits(const std::vector<H>& hits)
+{
+    double sum = 0;
+    for (const H& h : hits) {
+        sum += h.detection.x() + h.detection.y() + h.hit.x() + h.hit.y() + h.endX;
+    }
+    return sum;
+}
+
+static Digest digest(const mccvis::Profile& prof)
+{
+    Digest d = {};
+    d.size = prof.size();
+    d.hmin = prof.hmin();
+    d.hmax = prof.hmax();
+    double lastX = 0;
+    for (std::size_t i = 0; i < prof.size(); i++) {
+        mccvis::Profile::Data s = prof.sample(i);
+        for (double value : {s.profile.x(), s.profile.y(), s.target.x(), s.target.y(), s.dy, s.kview}) {
+            addSample(value, &d);
+        }
+        lastX = s.profile.x();
+    }
+
+    const mccvis::Rays& rays = prof.rays();
+    d.rays = rays.ends.size() + 2 * rays.minIsCut + 4 * rays.maxIsCut;
+    d.rayPoints = rays.start.x() + rays.start.y() + rays.minEnd.x() + rays.minEnd.y() + rays.maxEnd.x() + rays.maxEnd.y();
+    for (const mccvis::RayEnd& end : rays.ends) {
+        d.rayPoints += end.peak.x() + end.peak.y() + end.end.x() + end.end.y() + end.hasTargetIntersections;
+    }
+    d.viewRegion = sumPoints(prof.viewRegion());
+    d.intersections = sumPoints(prof.viewIntersections());
+    d.visionIntervals = sumIntervals(prof.horizontalVisionIntervals());
+    d.hitIntervals = sumIntervals(prof.horizontalHitIntervals());
+    d.hits = prof.hits().size() + 1e-3 * prof.outOfRangeHits().size();
+    d.hitPoints = sumHits(prof.hits()) + sumHits(prof.outOfRangeHits());
+    for (double x = 0; x < lastX; x += 997) {
+        auto interval = prof.verticalVisionIntervalAt(x);
+        if (interval.isSome()) {
+            d.vertical += interval->first + 2 * interval->second;
+        } else {
+            d.vertical -= 1;
+        }
+    }
+    return d;
+}
+
+// recorded values have 12 significant digits
+static bool near(double a, double b)
+{
+    return std::abs(a - b) <= 1e-6 + 1e-9 * std::max(std::abs(a), std::abs(b));
+}
+
+int main()
+{
+    // std distributions differ between standard libraries, recorded cases need same terrain everywhere
+    std::mt19937 rng(12345);
+    auto unit = [&rng]() { return rng() / 4294967296.0; };
+    const std::size_t cases = sizeof(expected) / sizeof(expected[0]);
+    const std::size_t fieldsCount = sizeof(fields) / sizeof(fields[0]);
+    std::size_t failures = 0;
+
+    for (std::size_t c = 0; c < cases; c++) {
+        // random walk terrain with occasional ridges
+        std::size_t size = 2 + std::size_t(unit() * 1500);
+        double step = 30 + unit() * 120;
+        double h = unit() * 500;
+        mccvis::PointVector slice;
+        slice.reserve(size);
+        for (std::size_t i = 0; i < size; i++) {
+            h += (unit() - 0.5) * 40;
+            if (unit() < 0.01) {
+                h += unit() * 400;
+            }
+            slice.emplace_back(i * step, std::max(0.0, h));
+        }
+
+        mccvis::ViewParams params;
+        params.radarHeight = unit() * 50;
+        params.minAngle = -5 + unit() * 4;
+        params.maxAngle = 10 + unit() * 60;
+        params.maxBeamDistance = 20000 + unit() * 120000;
+        params.minBeamDistance = unit() * 3000;
+        params.objectHeight = 10 + unit() * 500;
+        params.maxHitDistance = params.maxBeamDistance * unit();
+        params.minHitDistance = params.maxHitDistance * unit();
+        params.isRelativeHeight = unit() < 0.8;
+        params.isTargetRelativeHeight = unit() < 0.7;
+        params.hasRefraction = unit() < 0.3;
+        params.canViewGround = unit() < 0.8;
+        params.useFresnelRegion = unit() < 0.3;
+        params.calcHits = unit() < 0.7;
+        params.isTargetDirectedTowards = unit() < 0.5;
+
+        Digest d = digest(mccvis::Profile(0, slice, params));
+        const double* actual = &d.size;
+        const double* recorded = &expected[c].size;
+        for (std::size_t i = 0; i < fieldsCount; i++) {
+            if (!near(actual[i], recorded[i])) {
+                failures++;
+                std::printf("case %zu: %s differ, %.12g instead of %.12g\n", c, fields[i], actual[i], recorded[i]);
+            }
+        }
+    }
+
+    std::printf("%zu profiles checked, %zu differences\n", cases, failures);
+    return failures == 0 ? 0 : 1;
+}
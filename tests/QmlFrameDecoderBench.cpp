@@ -0,0 +1,127 @@
+#include "mcc/qml/QmlDataConverter.h"
+#include "mcc/qml/QmlFrameDecoder.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QTimer>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+static constexpr int fieldsCount = 200;
+static constexpr int rate = 50;
+static constexpr int seconds = 5;
+
+// Panel with one bound property per field. Old path decodes every field in js from list of bytes,
+// new path passes frame as ArrayBuffer to decoder
+static QByteArray makePanel()
+{
+    QByteArray qml = "import QtQml 2.2\n"
+                     "QtObject {\n"
+                     "    id: root\n"
+                     "    function makeLayout() {\n"
+                     "        var layout = []\n"
+                     "        for (var i = 0; i < " + QByteArray::number(fieldsCount) + "; i++)\n"
+                     "            layout.push({name: 'f' + i, type: 'f32le'})\n"
+                     "        return layout\n"
+                     "    }\n"
+                     "    property var decoder: dataConverter.createFrameDecoder(makeLayout())\n"
+                     "    function decodeOld(bytes) {\n"
+                     "        for (var i = 0; i < " + QByteArray::number(fieldsCount) + "; i++)\n"
+                     "            root['o' + i] = dataConverter.toFloatLe(bytes.slice(i * 4, i * 4 + 4))\n"
+                     "    }\n"
+                     "    function decodeNew(frame) {\n"
+                     "        decoder.frame = frame\n"
+                     "    }\n";
+    for (int i = 0; i < fieldsCount; i++) {
+        qml += "    property real o" + QByteArray::number(i) + "\n";
+        qml += "    property real f" + QByteArray::number(i) + ": decoder.values.f" + QByteArray::number(i) + "\n";
+    }
+    qml += "}\n";
+    return qml;
+}
+
+static QByteArray makeFrame(int n)
+{
+    QByteArray frame(fieldsCount * 4, 0);
+    for (int i = 0; i < fieldsCount; i++) {
+        // every field changes in every frame
+        float value = float(n * fieldsCount + i);
+        std::memcpy(frame.data() + i * 4, &value, 4);
+    }
+    return frame;
+}
+
+static QVariantList toList(const QByteArray& frame)
+{
+    QVariantList list;
+    list.reserve(frame.size());
+    for (char c : frame) {
+        list.append(int((uint8_t)c));
+    }
+    return list;
+}
+
+// frames are sent by timer at 50 Hz, returns time spent in panel per frame in microseconds
+static double run(QObject* panel, bool isOld)
+{
+    qint64 busy = 0;
+    int n = 0;
+    QEventLoop loop;
+    QTimer timer;
+    timer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&timer, &QTimer::timeout, [&]() {
+        QByteArray frame = makeFrame(n);
+        QElapsedTimer t;
+        t.start();
+        if (isOld) {
+            // list conversion is part of old path, bytes reach js as list of numbers
+            QMetaObject::invokeMethod(panel, "decodeOld", Q_ARG(QVariant, QVariant(toList(frame))));
+        } else {
+            QMetaObject::invokeMethod(panel, "decodeNew", Q_ARG(QVariant, QVariant(frame)));
+        }
+        busy += t.nsecsElapsed();
+        if (++n == rate * seconds) {
+            loop.quit();
+        }
+    });
+    timer.start(1000 / rate);
+    loop.exec();
+    return busy / 1000.0 / n;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    QQmlEngine engine;
+    mccqml::QmlDataConverter converter;
+    engine.rootContext()->setContextProperty("dataConverter", &converter);
+
+    QQmlComponent component(&engine);
+    component.setData(makePanel(), QUrl());
+    std::unique_ptr<QObject> panel(component.create());
+    if (!panel) {
+        std::printf("%s\n", component.errorString().toStdString().c_str());
+        return 1;
+    }
+
+    double oldTime = run(panel.get(), true);
+    double newTime = run(panel.get(), false);
+
+    // last frame is rate * seconds - 1
+    double expected = double((rate * seconds - 1) * fieldsCount + fieldsCount - 1);
+    QByteArray last = QByteArray::number(fieldsCount - 1);
+    bool isOk = panel->property(("o" + last).constData()).toDouble() == expected && panel->property(("f" + last).constData()).toDouble() == expected;
+
+    double period = 1000000.0 / rate;
+    std::printf("%d fields at %d Hz\n", fieldsCount, rate);
+    std::printf("list of bytes + js:      %8.1f us/frame, %5.1f%% of frame period\n", oldTime, oldTime / period * 100);
+    std::printf("ArrayBuffer + decoder:   %8.1f us/frame, %5.1f%% of frame period\n", newTime, newTime / period * 100);
+    std::printf("%s\n", isOk ? "OK" : "FAILED");
+    return isOk ? 0 : 1;
+}
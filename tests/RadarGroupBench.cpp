@@ -0,0 +1,95 @@
+#include "mcc/vis/Radar.h"
+#include "mcc/vis/RadarTerrainCache.h"
+#include "mcc/hm/HmReader.h"
+#include "mcc/geo/Constants.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// smooth synthetic relief, reads cost about the same as cached srtm tiles
+class SyntheticHmReader : public mcchm::HmReader {
+public:
+    SyntheticHmReader(const mcchm::RcGeod* geod)
+        : mcchm::HmReader(geod)
+    {
+    }
+
+    mcchm::Altitude readAltitude(mccgeo::LatLon latLon, double) const override
+    {
+        return 300 + 200 * std::sin(latLon.latitude() * 300) * std::cos(latLon.longitude() * 250);
+    }
+
+    const mcchm::HmReader* clone() const override
+    {
+        return new SyntheticHmReader(geod());
+    }
+};
+
+template <typename F>
+static double measure(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// change of one beam parameter in group of 10 radars along 100 km route profile
+int main()
+{
+    mccgeo::Geod geod(mccgeo::wgs84a<double>(), mccgeo::wgs84f<double>());
+    mcchm::Rc<mcchm::RcGeod> rcGeod = new mcchm::RcGeod(mccgeo::wgs84a<double>(), mccgeo::wgs84f<double>());
+    mcchm::Rc<const mcchm::HmReader> reader = new SyntheticHmReader(rcGeod.get());
+
+    mccgeo::LatLon start(55.0, 37.0);
+    mccgeo::LatLon end(55.9, 37.0);
+    std::vector<mccgeo::PositionAndDistance> profile = reader->profile(start, end, 200);
+    for (mccgeo::PositionAndDistance& pAd : profile) {
+        pAd.position().setAltitude(1000);
+    }
+
+    std::vector<mccvis::RadarPtr> radars;
+    for (int i = 0; i < 10; i++) {
+        mccvis::ViewParams params;
+        params.maxBeamDistance = 60000;
+        radars.emplace_back(new mccvis::Radar(mccgeo::LatLon(55.05 + i * 0.08, 37.2 + (i % 2) * 0.1), params));
+    }
+
+    std::size_t points = 0;
+    double full = measure([&]() {
+        for (const mccvis::RadarPtr& radar : radars) {
+            points += radar->visionArea(reader.get(), geod, profile).size();
+        }
+    });
+    std::printf("full group recompute: %.1f ms (%zu profile points)\n", full, profile.size());
+
+    mccvis::RadarTerrainCache cache(reader.get(), geod);
+    double fill = measure([&]() {
+        for (const mccvis::RadarPtr& radar : radars) {
+            points += cache.visionArea(radar.get(), profile).size();
+        }
+    });
+    std::printf("initial cached compute: %.1f ms (%zu rays sampled)\n", fill, cache.sampledRays());
+
+    const int changes = 20;
+    double beam = measure([&]() {
+        for (int i = 0; i < changes; i++) {
+            mccvis::ViewParams params = radars[3]->viewParams();
+            params.radarHeight += 1;
+            radars[3]->setParams(params);
+            points += cache.visionArea(radars[3].get(), profile).size();
+        }
+    });
+    std::printf("radar height change: %.2f ms per change (%zu rays sampled)\n", beam / changes, cache.sampledRays());
+
+    double move = measure([&]() {
+        mccgeo::LatLon pos = radars[3]->position();
+        pos.latitude() += 0.001;
+        radars[3]->setPosition(pos);
+        points += cache.visionArea(radars[3].get(), profile).size();
+    });
+    std::printf("radar position change: %.1f ms (%zu rays sampled)\n", move, cache.sampledRays());
+    return points == 0;
+}
@@ -0,0 +1,330 @@
+#include "mcc/vis/PlotGeometry.h"
+#include "mcc/vis/Profile.h"
+#include "mcc/vis/ProfileViewer.h"
+#include "mcc/vis/Region.h"
+#include "mcc/vis/RegionViewer.h"
+
+#include <bmcl/Math.h>
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QPainterPath>
+#include <QTransform>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+// Renders same region to several images as report does, rebuilding geometry for every image
+// and with shared cached geometry, first and repeated use. Images must be the same.
+// Zones drawn from simplified levels of cached geometry are compared with zones drawn as before, from
+// QPainterPath of every curve at full resolution. Simplified edges may move by half of pixel, so pixels may
+// differ only next to edges of reference image
+
+using namespace mccvis;
+
+static constexpr std::size_t profilesPerImage = 4;
+static constexpr std::size_t profileImages = 6;
+
+static Rc<Region> makeRegion()
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> unit(0, 1);
+    ViewParams params;
+    params.angleStep = 0.5;
+    params.calcHits = true;
+    std::vector<Rc<Profile>> profiles;
+    for (double dir = 0; dir < 360; dir += params.angleStep) {
+        // hills with small noise, 30m samples as in srtm
+        double phase = dir * 0.05;
+        PointVector slice;
+        slice.reserve(2200);
+        for (std::size_t i = 0; i < 2200; i++) {
+            double x = i * 30.0;
+            double h = 200 + 150 * std::sin(x / 4000 + phase) + 60 * std::sin(x / 900 + 2 * phase) + unit(rng) * 3;
+            slice.emplace_back(x, h);
+        }
+        profiles.emplace_back(new Profile(dir, slice, params));
+    }
+    return new Region(std::move(profiles), params);
+}
+
+struct Image {
+    const char* name;
+    int width;
+    int height;
+    // draws image, builds geometry from region if none is given
+    std::function<void(const Region* region, const RegionGeometry* geometry, QImage* img)> render;
+};
+
+static std::vector<Image> makeImages(const Region* region)
+{
+    std::vector<Image> images;
+    auto regionImage = [](RegionViewer::Mode mode, bool drawBackground) {
+        return [mode, drawBackground](const Region* region, const RegionGeometry* geometry, QImage* img) {
+            RegionViewer viewer;
+            if (geometry) {
+                viewer.setGeometry(geometry);
+            } else {
+                viewer.setRegion(region);
+            }
+            viewer.setMode(mode);
+            RegionViewer::RenderConfig cfg;
+            cfg.drawBackground = drawBackground;
+            viewer.renderPlot(img, cfg);
+        };
+    };
+    images.push_back(Image{"zones", 1600, 1600, regionImage(RegionViewer::RegionMode, true)});
+    images.push_back(Image{"zones, no background", 1600, 1600, regionImage(RegionViewer::RegionMode, false)});
+    images.push_back(Image{"zones, large", 4000, 4000, regionImage(RegionViewer::RegionMode, true)});
+    images.push_back(Image{"angles", 1600, 1600, regionImage(RegionViewer::AnglesMode, true)});
+    for (std::size_t i = 0; i < profileImages; i++) {
+        std::size_t first = i * region->profiles().size() / profileImages;
+        images.push_back(Image{"profiles", 1920, 1080, [first](const Region* region, const RegionGeometry* geometry, QImage* img) {
+            ProfileViewer viewer;
+            if (geometry) {
+                std::vector<Rc<const ProfileGeometry>> slice;
+                for (std::size_t k = first; k < first + profilesPerImage; k++) {
+                    slice.push_back(geometry->profile(k));
+                }
+                viewer.setGeometries(slice);
+            } else {
+                std::vector<Rc<const Profile>> slice;
+                for (std::size_t k = first; k < first + profilesPerImage; k++) {
+                    slice.push_back(region->profiles()[k]);
+                }
+                viewer.setProfiles(slice);
+            }
+            viewer.renderPlot(img, ProfileViewer::RenderConfig());
+        }});
+    }
+    return images;
+}
+
+static inline QPointF fromPolar(Point p)
+{
+    double phi = p.x() * bmcl::pi<double>() / 180.0;
+    double r = p.y();
+    return QPointF(r * std::sin(phi), r * std::cos(phi));
+}
+
+// zones as RegionViewer drew them before cached geometry
+static void renderPaths(const Region* region, const QTransform& transform, QImage* img)
+{
+    std::vector<QPainterPath> paths;
+    std::vector<QPainterPath> hitPaths;
+    auto addPaths = [](const std::vector<PointVector>& curves, std::vector<QPainterPath>* paths) {
+        for (const auto& curve : curves) {
+            paths->emplace_back();
+            QPainterPath& path = paths->back();
+            if (curve.empty()) {
+                continue;
+            }
+            path.moveTo(fromPolar(curve[0]));
+            for (std::size_t i = 1; i < curve.size(); i++) {
+                path.lineTo(fromPolar(curve[i]));
+            }
+        }
+    };
+    addPaths(region->curves(), &paths);
+    addPaths(region->hitCurves(), &hitPaths);
+
+    QPainter p(img);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setTransform(transform);
+    QColor fillGreen;
+    fillGreen.setRgba(region->params().viewZonesColorArgb);
+    for (const QPainterPath& path : paths) {
+        p.fillPath(path, fillGreen);
+    }
+    QColor fillRed;
+    fillRed.setRgba(region->params().hitZonesColorArgb);
+    for (const QPainterPath& path : hitPaths) {
+        p.fillPath(path, fillRed);
+    }
+}
+
+// zones as RegionViewer draws them now, returns number of drawn vertices
+static std::size_t renderGeometry(const RegionGeometry* geometry, const QTransform& transform, QImage* img)
+{
+    std::size_t vertices = 0;
+    QPainter p(img);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setTransform(transform);
+    p.setPen(Qt::NoPen);
+    QColor fillGreen;
+    fillGreen.setRgba(geometry->region()->params().viewZonesColorArgb);
+    p.setBrush(fillGreen);
+    for (const PolylineLod& zone : geometry->viewZones()) {
+        const QPolygonF& polygon = zone.level(transform.m11(), transform.m22());
+        vertices += polygon.size();
+        p.drawPolygon(polygon);
+    }
+    QColor fillRed;
+    fillRed.setRgba(geometry->region()->params().hitZonesColorArgb);
+    p.setBrush(fillRed);
+    for (const PolylineLod& zone : geometry->hitZones()) {
+        const QPolygonF& polygon = zone.level(transform.m11(), transform.m22());
+        vertices += polygon.size();
+        p.drawPolygon(polygon);
+    }
+    return vertices;
+}
+
+struct Difference {
+    std::size_t pixels;
+    int maxChannel;
+    // distance in pixels from differing pixel to nearest edge of reference, radius + 1 if none is found
+    int maxDistance;
+};
+
+static Difference compare(const QImage& reference, const QImage& img, int radius)
+{
+    const int w = reference.width();
+    const int h = reference.height();
+    auto at = [](const QImage& i, int x, int y) { return reinterpret_cast<const QRgb*>(i.constScanLine(y))[x]; };
+    // pixels of reference which are not surrounded by pixels of same color
+    std::vector<char> isEdge(std::size_t(w) * h, 0);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            QRgb c = at(reference, x, y);
+            for (int dy = -1; dy <= 1 && !isEdge[y * w + x]; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    int nx = x + dx;
+                    int ny = y + dy;
+                    if (nx >= 0 && ny >= 0 && nx < w && ny < h && at(reference, nx, ny) != c) {
+                        isEdge[y * w + x] = 1;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    Difference d{0, 0, 0};
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            QRgb a = at(reference, x, y);
+            QRgb b = at(img, x, y);
+            if (a == b) {
+                continue;
+            }
+            d.pixels++;
+            int channel = std::max({std::abs(qRed(a) - qRed(b)), std::abs(qGreen(a) - qGreen(b)),
+                                    std::abs(qBlue(a) - qBlue(b)), std::abs(qAlpha(a) - qAlpha(b))});
+            d.maxChannel = std::max(d.maxChannel, channel);
+            int distance = radius + 1;
+            for (int r = 0; r <= radius && distance > radius; r++) {
+                for (int ny = std::max(0, y - r); ny <= std::min(h - 1, y + r) && distance > radius; ny++) {
+                    for (int nx = std::max(0, x - r); nx <= std::min(w - 1, x + r); nx++) {
+                        if (isEdge[ny * w + nx]) {
+                            distance = r;
+                            break;
+                        }
+                    }
+                }
+            }
+            d.maxDistance = std::max(d.maxDistance, distance);
+        }
+    }
+    return d;
+}
+
+// zones of whole region at several image sizes and zoomed in
+static bool compareWithPaths(const Region* region, const RegionGeometry* geometry)
+{
+    struct View {
+        const char* name;
+        int size;
+        double zoom;
+    };
+    const View views[] = {
+        {"small", 400, 1},
+        {"medium", 1600, 1},
+        {"large", 4000, 1},
+        {"zoomed in", 1600, 6},
+    };
+    std::size_t fullVertices = 0;
+    for (const PolylineLod& zone : geometry->viewZones()) {
+        fullVertices += zone.full().size();
+    }
+    for (const PolylineLod& zone : geometry->hitZones()) {
+        fullVertices += zone.full().size();
+    }
+
+    bool isOk = true;
+    QElapsedTimer timer;
+    std::printf("zones with %zu vertices at full resolution\n", fullVertices);
+    std::printf("%-10s %11s %14s %14s %10s %10s %12s %14s\n", "zones", "size", "paths (ms)", "cached (ms)", "vertices",
+                "pixels", "max channel", "max distance");
+    for (const View& view : views) {
+        QTransform transform;
+        transform.translate(view.size / 2.0, view.size / 2.0);
+        double scale = view.zoom * view.size / 2.0 / geometry->maxDistance();
+        transform.scale(scale, -scale);
+
+        QImage reference(view.size, view.size, QImage::Format_ARGB32_Premultiplied);
+        QImage img(view.size, view.size, QImage::Format_ARGB32_Premultiplied);
+        reference.fill(Qt::white);
+        img.fill(Qt::white);
+        timer.start();
+        renderPaths(region, transform, &reference);
+        double pathsTime = timer.nsecsElapsed() / 1000000.0;
+        timer.restart();
+        std::size_t vertices = renderGeometry(geometry, transform, &img);
+        double cachedTime = timer.nsecsElapsed() / 1000000.0;
+
+        const int radius = 4;
+        Difference d = compare(reference, img, radius);
+        // half of pixel of simplification and rounding of antialiased edge
+        bool isSame = d.maxDistance <= 1;
+        isOk &= isSame;
+        std::printf("%-10s %5dx%-5d %14.1f %14.1f %10zu %10zu %12d %14d%s\n", view.name, view.size, view.size,
+                    pathsTime, cachedTime, vertices, d.pixels, d.maxChannel, d.maxDistance, isSame ? "" : "  DIFFERS");
+    }
+    return isOk;
+}
+
+int main(int argc, char** argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    QElapsedTimer timer;
+    timer.start();
+    Rc<Region> region = makeRegion();
+    std::printf("region with %zu profiles built in %.1f ms\n", region->profiles().size(), timer.nsecsElapsed() / 1000000.0);
+
+    timer.restart();
+    Rc<const RegionGeometry> cached = new RegionGeometry(region.get());
+    std::printf("cached geometry built in %.1f ms\n", timer.nsecsElapsed() / 1000000.0);
+
+    std::vector<Image> images = makeImages(region.get());
+    bool isOk = true;
+    double totals[3] = {0, 0, 0};
+    std::printf("%-22s %11s %14s %14s %14s\n", "image", "size", "rebuild (ms)", "first (ms)", "reuse (ms)");
+    for (const Image& image : images) {
+        // rebuilt, cached geometry used first time and cached geometry used again
+        const RegionGeometry* geometries[3] = {nullptr, cached.get(), cached.get()};
+        QImage results[3];
+        double times[3];
+        for (int i = 0; i < 3; i++) {
+            results[i] = QImage(image.width, image.height, QImage::Format_ARGB32_Premultiplied);
+            timer.restart();
+            image.render(region.get(), geometries[i], &results[i]);
+            times[i] = timer.nsecsElapsed() / 1000000.0;
+            totals[i] += times[i];
+        }
+        bool isSame = results[0] == results[1] && results[0] == results[2];
+        isOk &= isSame;
+        std::printf("%-22s %5dx%-5d %14.1f %14.1f %14.1f%s\n", image.name, image.width, image.height, times[0], times[1], times[2], isSame ? "" : "  DIFFERS");
+    }
+    std::printf("%-22s %11s %14.1f %14.1f %14.1f\n", "total", "", totals[0], totals[1], totals[2]);
+    isOk &= compareWithPaths(region.get(), cached.get());
+    std::printf("%s\n", isOk ? "OK" : "FAILED");
+    return isOk ? 0 : 1;
+}
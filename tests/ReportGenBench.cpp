@@ -0,0 +1,102 @@
+#include "mcc/vis/PlotGeometry.h"
+#include "mcc/vis/Profile.h"
+#include "mcc/vis/Region.h"
+#include "mcc/vis/ReportConfig.h"
+#include "mcc/vis/ReportGen.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// Excel report of full 360° region: 3600 profiles of 90 km with 30 m samples, as for srtm.
+// Prints wall time of report and peak memory of process before and after it. ReportGen interface
+// is the same for in-memory workbook and streaming writer, so bench built at older commit gives
+// measurement before streaming writer
+
+using namespace mccvis;
+
+static constexpr double angleStep = 0.1;
+static constexpr std::size_t samplesCount = 3000;
+
+static Rc<Region> makeRegion()
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> unit(0, 1);
+    ViewParams params;
+    params.angleStep = angleStep;
+    params.calcHits = true;
+    std::vector<Rc<Profile>> profiles;
+    for (std::size_t i = 0; i * angleStep < 360; i++) {
+        double dir = i * angleStep;
+        double phase = dir * 0.05;
+        PointVector slice;
+        slice.reserve(samplesCount);
+        for (std::size_t j = 0; j < samplesCount; j++) {
+            double x = j * 30.0;
+            double h = 200 + 150 * std::sin(x / 4000 + phase) + 60 * std::sin(x / 900 + 2 * phase) + unit(rng) * 3;
+            slice.emplace_back(x, h);
+        }
+        profiles.emplace_back(new Profile(dir, slice, params));
+    }
+    return new Region(std::move(profiles), params);
+}
+
+// peak resident memory of process in MB, 0 if unknown
+static double peakMemoryMb()
+{
+#ifndef _WIN32
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return usage.ru_maxrss / 1024.0;
+    }
+#endif
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        std::printf("FAILED: no temporary dir\n");
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    Rc<Region> region = makeRegion();
+    Rc<const RegionGeometry> geometry = new RegionGeometry(region.get());
+    std::printf("region with %zu profiles of %zu samples built in %.1f s, peak memory %.0f MB\n",
+                region->profiles().size(), samplesCount, timer.nsecsElapsed() / 1e9, peakMemoryMb());
+
+    // images do not depend on excel writer and are left out
+    ReportConfig conf;
+    conf.genProfileImages = false;
+    conf.genZoneImages = false;
+    conf.genAnglesImages = false;
+    conf.profilesPerExcelPage = 10;
+
+    ReportGen gen;
+    timer.restart();
+    gen.generateReport(geometry.get(), dir.path(), conf);
+    gen.wait();
+    double seconds = timer.nsecsElapsed() / 1e9;
+
+    QFile report(dir.filePath("report.xlsx"));
+    bool isOk = report.open(QIODevice::ReadOnly) && report.read(2) == "PK";
+    std::printf("excel report written in %.1f s, peak memory %.0f MB, %.1f MB file\n",
+                seconds, peakMemoryMb(), report.size() / 1048576.0);
+    std::printf("%s\n", isOk ? "OK" : "FAILED");
+    return isOk ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include "MissionPlanModel.h"
+
+#include "mcc/uav/Route.h"
+#include "mcc/ui/CoordinateSystemController.h"
+#include "mcc/ui/Settings.h"
+#include "mcc/geo/Position.h"
+
+#include <QTableView>
+#include <QtTest>
+
+// Edits of large route with MissionPlanModel attached to table view
+class RouteEditBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void setWaypoint();
+    void moveWaypoint();
+    void insertAndRemoveWaypoint();
+    void selectAll();
+
+private:
+    static constexpr const int pointsCount = 5000;
+
+    mccui::Rc<mccui::Settings> _settings;
+    mccui::Rc<mccui::CoordinateSystemController> _csController;
+    mccuav::Route* _route;
+    MissionPlanModel* _model;
+    QTableView* _view;
+};
+
+void RouteEditBench::init()
+{
+    _settings = new mccui::Settings;
+    _csController = new mccui::CoordinateSystemController(_settings.get());
+    _route = new mccuav::Route(nullptr, "bench", 1, pointsCount + 1);
+    mccmsg::Waypoints points;
+    points.reserve(pointsCount);
+    for (int i = 0; i < pointsCount; i++)
+        points.emplace_back(mccgeo::Position(55.0 + i * 0.0001, 37.0, 100.0), 10.0, 0.0);
+    _route->setWaypoints(points);
+
+    _model = new MissionPlanModel(_csController.get());
+    _model->setRoute(_route);
+    _view = new QTableView;
+    _view->setModel(_model);
+    _view->resize(800, 600);
+    _view->scrollTo(_model->index(pointsCount / 2, 0));
+}
+
+void RouteEditBench::cleanup()
+{
+    delete _view;
+    delete _model;
+    delete _route;
+    _csController.reset();
+    _settings.reset();
+}
+
+void RouteEditBench::setWaypoint()
+{
+    mccmsg::Waypoint wp = _route->waypointAt(pointsCount / 2);
+    QBENCHMARK
+    {
+        wp.speed += 1;
+        _route->setWaypoint(wp, pointsCount / 2);
+    }
+}
+
+void RouteEditBench::moveWaypoint()
+{
+    QBENCHMARK
+    {
+        _model->moveWaypointDown(pointsCount / 2);
+        _model->moveWaypointUp(pointsCount / 2 + 1);
+    }
+    QCOMPARE(_model->rowCount(), pointsCount);
+}
+
+void RouteEditBench::insertAndRemoveWaypoint()
+{
+    mccmsg::Waypoint wp = _route->waypointAt(pointsCount / 2);
+    QBENCHMARK
+    {
+        _route->insertWaypoint(wp, pointsCount / 2);
+        _model->removeWaypoint(pointsCount / 2);
+    }
+    QCOMPARE(_model->rowCount(), pointsCount);
+}
+
+void RouteEditBench::selectAll()
+{
+    QBENCHMARK
+    {
+        _route->selectAll();
+        _route->clearSelection();
+    }
+}
+
+QTEST_MAIN(RouteEditBench)
+#include "RouteEditBench.moc"
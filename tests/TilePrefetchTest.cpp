@@ -0,0 +1,348 @@
+#include "mcc/map/OmcfCache.h"
+#include "mcc/map/OmcfWriter.h"
+#include "mcc/map/TilePosition.h"
+#include "mcc/map/TilePrefetcher.h"
+#include "mcc/geo/LatLon.h"
+#include "mcc/geo/MercatorProjection.h"
+
+#include <bmcl/Bytes.h>
+#include <bmcl/Result.h>
+
+#include <asio/buffer.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/read_until.hpp>
+#include <asio/streambuf.hpp>
+#include <asio/write.hpp>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+
+// Prefetches region from local tile server in four runs: first run is interrupted as if process was killed,
+// second run is stopped, third run resumes from journal while some tiles are missing on server and some
+// fail once with 503, fourth run completes existing pack. Leftover of write with other projection is discarded.
+// Resulting omcf pack must hold every tile of region with data served for it
+
+using asio::ip::tcp;
+using mccmap::TilePosition;
+
+static std::string tilePath(const TilePosition& pos)
+{
+    return "/" + std::to_string(pos.zoomLevel) + "/" + std::to_string(pos.globalOffsetX) + "/" + std::to_string(pos.globalOffsetY) + ".png";
+}
+
+// unique body of every tile, a few kilobytes as real tile
+static std::string tileBody(const std::string& path)
+{
+    std::string body = "tile " + path + "\n";
+    std::mt19937 gen(std::hash<std::string>()(path));
+    std::size_t size = 2000 + gen() % 4000;
+    while (body.size() < size) {
+        body.push_back(char(gen()));
+    }
+    return body;
+}
+
+class TileServer {
+public:
+    TileServer()
+        : _acceptor(_context, tcp::endpoint(asio::ip::address_v4::loopback(), 0))
+    {
+        accept();
+        _thread = std::thread([this]() { _context.run(); });
+    }
+
+    ~TileServer()
+    {
+        _context.stop();
+        _thread.join();
+    }
+
+    unsigned short port() const
+    {
+        return _acceptor.local_endpoint().port();
+    }
+
+    // missing tiles are answered with 404
+    void setMissing(const std::set<std::string>& paths)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _missing = paths;
+    }
+
+    // unavailable tiles are answered with 503 once, retry gets tile
+    void setUnavailableOnce(const std::set<std::string>& paths)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _unavailable = paths;
+    }
+
+    std::size_t unavailableSent() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _unavailableSent;
+    }
+
+    std::map<std::string, std::size_t> served() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _served;
+    }
+
+private:
+    struct Connection {
+        explicit Connection(asio::io_context& context)
+            : socket(context)
+        {
+        }
+
+        tcp::socket socket;
+        asio::streambuf request;
+        std::string response;
+    };
+
+    void accept()
+    {
+        auto conn = std::make_shared<Connection>(_context);
+        _acceptor.async_accept(conn->socket, [this, conn](const asio::error_code& err) {
+            if (err) {
+                return;
+            }
+            read(conn);
+            accept();
+        });
+    }
+
+    void read(const std::shared_ptr<Connection>& conn)
+    {
+        asio::async_read_until(conn->socket, conn->request, "\r\n\r\n", [this, conn](const asio::error_code& err, std::size_t size) {
+            if (err) {
+                return;
+            }
+            std::string headers(asio::buffers_begin(conn->request.data()), asio::buffers_begin(conn->request.data()) + size);
+            conn->request.consume(size);
+            respond(conn, headers);
+        });
+    }
+
+    void respond(const std::shared_ptr<Connection>& conn, const std::string& headers)
+    {
+        std::size_t start = headers.find(' ') + 1;
+        std::string path = headers.substr(start, headers.find(' ', start) - start);
+        bool isMissing;
+        bool isUnavailable;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            isMissing = _missing.count(path) != 0;
+            isUnavailable = !isMissing && _unavailable.erase(path) != 0;
+            if (isUnavailable) {
+                _unavailableSent++;
+            } else if (!isMissing) {
+                _served[path]++;
+            }
+        }
+        if (isUnavailable) {
+            conn->response = "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\n\r\n";
+        } else if (isMissing) {
+            conn->response = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+        } else {
+            std::string body = tileBody(path);
+            conn->response = "HTTP/1.1 200 OK\r\nContent-Type: image/png\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+        }
+        asio::async_write(conn->socket, asio::buffer(conn->response), [this, conn](const asio::error_code& err, std::size_t) {
+            if (err) {
+                return;
+            }
+            read(conn);
+        });
+    }
+
+    asio::io_context _context;
+    tcp::acceptor _acceptor;
+    std::thread _thread;
+    mutable std::mutex _mutex;
+    std::set<std::string> _missing;
+    std::set<std::string> _unavailable;
+    std::size_t _unavailableSent = 0;
+    std::map<std::string, std::size_t> _served;
+};
+
+static constexpr std::size_t maxConnections = 8;
+
+static std::unique_ptr<mccmap::TilePrefetcher> makePrefetcher(unsigned short port)
+{
+    std::unique_ptr<mccmap::TilePrefetcher> prefetcher(new mccmap::TilePrefetcher);
+    prefetcher->setMaxConnections(maxConnections);
+    prefetcher->setMaxRetries(2);
+    prefetcher->setGenerator([port](const TilePosition& pos) {
+        return "http://127.0.0.1:" + std::to_string(port) + tilePath(pos);
+    });
+    return prefetcher;
+}
+
+static bool waitFor(const std::function<bool()>& isDone)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!isDone()) {
+        if (timer.elapsed() > 30000) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return true;
+}
+
+struct RunResult {
+    bool isFinished;
+    bool isOk;
+    std::size_t downloaded;
+    std::size_t skipped;
+    std::size_t failed;
+};
+
+// runs prefetcher to the end or, after given number of downloaded tiles, stops it or destroys it without finishing
+static RunResult run(unsigned short port, const QString& path, const std::vector<TilePosition>& tiles,
+                     std::size_t interruptAfter = 0, bool isStopped = false)
+{
+    std::unique_ptr<mccmap::TilePrefetcher> prefetcher = makePrefetcher(port);
+    RunResult rv{false, false, 0, 0, 0};
+    QObject::connect(prefetcher.get(), &mccmap::TilePrefetcher::finished, [&rv](bool isOk) {
+        rv.isFinished = true;
+        rv.isOk = isOk;
+    });
+    std::vector<TilePosition> copy = tiles;
+    if (!prefetcher->start(path, "test", "local prefetch test", std::move(copy))) {
+        return rv;
+    }
+    if (interruptAfter != 0) {
+        waitFor([&]() { return rv.isFinished || prefetcher->downloadedCount() >= interruptAfter; });
+        if (isStopped) {
+            prefetcher->stop();
+        }
+    } else {
+        waitFor([&]() { return rv.isFinished; });
+    }
+    rv.downloaded = prefetcher->downloadedCount();
+    rv.skipped = prefetcher->skippedCount();
+    rv.failed = prefetcher->failedCount();
+    return rv;
+}
+
+static void print(const char* name, const RunResult& result)
+{
+    std::printf("%-12s downloaded %4zu, skipped %4zu, failed %3zu, %s\n", name, result.downloaded, result.skipped, result.failed,
+                result.isFinished ? (result.isOk ? "finished" : "finished with errors") : "interrupted");
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    TileServer server;
+    QTemporaryDir dir;
+    QString path = dir.path() + "/region.omcf";
+
+    mccgeo::MercatorProjection proj(mccgeo::MercatorProjection::SphericalMercator);
+    std::vector<mccgeo::LatLon> polygon = {{55.9, 37.3}, {55.9, 37.9}, {55.5, 38.0}, {55.4, 37.4}};
+    std::vector<TilePosition> tiles = mccmap::TilePrefetcher::tilesInPolygon(proj, polygon, 1, 13);
+
+    std::set<std::string> missing;
+    for (std::size_t i = 0; i < tiles.size(); i += 37) {
+        missing.insert(tilePath(tiles[i]));
+    }
+
+    // leftover of write with other projection must not be resumed
+    {
+        mccmap::OmcfWriter leftover;
+        mccgeo::MercatorProjection other(mccgeo::MercatorProjection::EllipticalMercator);
+        std::string body = tileBody(tilePath(tiles[0]));
+        leftover.open(path, "other", "test", "local prefetch test", other, tiles.size());
+        leftover.addTile(tiles[0], body.data(), body.size());
+        leftover.close();
+    }
+
+    bool isOk = tiles.size() > 100;
+    RunResult first = run(server.port(), path, tiles, tiles.size() / 4);
+    isOk &= !first.isFinished && first.downloaded >= tiles.size() / 4 && first.skipped == 0;
+    isOk &= QFile::exists(path + ".part") && QFile::exists(path + ".part.journal") && !QFile::exists(path);
+
+    // stopped pack is left unfinished
+    RunResult stopped = run(server.port(), path, tiles, tiles.size() / 4, true);
+    isOk &= stopped.isFinished && !stopped.isOk;
+    isOk &= stopped.skipped >= first.downloaded && stopped.downloaded >= tiles.size() / 4;
+    isOk &= QFile::exists(path + ".part") && QFile::exists(path + ".part.journal") && !QFile::exists(path);
+
+    // some of tiles not downloaded yet fail once
+    std::set<std::string> unavailable;
+    std::map<std::string, std::size_t> served = server.served();
+    for (std::size_t i = 5; i < tiles.size(); i += 41) {
+        std::string tile = tilePath(tiles[i]);
+        if (missing.count(tile) == 0 && served.count(tile) == 0) {
+            unavailable.insert(tile);
+        }
+    }
+
+    // tiles written before interruption and stop are recovered from journal
+    server.setMissing(missing);
+    server.setUnavailableOnce(unavailable);
+    RunResult second = run(server.port(), path, tiles);
+    isOk &= second.isFinished && !second.isOk;
+    isOk &= second.skipped >= stopped.skipped + stopped.downloaded;
+    isOk &= second.skipped + second.downloaded + second.failed == tiles.size();
+    isOk &= second.failed != 0 && second.failed <= missing.size();
+    isOk &= QFile::exists(path) && !QFile::exists(path + ".part") && !QFile::exists(path + ".part.journal");
+
+    // tiles of finished pack are imported, only failed tiles are downloaded
+    server.setMissing(std::set<std::string>());
+    RunResult third = run(server.port(), path, tiles);
+    isOk &= third.isFinished && third.isOk;
+    isOk &= third.downloaded == second.failed && third.skipped == tiles.size() - second.failed && third.failed == 0;
+
+    auto cache = mccmap::OmcfCache::create(path);
+    std::size_t matched = 0;
+    if (cache.isOk()) {
+        for (const TilePosition& pos : tiles) {
+            bmcl::Bytes data = cache.unwrap()->tileData(pos);
+            std::string expected = tileBody(tilePath(pos));
+            if (data.size() == expected.size() && std::equal(data.begin(), data.end(), (const uint8_t*)expected.data())) {
+                matched++;
+            }
+        }
+        isOk &= cache.unwrap()->size() == int(tiles.size());
+    } else {
+        isOk = false;
+    }
+    isOk &= matched == tiles.size();
+
+    // only tiles in flight when first run was interrupted or second run was stopped are downloaded twice
+    std::size_t requests = 0;
+    for (const auto& it : server.served()) {
+        requests += it.second;
+    }
+    isOk &= requests >= tiles.size() && requests <= tiles.size() + 2 * maxConnections;
+    // tiles answered with 503 are retried, not failed
+    isOk &= !unavailable.empty() && server.unavailableSent() == unavailable.size();
+
+    std::printf("%zu tiles in region, %zu missing and %zu unavailable once on server in resumed run\n",
+                tiles.size(), missing.size(), unavailable.size());
+    print("interrupted", first);
+    print("stopped", stopped);
+    print("resumed", second);
+    print("completed", third);
+    std::printf("%zu/%zu tiles in pack match server, %zu tiles served %s\n", matched, tiles.size(), requests, isOk ? "OK" : "FAILED");
+    return isOk ? 0 : 1;
+}
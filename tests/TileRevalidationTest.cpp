@@ -0,0 +1,322 @@
+#include "mcc/map/DiskCache.h"
+#include "mcc/map/TileLoader.h"
+#include "mcc/map/TilePosition.h"
+
+#include <bmcl/Option.h>
+
+#include <asio/buffer.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/read_until.hpp>
+#include <asio/streambuf.hpp>
+#include <asio/write.hpp>
+
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGuiApplication>
+#include <QImage>
+#include <QPixmap>
+#include <QTemporaryDir>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+
+using asio::ip::tcp;
+
+static const char* tileEtag = "\"tile-v1\"";
+
+// Stand-in for tile server: every tile has the same body and etag, responses are never fresh,
+// so every repeated request of a tile is revalidated. Changed tiles are sent whole without validators
+class TileServer {
+public:
+    struct Stats {
+        std::size_t connections;
+        std::size_t requests;
+        std::size_t notModified;
+        std::size_t conditional;
+        std::size_t withAcceptEncoding;
+        std::size_t bytesSent;
+    };
+
+    explicit TileServer(const QByteArray& body)
+        : _body(body.constData(), body.size())
+        , _acceptor(_context, tcp::endpoint(asio::ip::address_v4::loopback(), 0))
+        , _connections(0)
+        , _requests(0)
+        , _notModified(0)
+        , _conditional(0)
+        , _withAcceptEncoding(0)
+        , _bytesSent(0)
+        , _isChanged(false)
+    {
+        accept();
+        _thread = std::thread([this]() { _context.run(); });
+    }
+
+    ~TileServer()
+    {
+        _context.stop();
+        _thread.join();
+    }
+
+    unsigned short port() const
+    {
+        return _acceptor.local_endpoint().port();
+    }
+
+    Stats stats() const
+    {
+        return Stats{_connections, _requests, _notModified, _conditional, _withAcceptEncoding, _bytesSent};
+    }
+
+    void setChanged(bool isChanged)
+    {
+        _isChanged = isChanged;
+    }
+
+private:
+    struct Connection {
+        explicit Connection(asio::io_context& context)
+            : socket(context)
+        {
+        }
+
+        tcp::socket socket;
+        asio::streambuf request;
+        std::string response;
+    };
+
+    void accept()
+    {
+        auto conn = std::make_shared<Connection>(_context);
+        _acceptor.async_accept(conn->socket, [this, conn](const asio::error_code& err) {
+            if (err) {
+                return;
+            }
+            _connections++;
+            read(conn);
+            accept();
+        });
+    }
+
+    // connection is kept open until client closes it
+    void read(const std::shared_ptr<Connection>& conn)
+    {
+        asio::async_read_until(conn->socket, conn->request, "\r\n\r\n", [this, conn](const asio::error_code& err, std::size_t size) {
+            if (err) {
+                return;
+            }
+            std::string headers(asio::buffers_begin(conn->request.data()), asio::buffers_begin(conn->request.data()) + size);
+            conn->request.consume(size);
+            respond(conn, headers);
+        });
+    }
+
+    void respond(const std::shared_ptr<Connection>& conn, const std::string& headers)
+    {
+        _requests++;
+        if (headers.find("Accept-Encoding:") != std::string::npos) {
+            _withAcceptEncoding++;
+        }
+        if (headers.find("If-None-Match:") != std::string::npos || headers.find("If-Modified-Since:") != std::string::npos) {
+            _conditional++;
+        }
+        std::string common = "Cache-Control: max-age=0\r\n";
+        if (!_isChanged) {
+            common += "ETag: " + std::string(tileEtag) + "\r\n"
+                      "Last-Modified: Mon, 01 Jan 2018 00:00:00 GMT\r\n";
+        }
+        if (!_isChanged && headers.find("If-None-Match: " + std::string(tileEtag)) != std::string::npos) {
+            _notModified++;
+            conn->response = "HTTP/1.1 304 Not Modified\r\n" + common + "\r\n";
+        } else {
+            conn->response = "HTTP/1.1 200 OK\r\n" + common
+                             + "Content-Type: image/png\r\nContent-Length: " + std::to_string(_body.size()) + "\r\n\r\n" + _body;
+        }
+        asio::async_write(conn->socket, asio::buffer(conn->response), [this, conn](const asio::error_code& err, std::size_t size) {
+            if (err) {
+                return;
+            }
+            _bytesSent += size;
+            read(conn);
+        });
+    }
+
+    std::string _body;
+    asio::io_context _context;
+    tcp::acceptor _acceptor;
+    std::thread _thread;
+    std::atomic<std::size_t> _connections;
+    std::atomic<std::size_t> _requests;
+    std::atomic<std::size_t> _notModified;
+    std::atomic<std::size_t> _conditional;
+    std::atomic<std::size_t> _withAcceptEncoding;
+    std::atomic<std::size_t> _bytesSent;
+    std::atomic<bool> _isChanged;
+};
+
+class LocalOnlineCache : public mccmap::DiskCache {
+public:
+    LocalOnlineCache(const QString& path, unsigned short port)
+        : mccmap::DiskCache(path, "tiles", "png")
+        , _port(port)
+        , _name("local")
+    {
+    }
+
+    bmcl::Option<std::string> generateTileUrl(const mccmap::TilePosition& pos) override
+    {
+        return "http://127.0.0.1:" + std::to_string(_port) + "/" + std::to_string(pos.zoomLevel) + "/"
+               + std::to_string(pos.globalOffsetX) + "/" + std::to_string(pos.globalOffsetY) + ".png";
+    }
+
+    bool hasOnlineTiles() const override
+    {
+        return true;
+    }
+
+    const mccgeo::MercatorProjection& projection() const override
+    {
+        return _proj;
+    }
+
+    const QString& description() const override
+    {
+        return _name;
+    }
+
+    const QString& name() const override
+    {
+        return _name;
+    }
+
+private:
+    unsigned short _port;
+    QString _name;
+    mccgeo::MercatorProjection _proj;
+};
+
+static QByteArray makeTile()
+{
+    // noise does not compress, so tile is about as large as real aerial image
+    QImage image(256, 256, QImage::Format_RGB32);
+    std::mt19937 gen(1);
+    for (int y = 0; y < image.height(); y++) {
+        for (int x = 0; x < image.width(); x++) {
+            image.setPixel(x, y, gen() & 0xffffff);
+        }
+    }
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return data;
+}
+
+static bool waitFor(const std::function<bool()>& isDone)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!isDone()) {
+        if (timer.elapsed() > 20000) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    // let loader handle last responses
+    timer.restart();
+    while (timer.elapsed() < 200) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+
+    QByteArray tile = makeTile();
+    TileServer server(tile);
+    QTemporaryDir dir;
+    mccmap::Rc<LocalOnlineCache> cache = new LocalOnlineCache(dir.path(), server.port());
+
+    const int zoom = 5;
+    const std::size_t tilesCount = 64;
+    std::size_t ready = 0;
+    std::size_t revalidated = 0;
+    // server responses are never fresh, so memory cache of map layer must request tiles again
+    std::size_t fresh = 0;
+    mccmap::TileLoader loader(cache.get());
+    loader.setZoomLevel(zoom);
+    QObject::connect(&loader, &mccmap::TileLoader::pixmapReady, [&](const mccmap::TilePosition&, const QPixmap&, qint64 expires) {
+        ready++;
+        fresh += expires > std::time(nullptr);
+    });
+    QObject::connect(&loader, &mccmap::TileLoader::pixmapRevalidated, [&](const mccmap::TilePosition&, qint64 expires) {
+        revalidated++;
+        fresh += expires > std::time(nullptr);
+    });
+
+    auto requestAll = [&]() {
+        for (std::size_t i = 0; i < tilesCount; i++) {
+            loader.addRequest(mccmap::TilePosition(zoom, int(i % 8), int(i / 8)));
+        }
+    };
+
+    // first pass downloads every tile
+    requestAll();
+    bool isOk = waitFor([&]() { return ready == tilesCount; });
+    TileServer::Stats first = server.stats();
+
+    // second pass shows tiles from disk and revalidates them
+    requestAll();
+    isOk &= waitFor([&]() { return server.stats().requests == 2 * tilesCount; });
+    TileServer::Stats second = server.stats();
+    std::size_t secondBytes = second.bytesSent - first.bytesSent;
+    std::size_t secondReady = ready;
+    std::size_t secondRevalidated = revalidated;
+
+    // third pass gets changed tiles without validators, validators of old tiles must be forgotten
+    server.setChanged(true);
+    requestAll();
+    isOk &= waitFor([&]() { return server.stats().requests == 3 * tilesCount; });
+    TileServer::Stats third = server.stats();
+
+    // so fourth pass can not get 304 for tiles it does not have
+    server.setChanged(false);
+    requestAll();
+    isOk &= waitFor([&]() { return server.stats().requests == 4 * tilesCount; });
+    TileServer::Stats fourth = server.stats();
+
+    QFile index(dir.path() + "/tiles/tiles.idx");
+    isOk &= index.open(QIODevice::ReadOnly) && index.size() != 0;
+    isOk &= first.requests == tilesCount;
+    isOk &= second.notModified == tilesCount;
+    isOk &= secondReady == 2 * tilesCount;
+    isOk &= secondRevalidated == tilesCount && fresh == 0;
+    isOk &= second.withAcceptEncoding == second.requests;
+    // connections are reused by following requests
+    isOk &= second.connections <= mccmap::TileLoader::numDownloaders;
+    isOk &= secondBytes * 10 < first.bytesSent;
+    isOk &= third.conditional - second.conditional == tilesCount && third.notModified == second.notModified;
+    isOk &= fourth.conditional == third.conditional && fourth.notModified == third.notModified;
+
+    std::printf("tile size %d bytes, %zu tiles\n", tile.size(), tilesCount);
+    std::printf("download:     %zu requests, %zu bytes sent\n", first.requests, first.bytesSent);
+    std::printf("revalidation: %zu requests, %zu not modified, %zu bytes sent\n",
+                second.requests - first.requests, second.notModified, secondBytes);
+    std::printf("changed tiles: %zu conditional requests, then %zu\n",
+                third.conditional - second.conditional, fourth.conditional - third.conditional);
+    std::printf("%zu connections, %zu requests with Accept-Encoding %s\n",
+                second.connections, second.withAcceptEncoding, isOk ? "OK" : "FAILED");
+    return isOk ? 0 : 1;
+}
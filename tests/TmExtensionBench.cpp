@@ -0,0 +1,74 @@
+#include "mcc/msg/TmView.h"
+#include "mcc/msg/exts/Position.h"
+#include "mcc/msg/exts/Attitude.h"
+#include "mcc/msg/exts/Velocity.h"
+#include "mcc/msg/exts/Gps.h"
+
+#include <bmcl/OptionRc.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+class BenchStorage : public mccmsg::ITmStorage {
+public:
+    BenchStorage()
+    {
+        addExtension(new mccmsg::TmPosition(counter()));
+        addExtension(new mccmsg::TmAttitude(counter()));
+        addExtension(new mccmsg::TmVelocity(counter()));
+        addExtension(new mccmsg::TmGps(counter()));
+    }
+
+    void set(const mccmsg::ITmView*) override {}
+    void update(const mccmsg::ITmViewUpdate*) override {}
+};
+
+template <typename F>
+static void bench(const char* name, std::size_t lookups, F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::size_t found = f();
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::printf("%-8s %6.2f ns/lookup (%zu found)\n", name, ns / lookups, found);
+}
+
+// typed vs uuid extension lookups over 100 vehicles, as done by widgets on telemetry refresh
+int main()
+{
+    const std::size_t vehicles = 100;
+    const std::size_t rounds = 10000;
+
+    std::vector<mccmsg::ITmStoragePtr> storages;
+    for (std::size_t i = 0; i < vehicles; i++) {
+        storages.emplace_back(new BenchStorage);
+    }
+
+    const std::size_t lookups = vehicles * rounds * 4;
+    bench("typed", lookups, [&]() {
+        std::size_t found = 0;
+        for (std::size_t r = 0; r < rounds; r++) {
+            for (const mccmsg::ITmStoragePtr& s : storages) {
+                found += s->getExtension<mccmsg::TmPosition>().isSome();
+                found += s->getExtension<mccmsg::TmAttitude>().isSome();
+                found += s->getExtension<mccmsg::TmVelocity>().isSome();
+                found += s->getExtension<mccmsg::TmGps>().isSome();
+            }
+        }
+        return found;
+    });
+    bench("uuid", lookups, [&]() {
+        std::size_t found = 0;
+        for (std::size_t r = 0; r < rounds; r++) {
+            for (const mccmsg::ITmStoragePtr& s : storages) {
+                found += s->getExtension(mccmsg::TmPosition::id()).isSome();
+                found += s->getExtension(mccmsg::TmAttitude::id()).isSome();
+                found += s->getExtension(mccmsg::TmVelocity::id()).isSome();
+                found += s->getExtension(mccmsg::TmGps::id()).isSome();
+            }
+        }
+        return found;
+    });
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "mcc/msg/exts/History.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// ingest and range queries of position histories, 50 vehicles at 100 Hz
+int main()
+{
+    const std::size_t vehicles = 50;
+    const std::size_t rateHz = 100;
+    const std::size_t seconds = 3600;
+    const std::size_t budget = 8 * 1024 * 1024;
+    const std::size_t fields = 4;
+
+    std::vector<mccmsg::TmHistoryPtr> histories;
+    for (std::size_t i = 0; i < vehicles; i++) {
+        histories.emplace_back(new mccmsg::TmHistory(fields, budget / mccmsg::TmHistory::sampleBytes(fields)));
+    }
+
+    const bmcl::SystemTime start = bmcl::SystemClock::now();
+    const auto period = std::chrono::microseconds(1000000 / rateHz);
+    const std::size_t samples = rateHz * seconds;
+
+    auto t1 = std::chrono::steady_clock::now();
+    for (std::size_t s = 0; s < samples; s++) {
+        bmcl::SystemTime t = start + period * s;
+        for (std::size_t v = 0; v < vehicles; v++) {
+            const double values[fields] = {55.0 + s * 1e-6, 37.0 + v * 1e-3, 100.0, 1.0};
+            histories[v]->append(t, values);
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    double ingest = std::chrono::duration<double>(t2 - t1).count();
+    std::printf("ingest: %zu samples in %.3f s, %.1f M samples/s, %.1f x realtime\n",
+                samples * vehicles, ingest, samples * vehicles / ingest / 1e6, seconds / ingest);
+    std::printf("kept %zu samples per vehicle (%zu KiB)\n", histories[0]->size(), histories[0]->bytes() / 1024);
+
+    const bmcl::SystemTime end = start + period * (samples - 1);
+    const std::size_t queries = 1000;
+    std::size_t points = 0;
+    t1 = std::chrono::steady_clock::now();
+    for (std::size_t q = 0; q < queries; q++) {
+        // last minute of every vehicle
+        for (const mccmsg::TmHistoryPtr& h : histories) {
+            points += h->read(end - std::chrono::seconds(60), end).times.size();
+        }
+    }
+    t2 = std::chrono::steady_clock::now();
+    double range = std::chrono::duration<double, std::micro>(t2 - t1).count();
+    std::printf("range 60 s: %.2f us/query (%zu points)\n", range / (queries * vehicles), points / (queries * vehicles));
+
+    points = 0;
+    t1 = std::chrono::steady_clock::now();
+    for (std::size_t q = 0; q < queries; q++) {
+        // whole history downsampled for plot
+        for (const mccmsg::TmHistoryPtr& h : histories) {
+            points += h->readDownsampled(start, end, 1000).times.size();
+        }
+    }
+    t2 = std::chrono::steady_clock::now();
+    double down = std::chrono::duration<double, std::micro>(t2 - t1).count();
+    std::printf("downsampled: %.2f us/query (%zu points)\n", down / (queries * vehicles), points / (queries * vehicles));
+    return 0;
+}
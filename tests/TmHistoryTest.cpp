@@ -0,0 +1,190 @@
+#include "mcc/msg/TmView.h"
+#include "mcc/msg/exts/History.h"
+#include "mcc/msg/exts/Position.h"
+#include "mcc/msg/exts/Velocity.h"
+
+#include <bmcl/OptionRc.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Checks ring of TmHistory: overwriting of oldest samples, time range reads across end of ring,
+// changes of capacity, downsampled reads, and sharing of memory budget between extensions of storage
+
+static std::size_t failures = 0;
+
+static void check(bool isOk, const char* what)
+{
+    if (!isOk) {
+        failures++;
+        std::printf("FAILED: %s\n", what);
+    }
+}
+
+static const bmcl::SystemTime start = bmcl::SystemTime(std::chrono::hours(24));
+
+static bmcl::SystemTime at(std::size_t second)
+{
+    return start + std::chrono::seconds(second);
+}
+
+// sample of second s has values s and 10 * s
+static void append(mccmsg::TmHistory* history, std::size_t second)
+{
+    const double values[2] = {double(second), 10.0 * second};
+    history->append(at(second), values);
+}
+
+// slice must hold samples of seconds [first, first + count) in order
+static bool holds(const mccmsg::TmHistorySlice& slice, std::size_t first, std::size_t count)
+{
+    if (slice.times.size() != count || slice.columns.size() != 2 || slice.columns[0].size() != count || slice.columns[1].size() != count)
+        return false;
+    for (std::size_t i = 0; i < count; i++) {
+        if (slice.times[i] != at(first + i) || slice.columns[0][i] != double(first + i) || slice.columns[1][i] != 10.0 * (first + i))
+            return false;
+    }
+    return true;
+}
+
+static void testWrapAround()
+{
+    mccmsg::TmHistoryPtr h = new mccmsg::TmHistory(2, 5);
+    check(h->isEmpty() && h->capacity() == 5 && h->bytes() == 5 * mccmsg::TmHistory::sampleBytes(2), "empty history");
+    for (std::size_t s = 0; s < 3; s++)
+        append(h.get(), s);
+    check(h->size() == 3 && h->timeAt(0) == at(0) && h->valueAt(2, 1) == 20.0, "history before wrap");
+
+    // 12 samples in ring of 5, seconds 7..11 are kept and oldest of them is in the middle of ring
+    for (std::size_t s = 3; s < 12; s++)
+        append(h.get(), s);
+    check(h->size() == 5, "size is capped by capacity");
+    check(h->timeAt(0) == at(7) && h->timeAt(4) == at(11), "oldest samples are overwritten");
+    check(h->valueAt(0, 0) == 7.0 && h->valueAt(4, 1) == 110.0, "values follow their times");
+}
+
+static void testRangeReads()
+{
+    mccmsg::TmHistoryPtr h = new mccmsg::TmHistory(2, 5);
+    for (std::size_t s = 0; s < 12; s++)
+        append(h.get(), s);
+
+    check(holds(h->read(at(8), at(10)), 8, 3), "range inside ring");
+    check(holds(h->read(at(9), at(11)), 9, 3), "range across end of ring");
+    check(holds(h->read(at(0), at(100)), 7, 5), "range wider than history");
+    check(holds(h->read(at(0), at(7)), 7, 1), "range ending at oldest sample");
+    check(h->read(at(12), at(20)).times.empty(), "range after newest sample");
+    check(h->read(at(10), at(8)).times.empty(), "reversed range");
+    check(h->read(at(8) + std::chrono::milliseconds(100), at(8) + std::chrono::milliseconds(900)).times.empty(), "range between samples");
+    auto r = h->range(at(8), at(10));
+    check(r.first == 1 && r.second == 4, "range indexes");
+
+    // samples with same time are all in range
+    mccmsg::TmHistoryPtr same = new mccmsg::TmHistory(2, 8);
+    const double values[2] = {1.0, 2.0};
+    same->append(at(1), values);
+    for (std::size_t i = 0; i < 3; i++)
+        same->append(at(2), values);
+    same->append(at(3), values);
+    check(same->read(at(2), at(2)).times.size() == 3, "equal times");
+}
+
+static void testSetCapacity()
+{
+    mccmsg::TmHistoryPtr h = new mccmsg::TmHistory(2, 5);
+    for (std::size_t s = 0; s < 12; s++)
+        append(h.get(), s);
+
+    h->setCapacity(3);
+    check(h->capacity() == 3 && holds(h->read(at(0), at(100)), 9, 3), "shrinking keeps newest samples");
+
+    h->setCapacity(8);
+    check(h->capacity() == 8 && holds(h->read(at(0), at(100)), 9, 3), "growing keeps all samples");
+    for (std::size_t s = 12; s < 20; s++)
+        append(h.get(), s);
+    check(holds(h->read(at(0), at(100)), 12, 8), "ring after growing");
+
+    h->clear();
+    check(h->isEmpty() && h->read(at(0), at(100)).times.empty(), "clear");
+
+    h->setCapacity(0);
+    append(h.get(), 20);
+    check(h->isEmpty(), "history of zero capacity keeps nothing");
+}
+
+static void testDownsampled()
+{
+    mccmsg::TmHistoryPtr h = new mccmsg::TmHistory(2, 100);
+    for (std::size_t s = 0; s < 150; s++)
+        append(h.get(), s);
+
+    auto slice = h->readDownsampled(at(0), at(1000), 10);
+    check(slice.times.size() == 10 && slice.columns[0].size() == 10 && slice.columns[1].size() == 10, "downsampled size");
+    check(slice.times.front() == at(50) && slice.times.back() == at(149), "downsampled range keeps its ends");
+    bool isOrdered = true;
+    for (std::size_t i = 0; i < slice.times.size(); i++) {
+        isOrdered &= i == 0 || slice.times[i - 1] < slice.times[i];
+        isOrdered &= slice.columns[1][i] == 10.0 * slice.columns[0][i];
+        isOrdered &= slice.times[i] == at(std::size_t(slice.columns[0][i]));
+    }
+    check(isOrdered, "downsampled samples are ordered and whole");
+
+    check(holds(h->readDownsampled(at(140), at(149), 10), 140, 10), "range not above limit is read whole");
+    auto last = h->readDownsampled(at(0), at(1000), 1);
+    check(last.times.size() == 1 && last.times[0] == at(149), "single point is newest sample");
+    check(h->readDownsampled(at(0), at(1000), 0).times.empty(), "zero points");
+}
+
+class TestStorage : public mccmsg::ITmStorage {
+public:
+    TestStorage()
+    {
+        addExtension(new mccmsg::TmPosition(counter()));
+        addExtension(new mccmsg::TmVelocity(counter()));
+    }
+
+    void set(const mccmsg::ITmView*) override {}
+    void update(const mccmsg::ITmViewUpdate*) override {}
+};
+
+static void testStorageBudget()
+{
+    bmcl::Rc<TestStorage> storage = new TestStorage;
+    auto pos = storage->getExtension<mccmsg::TmPosition>();
+    auto vel = storage->getExtension<mccmsg::TmVelocity>();
+    check(pos.isSome() && vel.isSome(), "extensions of storage");
+    if (pos.isNone() || vel.isNone())
+        return;
+    check(pos->history().isNone() && vel->history().isNone(), "history is off by default");
+
+    const std::size_t sampleBytes = mccmsg::TmHistory::sampleBytes(4) + mccmsg::TmHistory::sampleBytes(3);
+    storage->setHistoryBudget(100 * sampleBytes);
+    check(pos->history().isSome() && vel->history().isSome(), "budget enables histories");
+    if (pos->history().isNone() || vel->history().isNone())
+        return;
+    check(pos->history()->capacity() == 100 && vel->history()->capacity() == 100, "budget is split by samples");
+
+    pos->set(at(1), mccgeo::Position(55.0, 37.0, 120.0), 2.0);
+    pos->set(at(2), bmcl::None, bmcl::None);
+    pos->set(at(3), mccgeo::Position(55.5, 37.5, 130.0), bmcl::None);
+    auto h = pos->history().unwrap();
+    check(h->size() == 2 && h->timeAt(1) == at(3), "positions are recorded on set");
+    check(h->valueAt(0, 0) == 55.0 && h->valueAt(0, 1) == 37.0 && h->valueAt(0, 2) == 120.0 && h->valueAt(0, 3) == 2.0, "position fields");
+
+    storage->setHistoryBudget(10 * sampleBytes);
+    check(pos->history()->capacity() == 10 && pos->history()->size() == 2, "smaller budget keeps samples");
+    storage->setHistoryBudget(0);
+    check(pos->history().isNone() && vel->history().isNone(), "zero budget disables histories");
+}
+
+int main()
+{
+    testWrapAround();
+    testRangeReads();
+    testSetCapacity();
+    testDownsampled();
+    testStorageBudget();
+    std::printf("%zu failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
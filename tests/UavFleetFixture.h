@@ -0,0 +1,214 @@
+#pragma once
+
+#include "mcc/geo/Constants.h"
+#include "mcc/hm/HmStackReader.h"
+#include "mcc/msg/obj/Channel.h"
+#include "mcc/msg/obj/Device.h"
+#include "mcc/msg/ptr/Channel.h"
+#include "mcc/msg/ptr/Device.h"
+#include "mcc/msg/ptr/ReqVisitor.h"
+#include "mcc/msg/ptr/Tm.h"
+#include "mcc/msg/Stats.h"
+#include "mcc/res/Resource.h"
+#include "mcc/uav/ChannelsController.h"
+#include "mcc/uav/ExchangeService.h"
+#include "mcc/uav/RoutesController.h"
+#include "mcc/uav/UavController.h"
+#include "mcc/ui/HeightmapController.h"
+#include "mcc/ui/Settings.h"
+
+#include <bmcl/Rc.h>
+#include <bmcl/SharedBytes.h>
+
+#include <deque>
+#include <map>
+#include <vector>
+
+// Exchange service without core. Its db knows one channel with all devices of fleet and their descriptions,
+// other requests and commands to devices fail. Requests are answered only in process(), as core answers them
+// on later turn of event loop
+class StubExchangeService : public mccuav::ExchangeService
+{
+public:
+    void setChannel(const mccmsg::ChannelDescription& channel)
+    {
+        _channel = channel;
+    }
+
+    void addDevice(const mccmsg::DeviceDescription& device)
+    {
+        _devices.emplace(device->name(), device);
+    }
+
+    void process()
+    {
+        while (!_queue.empty())
+        {
+            mccuav::ReqItem item = std::move(_queue.front());
+            _queue.pop_front();
+            answer(item);
+        }
+    }
+
+    void cancel(const mccmsg::RequestPtr&) override {}
+    void cancel(mccmsg::RequestId) override {}
+
+    const mccuav::ReqMap& requests() const override
+    {
+        return _requests;
+    }
+
+    void onLog(bmcl::LogLevel logLevel, const mccmsg::Device& device, const std::string& text) override
+    {
+        emit log(new mccmsg::tm::Log(logLevel, "mcc.ui", device, text));
+    }
+
+    void onLog(const mccmsg::Device& device, const std::string& text) override
+    {
+        emit log(new mccmsg::tm::Log(bmcl::LogLevel::Info, "mcc.ui", device, text));
+    }
+
+    void onLog(bmcl::LogLevel logLevel, const std::string& text) override
+    {
+        emit log(new mccmsg::tm::Log(logLevel, "mcc.ui", text));
+    }
+
+    void onLog(const std::string& text) override
+    {
+        emit log(new mccmsg::tm::Log(bmcl::LogLevel::Info, "mcc.ui", text));
+    }
+
+protected:
+    void addResponseHandler(mccuav::ReqItem&& item) override
+    {
+        _queue.push_back(std::move(item));
+    }
+
+private:
+    class DbVisitor : public mccmsg::ReqVisitor
+    {
+    public:
+        DbVisitor(const StubExchangeService* self, const mccuav::ReqItem& item)
+            : mccmsg::ReqVisitor([&item](const mccmsg::DbReq*) { item.onerror(mccmsg::ErrorDscr(mccmsg::Error::NotImplemented)); })
+            , _self(self), _item(item)
+        {
+        }
+
+        using mccmsg::ReqVisitor::visit;
+
+        void visit(const mccmsg::channel::Description_Request* msg) override
+        {
+            if (_self->_channel.isNull() || msg->data() != _self->_channel->name())
+            {
+                _item.onerror(mccmsg::ErrorDscr(mccmsg::Error::ChannelUnknown));
+                return;
+            }
+            _item.onsuccess(mccmsg::make<mccmsg::channel::Description_Response>(msg, _self->_channel));
+        }
+
+        void visit(const mccmsg::device::Description_Request* msg) override
+        {
+            auto it = _self->_devices.find(msg->data());
+            if (it == _self->_devices.end())
+            {
+                _item.onerror(mccmsg::ErrorDscr(mccmsg::Error::DeviceUnknown));
+                return;
+            }
+            _item.onsuccess(mccmsg::make<mccmsg::device::Description_Response>(msg, it->second));
+        }
+
+    private:
+        const StubExchangeService* _self;
+        const mccuav::ReqItem& _item;
+    };
+
+    void answer(const mccuav::ReqItem& item)
+    {
+        if (item.req()->kind() != mccmsg::ReqKind::Db)
+        {
+            item.onerror(mccmsg::ErrorDscr(mccmsg::Error::NotImplemented));
+            return;
+        }
+        DbVisitor visitor(this, item);
+        bmcl::static_pointer_cast<const mccmsg::DbReq>(item.req())->visit(visitor);
+    }
+
+    mccmsg::ChannelDescription _channel;
+    std::map<mccmsg::Device, mccmsg::DeviceDescription> _devices;
+    std::deque<mccuav::ReqItem> _queue;
+    mccuav::ReqMap _requests;
+};
+
+// Controllers of ui core plugin over stub exchange service. Devices of fleet are added to UavController
+// the way exchange reports them: channel is registered, then statistics of each device arrive
+class UavFleet
+{
+public:
+    explicit UavFleet(std::size_t count)
+    {
+        _service = new StubExchangeService;
+        _settings = new mccui::Settings;
+        _routesController = new mccuav::RoutesController;
+        _geod = new mcchm::RcGeod(mccgeo::wgs84a<double>(), mccgeo::wgs84f<double>());
+        _hmReader = new mcchm::HmStackReader(_geod.get());
+        _hmController = new mccui::HeightmapController(_hmReader.get());
+        _chanController = new mccuav::ChannelsController(_settings.get(), _service.get());
+        // protocol controller is used only by telemetry views, fleet does not receive them
+        _uavController = new mccuav::UavController(_settings.get(), _chanController.get(), _routesController.get(),
+                                                   _hmController.get(), nullptr, _service.get());
+
+        auto protocol = mccmsg::Protocol::generate();
+        bmcl::SharedBytes pixmap = bmcl::SharedBytes::create(mccres::loadResource(mccres::ResourceKind::DeviceUnknownIcon));
+        mccmsg::ProtocolIds ids;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            mccmsg::ProtocolId id(mccmsg::Device::generate(), protocol, i + 1);
+            ids.push_back(id);
+            _devices.push_back(id.device());
+            _service->addDevice(new mccmsg::DeviceDescriptionObj(id.device(), "fleet " + std::to_string(i), "", id, bmcl::None
+                , pixmap, bmcl::None, false, false));
+        }
+        mccmsg::INetPtr net = new mccmsg::NetUdpParams("127.0.0.1", bmcl::None, bmcl::None);
+        mccmsg::ChannelDescription channel = new mccmsg::ChannelDescriptionObj(mccmsg::Channel::generate(), protocol, "fleet", net, false
+            , std::chrono::milliseconds(100), false, false, bmcl::None, bmcl::None, ids);
+        _service->setChannel(channel);
+
+        emit _service->channelRegistered(channel->name());
+        _service->process();
+        for (const mccmsg::Device& device : _devices)
+            emit _service->deviceState(mccmsg::StatDevice(device));
+        _service->process();
+    }
+
+    ~UavFleet()
+    {
+        _uavController.reset();
+        _chanController.reset();
+    }
+
+    StubExchangeService* service() const
+    {
+        return _service.get();
+    }
+
+    mccuav::UavController* uavController() const
+    {
+        return _uavController.get();
+    }
+
+    const std::vector<mccmsg::Device>& devices() const
+    {
+        return _devices;
+    }
+
+private:
+    bmcl::Rc<StubExchangeService> _service;
+    bmcl::Rc<mccui::Settings> _settings;
+    bmcl::Rc<mccuav::RoutesController> _routesController;
+    bmcl::Rc<mcchm::RcGeod> _geod;
+    bmcl::Rc<mcchm::HmStackReader> _hmReader;
+    bmcl::Rc<mccui::HeightmapController> _hmController;
+    bmcl::Rc<mccuav::ChannelsController> _chanController;
+    bmcl::Rc<mccuav::UavController> _uavController;
+    std::vector<mccmsg::Device> _devices;
+};
@@ -0,0 +1,135 @@
+#include "mcc/vis/Viewshed.h"
+#include "mcc/vis/Profile.h"
+#include "mcc/hm/HmReader.h"
+#include "mcc/geo/Constants.h"
+#include "mcc/geo/Geod.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// Compares viewshed raster with Profile vision intervals on sampled azimuths of synthetic hills.
+// Raster cells and profile samples lie at slightly different positions and near observer raster cell
+// covers wider sector than profile line, so samples may disagree near edges of profile intervals
+// and rarely elsewhere
+
+using namespace mccvis;
+
+static constexpr double cellSize = 60;
+static constexpr std::size_t azimuthsCount = 48;
+// parts of samples that must agree and that may disagree far from interval edges
+static constexpr double minAgreement = 0.99;
+static constexpr double maxFarFromEdge = 0.001;
+
+class HillsReader : public mcchm::HmReader {
+public:
+    using HmReader::HmReader;
+
+    mcchm::Altitude readAltitude(mccgeo::LatLon latLon, double) const override
+    {
+        double a = latLon.latitude() * 200;
+        double b = latLon.longitude() * 170;
+        return 200 + 150 * std::sin(a) * std::cos(b) + 60 * std::sin(3.1 * a + 1.3 * b);
+    }
+
+    const HmReader* clone() const override
+    {
+        return new HillsReader(geod());
+    }
+};
+
+struct Stats {
+    std::size_t total = 0;
+    std::size_t matched = 0;
+    std::size_t farFromEdge = 0;
+};
+
+static bool isNearEdge(const Profile* profile, double x)
+{
+    for (const Interval& interval : profile->horizontalVisionIntervals()) {
+        if (std::abs(x - interval.start()) < 2 * cellSize || std::abs(x - interval.end()) < 2 * cellSize) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static Stats compare(const Viewshed* vs, const mcchm::HmReader* reader)
+{
+    const ViewParams& params = vs->params();
+    const mccgeo::Geod* geod = reader->geod();
+    constexpr mccgeo::GeodMask mask = mccgeo::GeodMask::Latitude | mccgeo::GeodMask::Longitude | mccgeo::GeodMask::DistanceIn;
+
+    Stats stats;
+    for (std::size_t i = 0; i < azimuthsCount; i++) {
+        double azimuth = 360.0 * i / azimuthsCount + 0.5;
+        mccgeo::LatLon end;
+        geod->direct(vs->observer(), azimuth, params.maxBeamDistance * 0.99, &end, 0);
+        PointVector slice = reader->relativePointProfile(vs->observer(), end, cellSize);
+        Rc<Profile> profile = new Profile(azimuth, slice, params);
+
+        mccgeo::GeodLine line(*geod, vs->observer(), azimuth, mask);
+        for (const Point& sample : slice) {
+            if (sample.x() < 3 * cellSize) {
+                continue;
+            }
+            mccgeo::LatLon latLon;
+            line.position(sample.x(), &latLon, 0);
+            bmcl::Option<ViewshedCell> cell = vs->cellAt(latLon);
+            if (cell.isNone() || cell.unwrap() == ViewshedCell::OutOfRange) {
+                continue;
+            }
+            bool isVisibleInProfile = false;
+            for (const Interval& interval : profile->horizontalVisionIntervals()) {
+                if (sample.x() >= interval.start() && sample.x() <= interval.end()) {
+                    isVisibleInProfile = true;
+                    break;
+                }
+            }
+            stats.total++;
+            if (isVisibleInProfile == (cell.unwrap() == ViewshedCell::Visible)) {
+                stats.matched++;
+            } else if (!isNearEdge(profile.get(), sample.x())) {
+                stats.farFromEdge++;
+            }
+        }
+    }
+    return stats;
+}
+
+static bool check(const char* name, const mcchm::HmReader* reader, const ViewParams& params)
+{
+    Rc<Viewshed> vs = new Viewshed(mccgeo::LatLon(55.0, 37.0), params, cellSize);
+    vs->calculate(reader);
+    Stats stats = compare(vs.get(), reader);
+    double agreement = stats.total == 0 ? 0 : double(stats.matched) / stats.total;
+    bool isOk = stats.total != 0 && agreement >= minAgreement && stats.farFromEdge <= maxFarFromEdge * stats.total;
+    std::printf("%-24s %zu/%zu samples agree (%.2f%%), %zu far from interval edges: %s\n",
+                name, stats.matched, stats.total, 100 * agreement, stats.farFromEdge, isOk ? "OK" : "FAILED");
+    return isOk;
+}
+
+int main()
+{
+    mcchm::Rc<mcchm::RcGeod> geod = new mcchm::RcGeod(mccgeo::wgs84a<double>(), mccgeo::wgs84f<double>());
+    mcchm::Rc<HillsReader> reader = new HillsReader(geod.get());
+
+    ViewParams params;
+    params.maxBeamDistance = 40000;
+    params.minBeamDistance = 0;
+    params.radarHeight = 20;
+    params.objectHeight = 50;
+
+    bool isOk = true;
+    params.hasRefraction = false;
+    isOk &= check("relative target", reader.get(), params);
+    params.hasRefraction = true;
+    isOk &= check("relative target, refr.", reader.get(), params);
+    params.isTargetRelativeHeight = false;
+    params.objectHeight = 400;
+    params.hasRefraction = false;
+    isOk &= check("absolute target", reader.get(), params);
+    params.hasRefraction = true;
+    isOk &= check("absolute target, refr.", reader.get(), params);
+    return isOk ? 0 : 1;
+}